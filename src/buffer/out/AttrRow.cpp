@@ -9,13 +9,100 @@
 // Arguments:
 // - cchRowWidth - the length of the default text attribute
 // - attr - the default text attribute
+// - hyperlinkRefCounts - the table counting the hyperlink references of the
+//   text buffer this row belongs to, if any
+// - runResource - the memory the text buffer this row belongs to allocates
+//   attribute runs from, if any. Otherwise they're allocated on the heap.
 // Return Value:
 // - constructed object
 // Note: will throw exception if unable to allocate memory for text attribute storage
-ATTR_ROW::ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr)
+ATTR_ROW::ATTR_ROW(const UINT cchRowWidth,
+                   const TextAttribute attr,
+                   HyperlinkRefCounts* const hyperlinkRefCounts,
+                   std::pmr::memory_resource* const runResource) :
+    _list{ runResource ? runResource : std::pmr::get_default_resource() },
+    _hyperlinkRefCounts{ hyperlinkRefCounts },
+    _mayHaveHyperlinks{ attr.IsHyperlink() }
 {
     _list.push_back(TextAttributeRun(cchRowWidth, attr));
     _cchRowWidth = cchRowWidth;
+    _AcquireHyperlinks();
+}
+
+// Routine Description:
+// - copy constructor
+// - The copy doesn't belong to any text buffer, so it doesn't reference
+//   the hyperlink table of the original, and its runs are allocated on the heap
+//   instead of in the pool of the original's buffer.
+ATTR_ROW::ATTR_ROW(const ATTR_ROW& other) :
+    _list{ other._list },
+    _cchRowWidth{ other._cchRowWidth },
+    _hyperlinkRefCounts{ nullptr },
+    _mayHaveHyperlinks{ other._mayHaveHyperlinks }
+{
+}
+
+// Routine Description:
+// - move constructor
+// - The references of the runs move along with them, so the table doesn't change.
+//   So does the memory of the runs, which stays in the pool it came from.
+ATTR_ROW::ATTR_ROW(ATTR_ROW&& other) noexcept :
+    _list{ std::move(other._list) },
+    _cchRowWidth{ other._cchRowWidth },
+    _hyperlinkRefCounts{ other._hyperlinkRefCounts },
+    _mayHaveHyperlinks{ other._mayHaveHyperlinks }
+{
+}
+
+// Routine Description:
+// - copy assignment. This row keeps referencing its own hyperlink table.
+ATTR_ROW& ATTR_ROW::operator=(const ATTR_ROW& other)
+{
+    if (this != &other)
+    {
+        _ReleaseHyperlinks();
+        auto acquire = wil::scope_exit([&]() noexcept { _AcquireHyperlinks(); });
+        _list = other._list;
+        _cchRowWidth = other._cchRowWidth;
+        _mayHaveHyperlinks = other._mayHaveHyperlinks;
+    }
+    return *this;
+}
+
+// Routine Description:
+// - move assignment. This row keeps referencing its own hyperlink table.
+// - Rows of the same buffer hand over their runs. A row of another buffer
+//   allocates from a different pool, so its runs are copied into this one's.
+ATTR_ROW& ATTR_ROW::operator=(ATTR_ROW&& other) noexcept
+{
+    if (this != &other)
+    {
+        _ReleaseHyperlinks();
+
+        // Rows of the same buffer just hand over their references.
+        const bool sameTable = _hyperlinkRefCounts == other._hyperlinkRefCounts;
+        if (!sameTable)
+        {
+            other._ReleaseHyperlinks();
+        }
+
+        _list = std::move(other._list);
+        other._list.clear();
+        _cchRowWidth = other._cchRowWidth;
+        _mayHaveHyperlinks = other._mayHaveHyperlinks;
+        other._mayHaveHyperlinks = false;
+
+        if (!sameTable)
+        {
+            _AcquireHyperlinks();
+        }
+    }
+    return *this;
+}
+
+ATTR_ROW::~ATTR_ROW()
+{
+    _ReleaseHyperlinks();
 }
 
 // Routine Description:
@@ -24,8 +111,12 @@ ATTR_ROW::ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr)
 // - attr - The default text attributes to use on text in this row.
 void ATTR_ROW::Reset(const TextAttribute attr)
 {
+    _ReleaseHyperlinks();
+    auto acquire = wil::scope_exit([&]() noexcept { _AcquireHyperlinks(); });
+
     _list.clear();
     _list.push_back(TextAttributeRun(_cchRowWidth, attr));
+    _mayHaveHyperlinks = attr.IsHyperlink();
 }
 
 // Routine Description:
@@ -41,6 +132,9 @@ void ATTR_ROW::Resize(const size_t newWidth)
 {
     THROW_HR_IF(E_INVALIDARG, 0 == newWidth);
 
+    _ReleaseHyperlinks();
+    auto acquire = wil::scope_exit([&]() noexcept { _AcquireHyperlinks(); });
+
     // Easy case. If the new row is longer, increase the length of the last run by how much new space there is.
     if (newWidth > _cchRowWidth)
     {
@@ -176,22 +270,153 @@ size_t ATTR_ROW::FindAttrIndex(const size_t index, size_t* const pApplies) const
 }
 
 // Routine Description:
-// - Finds the hyperlink IDs present in this row and returns them
+// - Copies the runs covering the given columns, cut to fit them exactly.
+// Arguments:
+// - start - the first column
+// - length - the number of columns
+// Return Value:
+// - The runs, whose lengths add up to length
+// Note:
+// - will throw on error
+std::vector<TextAttributeRun> ATTR_ROW::GetRuns(const size_t start, const size_t length) const
+{
+    std::vector<TextAttributeRun> runs;
+    GetRuns(start, length, runs);
+    return runs;
+}
+
+// Routine Description:
+// - Copies the runs covering the given columns, cut to fit them exactly, into
+//   a vector the caller keeps around, so that it doesn't need to be
+//   allocated again for every row.
+// Arguments:
+// - start - the first column
+// - length - the number of columns
+// - runs - receives the runs, whose lengths add up to length
+// Return Value:
+// - <none>
+// Note:
+// - will throw on error
+void ATTR_ROW::GetRuns(const size_t start, const size_t length, std::vector<TextAttributeRun>& runs) const
+{
+    runs.clear();
+    if (length == 0)
+    {
+        return;
+    }
+    THROW_HR_IF(E_INVALIDARG, start >= _cchRowWidth || length > _cchRowWidth - start);
+
+    size_t applies = 0;
+    auto runPos = FindAttrIndex(start, &applies);
+    auto remaining = length;
+    while (remaining > 0)
+    {
+        const auto& run = _list.at(runPos);
+        const auto runLength = std::min(applies, remaining);
+        runs.emplace_back(runLength, run.GetAttributes());
+        remaining -= runLength;
+
+        if (++runPos < _list.size())
+        {
+            applies = _list.at(runPos).GetLength();
+        }
+    }
+}
+
+// Routine Description:
+// - Finds the hyperlink IDs which are referenced by this row, but by no other
+//   row sharing its hyperlink table.
+// - This only looks at the runs of this row, regardless of the size of the buffer.
 // Return value:
-// - An unordered set containing the hyperlink IDs present in this row
-std::unordered_set<uint16_t> ATTR_ROW::GetHyperlinks()
+// - The hyperlink IDs only present in this row
+std::vector<uint16_t> ATTR_ROW::GetExclusiveHyperlinks() const
 {
-    std::unordered_set<uint16_t> ids;
+    std::vector<uint16_t> ids;
+    if (!_mayHaveHyperlinks)
+    {
+        return ids;
+    }
+
     for (const auto& run : _list)
     {
         if (run.GetAttributes().IsHyperlink())
         {
-            ids.emplace(run.GetAttributes().GetHyperlinkId());
+            ids.emplace_back(run.GetAttributes().GetHyperlinkId());
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+
+    // Keep every ID whose references all come from the runs of this row.
+    auto out = ids.begin();
+    for (auto it = ids.begin(); it != ids.end();)
+    {
+        const auto id = *it;
+        const auto next = std::find_if(it, ids.end(), [=](const auto other) { return other != id; });
+        const auto runs = gsl::narrow_cast<size_t>(next - it);
+
+        bool exclusive = true;
+        if (_hyperlinkRefCounts)
+        {
+            const auto refs = _hyperlinkRefCounts->find(id);
+            exclusive = refs == _hyperlinkRefCounts->end() || refs->second <= runs;
+        }
+        if (exclusive)
+        {
+            *out++ = id;
         }
+        it = next;
     }
+    ids.erase(out, ids.end());
     return ids;
 }
 
+// Routine Description:
+// - Counts the hyperlink references of all runs of this row in its hyperlink table.
+// - The runs are only walked if one of them may carry a hyperlink. The walk
+//   clears _mayHaveHyperlinks once none of them does anymore.
+void ATTR_ROW::_AcquireHyperlinks() noexcept
+try
+{
+    if (_mayHaveHyperlinks)
+    {
+        bool found = false;
+        for (const auto& run : _list)
+        {
+            if (run.GetAttributes().IsHyperlink())
+            {
+                if (_hyperlinkRefCounts)
+                {
+                    ++(*_hyperlinkRefCounts)[run.GetAttributes().GetHyperlinkId()];
+                }
+                found = true;
+            }
+        }
+        _mayHaveHyperlinks = found;
+    }
+}
+CATCH_LOG()
+
+// Routine Description:
+// - Removes the hyperlink references of all runs of this row from its hyperlink table.
+//   IDs which aren't referenced anymore are removed from the table entirely.
+void ATTR_ROW::_ReleaseHyperlinks() noexcept
+{
+    if (_hyperlinkRefCounts && _mayHaveHyperlinks)
+    {
+        for (const auto& run : _list)
+        {
+            if (run.GetAttributes().IsHyperlink())
+            {
+                const auto refs = _hyperlinkRefCounts->find(run.GetAttributes().GetHyperlinkId());
+                if (refs != _hyperlinkRefCounts->end() && --refs->second == 0)
+                {
+                    _hyperlinkRefCounts->erase(refs);
+                }
+            }
+        }
+    }
+}
+
 // Routine Description:
 // - Sets the attributes (colors) of all character positions from the given position through the end of the row.
 // Arguments:
@@ -217,6 +442,10 @@ bool ATTR_ROW::SetAttrToEnd(const UINT iStart, const TextAttribute attr)
 // - <none>
 void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith) noexcept
 {
+    _ReleaseHyperlinks();
+    auto acquire = wil::scope_exit([&]() noexcept { _AcquireHyperlinks(); });
+    _mayHaveHyperlinks |= replaceWith.IsHyperlink();
+
     for (auto& run : _list)
     {
         if (run.GetAttributes() == toBeReplacedAttr)
@@ -257,6 +486,12 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
     //            (rgInsertAttrs is a 2 length array with Y1->N1 in it and cInsertAttrs = 2)
     // Final Run: R3 -> G2 -> Y1 -> N1 -> G1 -> B2
 
+    // Whatever the runs end up being, their hyperlink references need to be counted again.
+    // That's only necessary if the row or the inserted runs carry a hyperlink.
+    _ReleaseHyperlinks();
+    auto acquire = wil::scope_exit([&]() noexcept { _AcquireHyperlinks(); });
+    _mayHaveHyperlinks |= std::any_of(newAttrs.begin(), newAttrs.end(), [](const auto& run) { return run.GetAttributes().IsHyperlink(); });
+
     // We'll need to know what the last valid column is for some calculations versus iEnd
     // because iEnd is specified to us as an inclusive index value.
     // Do the -1 math here now so we don't have to have -1s scattered all over this function.
@@ -402,7 +637,7 @@ void ATTR_ROW::ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAtt
     // The original run was 3 long. The insertion run was 1 long. We need 1 more for the
     // fact that an existing piece of the run was split in half (to hold the latter half).
     const size_t cNewRun = _list.size() + newAttrs.size() + 1;
-    std::vector<TextAttributeRun> newRun;
+    decltype(_list) newRun{ _list.get_allocator() };
     newRun.reserve(cNewRun);
 
     // We will start analyzing from the beginning of our existing run.
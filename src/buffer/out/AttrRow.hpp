@@ -23,12 +23,24 @@ Revision History:
 #include "TextAttributeRun.hpp"
 #include "AttrRowIterator.hpp"
 
+// The number of attribute runs referencing each hyperlink ID,
+// summed over all the rows sharing the same table.
+using HyperlinkRefCounts = std::unordered_map<uint16_t, size_t>;
+
 class ATTR_ROW final
 {
 public:
     using const_iterator = typename AttrRowIterator;
 
-    ATTR_ROW(const UINT cchRowWidth, const TextAttribute attr);
+    ATTR_ROW(const UINT cchRowWidth,
+             const TextAttribute attr,
+             HyperlinkRefCounts* const hyperlinkRefCounts = nullptr,
+             std::pmr::memory_resource* const runResource = nullptr);
+    ATTR_ROW(const ATTR_ROW& other);
+    ATTR_ROW(ATTR_ROW&& other) noexcept;
+    ATTR_ROW& operator=(const ATTR_ROW& other);
+    ATTR_ROW& operator=(ATTR_ROW&& other) noexcept;
+    ~ATTR_ROW();
 
     void Reset(const TextAttribute attr);
 
@@ -41,7 +53,10 @@ public:
     size_t FindAttrIndex(const size_t index,
                          size_t* const pApplies) const;
 
-    std::unordered_set<uint16_t> GetHyperlinks();
+    std::vector<uint16_t> GetExclusiveHyperlinks() const;
+
+    std::vector<TextAttributeRun> GetRuns(const size_t start, const size_t length) const;
+    void GetRuns(const size_t start, const size_t length, std::vector<TextAttributeRun>& runs) const;
 
     bool SetAttrToEnd(const UINT iStart, const TextAttribute attr);
     void ReplaceAttrs(const TextAttribute& toBeReplacedAttr, const TextAttribute& replaceWith) noexcept;
@@ -65,9 +80,18 @@ public:
     friend class AttrRowIterator;
 
 private:
-    std::vector<TextAttributeRun> _list;
+    void _AcquireHyperlinks() noexcept;
+    void _ReleaseHyperlinks() noexcept;
+
+    // The runs of the rows of a text buffer come from a pool the buffer shares between them.
+    std::pmr::vector<TextAttributeRun> _list;
     size_t _cchRowWidth;
 
+    // Not owned. Rows copied out of a buffer don't reference its table.
+    HyperlinkRefCounts* _hyperlinkRefCounts;
+    // False if none of the runs carry a hyperlink, so that they don't need to be walked.
+    bool _mayHaveHyperlinks;
+
 #ifdef UNIT_TESTING
     friend class AttrRowTests;
 #endif
@@ -18,11 +18,80 @@
 CharRow::CharRow(size_t rowWidth, ROW* const pParent) :
     _wrapForced{ false },
     _doubleBytePadded{ false },
-    _data(rowWidth, value_type()),
+    _ownedData{ std::make_unique<value_type[]>(rowWidth) },
+    _data{ _ownedData.get(), rowWidth },
+    _glyphStorage{},
     _pParent{ FAIL_FAST_IF_NULL(pParent) }
 {
 }
 
+// Routine Description:
+// - constructor for a row that lives inside storage shared with other rows
+//   (the TextBuffer's cell storage). The cells are reset to their defaults.
+// Arguments:
+// - storage - the cells this row will use. Must outlive the row or be
+//   replaced via MoveToStorage.
+// - pParent - the parent ROW
+// Return Value:
+// - instantiated object
+CharRow::CharRow(gsl::span<value_type> storage, ROW* const pParent) noexcept :
+    _wrapForced{ false },
+    _doubleBytePadded{ false },
+    _ownedData{},
+    _data{ storage },
+    _glyphStorage{},
+    _pParent{ FAIL_FAST_IF_NULL(pParent) }
+{
+    std::fill(_data.begin(), _data.end(), value_type{});
+}
+
+// Routine Description:
+// - copy constructor. The copy always owns its cells, since the storage
+//   of the other row belongs to the other row's TextBuffer.
+// Arguments:
+// - other - the CharRow to copy
+// Return Value:
+// - instantiated object
+// Note: will throw if unable to allocate the cells
+CharRow::CharRow(const CharRow& other) :
+    _wrapForced{ other._wrapForced },
+    _doubleBytePadded{ other._doubleBytePadded },
+    _ownedData{ std::make_unique<value_type[]>(other._data.size()) },
+    _data{ _ownedData.get(), other._data.size() },
+    _glyphStorage{ other._glyphStorage },
+    _pParent{ other._pParent }
+{
+    std::copy(other._data.begin(), other._data.end(), _data.begin());
+}
+
+// Routine Description:
+// - copy assignment. If the widths match, the cells are copied into the
+//   storage this row already uses, wherever that lives.
+// Arguments:
+// - other - the CharRow to copy
+// Return Value:
+// - reference to this object
+// Note: will throw if unable to allocate the cells
+CharRow& CharRow::operator=(const CharRow& other)
+{
+    if (this != &other)
+    {
+        if (_data.size() != other._data.size())
+        {
+            auto newData = std::make_unique<value_type[]>(other._data.size());
+            _data = { newData.get(), other._data.size() };
+            _ownedData = std::move(newData);
+        }
+
+        std::copy(other._data.begin(), other._data.end(), _data.begin());
+        _glyphStorage = other._glyphStorage;
+        _wrapForced = other._wrapForced;
+        _doubleBytePadded = other._doubleBytePadded;
+        _pParent = other._pParent;
+    }
+    return *this;
+}
+
 // Routine Description:
 // - Sets the wrap status for the current row
 // Arguments:
@@ -86,10 +155,8 @@ size_t CharRow::size() const noexcept
 // - <none>
 void CharRow::Reset() noexcept
 {
-    for (auto& cell : _data)
-    {
-        cell.Reset();
-    }
+    std::fill(_data.begin(), _data.end(), value_type{});
+    _glyphStorage.Clear();
 
     _wrapForced = false;
     _doubleBytePadded = false;
@@ -103,16 +170,44 @@ void CharRow::Reset() noexcept
 // - S_OK on success, otherwise relevant error code
 [[nodiscard]] HRESULT CharRow::Resize(const size_t newSize) noexcept
 {
+    // Shrinking keeps using the same cells. Growing can't extend past the end
+    // of our slice of the buffer's storage, so the row takes its own copy
+    // until the TextBuffer packs it back with MoveToStorage.
+    if (newSize <= _data.size())
+    {
+        _data = _data.first(newSize);
+        _glyphStorage.Truncate(newSize);
+        return S_OK;
+    }
+
     try
     {
-        const value_type insertVals;
-        _data.resize(newSize, insertVals);
+        auto newData = std::make_unique<value_type[]>(newSize);
+        std::copy(_data.begin(), _data.end(), newData.get());
+        _data = { newData.get(), newSize };
+        _ownedData = std::move(newData);
     }
     CATCH_RETURN();
 
     return S_OK;
 }
 
+// Routine Description:
+// - Moves the cells of this row into the given storage and releases any
+//   allocation this row owned on its own.
+// Arguments:
+// - storage - the new location for the cells. Must be exactly as wide as the row.
+// Return Value:
+// - <none>
+void CharRow::MoveToStorage(gsl::span<value_type> storage) noexcept
+{
+    FAIL_FAST_IF(storage.size() != _data.size());
+
+    std::copy(_data.begin(), _data.end(), storage.begin());
+    _data = storage;
+    _ownedData.reset();
+}
+
 typename CharRow::iterator CharRow::begin() noexcept
 {
     return _data.begin();
@@ -120,7 +215,7 @@ typename CharRow::iterator CharRow::begin() noexcept
 
 typename CharRow::const_iterator CharRow::cbegin() const noexcept
 {
-    return _data.cbegin();
+    return gsl::span<const value_type>{ _data }.begin();
 }
 
 typename CharRow::iterator CharRow::end() noexcept
@@ -130,7 +225,7 @@ typename CharRow::iterator CharRow::end() noexcept
 
 typename CharRow::const_iterator CharRow::cend() const noexcept
 {
-    return _data.cend();
+    return gsl::span<const value_type>{ _data }.end();
 }
 
 // Routine Description:
@@ -141,12 +236,8 @@ typename CharRow::const_iterator CharRow::cend() const noexcept
 // - The calculated left boundary of the internal string.
 size_t CharRow::MeasureLeft() const
 {
-    std::vector<value_type>::const_iterator it = _data.cbegin();
-    while (it != _data.cend() && it->IsSpace())
-    {
-        ++it;
-    }
-    return it - _data.cbegin();
+    const auto it = std::find_if_not(cbegin(), cend(), [](const value_type& cell) noexcept { return cell.IsSpace(); });
+    return it - cbegin();
 }
 
 // Routine Description:
@@ -157,17 +248,20 @@ size_t CharRow::MeasureLeft() const
 // - The calculated right boundary of the internal string.
 size_t CharRow::MeasureRight() const noexcept
 {
-    std::vector<value_type>::const_reverse_iterator it = _data.crbegin();
-    while (it != _data.crend() && it->IsSpace())
-    {
-        ++it;
-    }
-    return _data.crend() - it;
+    const auto rbegin = std::make_reverse_iterator(cend());
+    const auto rend = std::make_reverse_iterator(cbegin());
+    const auto it = std::find_if_not(rbegin, rend, [](const value_type& cell) noexcept { return cell.IsSpace(); });
+    return rend - it;
 }
 
 void CharRow::ClearCell(const size_t column)
 {
-    _data.at(column).Reset();
+    auto& cell = _CellAt(column);
+    if (cell.DbcsAttr().IsGlyphStored())
+    {
+        _glyphStorage.Erase(column);
+    }
+    cell.Reset();
 }
 
 // Routine Description:
@@ -197,7 +291,7 @@ bool CharRow::ContainsText() const noexcept
 // Note: will throw exception if column is out of bounds
 const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 {
-    return _data.at(column).DbcsAttr();
+    return _CellAt(column).DbcsAttr();
 }
 
 // Routine Description:
@@ -209,7 +303,7 @@ const DbcsAttribute& CharRow::DbcsAttrAt(const size_t column) const
 // Note: will throw exception if column is out of bounds
 DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 {
-    return _data.at(column).DbcsAttr();
+    return _CellAt(column).DbcsAttr();
 }
 
 // Routine Description:
@@ -221,7 +315,84 @@ DbcsAttribute& CharRow::DbcsAttrAt(const size_t column)
 // Note: will throw exception if column is out of bounds
 void CharRow::ClearGlyph(const size_t column)
 {
-    _data.at(column).EraseChars();
+    auto& cell = _CellAt(column);
+    if (cell.DbcsAttr().IsGlyphStored())
+    {
+        _glyphStorage.Erase(column);
+    }
+    cell.EraseChars();
+}
+
+// Routine Description:
+// - Copies a block of cells of a row, which may be this one, into this row.
+// - Glyphs that don't fit into a cell are stored again for the columns they move to.
+//   The ones stored for the cells that are overwritten are dropped.
+// Arguments:
+// - source - the row to copy from. If it's this row, the ranges may overlap.
+// - sourceIndex - the first column to copy from
+// - targetIndex - the first column to copy to
+// - count - the number of cells to copy
+// Note: will throw exception if either range is out of bounds
+void CharRow::CopyCells(const CharRow& source, const size_t sourceIndex, const size_t targetIndex, const size_t count)
+{
+    THROW_HR_IF(E_INVALIDARG, sourceIndex > source.size() || count > source.size() - sourceIndex);
+    THROW_HR_IF(E_INVALIDARG, targetIndex > size() || count > size() - targetIndex);
+
+    const auto from = source._data.subspan(sourceIndex, count);
+
+    // Within this row, read the stored glyphs before any cell is overwritten.
+    // Another row's glyphs can be stored as they are, since storing them here doesn't touch that row.
+    std::vector<std::pair<size_t, std::wstring>> glyphs;
+    if (&source == this)
+    {
+        size_t offset = 0;
+        for (const auto& cell : from)
+        {
+            if (cell.DbcsAttr().IsGlyphStored())
+            {
+                glyphs.emplace_back(offset, source._glyphStorage.GetText(sourceIndex + offset));
+            }
+            ++offset;
+        }
+    }
+
+    for (auto column = targetIndex; column < targetIndex + count; ++column)
+    {
+        if (til::at(_data, column).DbcsAttr().IsGlyphStored())
+        {
+            _glyphStorage.Erase(column);
+        }
+    }
+
+    const auto to = _data.begin() + targetIndex;
+    if (&source != this || targetIndex <= sourceIndex)
+    {
+        std::copy(from.begin(), from.end(), to);
+    }
+    else
+    {
+        std::copy_backward(from.begin(), from.end(), to + count);
+    }
+
+    if (&source == this)
+    {
+        for (const auto& [glyphOffset, glyph] : glyphs)
+        {
+            _glyphStorage.StoreGlyph(targetIndex + glyphOffset, glyph);
+        }
+    }
+    else
+    {
+        size_t offset = 0;
+        for (const auto& cell : from)
+        {
+            if (cell.DbcsAttr().IsGlyphStored())
+            {
+                _glyphStorage.StoreGlyph(targetIndex + offset, source._glyphStorage.GetText(sourceIndex + offset));
+            }
+            ++offset;
+        }
+    }
 }
 
 // Routine Description:
@@ -296,32 +467,40 @@ const DelimiterClass CharRow::DelimiterClassAt(const size_t column, const std::w
     }
 }
 
-UnicodeStorage& CharRow::GetUnicodeStorage() noexcept
+RowGlyphStorage& CharRow::GetGlyphStorage() noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    return _glyphStorage;
 }
 
-const UnicodeStorage& CharRow::GetUnicodeStorage() const noexcept
+const RowGlyphStorage& CharRow::GetGlyphStorage() const noexcept
 {
-    return _pParent->GetUnicodeStorage();
+    return _glyphStorage;
 }
 
 // Routine Description:
-// - calculates the key used by the given column of the char row to store glyph data in UnicodeStorage
+// - Updates the pointer to the parent row (which might change if we shuffle the rows around)
 // Arguments:
-// - column - the column to generate the key for
-// Return Value:
-// - the COORD key for data access from UnicodeStorage for the column
-COORD CharRow::GetStorageKey(const size_t column) const noexcept
+// - pParent - Pointer to the parent row
+void CharRow::UpdateParent(ROW* const pParent)
 {
-    return { gsl::narrow<SHORT>(column), _pParent->GetId() };
+    _pParent = FAIL_FAST_IF_NULL(pParent);
 }
 
 // Routine Description:
-// - Updates the pointer to the parent row (which might change if we shuffle the rows around)
+// - bounds checked access to the cell at column
 // Arguments:
-// - pParent - Pointer to the parent row
-void CharRow::UpdateParent(ROW* const pParent)
+// - column - the column to get the cell for
+// Return Value:
+// - the cell
+// Note: will throw exception if column is out of bounds
+const CharRow::value_type& CharRow::_CellAt(const size_t column) const
 {
-    _pParent = FAIL_FAST_IF_NULL(pParent);
+    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    return til::at(_data, column);
+}
+
+CharRow::value_type& CharRow::_CellAt(const size_t column)
+{
+    THROW_HR_IF(E_INVALIDARG, column >= _data.size());
+    return til::at(_data, column);
 }
@@ -23,7 +23,7 @@ Revision History:
 #include "DbcsAttribute.hpp"
 #include "CharRowCellReference.hpp"
 #include "CharRowCell.hpp"
-#include "UnicodeStorage.hpp"
+#include "RowGlyphStorage.hpp"
 
 class ROW;
 
@@ -49,11 +49,18 @@ class CharRow final
 public:
     using glyph_type = typename wchar_t;
     using value_type = typename CharRowCell;
-    using iterator = typename std::vector<value_type>::iterator;
-    using const_iterator = typename std::vector<value_type>::const_iterator;
+    using iterator = typename gsl::span<value_type>::iterator;
+    using const_iterator = typename gsl::span<const value_type>::iterator;
     using reference = typename CharRowCellReference;
 
     CharRow(size_t rowWidth, ROW* const pParent);
+    CharRow(gsl::span<value_type> storage, ROW* const pParent) noexcept;
+
+    CharRow(const CharRow& other);
+    CharRow& operator=(const CharRow& other);
+    CharRow(CharRow&& other) noexcept = default;
+    CharRow& operator=(CharRow&& other) noexcept = default;
+    ~CharRow() = default;
 
     void SetWrapForced(const bool wrap) noexcept;
     bool WasWrapForced() const noexcept;
@@ -62,6 +69,7 @@ public:
     size_t size() const noexcept;
     void Reset() noexcept;
     [[nodiscard]] HRESULT Resize(const size_t newSize) noexcept;
+    void MoveToStorage(gsl::span<value_type> storage) noexcept;
     size_t MeasureLeft() const;
     size_t MeasureRight() const noexcept;
     void ClearCell(const size_t column);
@@ -69,6 +77,7 @@ public:
     const DbcsAttribute& DbcsAttrAt(const size_t column) const;
     DbcsAttribute& DbcsAttrAt(const size_t column);
     void ClearGlyph(const size_t column);
+    void CopyCells(const CharRow& source, const size_t sourceIndex, const size_t targetIndex, const size_t count);
     std::wstring GetText() const;
 
     const DelimiterClass DelimiterClassAt(const size_t column, const std::wstring_view wordDelimiters) const;
@@ -84,9 +93,8 @@ public:
     iterator end() noexcept;
     const_iterator cend() const noexcept;
 
-    UnicodeStorage& GetUnicodeStorage() noexcept;
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    COORD GetStorageKey(const size_t column) const noexcept;
+    RowGlyphStorage& GetGlyphStorage() noexcept;
+    const RowGlyphStorage& GetGlyphStorage() const noexcept;
 
     void UpdateParent(ROW* const pParent);
 
@@ -100,18 +108,28 @@ protected:
     // Occurs when the user runs out of text to support a double byte character and we're forced to the next line
     bool _doubleBytePadded;
 
+    // heap allocation backing _data when this row doesn't live in its TextBuffer's cell storage
+    // (standalone rows, copies and rows that grew during a resize until they're packed again)
+    std::unique_ptr<value_type[]> _ownedData;
+
     // storage for glyph data and dbcs attributes
-    std::vector<value_type> _data;
+    gsl::span<value_type> _data;
+
+    // glyphs of this row that don't fit into a cell
+    RowGlyphStorage _glyphStorage;
 
     // ROW that this CharRow belongs to
     ROW* _pParent;
+
+    const value_type& _CellAt(const size_t column) const;
+    value_type& _CellAt(const size_t column);
 };
 
 constexpr bool operator==(const CharRow& a, const CharRow& b) noexcept
 {
     return (a._wrapForced == b._wrapForced &&
             a._doubleBytePadded == b._doubleBytePadded &&
-            a._data == b._data);
+            std::equal(a._data.begin(), a._data.end(), b._data.begin(), b._data.end()));
 }
 
 template<typename InputIt1, typename InputIt2>
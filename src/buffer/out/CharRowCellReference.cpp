@@ -2,11 +2,10 @@
 // Licensed under the MIT license.
 
 #include "precomp.h"
-#include "UnicodeStorage.hpp"
 #include "CharRow.hpp"
 
 // Routine Description:
-// - assignment operator. will store extended glyph data in a separate storage location
+// - assignment operator. will store extended glyph data in the glyph storage of the row
 // Arguments:
 // - chars - the glyph data to store
 void CharRowCellReference::operator=(const std::wstring_view chars)
@@ -14,14 +13,16 @@ void CharRowCellReference::operator=(const std::wstring_view chars)
     THROW_HR_IF(E_INVALIDARG, chars.empty());
     if (chars.size() == 1)
     {
+        if (_cellData().DbcsAttr().IsGlyphStored())
+        {
+            _parent.GetGlyphStorage().Erase(_index);
+        }
         _cellData().Char() = chars.front();
         _cellData().DbcsAttr().SetGlyphStored(false);
     }
     else
     {
-        auto& storage = _parent.GetUnicodeStorage();
-        const auto key = _parent.GetStorageKey(_index);
-        storage.StoreGlyph(key, { chars.cbegin(), chars.cend() });
+        _parent.GetGlyphStorage().StoreGlyph(_index, chars);
         _cellData().DbcsAttr().SetGlyphStored(true);
     }
 }
@@ -41,7 +42,7 @@ CharRowCellReference::operator std::wstring_view() const
 // - ref to the CharRowCell
 CharRowCell& CharRowCellReference::_cellData()
 {
-    return _parent._data.at(_index);
+    return _parent._CellAt(_index);
 }
 
 // Routine Description:
@@ -50,7 +51,7 @@ CharRowCell& CharRowCellReference::_cellData()
 // - ref to the CharRowCell
 const CharRowCell& CharRowCellReference::_cellData() const
 {
-    return _parent._data.at(_index);
+    return _parent._CellAt(_index);
 }
 
 // Routine Description:
@@ -61,9 +62,7 @@ std::wstring_view CharRowCellReference::_glyphData() const
 {
     if (_cellData().DbcsAttr().IsGlyphStored())
     {
-        const auto& text = _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index));
-
-        return { text.data(), text.size() };
+        return _parent.GetGlyphStorage().GetText(_index);
     }
     else
     {
@@ -79,7 +78,7 @@ CharRowCellReference::const_iterator CharRowCellReference::begin() const
 {
     if (_cellData().DbcsAttr().IsGlyphStored())
     {
-        return _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index)).data();
+        return _parent.GetGlyphStorage().GetText(_index).data();
     }
     else
     {
@@ -98,7 +97,7 @@ CharRowCellReference::const_iterator CharRowCellReference::end() const
 {
     if (_cellData().DbcsAttr().IsGlyphStored())
     {
-        const auto& chars = _parent.GetUnicodeStorage().GetText(_parent.GetStorageKey(_index));
+        const auto chars = _parent.GetGlyphStorage().GetText(_index);
         return chars.data() + chars.size();
     }
     else
@@ -125,8 +124,8 @@ bool operator==(const CharRowCellReference& ref, const std::vector<wchar_t>& gly
     }
     else
     {
-        const auto& chars = ref._parent.GetUnicodeStorage().GetText(ref._parent.GetStorageKey(ref._index));
-        return chars == glyph;
+        const auto chars = ref._parent.GetGlyphStorage().GetText(ref._index);
+        return std::equal(chars.begin(), chars.end(), glyph.begin(), glyph.end());
     }
 }
 
@@ -7,6 +7,10 @@
 #include "textBuffer.hpp"
 #include "../types/inc/convert.hpp"
 
+// The last revision handed out to a row. It's shared by the rows of every buffer,
+// which can be written to from different threads.
+static std::atomic<uint64_t> s_lastRevision{ 0 };
+
 // Routine Description:
 // - constructor
 // Arguments:
@@ -20,9 +24,35 @@ ROW::ROW(const SHORT rowId, const short rowWidth, const TextAttribute fillAttrib
     _id{ rowId },
     _rowWidth{ gsl::narrow<size_t>(rowWidth) },
     _charRow{ gsl::narrow<size_t>(rowWidth), this },
-    _attrRow{ gsl::narrow<UINT>(rowWidth), fillAttribute },
+    _attrRow{ gsl::narrow<UINT>(rowWidth),
+              fillAttribute,
+              pParent ? &pParent->GetHyperlinkRefCounts() : nullptr,
+              pParent ? pParent->GetAttrRunResource() : nullptr },
+    _pParent{ pParent }
+{
+    _NewRevision();
+}
+
+// Routine Description:
+// - constructor for a row whose cells live in storage owned by the text buffer
+// Arguments:
+// - rowId - the row index in the text buffer
+// - cells - the glyph cells of the row. The width of the row is the size of this span.
+// - fillAttribute - the default text attribute
+// - pParent - the text buffer that this row belongs to
+// Return Value:
+// - constructed object
+ROW::ROW(const SHORT rowId, gsl::span<CharRow::value_type> cells, const TextAttribute fillAttribute, TextBuffer* const pParent) :
+    _id{ rowId },
+    _rowWidth{ cells.size() },
+    _charRow{ cells, this },
+    _attrRow{ gsl::narrow<UINT>(cells.size()),
+              fillAttribute,
+              pParent ? &pParent->GetHyperlinkRefCounts() : nullptr,
+              pParent ? pParent->GetAttrRunResource() : nullptr },
     _pParent{ pParent }
 {
+    _NewRevision();
 }
 
 size_t ROW::size() const noexcept
@@ -37,6 +67,8 @@ const CharRow& ROW::GetCharRow() const noexcept
 
 CharRow& ROW::GetCharRow() noexcept
 {
+    // The caller may change the text through it.
+    _NewRevision();
     return _charRow;
 }
 
@@ -60,6 +92,24 @@ void ROW::SetId(const SHORT id) noexcept
     _id = id;
 }
 
+// Routine Description:
+// - Gets the revision of the text of the row. The row gets a new one, that no row
+//   had before, whenever its text may have changed. Rows that trade places keep
+//   theirs, so anything derived from the text can be cached by revision.
+// Arguments:
+// - <none>
+// Return Value:
+// - the revision
+uint64_t ROW::GetRevision() const noexcept
+{
+    return _revision;
+}
+
+void ROW::_NewRevision() noexcept
+{
+    _revision = s_lastRevision.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 // Routine Description:
 // - Sets all properties of the ROW to default values
 // Arguments:
@@ -68,6 +118,7 @@ void ROW::SetId(const SHORT id) noexcept
 // - <none>
 bool ROW::Reset(const TextAttribute Attr)
 {
+    _NewRevision();
     _charRow.Reset();
     try
     {
@@ -89,6 +140,7 @@ bool ROW::Reset(const TextAttribute Attr)
 // - S_OK if successful, otherwise relevant error
 [[nodiscard]] HRESULT ROW::Resize(const size_t width)
 {
+    _NewRevision();
     RETURN_IF_FAILED(_charRow.Resize(width));
     try
     {
@@ -110,6 +162,7 @@ bool ROW::Reset(const TextAttribute Attr)
 void ROW::ClearColumn(const size_t column)
 {
     THROW_HR_IF(E_INVALIDARG, column >= _charRow.size());
+    _NewRevision();
     _charRow.ClearCell(column);
 }
 
@@ -132,16 +185,6 @@ RowCellIterator ROW::AsCellIter(const size_t startIndex, const size_t count) con
     return RowCellIterator(*this, startIndex, count);
 }
 
-UnicodeStorage& ROW::GetUnicodeStorage() noexcept
-{
-    return _pParent->GetUnicodeStorage();
-}
-
-const UnicodeStorage& ROW::GetUnicodeStorage() const noexcept
-{
-    return _pParent->GetUnicodeStorage();
-}
-
 // Routine Description:
 // - writes cell data to the row
 // Arguments:
@@ -155,6 +198,7 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 {
     THROW_HR_IF(E_INVALIDARG, index >= _charRow.size());
     THROW_HR_IF(E_INVALIDARG, limitRight.value_or(0) >= _charRow.size());
+    _NewRevision();
     size_t currentIndex = index;
 
     // If we're given a right-side column limit, use it. Otherwise, the write limit is the final column index available in the char row.
@@ -256,3 +300,49 @@ OutputCellIterator ROW::WriteCells(OutputCellIterator it, const size_t index, co
 
     return it;
 }
+
+// Routine Description:
+// - Copies a block of cells, text and attributes, from a row into this row.
+// - This is the row level counterpart of walking the cells one at a time through WriteCells,
+//   and pads out double width characters cut in half by the edges of the row the same way.
+// Arguments:
+// - source - the row to copy from. If it's this row, the ranges may overlap.
+// - sourceIndex - the first column to copy from
+// - targetIndex - the first column to copy to
+// - count - the number of cells to copy
+// - wrap - change the wrap flag if the copy fills the last column of the row, like WriteCells does
+// Note: will throw exception if either range is out of bounds
+void ROW::CopyCells(const ROW& source, const size_t sourceIndex, const size_t targetIndex, const size_t count, const std::optional<bool> wrap)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Collect the runs before the cells are copied, since source may be this row.
+    const auto runs = source._attrRow.GetRuns(sourceIndex, count);
+
+    _NewRevision();
+
+    _charRow.CopyCells(source._charRow, sourceIndex, targetIndex, count);
+
+    if (targetIndex == 0 && _charRow.DbcsAttrAt(0).IsTrailing())
+    {
+        _charRow.ClearCell(0);
+    }
+
+    const auto finalColumn = targetIndex + count - 1;
+    const bool fillingLastColumn = finalColumn == _charRow.size() - 1;
+    if (fillingLastColumn && _charRow.DbcsAttrAt(finalColumn).IsLeading())
+    {
+        _charRow.ClearCell(finalColumn);
+        _charRow.SetDoubleBytePadded(true);
+    }
+
+    if (wrap.has_value() && fillingLastColumn)
+    {
+        _charRow.SetWrapForced(wrap.value());
+    }
+
+    THROW_IF_FAILED(_attrRow.InsertAttrRuns(runs, targetIndex, finalColumn, _charRow.size()));
+}
@@ -25,7 +25,6 @@ Revision History:
 #include "OutputCellIterator.hpp"
 #include "CharRow.hpp"
 #include "RowCellIterator.hpp"
-#include "UnicodeStorage.hpp"
 
 class TextBuffer;
 
@@ -33,6 +32,7 @@ class ROW final
 {
 public:
     ROW(const SHORT rowId, const short rowWidth, const TextAttribute fillAttribute, TextBuffer* const pParent);
+    ROW(const SHORT rowId, gsl::span<CharRow::value_type> cells, const TextAttribute fillAttribute, TextBuffer* const pParent);
 
     size_t size() const noexcept;
 
@@ -45,6 +45,8 @@ public:
     SHORT GetId() const noexcept;
     void SetId(const SHORT id) noexcept;
 
+    uint64_t GetRevision() const noexcept;
+
     bool Reset(const TextAttribute Attr);
     [[nodiscard]] HRESULT Resize(const size_t width);
 
@@ -54,10 +56,8 @@ public:
     RowCellIterator AsCellIter(const size_t startIndex) const;
     RowCellIterator AsCellIter(const size_t startIndex, const size_t count) const;
 
-    UnicodeStorage& GetUnicodeStorage() noexcept;
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-
     OutputCellIterator WriteCells(OutputCellIterator it, const size_t index, const std::optional<bool> wrap = std::nullopt, std::optional<size_t> limitRight = std::nullopt);
+    void CopyCells(const ROW& source, const size_t sourceIndex, const size_t targetIndex, const size_t count, const std::optional<bool> wrap = std::nullopt);
 
     friend bool operator==(const ROW& a, const ROW& b) noexcept;
 
@@ -66,11 +66,14 @@ public:
 #endif
 
 private:
+    void _NewRevision() noexcept;
+
     CharRow _charRow;
     ATTR_ROW _attrRow;
     SHORT _id;
     size_t _rowWidth;
     TextBuffer* _pParent; // non ownership pointer
+    uint64_t _revision; // changes along with the text, see GetRevision
 };
 
 inline bool operator==(const ROW& a, const ROW& b) noexcept
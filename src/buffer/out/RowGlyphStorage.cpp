@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "RowGlyphStorage.hpp"
+
+RowGlyphStorage::RowGlyphStorage() noexcept :
+    _glyphs{}
+{
+}
+
+// Routine Description:
+// - fetches the glyph stored for a column
+// Arguments:
+// - column - the column of the glyph
+// Return Value:
+// - the glyph data stored for the column. It stays valid until the next glyph is stored or erased.
+// Note: will throw exception if no glyph is stored for the column
+std::wstring_view RowGlyphStorage::GetText(const size_t column) const
+{
+    const auto it = _LowerBound(column);
+    THROW_HR_IF(E_INVALIDARG, it == _glyphs.end() || it->column != column);
+    return it->text;
+}
+
+// Routine Description:
+// - stores the glyph of a column, replacing the one stored before if any.
+// Arguments:
+// - column - the column of the glyph
+// - glyph - the glyph data to store. It may point into this storage.
+void RowGlyphStorage::StoreGlyph(const size_t column, const std::wstring_view glyph)
+{
+    // Copy the glyph before touching the vector, which may move the one it points to.
+    std::wstring text{ glyph };
+
+    // Rows are mostly written from left to right, so check the end first.
+    if (_glyphs.empty() || _glyphs.back().column < column)
+    {
+        _glyphs.push_back({ column, std::move(text) });
+        return;
+    }
+
+    const auto it = _LowerBound(column);
+    if (it != _glyphs.end() && it->column == column)
+    {
+        it->text = std::move(text);
+    }
+    else
+    {
+        _glyphs.insert(it, { column, std::move(text) });
+    }
+}
+
+// Routine Description:
+// - erases the glyph stored for a column, if any
+// Arguments:
+// - column - the column of the glyph
+void RowGlyphStorage::Erase(const size_t column) noexcept
+{
+    const auto it = _LowerBound(column);
+    if (it != _glyphs.end() && it->column == column)
+    {
+        _glyphs.erase(it);
+    }
+}
+
+// Routine Description:
+// - erases the glyphs of the columns at or beyond the given width, when the row shrinks
+// Arguments:
+// - width - the new width of the row
+void RowGlyphStorage::Truncate(const size_t width) noexcept
+{
+    _glyphs.erase(_LowerBound(width), _glyphs.end());
+}
+
+// Routine Description:
+// - erases all stored glyphs
+void RowGlyphStorage::Clear() noexcept
+{
+    _glyphs.clear();
+}
+
+// Routine Description:
+// - gets the number of stored glyphs
+// Return Value:
+// - the number of stored glyphs
+size_t RowGlyphStorage::size() const noexcept
+{
+    return _glyphs.size();
+}
+
+// Routine Description:
+// - finds the first stored glyph at or after a column
+// Arguments:
+// - column - the column to look for
+// Return Value:
+// - an iterator to the glyph, or the end of the storage
+std::vector<RowGlyphStorage::StoredGlyph>::iterator RowGlyphStorage::_LowerBound(const size_t column) noexcept
+{
+    return std::lower_bound(_glyphs.begin(), _glyphs.end(), column, [](const StoredGlyph& glyph, const size_t value) noexcept {
+        return glyph.column < value;
+    });
+}
+
+std::vector<RowGlyphStorage::StoredGlyph>::const_iterator RowGlyphStorage::_LowerBound(const size_t column) const noexcept
+{
+    return std::lower_bound(_glyphs.begin(), _glyphs.end(), column, [](const StoredGlyph& glyph, const size_t value) noexcept {
+        return glyph.column < value;
+    });
+}
@@ -0,0 +1,50 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- RowGlyphStorage.hpp
+
+Abstract:
+- storage for the glyphs of one row that don't fit into the single wchar_t of a cell,
+  like surrogate pairs, emoji and combining sequences
+- it belongs to the CharRow, so it moves along with the row and never needs to be re-keyed.
+  The glyphs are kept in a vector sorted by column, and glyphs of a few code units
+  are held inline by their strings without allocating.
+--*/
+
+#pragma once
+
+class RowGlyphStorage final
+{
+public:
+    RowGlyphStorage() noexcept;
+
+    std::wstring_view GetText(const size_t column) const;
+
+    void StoreGlyph(const size_t column, const std::wstring_view glyph);
+
+    void Erase(const size_t column) noexcept;
+
+    void Truncate(const size_t width) noexcept;
+
+    void Clear() noexcept;
+
+    size_t size() const noexcept;
+
+private:
+    struct StoredGlyph
+    {
+        size_t column;
+        std::wstring text;
+    };
+
+    std::vector<StoredGlyph>::iterator _LowerBound(const size_t column) noexcept;
+    std::vector<StoredGlyph>::const_iterator _LowerBound(const size_t column) const noexcept;
+
+    std::vector<StoredGlyph> _glyphs;
+
+#ifdef UNIT_TESTING
+    friend class RowGlyphStorageTests;
+#endif
+};
@@ -0,0 +1,725 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+
+#include "SearchRegex.hpp"
+
+// Patterns are parsed recursively, once per nested group.
+static constexpr size_t MaxGroupDepth = 256;
+// The largest count allowed in a {n,m} quantifier.
+static constexpr size_t MaxRepeatCount = 1000;
+
+// Routine Description:
+// - Compiles a pattern.
+// Arguments:
+// - pattern - the regular expression, see the header for the syntax
+// - caseSensitive - whether letters only match themselves or both of their cases
+// Note:
+// - will throw E_INVALIDARG if the pattern is malformed, uses unsupported syntax,
+//   or would compile into too large a program
+SearchRegex::SearchRegex(const std::wstring_view pattern, const bool caseSensitive) :
+    _caseSensitive{ caseSensitive }
+{
+    auto rest = pattern;
+    const auto root = _ParseAlternation(rest, 0);
+
+    // The only thing that stops the parser early is a ')' without a '('.
+    THROW_HR_IF(E_INVALIDARG, !rest.empty());
+
+    _Compile(root);
+    _Emit({ Op::Match });
+}
+
+// Routine Description:
+// - Finds the leftmost match in the text, starting at the given position.
+// - ^ and $ match at the start and end of the whole text, not at from.
+// Arguments:
+// - text - the text to search, usually one logical line of the buffer
+// - from - the first position a match may start at
+// Return Value:
+// - The start and the end (exclusive) of the match, if there is one
+std::optional<std::pair<size_t, size_t>> SearchRegex::Find(const std::wstring_view text, const size_t from) const
+{
+    struct Thread
+    {
+        size_t pc;
+        size_t start;
+    };
+
+    std::vector<Thread> current;
+    std::vector<Thread> next;
+    std::vector<Thread> stack;
+
+    // The position each instruction was last added to a list at. An instruction that is
+    // reached again at the same position was already reached by a thread of higher priority.
+    std::vector<size_t> visited(_program.size(), SIZE_MAX);
+
+    // Follows the jumps, splits and assertions from pc, in order of priority, and adds
+    // the instructions that consume a character (or match) to the list.
+    const auto addThread = [&](std::vector<Thread>& list, const size_t pc, const size_t start, const size_t position) {
+        stack.push_back({ pc, start });
+        while (!stack.empty())
+        {
+            const auto thread = stack.back();
+            stack.pop_back();
+            if (visited.at(thread.pc) == position)
+            {
+                continue;
+            }
+            visited.at(thread.pc) = position;
+
+            const auto& instruction = _program.at(thread.pc);
+            switch (instruction.op)
+            {
+            case Op::Jump:
+                stack.push_back({ instruction.x, thread.start });
+                break;
+            case Op::Split:
+                // The stack is last in, first out. x is preferred, so it goes on top.
+                stack.push_back({ instruction.y, thread.start });
+                stack.push_back({ instruction.x, thread.start });
+                break;
+            case Op::LineStart:
+            case Op::LineEnd:
+            case Op::WordBoundary:
+            case Op::NotWordBoundary:
+                if (_AssertionHolds(instruction.op, text, position))
+                {
+                    stack.push_back({ thread.pc + 1, thread.start });
+                }
+                break;
+            default:
+                list.push_back(thread);
+                break;
+            }
+        }
+    };
+
+    std::optional<std::pair<size_t, size_t>> match;
+    for (auto position = from; position <= text.size(); ++position)
+    {
+        if (!match.has_value())
+        {
+            // Without any thread alive, skip ahead to where the pattern's first character is.
+            if (current.empty() && _program.front().op == Op::Char)
+            {
+                while (position < text.size() && !_Matches(_program.front(), text.at(position)))
+                {
+                    ++position;
+                }
+            }
+
+            // A match starting here has a lower priority than all the ones started before.
+            addThread(current, 0, position, position);
+        }
+
+        for (const auto& thread : current)
+        {
+            const auto& instruction = _program.at(thread.pc);
+            if (instruction.op == Op::Match)
+            {
+                // The threads after this one have a lower priority. They're dropped.
+                match = { thread.start, position };
+                break;
+            }
+            if (position < text.size() && _Matches(instruction, text.at(position)))
+            {
+                addThread(next, thread.pc + 1, thread.start, position + 1);
+            }
+        }
+
+        std::swap(current, next);
+        next.clear();
+
+        if (current.empty() && match.has_value())
+        {
+            break;
+        }
+    }
+    return match;
+}
+
+// Routine Description:
+// - Parses alternatives separated by '|', up to the end of the pattern or a ')'.
+// Arguments:
+// - pattern - the rest of the pattern. The parsed part is removed from it.
+// - depth - how many groups deep this is
+// Return Value:
+// - The parsed node
+SearchRegex::Node SearchRegex::_ParseAlternation(std::wstring_view& pattern, const size_t depth)
+{
+    Node node{ Node::Type::Alternation };
+    node.children.emplace_back(_ParseConcat(pattern, depth));
+    while (!pattern.empty() && pattern.front() == L'|')
+    {
+        pattern.remove_prefix(1);
+        node.children.emplace_back(_ParseConcat(pattern, depth));
+    }
+
+    if (node.children.size() == 1)
+    {
+        return std::move(node.children.front());
+    }
+    return node;
+}
+
+// Routine Description:
+// - Parses a sequence of atoms and their quantifiers, up to a '|', a ')' or the end of the pattern.
+// Arguments:
+// - pattern - the rest of the pattern. The parsed part is removed from it.
+// - depth - how many groups deep this is
+// Return Value:
+// - The parsed node
+SearchRegex::Node SearchRegex::_ParseConcat(std::wstring_view& pattern, const size_t depth)
+{
+    Node node{ Node::Type::Concat };
+    while (!pattern.empty() && pattern.front() != L'|' && pattern.front() != L')')
+    {
+        auto atom = _ParseAtom(pattern, depth);
+
+        size_t min = 0;
+        size_t max = 0;
+        while (_ParseQuantifier(pattern, min, max))
+        {
+            Node repeat{ Node::Type::Repeat };
+            repeat.min = min;
+            repeat.max = max;
+            if (!pattern.empty() && pattern.front() == L'?')
+            {
+                pattern.remove_prefix(1);
+                repeat.greedy = false;
+            }
+            repeat.children.emplace_back(std::move(atom));
+            atom = std::move(repeat);
+        }
+
+        node.children.emplace_back(std::move(atom));
+    }
+    return node;
+}
+
+// Routine Description:
+// - Parses a single character, class, assertion or group.
+// Arguments:
+// - pattern - the rest of the pattern, which isn't empty. The parsed part is removed from it.
+// - depth - how many groups deep this is
+// Return Value:
+// - The parsed node
+SearchRegex::Node SearchRegex::_ParseAtom(std::wstring_view& pattern, const size_t depth)
+{
+    const auto wch = pattern.front();
+    pattern.remove_prefix(1);
+
+    Node node{ Node::Type::Char };
+    switch (wch)
+    {
+    case L'(':
+    {
+        THROW_HR_IF(E_INVALIDARG, depth >= MaxGroupDepth);
+        if (pattern.size() >= 2 && pattern.front() == L'?')
+        {
+            // Only non-capturing groups. Lookarounds and named groups aren't supported.
+            THROW_HR_IF(E_INVALIDARG, pattern.at(1) != L':');
+            pattern.remove_prefix(2);
+        }
+        node = _ParseAlternation(pattern, depth + 1);
+        THROW_HR_IF(E_INVALIDARG, pattern.empty() || pattern.front() != L')');
+        pattern.remove_prefix(1);
+        return node;
+    }
+    case L'[':
+        return _ParseClass(pattern);
+    case L'.':
+        node.type = Node::Type::Any;
+        return node;
+    case L'^':
+        node.type = Node::Type::Assertion;
+        node.assertion = Op::LineStart;
+        return node;
+    case L'$':
+        node.type = Node::Type::Assertion;
+        node.assertion = Op::LineEnd;
+        return node;
+    case L'*':
+    case L'+':
+    case L'?':
+        // There's nothing to repeat.
+        THROW_HR(E_INVALIDARG);
+    case L'\\':
+        break;
+    default:
+        node.ch = wch;
+        return node;
+    }
+
+    THROW_HR_IF(E_INVALIDARG, pattern.empty());
+    const auto escape = pattern.front();
+    pattern.remove_prefix(1);
+    switch (escape)
+    {
+    case L'd':
+    case L'D':
+    case L'w':
+    case L'W':
+    case L's':
+    case L'S':
+        node.type = Node::Type::Class;
+        node.classIndex = _AddClass(s_ClassForEscape(escape));
+        return node;
+    case L'b':
+        node.type = Node::Type::Assertion;
+        node.assertion = Op::WordBoundary;
+        return node;
+    case L'B':
+        node.type = Node::Type::Assertion;
+        node.assertion = Op::NotWordBoundary;
+        return node;
+    case L't':
+        node.ch = L'\t';
+        return node;
+    case L'n':
+        node.ch = L'\n';
+        return node;
+    case L'r':
+        node.ch = L'\r';
+        return node;
+    case L'f':
+        node.ch = L'\f';
+        return node;
+    case L'v':
+        node.ch = L'\v';
+        return node;
+    case L'0':
+        node.ch = L'\0';
+        return node;
+    case L'x':
+    case L'u':
+    {
+        const size_t digits = escape == L'x' ? 2 : 4;
+        THROW_HR_IF(E_INVALIDARG, pattern.size() < digits);
+        unsigned int value = 0;
+        for (size_t i = 0; i < digits; ++i)
+        {
+            const auto digit = pattern.at(i);
+            THROW_HR_IF(E_INVALIDARG, !iswxdigit(digit));
+            value = value * 16 + (iswdigit(digit) ? digit - L'0' : towlower(digit) - L'a' + 10);
+        }
+        pattern.remove_prefix(digits);
+        node.ch = gsl::narrow_cast<wchar_t>(value);
+        return node;
+    }
+    default:
+        // Backreferences can't be matched by an automaton.
+        THROW_HR_IF(E_INVALIDARG, escape >= L'1' && escape <= L'9');
+        node.ch = escape;
+        return node;
+    }
+}
+
+// Routine Description:
+// - Parses a character class, after its opening '['.
+// Arguments:
+// - pattern - the rest of the pattern. The parsed part is removed from it.
+// Return Value:
+// - The parsed node
+SearchRegex::Node SearchRegex::_ParseClass(std::wstring_view& pattern)
+{
+    CharClass charClass;
+    if (!pattern.empty() && pattern.front() == L'^')
+    {
+        pattern.remove_prefix(1);
+        charClass.negated = true;
+    }
+
+    // Reads one character of the class. Escaped classes like \d are added right away.
+    const auto parseChar = [&](wchar_t& wch) {
+        THROW_HR_IF(E_INVALIDARG, pattern.empty());
+        wch = pattern.front();
+        pattern.remove_prefix(1);
+        if (wch != L'\\')
+        {
+            return true;
+        }
+
+        THROW_HR_IF(E_INVALIDARG, pattern.empty());
+        wch = pattern.front();
+        pattern.remove_prefix(1);
+        switch (wch)
+        {
+        case L'd':
+        case L'D':
+        case L'w':
+        case L'W':
+        case L's':
+        case L'S':
+        {
+            auto escaped = s_ClassForEscape(wch);
+            if (escaped.negated)
+            {
+                // Inside of a class, \D and friends add the complement of their ranges.
+                std::vector<std::pair<wchar_t, wchar_t>> complement;
+                wchar_t next = 0;
+                for (const auto& [first, last] : escaped.ranges)
+                {
+                    if (first > next)
+                    {
+                        complement.emplace_back(next, gsl::narrow_cast<wchar_t>(first - 1));
+                    }
+                    next = gsl::narrow_cast<wchar_t>(last + 1);
+                }
+                complement.emplace_back(next, WCHAR_MAX);
+                escaped.ranges = std::move(complement);
+            }
+            charClass.ranges.insert(charClass.ranges.end(), escaped.ranges.begin(), escaped.ranges.end());
+            return false;
+        }
+        case L't':
+            wch = L'\t';
+            return true;
+        case L'n':
+            wch = L'\n';
+            return true;
+        case L'r':
+            wch = L'\r';
+            return true;
+        case L'b':
+            wch = L'\b';
+            return true;
+        default:
+            return true;
+        }
+    };
+
+    while (true)
+    {
+        THROW_HR_IF(E_INVALIDARG, pattern.empty());
+        if (pattern.front() == L']')
+        {
+            pattern.remove_prefix(1);
+            break;
+        }
+
+        wchar_t first;
+        if (!parseChar(first))
+        {
+            continue;
+        }
+
+        // A '-' at the end of the class is just a '-'.
+        if (pattern.size() >= 2 && pattern.front() == L'-' && pattern.at(1) != L']')
+        {
+            pattern.remove_prefix(1);
+            wchar_t last;
+            THROW_HR_IF(E_INVALIDARG, !parseChar(last) || last < first);
+            charClass.ranges.emplace_back(first, last);
+        }
+        else
+        {
+            charClass.ranges.emplace_back(first, first);
+        }
+    }
+
+    Node node{ Node::Type::Class };
+    node.classIndex = _AddClass(std::move(charClass));
+    return node;
+}
+
+// Routine Description:
+// - Parses a quantifier, if the pattern continues with one.
+// - A '{' that doesn't start a valid quantifier is left alone, and will be taken literally.
+// Arguments:
+// - pattern - the rest of the pattern. The quantifier is removed from it.
+// - min - receives the least number of repetitions
+// - max - receives the most number of repetitions, or Unbounded
+// Return Value:
+// - true if there was a quantifier
+bool SearchRegex::_ParseQuantifier(std::wstring_view& pattern, size_t& min, size_t& max)
+{
+    if (pattern.empty())
+    {
+        return false;
+    }
+
+    switch (pattern.front())
+    {
+    case L'*':
+        min = 0;
+        max = Unbounded;
+        pattern.remove_prefix(1);
+        return true;
+    case L'+':
+        min = 1;
+        max = Unbounded;
+        pattern.remove_prefix(1);
+        return true;
+    case L'?':
+        min = 0;
+        max = 1;
+        pattern.remove_prefix(1);
+        return true;
+    case L'{':
+        break;
+    default:
+        return false;
+    }
+
+    size_t position = 1;
+    const auto parseNumber = [&](size_t& value) {
+        const auto start = position;
+        value = 0;
+        while (position < pattern.size() && iswdigit(pattern.at(position)))
+        {
+            value = std::min(value * 10 + (pattern.at(position) - L'0'), MaxRepeatCount + 1);
+            ++position;
+        }
+        return position > start;
+    };
+
+    if (!parseNumber(min))
+    {
+        return false;
+    }
+    max = min;
+    if (position < pattern.size() && pattern.at(position) == L',')
+    {
+        ++position;
+        if (!parseNumber(max))
+        {
+            max = Unbounded;
+        }
+    }
+    if (position >= pattern.size() || pattern.at(position) != L'}')
+    {
+        return false;
+    }
+
+    THROW_HR_IF(E_INVALIDARG, min > MaxRepeatCount || (max != Unbounded && (max > MaxRepeatCount || max < min)));
+    pattern.remove_prefix(position + 1);
+    return true;
+}
+
+// Routine Description:
+// - Stores a character class for the Class instructions to refer to.
+// Arguments:
+// - charClass - the class
+// Return Value:
+// - The index of the class
+size_t SearchRegex::_AddClass(CharClass charClass)
+{
+    std::sort(charClass.ranges.begin(), charClass.ranges.end());
+    _classes.emplace_back(std::move(charClass));
+    return _classes.size() - 1;
+}
+
+// Routine Description:
+// - Gets the character class of an escape like \d or \W.
+// Arguments:
+// - escape - the letter after the backslash
+// Return Value:
+// - The class, with sorted ranges
+SearchRegex::CharClass SearchRegex::s_ClassForEscape(const wchar_t escape)
+{
+    CharClass charClass;
+    switch (towlower(escape))
+    {
+    case L'd':
+        charClass.ranges = { { L'0', L'9' } };
+        break;
+    case L'w':
+        charClass.ranges = { { L'0', L'9' }, { L'A', L'Z' }, { L'_', L'_' }, { L'a', L'z' } };
+        break;
+    case L's':
+        charClass.ranges = { { L'\t', L'\r' }, { L' ', L' ' }, { 0x00A0, 0x00A0 }, { 0x1680, 0x1680 }, { 0x2000, 0x200A }, { 0x2028, 0x2029 }, { 0x202F, 0x202F }, { 0x205F, 0x205F }, { 0x3000, 0x3000 }, { 0xFEFF, 0xFEFF } };
+        break;
+    default:
+        break;
+    }
+    charClass.negated = iswupper(escape) != 0;
+    return charClass;
+}
+
+// Routine Description:
+// - Appends the instructions for a node to the program.
+// Arguments:
+// - node - the node to compile
+void SearchRegex::_Compile(const Node& node)
+{
+    switch (node.type)
+    {
+    case Node::Type::Empty:
+        break;
+    case Node::Type::Char:
+        _Emit({ Op::Char, _caseSensitive ? node.ch : gsl::narrow_cast<wchar_t>(towlower(node.ch)) });
+        break;
+    case Node::Type::Any:
+        _Emit({ Op::Any });
+        break;
+    case Node::Type::Class:
+        _Emit({ Op::Class, 0, node.classIndex });
+        break;
+    case Node::Type::Assertion:
+        _Emit({ node.assertion });
+        break;
+    case Node::Type::Concat:
+        for (const auto& child : node.children)
+        {
+            _Compile(child);
+        }
+        break;
+    case Node::Type::Alternation:
+    {
+        // Each alternative but the last is tried through a split that prefers it.
+        std::vector<size_t> jumps;
+        for (size_t i = 0; i + 1 < node.children.size(); ++i)
+        {
+            const auto split = _Emit({ Op::Split });
+            _program.at(split).x = _program.size();
+            _Compile(node.children.at(i));
+            jumps.push_back(_Emit({ Op::Jump }));
+            _program.at(split).y = _program.size();
+        }
+        _Compile(node.children.back());
+        for (const auto jump : jumps)
+        {
+            _program.at(jump).x = _program.size();
+        }
+        break;
+    }
+    case Node::Type::Repeat:
+    {
+        const auto& child = node.children.front();
+        for (size_t i = 0; i < node.min; ++i)
+        {
+            _Compile(child);
+        }
+
+        if (node.max == Unbounded)
+        {
+            const auto split = _Emit({ Op::Split });
+            _Compile(child);
+            _Emit({ Op::Jump, 0, split });
+            const auto body = split + 1;
+            const auto out = _program.size();
+            _program.at(split).x = node.greedy ? body : out;
+            _program.at(split).y = node.greedy ? out : body;
+        }
+        else
+        {
+            // Each optional repetition is entered through its own split, which all leave to the end.
+            std::vector<size_t> splits;
+            for (auto i = node.min; i < node.max; ++i)
+            {
+                splits.push_back(_Emit({ Op::Split }));
+                _Compile(child);
+            }
+            const auto out = _program.size();
+            for (const auto split : splits)
+            {
+                _program.at(split).x = node.greedy ? split + 1 : out;
+                _program.at(split).y = node.greedy ? out : split + 1;
+            }
+        }
+        break;
+    }
+    }
+}
+
+// Routine Description:
+// - Appends an instruction to the program.
+// Arguments:
+// - instruction - the instruction
+// Return Value:
+// - The index of the instruction
+size_t SearchRegex::_Emit(const Instruction instruction)
+{
+    // Quantifiers copy their operand, so nesting them can blow up the program.
+    THROW_HR_IF(E_INVALIDARG, _program.size() >= MaxInstructions);
+    _program.push_back(instruction);
+    return _program.size() - 1;
+}
+
+// Routine Description:
+// - Checks whether an instruction that consumes a character accepts the given one.
+// Arguments:
+// - instruction - a Char, Any or Class instruction
+// - wch - the character of the text
+// Return Value:
+// - true if the instruction matches the character
+bool SearchRegex::_Matches(const Instruction& instruction, const wchar_t wch) const noexcept
+{
+    switch (instruction.op)
+    {
+    case Op::Char:
+        return instruction.ch == (_caseSensitive ? wch : towlower(wch));
+    case Op::Any:
+        return true;
+    case Op::Class:
+        return _ClassContains(_classes.at(instruction.x), wch);
+    default:
+        return false;
+    }
+}
+
+// Routine Description:
+// - Checks whether a character is in a class. Without case sensitivity,
+//   a letter is in a class if either of its cases is.
+// Arguments:
+// - charClass - the class
+// - wch - the character
+// Return Value:
+// - true if the character is in the class
+bool SearchRegex::_ClassContains(const CharClass& charClass, const wchar_t wch) const noexcept
+{
+    const auto inRanges = [&](const wchar_t c) {
+        return std::any_of(charClass.ranges.begin(), charClass.ranges.end(), [c](const auto& range) {
+            return range.first <= c && c <= range.second;
+        });
+    };
+
+    auto contained = inRanges(wch);
+    if (!contained && !_caseSensitive)
+    {
+        contained = inRanges(towlower(wch)) || inRanges(towupper(wch));
+    }
+    return contained != charClass.negated;
+}
+
+// Routine Description:
+// - Checks a zero-width assertion at a position of the text.
+// Arguments:
+// - op - the assertion
+// - text - the whole text
+// - position - the position between two characters
+// Return Value:
+// - true if the assertion holds there
+bool SearchRegex::_AssertionHolds(const Op op, const std::wstring_view text, const size_t position) const noexcept
+{
+    switch (op)
+    {
+    case Op::LineStart:
+        return position == 0;
+    case Op::LineEnd:
+        return position == text.size();
+    case Op::WordBoundary:
+    case Op::NotWordBoundary:
+    {
+        const auto before = position > 0 && s_IsWordChar(text.at(position - 1));
+        const auto after = position < text.size() && s_IsWordChar(text.at(position));
+        return (before != after) == (op == Op::WordBoundary);
+    }
+    default:
+        return false;
+    }
+}
+
+// Routine Description:
+// - Checks whether a character is a word character, like \w.
+// Arguments:
+// - wch - the character
+// Return Value:
+// - true if it's a letter, digit or underscore
+bool SearchRegex::s_IsWordChar(const wchar_t wch) noexcept
+{
+    return (wch >= L'0' && wch <= L'9') || (wch >= L'A' && wch <= L'Z') || (wch >= L'a' && wch <= L'z') || wch == L'_';
+}
@@ -0,0 +1,111 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- SearchRegex.hpp
+
+Abstract:
+- A regular expression for searching the text buffer.
+- The pattern is compiled once into a program for a Thompson NFA, which is run
+  as a Pike VM: every position of the text is visited once, with all possible
+  states of the automaton at the same time. That takes time linear in the
+  length of the text, whatever the pattern, unlike the backtracking std::wregex.
+- Matches are leftmost-first like ECMAScript, so alternatives and greedy or
+  lazy quantifiers choose the same match std::wregex would.
+- Supported syntax: literals, ".", "[...]" classes with ranges and negation,
+  "\d \w \s \D \W \S", "\b \B", "^ $", groups "(...)" and "(?:...)",
+  alternation "|" and the quantifiers "* + ? {n} {n,} {n,m}", optionally lazy.
+  Backreferences and lookaround can't be matched in linear time and are rejected.
+--*/
+
+#pragma once
+
+class SearchRegex final
+{
+public:
+    SearchRegex(const std::wstring_view pattern, const bool caseSensitive);
+
+    std::optional<std::pair<size_t, size_t>> Find(const std::wstring_view text, const size_t from) const;
+
+private:
+    enum class Op : BYTE
+    {
+        Char,
+        Any,
+        Class,
+        Split,
+        Jump,
+        LineStart,
+        LineEnd,
+        WordBoundary,
+        NotWordBoundary,
+        Match
+    };
+
+    struct Instruction
+    {
+        Op op;
+        wchar_t ch = 0;
+        // Class: the index of the class. Split: the preferred branch. Jump: the target.
+        size_t x = 0;
+        // Split: the other branch.
+        size_t y = 0;
+    };
+
+    struct CharClass
+    {
+        std::vector<std::pair<wchar_t, wchar_t>> ranges;
+        bool negated = false;
+    };
+
+    struct Node
+    {
+        enum class Type
+        {
+            Empty,
+            Char,
+            Any,
+            Class,
+            Assertion,
+            Concat,
+            Alternation,
+            Repeat
+        };
+
+        Type type = Type::Empty;
+        wchar_t ch = 0;
+        size_t classIndex = 0;
+        Op assertion = Op::Match;
+        std::vector<Node> children;
+        size_t min = 0;
+        size_t max = 0;
+        bool greedy = true;
+    };
+
+    static constexpr size_t Unbounded = SIZE_MAX;
+    static constexpr size_t MaxInstructions = 65536;
+
+    // parsing
+    Node _ParseAlternation(std::wstring_view& pattern, const size_t depth);
+    Node _ParseConcat(std::wstring_view& pattern, const size_t depth);
+    Node _ParseAtom(std::wstring_view& pattern, const size_t depth);
+    Node _ParseClass(std::wstring_view& pattern);
+    bool _ParseQuantifier(std::wstring_view& pattern, size_t& min, size_t& max);
+    size_t _AddClass(CharClass charClass);
+    static CharClass s_ClassForEscape(const wchar_t escape);
+
+    // compiling
+    void _Compile(const Node& node);
+    size_t _Emit(const Instruction instruction);
+
+    // matching
+    bool _Matches(const Instruction& instruction, const wchar_t wch) const noexcept;
+    bool _ClassContains(const CharClass& charClass, const wchar_t wch) const noexcept;
+    bool _AssertionHolds(const Op op, const std::wstring_view text, const size_t position) const noexcept;
+    static bool s_IsWordChar(const wchar_t wch) noexcept;
+
+    std::vector<Instruction> _program;
+    std::vector<CharClass> _classes;
+    bool _caseSensitive;
+};
@@ -22,15 +22,20 @@ using namespace Microsoft::Console::Types;
 // - str - The search term you want to find (the "needle")
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
+// - mode - Whether the search term is the text itself or a regular expression
+// Note:
+// - will throw E_INVALIDARG if the search term isn't a valid regular expression in regex mode
 Search::Search(IUiaData& uiaData,
                const std::wstring& str,
                const Direction direction,
-               const Sensitivity sensitivity) :
+               const Sensitivity sensitivity,
+               const Mode mode) :
     _direction(direction),
     _sensitivity(sensitivity),
     _needle(s_CreateNeedleFromString(str)),
     _uiaData(uiaData),
-    _coordAnchor(s_GetInitialAnchor(uiaData, direction))
+    _coordAnchor(s_GetInitialAnchor(uiaData, direction)),
+    _regex(s_CreateRegex(str, sensitivity, mode))
 {
     _coordNext = _coordAnchor;
 }
@@ -46,16 +51,21 @@ Search::Search(IUiaData& uiaData,
 // - direction - The direction to search (upward or downward)
 // - sensitivity - Whether or not you care about case
 // - anchor - starting search location in screenInfo
+// - mode - Whether the search term is the text itself or a regular expression
+// Note:
+// - will throw E_INVALIDARG if the search term isn't a valid regular expression in regex mode
 Search::Search(IUiaData& uiaData,
                const std::wstring& str,
                const Direction direction,
                const Sensitivity sensitivity,
-               const COORD anchor) :
+               const COORD anchor,
+               const Mode mode) :
     _direction(direction),
     _sensitivity(sensitivity),
     _needle(s_CreateNeedleFromString(str)),
     _coordAnchor(anchor),
-    _uiaData(uiaData)
+    _uiaData(uiaData),
+    _regex(s_CreateRegex(str, sensitivity, mode))
 {
     _coordNext = _coordAnchor;
 }
@@ -69,6 +79,11 @@ Search::Search(IUiaData& uiaData,
 // - NOTE: You can FindNext() again after False to go around the buffer again.
 bool Search::FindNext()
 {
+    if (_regex.has_value())
+    {
+        return _FindNextMatch();
+    }
+
     if (_reachedEnd)
     {
         _reachedEnd = false;
@@ -124,6 +139,126 @@ std::pair<COORD, COORD> Search::GetFoundLocation() const noexcept
     return { _coordSelStart, _coordSelEnd };
 }
 
+// Routine Description:
+// - Finds every match of the search term in the buffer, up to its end position.
+// - The rows are scanned in bulk, as one string, instead of comparing the needle at every cell.
+// - The matches are kept, so that a regex FindNext can step through them and
+//   UpdateMatches can bring them up to date later on without scanning the whole buffer again.
+// Return Value:
+// - The start and end of every match, ordered by start. Overlapping matches are all included.
+const std::vector<std::pair<COORD, COORD>>& Search::FindAll()
+{
+    _matches.clear();
+    _indexedFirstRow = _uiaData.GetTextBuffer().GetFirstRowIndex();
+    _Index(0);
+    return _matches;
+}
+
+// Routine Description:
+// - Brings the matches found by FindAll up to date with the output written since.
+// - Output goes into the active area at the bottom of the text and the viewport,
+//   everything above that is history. Only those rows are scanned again. If the
+//   buffer has circled in the meantime, the matches move up with their rows, and
+//   so does the match last found by FindNext.
+// - If no index has been built yet, this is the same as FindAll.
+// Return Value:
+// - The start and end of every match, ordered by start.
+const std::vector<std::pair<COORD, COORD>>& Search::UpdateMatches()
+{
+    if (_indexedEndRow < 0)
+    {
+        return FindAll();
+    }
+
+    const auto& textBuffer = _uiaData.GetTextBuffer();
+    const auto bufferSize = textBuffer.GetSize();
+    const auto endRow = _uiaData.GetTextBufferEndPosition().Y;
+    const auto viewport = _uiaData.GetViewport();
+
+    // Rows that scrolled off the top took their matches with them.
+    const auto circled = gsl::narrow_cast<SHORT>((textBuffer.GetFirstRowIndex() - _indexedFirstRow + bufferSize.Height()) % bufferSize.Height());
+    if (circled > 0)
+    {
+        _matches.erase(std::remove_if(_matches.begin(), _matches.end(), [=](const auto& match) { return match.first.Y < circled; }), _matches.end());
+        for (auto& [start, end] : _matches)
+        {
+            start.Y -= circled;
+            end.Y -= circled;
+        }
+        _coordSelStart.Y -= circled;
+        _coordSelEnd.Y -= circled;
+        _coordNext.Y = std::max(gsl::narrow_cast<SHORT>(_coordNext.Y - circled), SHORT{ 0 });
+        _indexedFirstRow = textBuffer.GetFirstRowIndex();
+    }
+
+    // A match can reach from rows that are left alone into the ones scanned again.
+    // A regex match can't, it's within a line, and lines are scanned again as a whole.
+    const auto neededRows = _regex.has_value() ? 0 : gsl::narrow_cast<SHORT>((_needle.size() + bufferSize.Width() - 1) / bufferSize.Width());
+    auto top = _indexedEndRow - circled - neededRows;
+    top = std::min(top, viewport.Top() - neededRows);
+    top = std::min(top, endRow - viewport.Height() + 1 - neededRows);
+    top = std::max(top, 0);
+    while (_regex.has_value() && top > 0 && textBuffer.GetRowByOffset(top - 1).GetCharRow().WasWrapForced())
+    {
+        --top;
+    }
+
+    _matches.erase(std::find_if(_matches.begin(), _matches.end(), [=](const auto& match) { return match.first.Y >= top; }), _matches.end());
+    _Index(gsl::narrow_cast<SHORT>(top));
+
+    // A regex FindNext carries on from the match it found last, wherever that is now.
+    if (_matchIndex.has_value())
+    {
+        _matchIndex = GetFoundIndex();
+        _matchesVisited = std::min(_matchesVisited, _matches.size());
+    }
+    return _matches;
+}
+
+// Routine Description:
+// - Finds the position of the match last found by FindNext among all matches.
+// - Together with the number of matches this gives "N of M" for a search box.
+//   Only meaningful once FindNext has returned true.
+// Return Value:
+// - The index into the matches of FindAll/UpdateMatches, if the match is one of them.
+std::optional<size_t> Search::GetFoundIndex() const
+{
+    const auto bufferSize = _uiaData.GetTextBuffer().GetSize();
+    const auto it = std::lower_bound(_matches.begin(), _matches.end(), _coordSelStart, [&](const auto& match, const COORD pos) {
+        return bufferSize.CompareInBounds(match.first, pos) < 0;
+    });
+    if (it == _matches.end() || it->first != _coordSelStart || it->second != _coordSelEnd)
+    {
+        return std::nullopt;
+    }
+    return gsl::narrow_cast<size_t>(std::distance(_matches.begin(), it));
+}
+
+// Routine Description:
+// - Sets a flag that stops a search early once it's raised, for example
+//   because the search term changed while a search was running on another thread.
+// - A cancelled search finds nothing more.
+// Arguments:
+// - cancelled - the flag. It has to outlive the search.
+void Search::SetCancellation(const std::atomic<bool>* cancelled) noexcept
+{
+    _cancelled = cancelled;
+}
+
+// Routine Description:
+// - Sets a function that is called between blocks of rows while the buffer is scanned,
+//   for example to let go of the lock on the buffer for a moment, so that a long search
+//   doesn't hold up output and rendering.
+// - Rows can scroll while the lock is released, so matches found before may have moved
+//   by the time the search is done. If the buffer is resized or replaced meanwhile,
+//   the search stops like a cancelled one.
+// Arguments:
+// - yield - the function
+void Search::SetYield(std::function<void()> yield) noexcept
+{
+    _yield = std::move(yield);
+}
+
 // Routine Description:
 // - Finds the anchor position where we will start searches from.
 // - This position will represent the "wrap around" point in the buffer or where
@@ -212,6 +347,290 @@ bool Search::_FindNeedleInHaystackAt(const COORD pos, COORD& start, COORD& end)
     return true;
 }
 
+// Routine Description:
+// - Scans the rows from top to the end position of the buffer for the needle and appends
+//   every match starting in them to the index.
+// - The text of the rows is laid out in one string, cell after cell, the way the needle is.
+//   A substring search finds the candidates, which then have to line up with whole cells.
+//   This is done for a block of rows at a time, so a large buffer isn't copied as a whole.
+// Arguments:
+// - top - the first row to scan
+void Search::_IndexRows(const SHORT top)
+{
+    const auto& textBuffer = _uiaData.GetTextBuffer();
+    const auto width = gsl::narrow_cast<size_t>(textBuffer.GetSize().Width());
+    const auto endPosition = _uiaData.GetTextBufferEndPosition();
+    _indexedEndRow = endPosition.Y;
+
+    if (_needle.empty() || top > endPosition.Y)
+    {
+        return;
+    }
+
+    std::wstring needle;
+    for (const auto& cell : _needle)
+    {
+        std::transform(cell.begin(), cell.end(), std::back_inserter(needle), [this](const wchar_t wch) { return _ApplySensitivity(wch); });
+    }
+    const std::boyer_moore_horspool_searcher searcher{ needle.begin(), needle.end() };
+
+    // Matches may not start past the end position, like with FindNext.
+    const auto lastStart = gsl::narrow_cast<size_t>(endPosition.Y - top) * width + endPosition.X;
+
+    // Each block also holds the rows a match starting in its last row can reach into.
+    const auto overlap = (_needle.size() + width - 1) / width;
+    const auto rows = gsl::narrow_cast<size_t>(endPosition.Y - top + 1);
+
+    // haystack holds the text of the cells, cellStarts the offset of each cell within it.
+    std::wstring haystack;
+    std::vector<size_t> cellStarts;
+    for (size_t blockTop = 0; blockTop < rows && !_IsCancelled(); blockTop += RowsPerBlock)
+    {
+        if (blockTop != 0 && !_Yield(textBuffer))
+        {
+            break;
+        }
+
+        const auto blockRows = std::min(rows - blockTop, RowsPerBlock + overlap);
+        haystack.clear();
+        cellStarts.clear();
+        for (size_t y = blockTop; y < blockTop + blockRows; ++y)
+        {
+            const auto& charRow = textBuffer.GetRowByOffset(top + y).GetCharRow();
+            for (size_t x = 0; x < width; ++x)
+            {
+                cellStarts.push_back(haystack.size());
+                const std::wstring_view glyph = charRow.GlyphAt(x);
+                std::transform(glyph.begin(), glyph.end(), std::back_inserter(haystack), [this](const wchar_t wch) { return _ApplySensitivity(wch); });
+            }
+        }
+        cellStarts.push_back(haystack.size());
+
+        const auto firstCell = blockTop * width;
+        const auto cellLimit = std::min(lastStart + 1, firstCell + RowsPerBlock * width);
+        const auto toCoord = [&](const size_t cell) {
+            return COORD{ gsl::narrow_cast<SHORT>(cell % width), gsl::narrow_cast<SHORT>(top + cell / width) };
+        };
+
+        auto it = haystack.cbegin();
+        while ((it = std::search(it, haystack.cend(), searcher)) != haystack.cend())
+        {
+            const auto offset = gsl::narrow_cast<size_t>(it - haystack.cbegin());
+            const auto cell = gsl::narrow_cast<size_t>(std::lower_bound(cellStarts.begin(), cellStarts.end(), offset) - cellStarts.begin());
+
+            // Matches starting in the overlap are left to the next block.
+            if (firstCell + cell >= cellLimit)
+            {
+                break;
+            }
+
+            // The candidate has to begin at a cell and cover the same cells as the needle.
+            // Their text is already known to be equal, so comparing the lengths is enough.
+            auto matches = cellStarts.at(cell) == offset && cell + _needle.size() < cellStarts.size();
+            for (size_t i = 0; matches && i < _needle.size(); ++i)
+            {
+                matches = cellStarts.at(cell + i + 1) - cellStarts.at(cell + i) == _needle.at(i).size();
+            }
+
+            if (matches)
+            {
+                _matches.emplace_back(toCoord(firstCell + cell), toCoord(firstCell + cell + _needle.size() - 1));
+            }
+            ++it;
+        }
+    }
+}
+
+// Routine Description:
+// - Scans the lines from top to the end position of the buffer with the regex and appends
+//   every match starting in them to the index.
+// - A line is a row along with the rows it wrapped onto, so a match can span the wrap.
+//   The padding cell in front of a wide glyph that didn't fit is skipped, as are the
+//   empty cells at the end of the line.
+// - Matches don't overlap, and empty ones are skipped since there's nothing to select.
+// Arguments:
+// - top - the first row to scan. It has to start a line.
+void Search::_IndexLines(const SHORT top)
+{
+    const auto& textBuffer = _uiaData.GetTextBuffer();
+    const auto width = gsl::narrow_cast<size_t>(textBuffer.GetSize().Width());
+    const auto endPosition = _uiaData.GetTextBufferEndPosition();
+    _indexedEndRow = endPosition.Y;
+
+    // line holds the text, cells the first and last cell of the glyph each character belongs to.
+    std::wstring line;
+    std::vector<std::pair<COORD, COORD>> cells;
+    auto y = top;
+    auto yieldedAt = top;
+    while (y <= endPosition.Y && !_IsCancelled())
+    {
+        if (gsl::narrow_cast<size_t>(y - yieldedAt) >= RowsPerBlock)
+        {
+            if (!_Yield(textBuffer))
+            {
+                break;
+            }
+            yieldedAt = y;
+        }
+
+        line.clear();
+        cells.clear();
+        for (auto wrapped = true; wrapped && y <= endPosition.Y; ++y)
+        {
+            const auto& charRow = textBuffer.GetRowByOffset(y).GetCharRow();
+            wrapped = charRow.WasWrapForced();
+            const auto right = wrapped ? width - (charRow.WasDoubleBytePadded() ? 1 : 0) : charRow.MeasureRight();
+            for (size_t x = 0; x < right; ++x)
+            {
+                const auto& dbcsAttr = charRow.DbcsAttrAt(x);
+                if (dbcsAttr.IsTrailing())
+                {
+                    continue;
+                }
+
+                const COORD first{ gsl::narrow_cast<SHORT>(x), y };
+                const COORD last{ gsl::narrow_cast<SHORT>(dbcsAttr.IsLeading() ? std::min(x + 1, width - 1) : x), y };
+                const std::wstring_view glyph = charRow.GlyphAt(x);
+                line.append(glyph);
+                cells.insert(cells.end(), glyph.size(), { first, last });
+            }
+        }
+
+        for (size_t from = 0; from < line.size();)
+        {
+            const auto match = _regex->Find(line, from);
+            if (!match.has_value())
+            {
+                break;
+            }
+
+            const auto [start, end] = *match;
+            if (start == end)
+            {
+                from = end + 1;
+                continue;
+            }
+
+            // Matches may not start past the end position, like with FindNext.
+            const auto matchStart = cells.at(start).first;
+            if (matchStart.Y == endPosition.Y && matchStart.X > endPosition.X)
+            {
+                break;
+            }
+
+            _matches.emplace_back(matchStart, cells.at(end - 1).second);
+            from = end;
+        }
+    }
+
+    // An index that was cut short would be wrong to update later on. It's built again next time.
+    if (_IsCancelled())
+    {
+        _indexedEndRow = -1;
+    }
+}
+
+// Routine Description:
+// - Scans the buffer from the given row on, for the search term or with the regex.
+// Arguments:
+// - top - the first row to scan
+void Search::_Index(const SHORT top)
+{
+    if (_regex.has_value())
+    {
+        _IndexLines(top);
+    }
+    else
+    {
+        _IndexRows(top);
+    }
+}
+
+// Routine Description:
+// - Locates the next regex match, going through the matches of FindAll.
+// - Behaves like FindNext does for the plain search term: the first match is the one
+//   at or after the anchor (at or before when searching backward), then it goes around
+//   the buffer, and after all of the matches were found once it returns false once.
+// Return Value:
+// - True if we found another match. False if there are none, or we went around the buffer.
+bool Search::_FindNextMatch()
+{
+    if (_indexedEndRow < 0)
+    {
+        FindAll();
+    }
+
+    if (_matches.empty() || _IsCancelled())
+    {
+        return false;
+    }
+
+    if (_matchesVisited == _matches.size())
+    {
+        _matchesVisited = 0;
+        return false;
+    }
+
+    const auto count = _matches.size();
+    if (!_matchIndex.has_value())
+    {
+        const auto bufferSize = _uiaData.GetTextBuffer().GetSize();
+        if (_direction == Direction::Forward)
+        {
+            const auto it = std::lower_bound(_matches.begin(), _matches.end(), _coordAnchor, [&](const auto& match, const COORD pos) {
+                return bufferSize.CompareInBounds(match.first, pos) < 0;
+            });
+            _matchIndex = gsl::narrow_cast<size_t>(std::distance(_matches.begin(), it)) % count;
+        }
+        else
+        {
+            const auto it = std::upper_bound(_matches.begin(), _matches.end(), _coordAnchor, [&](const COORD pos, const auto& match) {
+                return bufferSize.CompareInBounds(pos, match.first) < 0;
+            });
+            _matchIndex = (gsl::narrow_cast<size_t>(std::distance(_matches.begin(), it)) + count - 1) % count;
+        }
+    }
+    else
+    {
+        _matchIndex = (_direction == Direction::Forward ? *_matchIndex + 1 : *_matchIndex + count - 1) % count;
+    }
+
+    ++_matchesVisited;
+    std::tie(_coordSelStart, _coordSelEnd) = _matches.at(*_matchIndex);
+    return true;
+}
+
+// Routine Description:
+// - Checks whether the search was cancelled with the flag given to SetCancellation.
+// Return Value:
+// - True if the search should stop.
+bool Search::_IsCancelled() const noexcept
+{
+    return _interrupted || (_cancelled && _cancelled->load(std::memory_order_relaxed));
+}
+
+// Routine Description:
+// - Calls the function given to SetYield, if any, between two blocks of rows.
+// Arguments:
+// - textBuffer - the buffer that is being scanned
+// Return Value:
+// - True if the scan can go on. False if the buffer was resized or replaced meanwhile,
+//   in which case the search is stopped like a cancelled one.
+bool Search::_Yield(const TextBuffer& textBuffer)
+{
+    if (!_yield)
+    {
+        return true;
+    }
+
+    const auto size = textBuffer.GetSize().Dimensions();
+    _yield();
+
+    const auto& current = _uiaData.GetTextBuffer();
+    _interrupted = &current != &textBuffer || current.GetSize().Dimensions() != size;
+    return !_interrupted;
+}
+
 // Routine Description:
 // - Provides an abstraction for comparing two spans of text.
 // - Internally handles case sensitivity based on object construction.
@@ -336,3 +755,20 @@ std::vector<std::vector<wchar_t>> Search::s_CreateNeedleFromString(const std::ws
     }
     return cells;
 }
+
+// Routine Description:
+// - Compiles the search term into a regex, if it is one.
+// Arguments:
+// - wstr - String that will be our search term
+// - sensitivity - Whether or not you care about case
+// - mode - Whether the search term is the text itself or a regular expression
+// Return Value:
+// - The regex in regex mode, nothing otherwise.
+std::optional<SearchRegex> Search::s_CreateRegex(const std::wstring& wstr, const Sensitivity sensitivity, const Mode mode)
+{
+    if (mode != Mode::Regex)
+    {
+        return std::nullopt;
+    }
+    return SearchRegex{ wstr, sensitivity == Sensitivity::CaseSensitive };
+}
@@ -20,6 +20,7 @@ Revision History:
 #include <WinConTypes.h>
 #include "TextAttribute.hpp"
 #include "textBuffer.hpp"
+#include "SearchRegex.hpp"
 #include "../types/IUiaData.h"
 
 // This used to be in find.h.
@@ -40,16 +41,24 @@ public:
         CaseSensitive
     };
 
+    enum class Mode
+    {
+        Literal,
+        Regex
+    };
+
     Search(Microsoft::Console::Types::IUiaData& uiaData,
            const std::wstring& str,
            const Direction dir,
-           const Sensitivity sensitivity);
+           const Sensitivity sensitivity,
+           const Mode mode = Mode::Literal);
 
     Search(Microsoft::Console::Types::IUiaData& uiaData,
            const std::wstring& str,
            const Direction dir,
            const Sensitivity sensitivity,
-           const COORD anchor);
+           const COORD anchor,
+           const Mode mode = Mode::Literal);
 
     bool FindNext();
     void Select() const;
@@ -57,11 +66,24 @@ public:
 
     std::pair<COORD, COORD> GetFoundLocation() const noexcept;
 
+    const std::vector<std::pair<COORD, COORD>>& FindAll();
+    const std::vector<std::pair<COORD, COORD>>& UpdateMatches();
+    std::optional<size_t> GetFoundIndex() const;
+
+    void SetCancellation(const std::atomic<bool>* cancelled) noexcept;
+    void SetYield(std::function<void()> yield) noexcept;
+
 private:
     wchar_t _ApplySensitivity(const wchar_t wch) const noexcept;
     bool _FindNeedleInHaystackAt(const COORD pos, COORD& start, COORD& end) const;
     bool _CompareChars(const std::wstring_view one, const std::wstring_view two) const noexcept;
     void _UpdateNextPosition();
+    void _IndexRows(const SHORT top);
+    void _IndexLines(const SHORT top);
+    void _Index(const SHORT top);
+    bool _FindNextMatch();
+    bool _IsCancelled() const noexcept;
+    bool _Yield(const TextBuffer& textBuffer);
 
     void _IncrementCoord(COORD& coord) const noexcept;
     void _DecrementCoord(COORD& coord) const noexcept;
@@ -69,6 +91,23 @@ private:
     static COORD s_GetInitialAnchor(Microsoft::Console::Types::IUiaData& uiaData, const Direction dir);
 
     static std::vector<std::vector<wchar_t>> s_CreateNeedleFromString(const std::wstring& wstr);
+    static std::optional<SearchRegex> s_CreateRegex(const std::wstring& wstr, const Sensitivity sensitivity, const Mode mode);
+
+    // Every match in the buffer, ordered by start, once FindAll has been called.
+    std::vector<std::pair<COORD, COORD>> _matches;
+    SHORT _indexedFirstRow = 0;
+    SHORT _indexedEndRow = -1;
+
+    // In regex mode, FindNext steps through the matches instead of the cells.
+    std::optional<size_t> _matchIndex;
+    size_t _matchesVisited = 0;
+
+    const std::atomic<bool>* _cancelled = nullptr;
+    bool _interrupted = false;
+    std::function<void()> _yield;
+
+    // The number of rows scanned between two calls to _yield.
+    static constexpr size_t RowsPerBlock = 256;
 
     bool _reachedEnd = false;
     COORD _coordNext = { 0 };
@@ -79,6 +118,7 @@ private:
     const std::vector<std::vector<wchar_t>> _needle;
     const Direction _direction;
     const Sensitivity _sensitivity;
+    const std::optional<SearchRegex> _regex;
     Microsoft::Console::Types::IUiaData& _uiaData;
 
 #ifdef UNIT_TESTING
@@ -17,6 +17,94 @@ using namespace Microsoft::Console::Types;
 
 using PointTree = interval_tree::IntervalTree<til::point, size_t>;
 
+// Growing _storage moves its rows into a new allocation. Copies of them wouldn't belong to this buffer anymore.
+static_assert(std::is_nothrow_move_constructible_v<ROW>);
+
+// Characters \b in TextBuffer::UrlPattern tells apart from the others: [A-Za-z0-9_].
+// Those are the ones of ECMAScript, whatever the locale is.
+static constexpr bool IsWordChar(const wchar_t ch) noexcept
+{
+    return (ch >= L'A' && ch <= L'Z') || (ch >= L'a' && ch <= L'z') || (ch >= L'0' && ch <= L'9') || ch == L'_';
+}
+
+// Characters a URL may end with: [A-Za-z0-9+&@#/%=~_|$] in TextBuffer::UrlPattern
+static constexpr bool IsUrlEndChar(const wchar_t ch) noexcept
+{
+    return (ch >= L'A' && ch <= L'Z') || (ch >= L'a' && ch <= L'z') || (ch >= L'0' && ch <= L'9') ||
+           ch == L'+' || ch == L'&' || ch == L'@' || ch == L'#' || ch == L'/' || ch == L'%' ||
+           ch == L'=' || ch == L'~' || ch == L'_' || ch == L'|' || ch == L'$';
+}
+
+// Characters that may follow the scheme of a URL: [-A-Za-z0-9+&@#/%?=~_|$!:,.;] in TextBuffer::UrlPattern
+static constexpr bool IsUrlBodyChar(const wchar_t ch) noexcept
+{
+    return IsUrlEndChar(ch) || ch == L'-' || ch == L'?' || ch == L'!' || ch == L':' || ch == L',' || ch == L'.' || ch == L';';
+}
+
+// Routine Description:
+// - Finds the matches of TextBuffer::UrlPattern in text, with the same results as
+//   running the pattern through std::wsregex_iterator but in a single pass.
+// Arguments:
+// - text - the text to search
+// Return Value:
+// - the [start, end) cell offsets of the matches
+static std::vector<std::pair<size_t, size_t>> FindUrls(const std::wstring_view text)
+{
+    static constexpr std::array<std::wstring_view, 4> schemes{ L"https://", L"http://", L"ftp://", L"file://" };
+
+    std::vector<std::pair<size_t, size_t>> matches;
+    size_t position = 0;
+    while (position < text.size())
+    {
+        const auto ch = til::at(text, position);
+
+        // The pattern starts with \b, so the scheme can't follow a word character.
+        if ((ch == L'h' || ch == L'f') && (position == 0 || !IsWordChar(til::at(text, position - 1))))
+        {
+            const auto scheme = std::find_if(schemes.begin(), schemes.end(), [&](const auto& s) {
+                return text.substr(position, s.size()) == s;
+            });
+            if (scheme != schemes.end())
+            {
+                // The body is greedy, but has to end in one of the end characters.
+                size_t matchEnd = 0;
+                for (auto i = position + scheme->size(); i < text.size() && IsUrlBodyChar(til::at(text, i)); ++i)
+                {
+                    if (IsUrlEndChar(til::at(text, i)))
+                    {
+                        matchEnd = i + 1;
+                    }
+                }
+
+                if (matchEnd != 0)
+                {
+                    matches.emplace_back(position, matchEnd);
+                    position = matchEnd;
+                    continue;
+                }
+            }
+        }
+        ++position;
+    }
+
+    // Convert the character offsets into cells.
+    size_t cells = 0;
+    size_t charPos = 0;
+    const auto advanceTo = [&](const size_t target) {
+        for (; charPos < target; ++charPos)
+        {
+            cells += IsGlyphFullWidth(til::at(text, charPos)) ? 2 : 1;
+        }
+        return cells;
+    };
+    for (auto& [start, end] : matches)
+    {
+        start = advanceTo(start);
+        end = advanceTo(end);
+    }
+    return matches;
+}
+
 // Routine Description:
 // - Creates a new instance of TextBuffer
 // Arguments:
@@ -34,17 +122,22 @@ TextBuffer::TextBuffer(const COORD screenBufferSize,
     _firstRow{ 0 },
     _currentAttributes{ defaultAttributes },
     _cursor{ cursorSize, *this },
+    _hyperlinkRefCounts{},
     _storage{},
-    _unicodeStorage{},
     _renderTarget{ renderTarget },
     _size{},
     _currentHyperlinkId{ 1 },
     _currentPatternId{ 0 }
 {
-    // initialize ROWs
-    for (size_t i = 0; i < static_cast<size_t>(screenBufferSize.Y); ++i)
+    // initialize ROWs, all of which share one allocation for their glyph cells
+    const auto rowWidth = gsl::narrow<size_t>(screenBufferSize.X);
+    const auto rowCount = gsl::narrow<size_t>(screenBufferSize.Y);
+    _cells = std::make_unique<CharRow::value_type[]>(rowWidth * rowCount);
+    const gsl::span<CharRow::value_type> cells{ _cells.get(), rowWidth * rowCount };
+    _storage.reserve(rowCount);
+    for (size_t i = 0; i < rowCount; ++i)
     {
-        _storage.emplace_back(static_cast<SHORT>(i), screenBufferSize.X, _currentAttributes, this);
+        _storage.emplace_back(static_cast<SHORT>(i), cells.subspan(i * rowWidth, rowWidth), _currentAttributes, this);
     }
 
     _UpdateSize();
@@ -679,6 +772,16 @@ void TextBuffer::_SetFirstRowIndex(const SHORT FirstRowIndex) noexcept
     _firstRow = FirstRowIndex;
 }
 
+// Routine Description:
+// - Moves the rows [firstRow, firstRow + size) by delta rows. The rows they slide over
+//   wrap around to the other end of the affected region.
+// - Only the rows of that region are touched, however large the rest of the buffer is.
+// Arguments:
+// - firstRow - the offset of the first row to move
+// - size - the number of rows to move
+// - delta - how far to move them. Negative values move them up.
+// Return Value:
+// - <none>
 void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT delta)
 {
     // If we don't have to move anything, leave early.
@@ -687,97 +790,94 @@ void TextBuffer::ScrollRows(const SHORT firstRow, const SHORT size, const SHORT
         return;
     }
 
-    // OK. We're about to play games by moving rows around within the deque to
-    // scroll a massive region in a faster way than copying things.
-    // To make this easier, first correct the circular buffer to have the first row be 0 again.
-    if (_firstRow != 0)
-    {
-        // Rotate the buffer to put the first row at the front.
-        std::rotate(_storage.begin(), _storage.begin() + _firstRow, _storage.end());
-
-        // The first row is now at the top.
-        _firstRow = 0;
-    }
-
-    // Rotate just the subsection specified
-    if (delta < 0)
-    {
-        // The layout is like this:
-        // delta is -2, size is 3, firstRow is 5
-        // We want 3 rows from 5 (5, 6, and 7) to move up 2 spots.
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 3 A. begin + firstRow + delta (because delta is negative)
-        // | 4
-        // | 5 B. begin + firstRow
-        // | 6
-        // | 7
-        // | 8 C. begin + firstRow + size
-        // | 9
-        // | 10
-        // | 11
-        // - end
-        // We want B to slide up to A (the negative delta) and everything from [B,C) to slide up with it.
-        // So the final layout will be
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 5
-        // | 6
-        // | 7
-        // | 3
-        // | 4
-        // | 8
-        // | 9
-        // | 10
-        // | 11
-        // - end
-        std::rotate(_storage.begin() + firstRow + delta, _storage.begin() + firstRow, _storage.begin() + firstRow + size);
+    // The layout is like this:
+    // delta is -2, size is 3, firstRow is 5
+    // We want 3 rows from 5 (5, 6, and 7) to move up 2 spots.
+    // | 3 region top (firstRow + delta, because delta is negative)
+    // | 4
+    // | 5 firstRow
+    // | 6
+    // | 7
+    // | 8 region end (firstRow + size)
+    // So the final layout will be 5, 6, 7, 3, 4. That's the region rotated left by -delta.
+    // If delta is 2 instead, the region is [firstRow, firstRow + size + delta)
+    // and the final layout 8, 9, 5, 6, 7. That's the region rotated left by size.
+    const auto regionTop = gsl::narrow<size_t>(delta < 0 ? firstRow + delta : firstRow);
+    const auto regionSize = gsl::narrow<size_t>(size + std::abs(delta));
+    const auto shift = gsl::narrow<size_t>(delta < 0 ? -delta : size);
+
+    // The region can wrap around the end of the circular buffer, so all indices go through this.
+    const size_t total = _storage.size();
+    THROW_HR_IF(E_INVALIDARG, regionTop + regionSize > total);
+    const auto physical = [&](const size_t index) {
+        return (_firstRow + regionTop + index) % total;
+    };
+
+    // Rotate by reversing the two parts and then the whole region.
+    // Swapping rows only exchanges a few pointers per row.
+    const auto reverse = [&](size_t lo, size_t hi) {
+        while (lo + 1 < hi)
+        {
+            --hi;
+            std::swap(_storage.at(physical(lo)), _storage.at(physical(hi)));
+            ++lo;
+        }
+    };
+    reverse(0, shift);
+    reverse(shift, regionSize);
+    reverse(0, regionSize);
+
+    // The char rows still point at the row object they were swapped out of.
+    for (size_t i = 0; i < regionSize; ++i)
+    {
+        auto& row = _storage.at(physical(i));
+        row.GetCharRow().UpdateParent(&row);
     }
-    else
+}
+
+// Routine Description:
+// - Copies a rectangle of cells to another position in the buffer. The two may overlap.
+// - Works one row at a time with ROW::CopyCells, instead of one cell at a time.
+//   Parts of the rectangle that would land outside of the buffer are dropped.
+// Arguments:
+// - source - the rectangle to copy
+// - targetOrigin - the top left position to copy it to
+// Return Value:
+// - <none>
+void TextBuffer::CopyRectangle(const Viewport& source, const COORD targetOrigin)
+{
+    const auto bufferSize = GetSize();
+    const COORD delta{ gsl::narrow<SHORT>(targetOrigin.X - source.Left()), gsl::narrow<SHORT>(targetOrigin.Y - source.Top()) };
+
+    // Clip the target to the buffer, then the source to what is left of the target.
+    const auto clippedSource = Viewport::Intersect(source, bufferSize);
+    if (!clippedSource.IsValid())
+    {
+        return;
+    }
+    const auto target = Viewport::Intersect(Viewport::Offset(clippedSource, delta), bufferSize);
+    if (!target.IsValid())
+    {
+        return;
+    }
+    const auto sourceLeft = gsl::narrow<size_t>(target.Left() - delta.X);
+    const auto sourceTop = target.Top() - delta.Y;
+
+    const auto targetLeft = gsl::narrow<size_t>(target.Left());
+    const auto width = gsl::narrow<size_t>(target.Width());
+
+    // When moving down, start at the bottom so no source row is overwritten before it's copied.
+    // Like writing the cells one by one with Write, filling the last column of a row marks it as wrapped.
+    const auto height = target.Height();
+    for (SHORT i = 0; i < height; ++i)
     {
-        // The layout is like this:
-        // delta is 2, size is 3, firstRow is 5
-        // We want 3 rows from 5 (5, 6, and 7) to move down 2 spots.
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 3
-        // | 4
-        // | 5 A. begin + firstRow
-        // | 6
-        // | 7
-        // | 8 B. begin + firstRow + size
-        // | 9
-        // | 10 C. begin + firstRow + size + delta
-        // | 11
-        // - end
-        // We want B-1 to slide down to C-1 (the positive delta) and everything from [A, B) to slide down with it.
-        // So the final layout will be
-        // --- (storage) ----
-        // | 0 begin
-        // | 1
-        // | 2
-        // | 3
-        // | 4
-        // | 8
-        // | 9
-        // | 5
-        // | 6
-        // | 7
-        // | 10
-        // | 11
-        // - end
-        std::rotate(_storage.begin() + firstRow, _storage.begin() + firstRow + size, _storage.begin() + firstRow + size + delta);
-    }
-
-    // Renumber the IDs now that we've rearranged where the rows sit within the buffer.
-    // Refreshing should also delegate to the UnicodeStorage to re-key all the stored unicode sequences (where applicable).
-    _RefreshRowIDs(std::nullopt);
+        const auto offset = delta.Y > 0 ? height - 1 - i : i;
+        const auto& sourceRow = GetRowByOffset(gsl::narrow<size_t>(sourceTop + offset));
+        auto& targetRow = GetRowByOffset(gsl::narrow<size_t>(target.Top() + offset));
+        targetRow.CopyCells(sourceRow, sourceLeft, targetLeft, width, true);
+    }
+
+    _NotifyPaint(target);
 }
 
 Cursor& TextBuffer::GetCursor() noexcept
@@ -837,32 +937,32 @@ void TextBuffer::Reset()
         const SHORT TopRowIndex = (GetFirstRowIndex() + TopRow) % currentSize.Y;
 
         // rotate rows until the top row is at index 0
-        const ROW& newTopRow = _storage.at(TopRowIndex);
-        while (&newTopRow != &_storage.front())
-        {
-            _storage.push_back(std::move(_storage.front()));
-            _storage.pop_front();
-        }
+        std::rotate(_storage.begin(), _storage.begin() + TopRowIndex, _storage.end());
 
         _SetFirstRowIndex(0);
 
         // realloc in the Y direction
         // remove rows if we're shrinking
-        while (_storage.size() > static_cast<size_t>(newSize.Y))
+        if (_storage.size() > static_cast<size_t>(newSize.Y))
         {
-            _storage.pop_back();
+            _storage.erase(_storage.begin() + newSize.Y, _storage.end());
         }
-        // add rows if we're growing
+        // add rows if we're growing. The rows may move to a new allocation,
+        // their CharRows get pointed at them again below.
+        _storage.reserve(newSize.Y);
         while (_storage.size() < static_cast<size_t>(newSize.Y))
         {
             _storage.emplace_back(static_cast<short>(_storage.size()), newSize.X, attributes, this);
         }
 
         // Now that we've tampered with the row placement, refresh all the row IDs.
-        // Also take advantage of the row ID refresh loop to resize the rows in the X dimension
-        // and cleanup the UnicodeStorage characters that might fall outside the resized buffer.
+        // Also take advantage of the row ID refresh loop to resize the rows in the X dimension.
         _RefreshRowIDs(newSize.X);
 
+        // Rows that were added or grew own their cells now. Put them all back
+        // into a single allocation, which also drops the cells of removed rows.
+        _PackCharRows(newSize.X);
+
         // Update the cached size value
         _UpdateSize();
     }
@@ -871,34 +971,20 @@ void TextBuffer::Reset()
     return S_OK;
 }
 
-const UnicodeStorage& TextBuffer::GetUnicodeStorage() const noexcept
-{
-    return _unicodeStorage;
-}
-
-UnicodeStorage& TextBuffer::GetUnicodeStorage() noexcept
-{
-    return _unicodeStorage;
-}
-
 // Routine Description:
 // - Method to help refresh all the Row IDs after manipulating the row
 //   by shuffling pointers around.
 // - This will also update parent pointers that are stored in depth within the buffer
 //   (e.g. it will update CharRow parents pointing at Rows that might have been moved around)
-// - Optionally takes a new row width if we're resizing to perform a resize operation and cleanup
-//   any high unicode (UnicodeStorage) runs while we're already looping through the rows.
+// - Optionally takes a new row width if we're resizing to perform a resize operation
+//   while we're already looping through the rows.
 // Arguments:
 // - newRowWidth - Optional new value for the row width.
 void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
 {
-    std::unordered_map<SHORT, SHORT> rowMap;
     SHORT i = 0;
     for (auto& it : _storage)
     {
-        // Build a map so we can update Unicode Storage
-        rowMap.emplace(it.GetId(), i);
-
         // Update the IDs
         it.SetId(i++);
 
@@ -912,9 +998,30 @@ void TextBuffer::_RefreshRowIDs(std::optional<SHORT> newRowWidth)
             THROW_IF_FAILED(it.Resize(newRowWidth.value()));
         }
     }
+}
+
+// Routine Description:
+// - Moves the glyph cells of all rows into a new contiguous allocation, in storage order.
+// - Rows can own their cells after being resized or added, this brings them back together.
+// Arguments:
+// - rowWidth - The width of every row in the buffer.
+// Return Value:
+// - <none>
+// Note: will throw if unable to allocate. The rows are left untouched in that case.
+void TextBuffer::_PackCharRows(const size_t rowWidth)
+{
+    const auto cellCount = rowWidth * _storage.size();
+    auto newCells = std::make_unique<CharRow::value_type[]>(cellCount);
+    const gsl::span<CharRow::value_type> cells{ newCells.get(), cellCount };
+
+    size_t offset = 0;
+    for (auto& row : _storage)
+    {
+        row.GetCharRow().MoveToStorage(cells.subspan(offset, rowWidth));
+        offset += rowWidth;
+    }
 
-    // Give the new mapping to Unicode Storage
-    _unicodeStorage.Remap(rowMap, newRowWidth);
+    _cells = std::move(newCells);
 }
 
 void TextBuffer::_NotifyPaint(const Viewport& viewport) const
@@ -933,27 +1040,6 @@ ROW& TextBuffer::_GetFirstRow()
     return GetRowByOffset(0);
 }
 
-// Routine Description:
-// - Retrieves the row that comes before the given row.
-// - Does not wrap around the screen buffer.
-// Arguments:
-// - The current row.
-// Return Value:
-// - reference to the previous row
-// Note:
-// - will throw exception if called with the first row of the text buffer
-ROW& TextBuffer::_GetPrevRowNoWrap(const ROW& Row)
-{
-    int prevRowIndex = Row.GetId() - 1;
-    if (prevRowIndex < 0)
-    {
-        prevRowIndex = TotalRowCount() - 1;
-    }
-
-    THROW_HR_IF(E_FAIL, Row.GetId() == _firstRow);
-    return _storage.at(prevRowIndex);
-}
-
 // Method Description:
 // - Retrieves this buffer's current render target.
 // Arguments:
@@ -1226,40 +1312,12 @@ const COORD TextBuffer::_GetWordEndForSelection(const COORD target, const std::w
 void TextBuffer::_PruneHyperlinks()
 {
     // Check the old first row for hyperlink references
-    // If there are any, search the entire buffer for the same reference
-    // If the buffer does not contain the same reference, we can remove that hyperlink from our map
+    // If no other row of the buffer references the same hyperlink, we can remove it from our map
     // This way, obsolete hyperlink references are cleared from our hyperlink map instead of hanging around
-    // Get all the hyperlink references in the row we're erasing
-    auto firstRowRefs = _storage.at(_firstRow).GetAttrRow().GetHyperlinks();
-    if (!firstRowRefs.empty())
-    {
-        const auto total = TotalRowCount();
-        // Loop through all the rows in the buffer except the first row -
-        // we have found all hyperlink references in the first row and put them in refs,
-        // now we need to search the rest of the buffer (i.e. all the rows except the first)
-        // to see if those references are anywhere else
-        for (size_t i = 1; i != total; ++i)
-        {
-            const auto nextRowRefs = GetRowByOffset(i).GetAttrRow().GetHyperlinks();
-            for (auto id : nextRowRefs)
-            {
-                if (firstRowRefs.find(id) != firstRowRefs.end())
-                {
-                    firstRowRefs.erase(id);
-                }
-            }
-            if (firstRowRefs.empty())
-            {
-                // No more hyperlink references left to search for, terminate early
-                break;
-            }
-        }
-    }
-
-    // Now delete obsolete references from our map
-    for (auto hyperlinkReference : firstRowRefs)
+    // Every row keeps _hyperlinkRefCounts up to date, so this only needs to look at the row we're erasing
+    for (const auto id : _storage.at(_firstRow).GetAttrRow().GetExclusiveHyperlinks())
     {
-        RemoveHyperlinkFromMap(hyperlinkReference);
+        RemoveHyperlinkFromMap(id);
     }
 }
 
@@ -1634,213 +1692,285 @@ const TextBuffer::TextAndColor TextBuffer::GetText(const bool includeCRLF,
 }
 
 // Routine Description:
-// - Generates a CF_HTML compliant structure based on the passed in text and color data
+// - Appends a color to a string the way HTML writes it, as #RRGGBB.
+static void _AppendHtmlColor(std::string& out, const COLORREF color)
+{
+    fmt::format_to(std::back_inserter(out),
+                   "#{:02X}{:02X}{:02X}",
+                   static_cast<int>(GetRValue(color)),
+                   static_cast<int>(GetGValue(color)),
+                   static_cast<int>(GetBValue(color)));
+}
+
+// Routine Description:
+// - Retrieves the text data from the selected region for the clipboard, as plain text and, if asked to,
+//   as a CF_HTML compliant structure and as an RTF document (RTF 1.5 Spec: https://www.biblioscape.com/rtf15_spec.htm).
+// - All of the formats are written in a single pass over the selected rows. The text is appended straight
+//   from each CharRow, and the colors are looked up once per run of attributes of the ATTR_ROW, so the HTML
+//   and RTF only switch styles where the colors actually change and no copy of the cells is ever made.
 // Arguments:
-// - rows - the text and color data we will format & encapsulate
-// - backgroundColor - default background color for characters, also used in padding
-// - fontHeightPoints - the unscaled font height
-// - fontFaceName - the name of the font used
+// - includeCRLF - inject CRLF pairs to the end of each line
+// - trimTrailingWhitespace - remove the trailing whitespace at the end of each line
+// - selectionRects - the rectangular regions from which the data will be extracted from the buffer (i.e.: selection rects)
+// - GetAttributeColors - function used to map TextAttribute to RGB COLORREFs. If null, only the plain text is generated.
+// - formats - the formats to generate besides plain text, and the font and default background color they use
 // Return Value:
-// - string containing the generated HTML
-std::string TextBuffer::GenHTML(const TextAndColor& rows,
-                                const int fontHeightPoints,
-                                const std::wstring_view fontFaceName,
-                                const COLORREF backgroundColor)
-{
-    try
+// - The plain text of the selected region, and its HTML and RTF if they were asked for.
+// Note:
+// - will throw on failure
+TextBuffer::ClipboardData TextBuffer::GetClipboardData(const bool includeCRLF,
+                                                       const bool trimTrailingWhitespace,
+                                                       const std::vector<SMALL_RECT>& selectionRects,
+                                                       std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors,
+                                                       const ClipboardFormats& formats) const
+{
+    ClipboardData data;
+    const bool copyHtml = formats.html && GetAttributeColors != nullptr;
+    const bool copyRtf = formats.rtf && GetAttributeColors != nullptr;
+
+    // preallocate the text to reduce reallocs
+    size_t textSize = 0;
+    for (const auto& rect : selectionRects)
+    {
+        textSize += gsl::narrow_cast<size_t>(std::max(rect.Right - rect.Left + 1, 0)) + 2; // + 2 for \r\n if we munged it
+    }
+    data.text.reserve(textSize);
+
+    // The CF_HTML header holds the byte offsets of the parts of the document. It has
+    // a fixed size, so its place is held with padding until they're known at the end.
+    // Once filled with values, there will be exactly 157 bytes in the clipboard header.
+    constexpr size_t ClipboardHeaderSize = 157;
+    constexpr std::string_view HtmlHeader = "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
+    constexpr std::string_view HtmlFooter = "</BODY></HTML>";
+    if (copyHtml)
+    {
+        data.html.reserve(ClipboardHeaderSize + textSize * 2);
+        data.html.append(ClipboardHeaderSize, ' ');
+        data.html.append(HtmlHeader);
+        data.html.append("<!--StartFragment -->");
+
+        // apply global style in div element
+        // note: MS Word doesn't support padding (in this way at least)
+        data.html.append("<DIV STYLE=\"display:inline-block;white-space:pre;background-color:");
+        _AppendHtmlColor(data.html, formats.backgroundColor);
+        data.html.append(";font-family:'");
+        data.html.append(til::u16u8(formats.fontFaceName));
+        // even with different font, add monospace as fallback
+        fmt::format_to(std::back_inserter(data.html),
+                       "',monospace;font-size:{}pt;padding:{}px;\">",
+                       formats.fontHeightPoints,
+                       4); // todo: customizable padding
+    }
+
+    // The RTF color table has to come before the content, but the colors are only
+    // known once the content is done. The table is kept on the side meanwhile.
+    // The keys of the map are colors, the values their indices in the color table.
+    std::string rtfColorTable;
+    std::unordered_map<COLORREF, size_t> rtfColorMap;
+    const auto rtfColorIndex = [&](const COLORREF color) {
+        // leave 0 for the default color and start from 1.
+        const auto [it, inserted] = rtfColorMap.emplace(color, rtfColorMap.size() + 1);
+        if (inserted)
+        {
+            fmt::format_to(std::back_inserter(rtfColorTable),
+                           "\\red{}\\green{}\\blue{};",
+                           static_cast<int>(GetRValue(color)),
+                           static_cast<int>(GetGValue(color)),
+                           static_cast<int>(GetBValue(color)));
+        }
+        return it->second;
+    };
+    if (copyRtf)
     {
-        std::ostringstream htmlBuilder;
+        data.rtf.reserve(textSize * 2);
+        rtfColorIndex(formats.backgroundColor);
+
+        // \fs specifies font size in half-points i.e. \fs20 results in a font size
+        // of 10 pts. That's why, font size is multiplied by 2 here.
+        fmt::format_to(std::back_inserter(data.rtf),
+                       "\\viewkind4\\uc4\\pard\\slmult1\\f0\\fs{}\\highlight1 ",
+                       2 * formats.fontHeightPoints);
+    }
 
-        // First we have to add some standard
-        // HTML boiler plate required for CF_HTML
-        // as part of the HTML Clipboard format
-        const std::string htmlHeader =
-            "<!DOCTYPE><HTML><HEAD></HEAD><BODY>";
-        htmlBuilder << htmlHeader;
+    std::optional<std::pair<COLORREF, COLORREF>> colors;
+    std::vector<TextAttributeRun> attrRuns;
+    std::string utf8Run;
 
-        htmlBuilder << "<!--StartFragment -->";
+    // for each row in the selection
+    for (size_t i = 0; i < selectionRects.size(); ++i)
+    {
+        const auto& rect = til::at(selectionRects, i);
+        const auto& row = GetRowByOffset(rect.Top);
+        const auto& charRow = row.GetCharRow();
+        const bool forcedWrap = charRow.WasWrapForced();
 
-        // apply global style in div element
+        if (i != 0)
         {
-            htmlBuilder << "<DIV STYLE=\"";
-            htmlBuilder << "display:inline-block;";
-            htmlBuilder << "white-space:pre;";
-
-            htmlBuilder << "background-color:";
-            htmlBuilder << Utils::ColorToHexString(backgroundColor);
-            htmlBuilder << ";";
-
-            htmlBuilder << "font-family:";
-            htmlBuilder << "'";
-            htmlBuilder << ConvertToA(CP_UTF8, fontFaceName);
-            htmlBuilder << "',";
-            // even with different font, add monospace as fallback
-            htmlBuilder << "monospace;";
-
-            htmlBuilder << "font-size:";
-            htmlBuilder << fontHeightPoints;
-            htmlBuilder << "pt;";
-
-            // note: MS Word doesn't support padding (in this way at least)
-            htmlBuilder << "padding:";
-            htmlBuilder << 4; // todo: customizable padding
-            htmlBuilder << "px;";
-
-            htmlBuilder << "\">";
+            // \r and \n have no color attributes and are not HTML friendly,
+            // so the formatted lines are broken with <BR> and \line instead.
+            if (copyHtml)
+            {
+                data.html.append("<BR>");
+            }
+            if (copyRtf)
+            {
+                data.rtf.append("\\line ");
+            }
         }
 
-        // copy text and info color from buffer
-        bool hasWrittenAnyText = false;
-        std::optional<COLORREF> fgColor = std::nullopt;
-        std::optional<COLORREF> bkColor = std::nullopt;
-        for (size_t row = 0; row < rows.text.size(); row++)
-        {
-            size_t startOffset = 0;
+        const auto width = gsl::narrow_cast<ptrdiff_t>(charRow.size());
+        const auto left = gsl::narrow_cast<size_t>(std::clamp<ptrdiff_t>(rect.Left, 0, width));
+        auto right = gsl::narrow_cast<size_t>(std::clamp<ptrdiff_t>(rect.Right + 1, 0, width));
 
-            if (row != 0)
+        // if the row was NOT wrapped, leave out the spaces at the end (aka trim the trailing whitespace)
+        if (trimTrailingWhitespace && !forcedWrap)
+        {
+            while (right > left &&
+                   !charRow.DbcsAttrAt(right - 1).IsTrailing() &&
+                   std::wstring_view{ charRow.GlyphAt(right - 1) } == std::wstring_view{ &UNICODE_SPACE, 1 })
             {
-                htmlBuilder << "<BR>";
+                --right;
             }
+        }
 
-            for (size_t col = 0; col < rows.text.at(row).length(); col++)
+        if (right > left)
+        {
+            row.GetAttrRow().GetRuns(left, right - left, attrRuns);
+            auto column = left;
+            for (const auto& attrRun : attrRuns)
             {
-                const auto writeAccumulatedChars = [&](bool includeCurrent) {
-                    if (col >= startOffset)
+                // copy char data into the string buffer, skipping trailing bytes
+                const auto runEnd = column + attrRun.GetLength();
+                const auto runStart = data.text.size();
+                for (; column < runEnd; ++column)
+                {
+                    if (!charRow.DbcsAttrAt(column).IsTrailing())
                     {
-                        const auto unescapedText = ConvertToA(CP_UTF8, std::wstring_view(rows.text.at(row)).substr(startOffset, col - startOffset + includeCurrent));
-                        for (const auto c : unescapedText)
-                        {
-                            switch (c)
-                            {
-                            case '<':
-                                htmlBuilder << "&lt;";
-                                break;
-                            case '>':
-                                htmlBuilder << "&gt;";
-                                break;
-                            case '&':
-                                htmlBuilder << "&amp;";
-                                break;
-                            default:
-                                htmlBuilder << c;
-                            }
-                        }
-
-                        startOffset = col;
+                        const std::wstring_view glyph{ charRow.GlyphAt(column) };
+                        data.text.append(glyph);
                     }
-                };
-
-                if (rows.text.at(row).at(col) == '\r' || rows.text.at(row).at(col) == '\n')
-                {
-                    // do not include \r nor \n as they don't have color attributes
-                    // and are not HTML friendly. For line break use '<BR>' instead.
-                    writeAccumulatedChars(false);
-                    break;
                 }
 
-                bool colorChanged = false;
-                if (!fgColor.has_value() || rows.FgAttr.at(row).at(col) != fgColor.value())
+                if ((!copyHtml && !copyRtf) || data.text.size() == runStart)
                 {
-                    fgColor = rows.FgAttr.at(row).at(col);
-                    colorChanged = true;
+                    continue;
                 }
 
-                if (!bkColor.has_value() || rows.BkAttr.at(row).at(col) != bkColor.value())
-                {
-                    bkColor = rows.BkAttr.at(row).at(col);
-                    colorChanged = true;
-                }
+                THROW_IF_FAILED(til::u16u8(std::wstring_view{ data.text }.substr(runStart), utf8Run));
+                const auto runColors = GetAttributeColors(attrRun.GetAttributes());
+                const bool colorChanged = !colors.has_value() || colors.value() != runColors;
 
-                if (colorChanged)
+                if (copyHtml)
                 {
-                    writeAccumulatedChars(false);
-
-                    if (hasWrittenAnyText)
+                    if (colorChanged)
                     {
-                        htmlBuilder << "</SPAN>";
+                        if (colors.has_value())
+                        {
+                            data.html.append("</SPAN>");
+                        }
+                        data.html.append("<SPAN STYLE=\"color:");
+                        _AppendHtmlColor(data.html, runColors.first);
+                        data.html.append(";background-color:");
+                        _AppendHtmlColor(data.html, runColors.second);
+                        data.html.append(";\">");
                     }
 
-                    htmlBuilder << "<SPAN STYLE=\"";
-                    htmlBuilder << "color:";
-                    htmlBuilder << Utils::ColorToHexString(fgColor.value());
-                    htmlBuilder << ";";
-                    htmlBuilder << "background-color:";
-                    htmlBuilder << Utils::ColorToHexString(bkColor.value());
-                    htmlBuilder << ";";
-                    htmlBuilder << "\">";
+                    for (const auto c : utf8Run)
+                    {
+                        switch (c)
+                        {
+                        case '<':
+                            data.html.append("&lt;");
+                            break;
+                        case '>':
+                            data.html.append("&gt;");
+                            break;
+                        case '&':
+                            data.html.append("&amp;");
+                            break;
+                        default:
+                            data.html.push_back(c);
+                        }
+                    }
                 }
 
-                hasWrittenAnyText = true;
-
-                // if this is the last character in the row, flush the whole row
-                if (col == rows.text.at(row).length() - 1)
+                if (copyRtf)
                 {
-                    writeAccumulatedChars(true);
+                    if (colorChanged)
+                    {
+                        const auto bkColorIndex = rtfColorIndex(runColors.second);
+                        const auto fgColorIndex = rtfColorIndex(runColors.first);
+                        fmt::format_to(std::back_inserter(data.rtf), "\\highlight{}\\cf{} ", bkColorIndex, fgColorIndex);
+                    }
+
+                    for (const auto c : utf8Run)
+                    {
+                        switch (c)
+                        {
+                        case '\\':
+                        case '{':
+                        case '}':
+                            data.rtf.push_back('\\');
+                            data.rtf.push_back(c);
+                            break;
+                        default:
+                            data.rtf.push_back(c);
+                        }
+                    }
                 }
+
+                colors = runColors;
             }
         }
 
-        if (hasWrittenAnyText)
+        // apply CR/LF to the end of the final string, unless we're the last line.
+        // a.k.a if we're earlier than the bottom, then apply CR/LF.
+        // if the row was NOT wrapped, then we can assume a CR/LF is proper
+        if (includeCRLF && i < selectionRects.size() - 1 && !forcedWrap)
         {
-            // last opened span wasn't closed in loop above, so close it now
-            htmlBuilder << "</SPAN>";
+            data.text.push_back(UNICODE_CARRIAGERETURN);
+            data.text.push_back(UNICODE_LINEFEED);
         }
+    }
 
-        htmlBuilder << "</DIV>";
-
-        htmlBuilder << "<!--EndFragment -->";
-
-        constexpr std::string_view HtmlFooter = "</BODY></HTML>";
-        htmlBuilder << HtmlFooter;
-
-        // once filled with values, there will be exactly 157 bytes in the clipboard header
-        constexpr size_t ClipboardHeaderSize = 157;
+    if (copyHtml)
+    {
+        if (colors.has_value())
+        {
+            // last opened span wasn't closed in loop above, so close it now
+            data.html.append("</SPAN>");
+        }
+        data.html.append("</DIV><!--EndFragment -->");
+        data.html.append(HtmlFooter);
 
         // these values are byte offsets from start of clipboard
         const size_t htmlStartPos = ClipboardHeaderSize;
-        const size_t htmlEndPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlBuilder.tellp());
-        const size_t fragStartPos = ClipboardHeaderSize + gsl::narrow<size_t>(htmlHeader.length());
-        const size_t fragEndPos = htmlEndPos - HtmlFooter.length();
+        const size_t htmlEndPos = data.html.size();
+        const size_t fragStartPos = ClipboardHeaderSize + HtmlHeader.size();
+        const size_t fragEndPos = htmlEndPos - HtmlFooter.size();
 
         // header required by HTML 0.9 format
-        std::ostringstream clipHeaderBuilder;
-        clipHeaderBuilder << "Version:0.9\r\n";
-        clipHeaderBuilder << std::setfill('0');
-        clipHeaderBuilder << "StartHTML:" << std::setw(10) << htmlStartPos << "\r\n";
-        clipHeaderBuilder << "EndHTML:" << std::setw(10) << htmlEndPos << "\r\n";
-        clipHeaderBuilder << "StartFragment:" << std::setw(10) << fragStartPos << "\r\n";
-        clipHeaderBuilder << "EndFragment:" << std::setw(10) << fragEndPos << "\r\n";
-        clipHeaderBuilder << "StartSelection:" << std::setw(10) << fragStartPos << "\r\n";
-        clipHeaderBuilder << "EndSelection:" << std::setw(10) << fragEndPos << "\r\n";
-
-        return clipHeaderBuilder.str() + htmlBuilder.str();
-    }
-    catch (...)
+        const auto clipHeader = fmt::format("Version:0.9\r\n"
+                                            "StartHTML:{:010}\r\n"
+                                            "EndHTML:{:010}\r\n"
+                                            "StartFragment:{:010}\r\n"
+                                            "EndFragment:{:010}\r\n"
+                                            "StartSelection:{:010}\r\n"
+                                            "EndSelection:{:010}\r\n",
+                                            htmlStartPos,
+                                            htmlEndPos,
+                                            fragStartPos,
+                                            fragEndPos,
+                                            fragStartPos,
+                                            fragEndPos);
+        FAIL_FAST_IF(clipHeader.size() != ClipboardHeaderSize);
+        std::copy(clipHeader.cbegin(), clipHeader.cend(), data.html.begin());
+    }
+
+    if (copyRtf)
     {
-        LOG_HR(wil::ResultFromCaughtException());
-        return {};
-    }
-}
-
-// Routine Description:
-// - Generates an RTF document based on the passed in text and color data
-//   RTF 1.5 Spec: https://www.biblioscape.com/rtf15_spec.htm
-// Arguments:
-// - rows - the text and color data we will format & encapsulate
-// - backgroundColor - default background color for characters, also used in padding
-// - fontHeightPoints - the unscaled font height
-// - fontFaceName - the name of the font used
-// - htmlTitle - value used in title tag of html header. Used to name the application
-// Return Value:
-// - string containing the generated RTF
-std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoints, const std::wstring_view fontFaceName, const COLORREF backgroundColor)
-{
-    try
-    {
-        std::ostringstream rtfBuilder;
-
-        // start rtf
-        rtfBuilder << "{";
+        // end rtf
+        data.rtf.push_back('}');
 
         // Standard RTF header.
         // This is similar to the header generated by WordPad.
@@ -1848,163 +1978,15 @@ std::string TextBuffer::GenRTF(const TextAndColor& rows, const int fontHeightPoi
         // \ansicpg1252 - represents the ANSI code page which is used to perform the Unicode to ANSI conversion when writing RTF text
         // \deff0 - specifies that the default font for the document is the one at index 0 in the font table
         // \nouicompat - ?
-        rtfBuilder << "\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat";
-
-        // font table
-        rtfBuilder << "{\\fonttbl{\\f0\\fmodern\\fcharset0 " << ConvertToA(CP_UTF8, fontFaceName) << ";}}";
-
-        // map to keep track of colors:
-        // keys are colors represented by COLORREF
-        // values are indices of the corresponding colors in the color table
-        std::unordered_map<COLORREF, int> colorMap;
-        int nextColorIndex = 1; // leave 0 for the default color and start from 1.
-
-        // RTF color table
-        std::ostringstream colorTableBuilder;
-        colorTableBuilder << "{\\colortbl ;";
-        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(backgroundColor))
-                          << "\\green" << static_cast<int>(GetGValue(backgroundColor))
-                          << "\\blue" << static_cast<int>(GetBValue(backgroundColor))
-                          << ";";
-        colorMap[backgroundColor] = nextColorIndex++;
-
-        // content
-        std::ostringstream contentBuilder;
-        contentBuilder << "\\viewkind4\\uc4";
-
-        // paragraph styles
-        // \fs specifies font size in half-points i.e. \fs20 results in a font size
-        // of 10 pts. That's why, font size is multiplied by 2 here.
-        contentBuilder << "\\pard\\slmult1\\f0\\fs" << std::to_string(2 * fontHeightPoints)
-                       << "\\highlight1"
-                       << " ";
-
-        std::optional<COLORREF> fgColor = std::nullopt;
-        std::optional<COLORREF> bkColor = std::nullopt;
-        for (size_t row = 0; row < rows.text.size(); ++row)
-        {
-            size_t startOffset = 0;
-
-            if (row != 0)
-            {
-                contentBuilder << "\\line "; // new line
-            }
-
-            for (size_t col = 0; col < rows.text.at(row).length(); ++col)
-            {
-                const auto writeAccumulatedChars = [&](bool includeCurrent) {
-                    if (col >= startOffset)
-                    {
-                        const auto unescapedText = ConvertToA(CP_UTF8, std::wstring_view(rows.text.at(row)).substr(startOffset, col - startOffset + includeCurrent));
-                        for (const auto c : unescapedText)
-                        {
-                            switch (c)
-                            {
-                            case '\\':
-                            case '{':
-                            case '}':
-                                contentBuilder << "\\" << c;
-                                break;
-                            default:
-                                contentBuilder << c;
-                            }
-                        }
-
-                        startOffset = col;
-                    }
-                };
-
-                if (rows.text.at(row).at(col) == '\r' || rows.text.at(row).at(col) == '\n')
-                {
-                    // do not include \r nor \n as they don't have color attributes.
-                    // For line break use \line instead.
-                    writeAccumulatedChars(false);
-                    break;
-                }
-
-                bool colorChanged = false;
-                if (!fgColor.has_value() || rows.FgAttr.at(row).at(col) != fgColor.value())
-                {
-                    fgColor = rows.FgAttr.at(row).at(col);
-                    colorChanged = true;
-                }
-
-                if (!bkColor.has_value() || rows.BkAttr.at(row).at(col) != bkColor.value())
-                {
-                    bkColor = rows.BkAttr.at(row).at(col);
-                    colorChanged = true;
-                }
-
-                if (colorChanged)
-                {
-                    writeAccumulatedChars(false);
-
-                    int bkColorIndex = 0;
-                    if (colorMap.find(bkColor.value()) != colorMap.end())
-                    {
-                        // color already exists in the map, just retrieve the index
-                        bkColorIndex = colorMap[bkColor.value()];
-                    }
-                    else
-                    {
-                        // color not present in the map, so add it
-                        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(bkColor.value()))
-                                          << "\\green" << static_cast<int>(GetGValue(bkColor.value()))
-                                          << "\\blue" << static_cast<int>(GetBValue(bkColor.value()))
-                                          << ";";
-                        colorMap[bkColor.value()] = nextColorIndex;
-                        bkColorIndex = nextColorIndex++;
-                    }
-
-                    int fgColorIndex = 0;
-                    if (colorMap.find(fgColor.value()) != colorMap.end())
-                    {
-                        // color already exists in the map, just retrieve the index
-                        fgColorIndex = colorMap[fgColor.value()];
-                    }
-                    else
-                    {
-                        // color not present in the map, so add it
-                        colorTableBuilder << "\\red" << static_cast<int>(GetRValue(fgColor.value()))
-                                          << "\\green" << static_cast<int>(GetGValue(fgColor.value()))
-                                          << "\\blue" << static_cast<int>(GetBValue(fgColor.value()))
-                                          << ";";
-                        colorMap[fgColor.value()] = nextColorIndex;
-                        fgColorIndex = nextColorIndex++;
-                    }
-
-                    contentBuilder << "\\highlight" << bkColorIndex
-                                   << "\\cf" << fgColorIndex
-                                   << " ";
-                }
-
-                // if this is the last character in the row, flush the whole row
-                if (col == rows.text.at(row).length() - 1)
-                {
-                    writeAccumulatedChars(true);
-                }
-            }
-        }
-
-        // end colortbl
-        colorTableBuilder << "}";
-
-        // add color table to the final RTF
-        rtfBuilder << colorTableBuilder.str();
-
-        // add the text content to the final RTF
-        rtfBuilder << contentBuilder.str();
-
-        // end rtf
-        rtfBuilder << "}";
-
-        return rtfBuilder.str();
-    }
-    catch (...)
-    {
-        LOG_HR(wil::ResultFromCaughtException());
-        return {};
+        std::string rtfHeader{ "{\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat{\\fonttbl{\\f0\\fmodern\\fcharset0 " };
+        rtfHeader.append(til::u16u8(formats.fontFaceName));
+        rtfHeader.append(";}}{\\colortbl ;");
+        rtfHeader.append(rtfColorTable);
+        rtfHeader.push_back('}');
+        data.rtf.insert(0, rtfHeader);
     }
+
+    return data;
 }
 
 // Function Description:
@@ -2077,31 +2059,49 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
             }
         }
 
-        // Loop through every character in the current row (up to
-        // the "right" boundary, which is one past the final valid
-        // character)
-        for (short iOldCol = 0; iOldCol < iRight; iOldCol++)
+        // Most rows can be copied over in blocks of cells, as many as fit
+        // into the current row of the new buffer at a time.
+        if (newBuffer._CanReflowBlocksFrom(charRow, iRight))
         {
-            if (iOldCol == cOldCursorPos.X && iOldRow == cOldCursorPos.Y)
+            try
             {
-                cNewCursorPos = newCursor.GetPosition();
-                fFoundCursorPos = true;
+                const auto cursorColumn = iOldRow == cOldCursorPos.Y ? std::optional<short>{ cOldCursorPos.X } : std::nullopt;
+                if (const auto newPos = newBuffer._ReflowBlocksFrom(row, iRight, cursorColumn))
+                {
+                    cNewCursorPos = *newPos;
+                    fFoundCursorPos = true;
+                }
             }
-
-            try
+            CATCH_RETURN();
+        }
+        // Otherwise loop through every character in the current row (up to
+        // the "right" boundary, which is one past the final valid
+        // character)
+        else
+        {
+            for (short iOldCol = 0; iOldCol < iRight; iOldCol++)
             {
-                // TODO: MSFT: 19446208 - this should just use an iterator and the inserter...
-                const auto glyph = row.GetCharRow().GlyphAt(iOldCol);
-                const auto dbcsAttr = row.GetCharRow().DbcsAttrAt(iOldCol);
-                const auto textAttr = row.GetAttrRow().GetAttrByColumn(iOldCol);
+                if (iOldCol == cOldCursorPos.X && iOldRow == cOldCursorPos.Y)
+                {
+                    cNewCursorPos = newCursor.GetPosition();
+                    fFoundCursorPos = true;
+                }
 
-                if (!newBuffer.InsertCharacter(glyph, dbcsAttr, textAttr))
+                try
                 {
-                    hr = E_OUTOFMEMORY;
-                    break;
+                    // TODO: MSFT: 19446208 - this should just use an iterator and the inserter...
+                    const auto glyph = row.GetCharRow().GlyphAt(iOldCol);
+                    const auto dbcsAttr = row.GetCharRow().DbcsAttrAt(iOldCol);
+                    const auto textAttr = row.GetAttrRow().GetAttrByColumn(iOldCol);
+
+                    if (!newBuffer.InsertCharacter(glyph, dbcsAttr, textAttr))
+                    {
+                        hr = E_OUTOFMEMORY;
+                        break;
+                    }
                 }
+                CATCH_RETURN();
             }
-            CATCH_RETURN();
         }
 
         // If we found the old row that the caller was interested in, set the
@@ -2260,6 +2260,118 @@ HRESULT TextBuffer::Reflow(TextBuffer& oldBuffer,
     return hr;
 }
 
+// Routine Description:
+// - Checks whether the cells [0, right) of a row can be reflowed into this buffer
+//   with _ReflowBlocksFrom. That is the case if they don't contain a broken double
+//   byte sequence, which InsertCharacter would have to correct one character at a time.
+// Arguments:
+// - charRow - the row of the old buffer
+// - right - one past the last column that will be copied
+// Return Value:
+// - true if the row can be copied a block at a time
+bool TextBuffer::_CanReflowBlocksFrom(const CharRow& charRow, const short right) const
+{
+    // A double byte sequence never fits into a single column. InsertCharacter pads the row
+    // and splits it anyway, where the blocks would keep padding rows without making progress.
+    if (GetSize().Width() < 2)
+    {
+        return false;
+    }
+
+    // The cell before our cursor is the one the first character is checked against.
+    const auto previous = _GetPreviousFromCursor();
+    if (GetRowByOffset(previous.Y).GetCharRow().DbcsAttrAt(previous.X).IsLeading())
+    {
+        return false;
+    }
+
+    for (short column = 0; column < right; ++column)
+    {
+        const auto dbcsAttr = charRow.DbcsAttrAt(column);
+        if (dbcsAttr.IsLeading() && (column + 1 >= right || !charRow.DbcsAttrAt(column + 1).IsTrailing()))
+        {
+            return false;
+        }
+        if (dbcsAttr.IsTrailing() && (column == 0 || !charRow.DbcsAttrAt(column - 1).IsLeading()))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Routine Description:
+// - Copies the cells [0, right) of a row of another buffer to the cursor position while
+//   reflowing, as many as fit into the cursor's row at a time. The cursor is advanced and
+//   wraps exactly like it would by inserting the cells one at a time with InsertCharacter.
+// - The cells have to pass _CanReflowBlocksFrom first.
+// Arguments:
+// - row - the row of the old buffer
+// - right - one past the last column to copy
+// - cursorColumn - the column of the old buffer's cursor, if it's on this row
+// Return Value:
+// - The position the old cursor's cell was copied to, if it's on this row
+// Note:
+// - will throw on error
+std::optional<COORD> TextBuffer::_ReflowBlocksFrom(const ROW& row, const short right, const std::optional<short> cursorColumn)
+{
+    const auto width = GetSize().Width();
+    std::optional<COORD> newCursorPos;
+
+    short column = 0;
+    while (column < right)
+    {
+        const auto position = GetCursor().GetPosition();
+        auto count = gsl::narrow_cast<short>(std::min(right - column, width - position.X));
+
+        // A leading byte that gets padded out is looked at again on the next row. InsertCharacter
+        // would have found the cursor on the padding, so keep the first position.
+        if (!newCursorPos.has_value() && cursorColumn.has_value() && cursorColumn.value() >= column && cursorColumn.value() < column + count)
+        {
+            newCursorPos = COORD{ gsl::narrow<short>(position.X + cursorColumn.value() - column), position.Y };
+        }
+
+        // A leading byte can't go into the last column. It's padded out and moved onto the next row instead.
+        const auto padded = position.X + count == width && row.GetCharRow().DbcsAttrAt(column + count - 1).IsLeading();
+        if (padded)
+        {
+            --count;
+        }
+
+        ROW& newRow = GetRowByOffset(position.Y);
+        if (count > 0)
+        {
+            newRow.CopyCells(row, column, position.X, count);
+
+            // InsertCharacter colors the rest of the row with each character it inserts.
+            const auto end = position.X + count;
+            if (end < width)
+            {
+                const auto lastAttr = row.GetAttrRow().GetAttrByColumn(column + count - 1);
+                THROW_HR_IF(E_OUTOFMEMORY, !newRow.GetAttrRow().SetAttrToEnd(end, lastAttr));
+            }
+            column += count;
+        }
+
+        if (padded)
+        {
+            newRow.GetCharRow().SetDoubleBytePadded(true);
+        }
+
+        // If the row is full, let IncrementCursor step onto the next one and mark the wrap.
+        if (position.X + count + (padded ? 1 : 0) == width)
+        {
+            GetCursor().SetXPosition(width - 1);
+            THROW_HR_IF(E_OUTOFMEMORY, !IncrementCursor());
+        }
+        else
+        {
+            GetCursor().SetXPosition(position.X + count);
+        }
+    }
+    return newCursorPos;
+}
+
 // Method Description:
 // - Adds or updates a hyperlink in our hyperlink table
 // Arguments:
@@ -2366,9 +2478,29 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
     _currentHyperlinkId = other._currentHyperlinkId;
 }
 
+// Method Description:
+// - Gets the table counting how many attribute runs of this buffer reference each hyperlink ID
+// Return Value:
+// - The reference counts, keyed by hyperlink ID
+HyperlinkRefCounts& TextBuffer::GetHyperlinkRefCounts() noexcept
+{
+    return _hyperlinkRefCounts;
+}
+
+// Method Description:
+// - Gets the memory the attribute runs of this buffer's rows are allocated from
+// Return Value:
+// - The pool of attribute runs. It's not thread safe, just like the rows using it.
+std::pmr::memory_resource* TextBuffer::GetAttrRunResource() noexcept
+{
+    return &_attrRunPool;
+}
+
 // Method Description:
 // - Adds a regex pattern we should search for
 // - The searching does not happen here, we only search when asked to by TerminalCore
+// - The pattern is compiled once, here, and matched with std::wregex. For URLs,
+//   AddUrlPatternRecognizer is much faster.
 // Arguments:
 // - The regex pattern
 // Return value:
@@ -2376,7 +2508,23 @@ void TextBuffer::CopyHyperlinkMaps(const TextBuffer& other)
 const size_t TextBuffer::AddPatternRecognizer(const std::wstring_view regexString)
 {
     ++_currentPatternId;
-    _idsAndPatterns.emplace(std::make_pair(_currentPatternId, regexString));
+    _idsAndPatterns.emplace(_currentPatternId, PatternRecognizer{ std::wregex{ regexString.begin(), regexString.end() }, false });
+    return _currentPatternId;
+}
+
+// Method Description:
+// - Adds UrlPattern as a pattern we should search for.
+// - It finds the same matches as AddPatternRecognizer(UrlPattern) would, but is matched
+//   by a scanner of its own in linear time, and only the lines that changed since the
+//   last search are scanned again.
+// Arguments:
+// - <none>
+// Return value:
+// - An ID that the caller should associate with the URL pattern
+const size_t TextBuffer::AddUrlPatternRecognizer()
+{
+    ++_currentPatternId;
+    _idsAndPatterns.emplace(_currentPatternId, PatternRecognizer{ std::wregex{ UrlPattern.begin(), UrlPattern.end() }, true });
     return _currentPatternId;
 }
 
@@ -2403,23 +2551,29 @@ PointTree TextBuffer::GetPatterns(const size_t firstRow, const size_t lastRow) c
 
     std::wstring concatAll;
     const auto rowSize = GetRowByOffset(0).size();
-    concatAll.reserve(rowSize * (lastRow - firstRow + 1));
-
-    // to deal with text that spans multiple lines, we will first concatenate
-    // all the text into one string and find the patterns in that string
-    for (auto i = firstRow; i <= lastRow; ++i)
-    {
-        auto row = GetRowByOffset(i);
-        concatAll += row.GetCharRow().GetText();
-    }
 
     // for each pattern we know of, iterate through the string
     for (const auto& idAndPattern : _idsAndPatterns)
     {
-        std::wregex regexObj{ idAndPattern.second };
+        if (idAndPattern.second.isUrlPattern)
+        {
+            _FindUrlPatterns(idAndPattern.first, firstRow, lastRow, intervals);
+            continue;
+        }
+
+        // to deal with text that spans multiple lines, we will first concatenate
+        // all the text into one string and find the patterns in that string
+        if (concatAll.empty())
+        {
+            concatAll.reserve(rowSize * (lastRow - firstRow + 1));
+            for (auto i = firstRow; i <= lastRow; ++i)
+            {
+                concatAll += GetRowByOffset(i).GetCharRow().GetText();
+            }
+        }
 
         // search through the run with our regex object
-        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), regexObj);
+        auto words_begin = std::wsregex_iterator(concatAll.begin(), concatAll.end(), idAndPattern.second.regex);
         auto words_end = std::wsregex_iterator();
 
         size_t lenUpToThis = 0;
@@ -2458,3 +2612,82 @@ PointTree TextBuffer::GetPatterns(const size_t firstRow, const size_t lastRow) c
     PointTree result(std::move(intervals));
     return result;
 }
+
+// Method Description:
+// - Finds the matches of UrlPattern within the requested region of the text buffer.
+// - The rows are scanned in lines. A URL can't contain spaces, so it can only
+//   continue onto the next row if a row doesn't end in one, and a line ends at
+//   the first row that does. The matches of every line are cached along with the
+//   revisions of its rows, so only the lines with rows that changed since the last
+//   call get scanned. Scrolling doesn't change any revisions.
+// Arguments:
+// - patternId - The ID to give the matches
+// - firstRow - The first row to search
+// - lastRow - The last row to search
+// - intervals - The vector to append the matches to, relative to firstRow
+void TextBuffer::_FindUrlPatterns(const size_t patternId, const size_t firstRow, const size_t lastRow, PointTree::interval_vector& intervals) const
+{
+    const auto rowSize = GetRowByOffset(0).size();
+
+    // A cached line is only good if none of its rows changed and it ends where it would now.
+    const auto isCurrent = [&](const size_t lineStart, const UrlLine& line) {
+        const auto lineEnd = lineStart + line.revisions.size() - 1;
+        if (lineEnd > lastRow || (line.cutOff && lineEnd != lastRow))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < line.revisions.size(); ++i)
+        {
+            if (GetRowByOffset(lineStart + i).GetRevision() != til::at(line.revisions, i))
+            {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    decltype(_urlMatchCache) cache;
+    std::wstring text;
+    for (auto lineStart = firstRow; lineStart <= lastRow;)
+    {
+        const auto revision = GetRowByOffset(lineStart).GetRevision();
+        auto previous = _urlMatchCache.find(revision);
+        UrlLine line;
+        if (previous != _urlMatchCache.end() && isCurrent(lineStart, previous->second))
+        {
+            line = std::move(previous->second);
+            _urlMatchCache.erase(previous);
+        }
+        else
+        {
+            text.clear();
+            for (auto i = lineStart; i <= lastRow; ++i)
+            {
+                const auto& row = GetRowByOffset(i);
+                text += row.GetCharRow().GetText();
+                line.revisions.push_back(row.GetRevision());
+                if (!text.empty() && text.back() == UNICODE_SPACE)
+                {
+                    break;
+                }
+            }
+            line.cutOff = text.empty() || text.back() != UNICODE_SPACE;
+            line.matches = FindUrls(text);
+        }
+
+        const auto lineOffset = (lineStart - firstRow) * rowSize;
+        for (const auto& [matchStart, matchEnd] : line.matches)
+        {
+            const auto start = lineOffset + matchStart;
+            const auto end = lineOffset + matchEnd;
+            const til::point startCoord{ gsl::narrow<SHORT>(start % rowSize), gsl::narrow<SHORT>(start / rowSize) };
+            const til::point endCoord{ gsl::narrow<SHORT>(end % rowSize), gsl::narrow<SHORT>(end / rowSize) };
+            intervals.push_back(PointTree::interval(startCoord, endCoord, patternId));
+        }
+
+        lineStart += line.revisions.size();
+        cache.emplace(revision, std::move(line));
+    }
+
+    _urlMatchCache = std::move(cache);
+}
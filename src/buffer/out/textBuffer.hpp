@@ -52,7 +52,6 @@ filling in the last row, and updating the screen.
 #include "cursor.h"
 #include "Row.hpp"
 #include "TextAttribute.hpp"
-#include "UnicodeStorage.hpp"
 #include "../types/inc/Viewport.hpp"
 
 #include "../buffer/out/textBufferCellIterator.hpp"
@@ -113,6 +112,7 @@ public:
     const Microsoft::Console::Types::Viewport GetSize() const noexcept;
 
     void ScrollRows(const SHORT firstRow, const SHORT size, const SHORT delta);
+    void CopyRectangle(const Microsoft::Console::Types::Viewport& source, const COORD targetOrigin);
 
     UINT TotalRowCount() const noexcept;
 
@@ -124,9 +124,6 @@ public:
 
     [[nodiscard]] HRESULT ResizeTraditional(const COORD newSize) noexcept;
 
-    const UnicodeStorage& GetUnicodeStorage() const noexcept;
-    UnicodeStorage& GetUnicodeStorage() noexcept;
-
     Microsoft::Console::Render::IRenderTarget& GetRenderTarget() noexcept;
 
     const COORD GetWordStart(const COORD target, const std::wstring_view wordDelimiters, bool accessibilityMode = false) const;
@@ -147,6 +144,8 @@ public:
     void RemoveHyperlinkFromMap(uint16_t id);
     std::wstring GetCustomIdFromId(uint16_t id) const;
     void CopyHyperlinkMaps(const TextBuffer& OtherBuffer);
+    HyperlinkRefCounts& GetHyperlinkRefCounts() noexcept;
+    std::pmr::memory_resource* GetAttrRunResource() noexcept;
 
     class TextAndColor
     {
@@ -161,15 +160,30 @@ public:
                                const std::vector<SMALL_RECT>& textRects,
                                std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors = nullptr) const;
 
-    static std::string GenHTML(const TextAndColor& rows,
-                               const int fontHeightPoints,
-                               const std::wstring_view fontFaceName,
-                               const COLORREF backgroundColor);
+    // The formats GetClipboardData generates besides plain text,
+    // and the font and default background color they're styled with.
+    struct ClipboardFormats
+    {
+        bool html = false;
+        bool rtf = false;
+        int fontHeightPoints = 0;
+        std::wstring_view fontFaceName;
+        COLORREF backgroundColor = 0;
+    };
 
-    static std::string GenRTF(const TextAndColor& rows,
-                              const int fontHeightPoints,
-                              const std::wstring_view fontFaceName,
-                              const COLORREF backgroundColor);
+    class ClipboardData
+    {
+    public:
+        std::wstring text;
+        std::string html;
+        std::string rtf;
+    };
+
+    ClipboardData GetClipboardData(const bool includeCRLF,
+                                   const bool trimTrailingWhitespace,
+                                   const std::vector<SMALL_RECT>& selectionRects,
+                                   std::function<std::pair<COLORREF, COLORREF>(const TextAttribute&)> GetAttributeColors,
+                                   const ClipboardFormats& formats) const;
 
     struct PositionInformation
     {
@@ -182,28 +196,43 @@ public:
                           const std::optional<Microsoft::Console::Types::Viewport> lastCharacterViewport,
                           std::optional<std::reference_wrapper<PositionInformation>> positionInfo);
 
+    // The pattern TerminalCore uses to detect URLs. AddUrlPatternRecognizer matches
+    // it with a linear time scanner instead of std::wregex.
+    static constexpr std::wstring_view UrlPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
+
     const size_t AddPatternRecognizer(const std::wstring_view regexString);
+    const size_t AddUrlPatternRecognizer();
     void CopyPatterns(const TextBuffer& OtherBuffer);
     interval_tree::IntervalTree<til::point, size_t> GetPatterns(const size_t firstRow, const size_t lastRow) const;
 
 private:
     void _UpdateSize();
     Microsoft::Console::Types::Viewport _size;
-    std::deque<ROW> _storage;
+
+    // How many attribute runs reference each hyperlink ID. This is maintained by
+    // the ATTR_ROWs of _storage, so it has to be declared (and outlive) them.
+    HyperlinkRefCounts _hyperlinkRefCounts;
+
+    // The attribute runs of the ATTR_ROWs of _storage are allocated from this pool,
+    // instead of each on its own on the heap. It has to outlive them, too.
+    std::pmr::unsynchronized_pool_resource _attrRunPool;
+
+    // The glyph cells of every row, stored contiguously one row after the other.
+    // Each CharRow in _storage views its own slice of this allocation.
+    std::unique_ptr<CharRow::value_type[]> _cells;
+    std::vector<ROW> _storage;
     Cursor _cursor;
 
     SHORT _firstRow; // indexes top row (not necessarily 0)
 
     TextAttribute _currentAttributes;
 
-    // storage location for glyphs that can't fit into the buffer normally
-    UnicodeStorage _unicodeStorage;
-
     std::unordered_map<uint16_t, std::wstring> _hyperlinkMap;
     std::unordered_map<std::wstring, uint16_t> _hyperlinkCustomIdMap;
     uint16_t _currentHyperlinkId;
 
     void _RefreshRowIDs(std::optional<SHORT> newRowWidth);
+    void _PackCharRows(const size_t rowWidth);
 
     Microsoft::Console::Render::IRenderTarget& _renderTarget;
 
@@ -220,8 +249,11 @@ private:
     bool _PrepareForDoubleByteSequence(const DbcsAttribute dbcsAttribute);
     bool _AssertValidDoubleByteSequence(const DbcsAttribute dbcsAttribute);
 
+    // Reflow support for rows that can be copied a block of cells at a time
+    bool _CanReflowBlocksFrom(const CharRow& charRow, const short right) const;
+    std::optional<COORD> _ReflowBlocksFrom(const ROW& row, const short right, const std::optional<short> cursorColumn);
+
     ROW& _GetFirstRow();
-    ROW& _GetPrevRowNoWrap(const ROW& row);
 
     void _ExpandTextRow(SMALL_RECT& selectionRow) const;
 
@@ -233,9 +265,29 @@ private:
 
     void _PruneHyperlinks();
 
-    std::unordered_map<size_t, std::wstring> _idsAndPatterns;
+    void _FindUrlPatterns(const size_t patternId, const size_t firstRow, const size_t lastRow, interval_tree::IntervalTree<til::point, size_t>::interval_vector& intervals) const;
+
+    struct PatternRecognizer
+    {
+        std::wregex regex;
+        bool isUrlPattern;
+    };
+
+    std::unordered_map<size_t, PatternRecognizer> _idsAndPatterns;
     size_t _currentPatternId;
 
+    // The URL matches (in cells) of a line, along with the revisions of its rows.
+    struct UrlLine
+    {
+        std::vector<uint64_t> revisions;
+        std::vector<std::pair<size_t, size_t>> matches;
+        bool cutOff = false; // the line went on past the last row that was searched
+    };
+
+    // The lines seen by the last call to GetPatterns, keyed by the revision of their first row.
+    // Lines whose rows didn't change since then don't need to be scanned again.
+    mutable std::unordered_map<uint64_t, UrlLine> _urlMatchCache;
+
 #ifdef UNIT_TESTING
     friend class TextBufferTests;
     friend class UiaTextRangeTests;
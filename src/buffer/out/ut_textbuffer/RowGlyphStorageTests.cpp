@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../RowGlyphStorage.hpp"
+#include "../Row.hpp"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+class RowGlyphStorageTests
+{
+    TEST_CLASS(RowGlyphStorageTests);
+
+    TEST_METHOD(CanOverwriteEmoji)
+    {
+        RowGlyphStorage storage;
+        const size_t column = 3;
+        const std::wstring_view newMoon{ L"\xD83C\xDF11" };
+        const std::wstring_view fullMoon{ L"\xD83C\xDF15" };
+
+        // store initial glyph
+        storage.StoreGlyph(column, newMoon);
+
+        // verify it was stored
+        VERIFY_ARE_EQUAL(1u, storage.size());
+        VERIFY_ARE_EQUAL(String(newMoon.data(), 2), String(storage.GetText(column).data(), 2));
+
+        // overwrite it
+        storage.StoreGlyph(column, fullMoon);
+
+        // verify the glyph was overwritten
+        VERIFY_ARE_EQUAL(1u, storage.size());
+        VERIFY_ARE_EQUAL(String(fullMoon.data(), 2), String(storage.GetText(column).data(), 2));
+    }
+
+    TEST_METHOD(KeepsGlyphsSortedByColumn)
+    {
+        RowGlyphStorage storage;
+
+        // Store them out of order, the way a row written right to left would.
+        storage.StoreGlyph(5, L"e\x0301");
+        storage.StoreGlyph(1, L"a\x0300");
+        storage.StoreGlyph(3, L"\xD83D\xDD25");
+
+        VERIFY_ARE_EQUAL(3u, storage.size());
+        for (size_t i = 1; i < storage._glyphs.size(); ++i)
+        {
+            VERIFY_IS_LESS_THAN(storage._glyphs.at(i - 1).column, storage._glyphs.at(i).column);
+        }
+
+        VERIFY_IS_TRUE(storage.GetText(1) == L"a\x0300");
+        VERIFY_IS_TRUE(storage.GetText(3) == L"\xD83D\xDD25");
+        VERIFY_IS_TRUE(storage.GetText(5) == L"e\x0301");
+        VERIFY_THROWS(storage.GetText(2), wil::ResultException);
+    }
+
+    TEST_METHOD(CanStoreGlyphFromItself)
+    {
+        RowGlyphStorage storage;
+        storage.StoreGlyph(4, L"\xD83D\xDD25");
+
+        // Copying a glyph to a column in front of it moves it in the vector.
+        storage.StoreGlyph(2, storage.GetText(4));
+        storage.StoreGlyph(0, storage.GetText(4));
+
+        VERIFY_ARE_EQUAL(3u, storage.size());
+        VERIFY_IS_TRUE(storage.GetText(0) == L"\xD83D\xDD25");
+        VERIFY_IS_TRUE(storage.GetText(2) == L"\xD83D\xDD25");
+    }
+
+    TEST_METHOD(EraseAndTruncate)
+    {
+        RowGlyphStorage storage;
+        for (size_t column = 0; column < 10; column += 2)
+        {
+            storage.StoreGlyph(column, L"\xD83C\xDF11");
+        }
+        VERIFY_ARE_EQUAL(5u, storage.size());
+
+        // Erasing a column without a glyph does nothing.
+        storage.Erase(3);
+        VERIFY_ARE_EQUAL(5u, storage.size());
+
+        storage.Erase(4);
+        VERIFY_ARE_EQUAL(4u, storage.size());
+        VERIFY_THROWS(storage.GetText(4), wil::ResultException);
+
+        // Shrinking the row to 6 columns drops the glyphs of columns 6 and 8.
+        storage.Truncate(6);
+        VERIFY_ARE_EQUAL(2u, storage.size());
+        VERIFY_IS_TRUE(storage.GetText(2) == L"\xD83C\xDF11");
+
+        storage.Clear();
+        VERIFY_ARE_EQUAL(0u, storage.size());
+    }
+
+    TEST_METHOD(CopyCellsDropsOverwrittenGlyphs)
+    {
+        ROW row{ 0, 10, TextAttribute{}, nullptr };
+        row.WriteCells(OutputCellIterator{ L"ab\xD83C\xDF11xyz" }, 0);
+        VERIFY_IS_GREATER_THAN(row.GetCharRow().GetGlyphStorage().size(), 0u);
+
+        // Delete the emoji at column 2 the way DCH does: shift the rest of the row left over it.
+        row.CopyCells(row, 4, 2, 6);
+        row.ClearColumn(8);
+        row.ClearColumn(9);
+
+        VERIFY_ARE_EQUAL(0u, row.GetCharRow().GetGlyphStorage().size());
+        VERIFY_IS_TRUE(row.GetText().substr(0, 5) == L"abxyz");
+    }
+};
@@ -118,8 +118,7 @@ try
             {
                 try
                 {
-                    const auto bufferData = terminal->_terminal->RetrieveSelectedTextFromBuffer(false);
-                    LOG_IF_FAILED(terminal->_CopyTextToSystemClipboard(bufferData, true));
+                    LOG_IF_FAILED(terminal->_CopyTextToSystemClipboard(true));
                     TerminalClearSelection(terminal);
                 }
                 CATCH_LOG();
@@ -636,14 +635,7 @@ const wchar_t* _stdcall TerminalGetSelection(void* terminal)
     const auto bufferData = publicTerminal->_terminal->RetrieveSelectedTextFromBuffer(false);
     publicTerminal->_ClearSelection();
 
-    // convert text: vector<string> --> string
-    std::wstring selectedText;
-    for (const auto& text : bufferData.text)
-    {
-        selectedText += text;
-    }
-
-    auto returnText = wil::make_cotaskmem_string_nothrow(selectedText.c_str());
+    auto returnText = wil::make_cotaskmem_string_nothrow(bufferData.text.c_str());
     return returnText.release();
 }
 
@@ -867,21 +859,26 @@ COORD HwndTerminal::_GetCursorPosition()
 }
 
 // Routine Description:
-// - Copies the text given onto the global system clipboard.
+// - Copies the selected text onto the global system clipboard.
 // Arguments:
-// - rows - Rows of text data to copy
 // - fAlsoCopyFormatting - true if the color and formatting should also be copied, false otherwise
-HRESULT HwndTerminal::_CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows, bool const fAlsoCopyFormatting)
+HRESULT HwndTerminal::_CopyTextToSystemClipboard(bool const fAlsoCopyFormatting)
 try
 {
-    std::wstring finalString;
-
-    // Concatenate strings into one giant string to put onto the clipboard.
-    for (const auto& str : rows.text)
+    TextBuffer::ClipboardFormats formats;
+    if (fAlsoCopyFormatting)
     {
-        finalString += str;
+        const auto& fontData = _actualFont;
+        formats.html = true;
+        formats.rtf = true;
+        formats.fontHeightPoints = fontData.GetUnscaledSize().Y; // this renderer uses points already
+        formats.fontFaceName = fontData.GetFaceName();
+        formats.backgroundColor = _terminal->GetAttributeColors(_terminal->GetDefaultBrushColors()).second;
     }
 
+    const auto bufferData = _terminal->RetrieveSelectedTextFromBuffer(false, formats);
+    const auto& finalString = bufferData.text;
+
     // allocate the final clipboard data
     const size_t cchNeeded = finalString.size() + 1;
     const size_t cbNeeded = sizeof(wchar_t) * cchNeeded;
@@ -910,15 +907,8 @@ try
 
         if (fAlsoCopyFormatting)
         {
-            const auto& fontData = _actualFont;
-            int const iFontHeightPoints = fontData.GetUnscaledSize().Y; // this renderer uses points already
-            const COLORREF bgColor = _terminal->GetAttributeColors(_terminal->GetDefaultBrushColors()).second;
-
-            std::string HTMLToPlaceOnClip = TextBuffer::GenHTML(rows, iFontHeightPoints, fontData.GetFaceName(), bgColor);
-            _CopyToSystemClipboard(HTMLToPlaceOnClip, L"HTML Format");
-
-            std::string RTFToPlaceOnClip = TextBuffer::GenRTF(rows, iFontHeightPoints, fontData.GetFaceName(), bgColor);
-            _CopyToSystemClipboard(RTFToPlaceOnClip, L"Rich Text Format");
+            _CopyToSystemClipboard(bufferData.html, L"HTML Format");
+            _CopyToSystemClipboard(bufferData.rtf, L"Rich Text Format");
         }
     }
 
@@ -936,7 +926,7 @@ CATCH_RETURN()
 // Arguments:
 // - stringToCopy - The string to copy
 // - lpszFormat - the name of the format
-HRESULT HwndTerminal::_CopyToSystemClipboard(std::string stringToCopy, LPCWSTR lpszFormat)
+HRESULT HwndTerminal::_CopyToSystemClipboard(const std::string& stringToCopy, LPCWSTR lpszFormat)
 {
     const size_t cbData = stringToCopy.size() + 1; // +1 for '\0'
     if (cbData)
@@ -16,6 +16,13 @@
 
 using namespace ::Microsoft::Console;
 
+// The maximum number of bytes the output thread may queue up for the drain
+// thread, before it stops reading from the pseudoconsole. Every connection
+// allocates a queue this size, so it only holds a few frames of busy output.
+static constexpr uint32_t OutputQueueCapacity = 256 * 1024;
+// The maximum number of bytes decoded and delivered to the TerminalOutput handlers at once.
+static constexpr size_t OutputBatchSize = 64 * 1024;
+
 // Notes:
 // There is a number of ways that the Conpty connection can be terminated (voluntarily or not):
 // 1. The connection is Close()d
@@ -204,9 +211,9 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         _startingTitle{ startingTitle },
         _environment{ environment },
         _guid{ initialGuid },
+        _buffer{},
         _u8State{},
-        _u16Str{},
-        _buffer{}
+        _u16Str{}
     {
         if (_guid == guid{})
         {
@@ -219,6 +226,16 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         return _guid;
     }
 
+    // Method Description:
+    // - Returns the number of bytes that were read from the pseudoconsole,
+    //   but haven't been delivered to our TerminalOutput handlers yet.
+    //   If this stays close to the queue capacity, the handlers can't keep up and the
+    //   client application is being throttled.
+    uint64_t ConptyConnection::QueuedOutputBytes() const noexcept
+    {
+        return _queuedOutputBytes.load(std::memory_order_relaxed);
+    }
+
     void ConptyConnection::Start()
     try
     {
@@ -228,6 +245,32 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         _startTime = std::chrono::high_resolution_clock::now();
 
+        {
+            // The threads take these over when they start.
+            auto [producer, consumer] = til::spsc::channel<char>(OutputQueueCapacity);
+            _outputProducer.emplace(std::move(producer));
+            _outputConsumer.emplace(std::move(consumer));
+        }
+
+        // The drain thread delivers the output that the output thread below queues up.
+        // It runs until the output thread has exited and the queue has been emptied.
+        _hOutputDrainThread.reset(CreateThread(
+            nullptr,
+            0,
+            [](LPVOID lpParameter) noexcept {
+                ConptyConnection* const pInstance = static_cast<ConptyConnection*>(lpParameter);
+                if (pInstance)
+                {
+                    return pInstance->_OutputDrainThread();
+                }
+                return gsl::narrow_cast<DWORD>(E_INVALIDARG);
+            },
+            this,
+            0,
+            nullptr));
+
+        THROW_LAST_ERROR_IF_NULL(_hOutputDrainThread);
+
         // Create our own output handling thread
         // This must be done after the pipes are populated.
         // Each connection needs to make sure to drain the output from its backing host.
@@ -274,6 +317,13 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
 
         // Tear down any state we may have accumulated.
         _hPC.reset();
+
+        // If the output thread never started, the producer is still ours.
+        // Without it the drain thread (if any) exits on its own.
+        if (!_hOutputThread)
+        {
+            _outputProducer.reset();
+        }
     }
 
     // Method Description:
@@ -317,6 +367,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         {
             LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(localOutputThreadHandle.get(), INFINITE));
         }
+        _WaitForOutputDrain();
 
         _indicateExitWithStatus(exitCode);
 
@@ -324,6 +375,18 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
     }
     CATCH_LOG()
 
+    // Method Description:
+    // - Waits until the drain thread delivered everything that was queued up.
+    //   It only finishes once the output thread dropped the producer, so the output
+    //   thread must not be running anymore, or be the one calling this after dropping it.
+    void ConptyConnection::_WaitForOutputDrain() noexcept
+    {
+        if (_hOutputDrainThread)
+        {
+            LOG_LAST_ERROR_IF(WAIT_FAILED == WaitForSingleObject(_hOutputDrainThread.get(), INFINITE));
+        }
+    }
+
     void ConptyConnection::WriteInput(hstring const& data)
     {
         if (!_isConnected())
@@ -371,6 +434,10 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 _hOutputThread.reset();
             }
 
+            // Let the drain thread deliver what the output thread left in the queue.
+            _WaitForOutputDrain();
+            _hOutputDrainThread.reset();
+
             if (_piClient.hProcess)
             {
                 // Wait for the client to terminate (which it should do successfully)
@@ -389,6 +456,11 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         // won't wait for us, and the known exit points _do_.
         auto strongThis{ get_strong() };
 
+        // The producer is only ever used by this thread. Once it's dropped,
+        // the drain thread exits after emptying the queue.
+        auto producer{ std::move(_outputProducer) };
+        _outputProducer.reset();
+
         // process the data of the output pipe in a loop
         while (true)
         {
@@ -401,29 +473,17 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 if (lastError != ERROR_BROKEN_PIPE && !_isStateAtOrBeyond(ConnectionState::Closing))
                 {
                     // EXIT POINT
+                    producer.reset();
+                    _WaitForOutputDrain(); // the message must come after all the output we queued up
                     _indicateExitWithStatus(HRESULT_FROM_WIN32(lastError)); // print a message
                     _transitionToState(ConnectionState::Failed);
                     return gsl::narrow_cast<DWORD>(HRESULT_FROM_WIN32(lastError));
                 }
-                // else we call convertUTF8ChunkToUTF16 with an empty string_view to convert possible remaining partials to U+FFFD
-            }
-
-            const HRESULT result{ til::u8u16(std::string_view{ _buffer.data(), read }, _u16Str, _u8State) };
-            if (FAILED(result))
-            {
-                if (_isStateAtOrBeyond(ConnectionState::Closing))
-                {
-                    // This termination was expected.
-                    return 0;
-                }
-
-                // EXIT POINT
-                _indicateExitWithStatus(result); // print a message
-                _transitionToState(ConnectionState::Failed);
-                return gsl::narrow_cast<DWORD>(result);
+                // else the drain thread converts possible remaining partials to U+FFFD once we're gone
+                return 0;
             }
 
-            if (_u16Str.empty())
+            if (read == 0)
             {
                 return 0;
             }
@@ -444,13 +504,82 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
                 _receivedFirstByte = true;
             }
 
-            // Pass the output to our registered event handlers
-            _TerminalOutputHandlers(_u16Str);
+            // Queue the output up for the drain thread, which decodes it and passes it to our registered
+            // event handlers. If the queue is full, the handlers can't keep up with the client application.
+            // We'll then block until there's room again, which in turn stops the pseudoconsole from
+            // accepting more output from the client application (backpressure).
+            _queuedOutputBytes.fetch_add(read, std::memory_order_relaxed);
+            auto [written, alive] = producer->push_n(til::spsc::block_initially, _buffer.data(), read);
+            if (alive && written < read)
+            {
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+                TraceLoggingWrite(g_hTerminalConnectionProvider,
+                                  "OutputBackpressure",
+                                  TraceLoggingDescription("An event emitted when the output queue is full and the connection stops reading from the pseudoconsole"),
+                                  TraceLoggingGuid(_guid, "SessionGuid", "The WT_SESSION's GUID"),
+                                  TraceLoggingUInt64(_queuedOutputBytes.load(std::memory_order_relaxed), "QueuedOutputBytes", "The number of bytes of output waiting to be delivered"),
+                                  TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
+                                  TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
+
+                std::tie(written, alive) = producer->push_n(til::spsc::block_forever, _buffer.data() + written, read - written);
+            }
+            if (!alive)
+            {
+                // The drain thread is gone. There's nobody to deliver our output to.
+                return 0;
+            }
         }
 
         return 0;
     }
 
+    DWORD ConptyConnection::_OutputDrainThread()
+    {
+        // Keep us alive until the drain thread terminates, just like the output thread.
+        auto strongThis{ get_strong() };
+
+        // The consumer is only ever used by this thread and dropped along with it.
+        auto consumer{ std::move(*_outputConsumer) };
+        _outputConsumer.reset();
+
+        _outputBatch.resize(OutputBatchSize);
+
+        while (true)
+        {
+            // Block until there's any output and then take everything that's available
+            // (up to the batch size), so that the handlers get to process it in one go.
+            const auto [read, alive] = consumer.pop_n(til::spsc::block_initially, _outputBatch.data(), _outputBatch.size());
+            _queuedOutputBytes.fetch_sub(read, std::memory_order_relaxed);
+
+            // Once the output thread is gone and the queue is empty, nothing is read. Converting
+            // that empty string turns a partial UTF-8 sequence that was left over into U+FFFD.
+            const HRESULT result{ til::u8u16(std::string_view{ _outputBatch.data(), read }, _u16Str, _u8State) };
+            if (FAILED(result))
+            {
+                if (!_isStateAtOrBeyond(ConnectionState::Closing))
+                {
+                    // EXIT POINT
+                    _indicateExitWithStatus(result); // print a message
+                    _transitionToState(ConnectionState::Failed);
+                }
+                // Dropping the consumer stops the output thread from queuing up any more.
+                return gsl::narrow_cast<DWORD>(result);
+            }
+
+            if (!_u16Str.empty())
+            {
+                // Pass the output to our registered event handlers
+                _TerminalOutputHandlers(_u16Str);
+            }
+
+            if (read == 0)
+            {
+                // The output thread is gone and the queue is empty.
+                return 0;
+            }
+        }
+    }
+
     // Function Description:
     // - This function will be called (by C++/WinRT) after the final outstanding reference to
     //   any given connection instance is released.
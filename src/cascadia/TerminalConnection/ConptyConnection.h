@@ -35,6 +35,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         void Close() noexcept;
 
         winrt::guid Guid() const noexcept;
+        uint64_t QueuedOutputBytes() const noexcept;
 
         WINRT_CALLBACK(TerminalOutput, TerminalOutputHandler);
 
@@ -42,6 +43,7 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         HRESULT _LaunchAttachedClient() noexcept;
         void _indicateExitWithStatus(unsigned int status) noexcept;
         void _ClientTerminated() noexcept;
+        void _WaitForOutputDrain() noexcept;
 
         uint32_t _initialRows{};
         uint32_t _initialCols{};
@@ -58,15 +60,30 @@ namespace winrt::Microsoft::Terminal::TerminalConnection::implementation
         wil::unique_hfile _inPipe; // The pipe for writing input to
         wil::unique_hfile _outPipe; // The pipe for reading output from
         wil::unique_handle _hOutputThread;
+        wil::unique_handle _hOutputDrainThread;
         wil::unique_process_information _piClient;
         wil::unique_static_pseudoconsole_handle _hPC;
         wil::unique_threadpool_wait _clientExitWait;
 
+        std::array<char, 4096> _buffer;
+
+        // The output thread only reads the output pipe and hands the bytes over to the drain
+        // thread through this queue. The drain thread decodes everything that has piled up in
+        // the meantime and delivers it to our TerminalOutput handlers in a single call. That way
+        // the pipe keeps getting drained while the handlers are blocked (for instance by the
+        // renderer holding the terminal lock), until the queue is full and we push back on the
+        // pseudoconsole. Each thread takes its end of the queue over when it starts.
+        std::optional<til::spsc::producer<char>> _outputProducer;
+        std::optional<til::spsc::consumer<char>> _outputConsumer;
+        std::atomic<uint64_t> _queuedOutputBytes{ 0 };
+
+        // These are only used by the drain thread.
+        std::string _outputBatch;
         til::u8state _u8State;
         std::wstring _u16Str;
-        std::array<char, 4096> _buffer;
 
         DWORD _OutputThread();
+        DWORD _OutputDrainThread();
     };
 }
 
@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "SearchBoxControl.h"
+#include <LibraryResources.h>
 #include "SearchBoxControl.g.cpp"
 
 using namespace winrt;
@@ -22,6 +23,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         _focusableElements.insert(TextBox());
         _focusableElements.insert(CloseButton());
         _focusableElements.insert(CaseSensitivityButton());
+        _focusableElements.insert(RegexButton());
         _focusableElements.insert(GoForwardButton());
         _focusableElements.insert(GoBackwardButton());
     }
@@ -50,6 +52,18 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         return CaseSensitivityButton().IsChecked().GetBoolean();
     }
 
+    // Method Description:
+    // - Check if the current search is a regular expression
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - bool: whether the query is a regular expression (regex button is checked)
+    //   or plain text
+    bool SearchBoxControl::_Regex()
+    {
+        return RegexButton().IsChecked().GetBoolean();
+    }
+
     // Method Description:
     // - Handler for pressing Enter on TextBox, trigger
     //   text search
@@ -65,11 +79,11 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
             auto const state = CoreWindow::GetForCurrentThread().GetKeyState(winrt::Windows::System::VirtualKey::Shift);
             if (WI_IsFlagSet(state, CoreVirtualKeyStates::Down))
             {
-                _SearchHandlers(TextBox().Text(), !_GoForward(), _CaseSensitive());
+                _SearchHandlers(TextBox().Text(), !_GoForward(), _CaseSensitive(), _Regex());
             }
             else
             {
-                _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+                _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
             }
             e.Handled(true);
         }
@@ -128,6 +142,45 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         return false;
     }
 
+    // Method Description:
+    // - Shows how many matches the last search found and which of them is selected,
+    //   as in "3 of 12".
+    // Arguments:
+    // - totalMatches: the number of matches in the buffer
+    // - currentMatch: the index of the selected match, or -1 if it isn't known
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::SetStatus(int32_t totalMatches, int32_t currentMatch)
+    {
+        StatusBox().ClearValue(Controls::TextBlock::ForegroundProperty());
+
+        if (totalMatches <= 0)
+        {
+            StatusBox().Text(RS_(L"SearchBox_NoResults"));
+            return;
+        }
+
+        const auto current = currentMatch < 0 ? std::wstring{ L"?" } : std::to_wstring(currentMatch + 1);
+        StatusBox().Text(fmt::format(std::wstring_view{ RS_(L"SearchBox_MatchCounter") }, current, totalMatches));
+    }
+
+    // Method Description:
+    // - Tells the user that the query isn't a valid regular expression, in place of
+    //   the number of matches. The next SetStatus puts the box back to normal.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void SearchBoxControl::SetInvalidQuery()
+    {
+        const auto key = winrt::box_value(L"ErrorTextBrush");
+        if (Resources().HasKey(key))
+        {
+            StatusBox().Foreground(Resources().Lookup(key).try_as<Media::Brush>());
+        }
+        StatusBox().Text(RS_(L"SearchBox_InvalidRegex"));
+    }
+
     // Method Description:
     // - Handler for clicking the GoBackward button. This change the value of _goForward,
     //   mark GoBackward button as checked and ensure GoForward button
@@ -146,7 +199,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
 
         // kick off search
-        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
     }
 
     // Method Description:
@@ -167,7 +220,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
 
         // kick off search
-        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive());
+        _SearchHandlers(TextBox().Text(), _GoForward(), _CaseSensitive(), _Regex());
     }
 
     // Method Description:
@@ -30,6 +30,8 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
 
         void SetFocusOnTextbox();
         bool ContainsFocus();
+        void SetStatus(int32_t totalMatches, int32_t currentMatch);
+        void SetInvalidQuery();
 
         void GoBackwardClicked(winrt::Windows::Foundation::IInspectable const& /*sender*/, winrt::Windows::UI::Xaml::RoutedEventArgs const& /*e*/);
         void GoForwardClicked(winrt::Windows::Foundation::IInspectable const& /*sender*/, winrt::Windows::UI::Xaml::RoutedEventArgs const& /*e*/);
@@ -43,6 +45,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
 
         bool _GoForward();
         bool _CaseSensitive();
+        bool _Regex();
         void _KeyDownHandler(winrt::Windows::Foundation::IInspectable const& sender, winrt::Windows::UI::Xaml::Input::KeyRoutedEventArgs const& e);
         void _CharacterHandler(winrt::Windows::Foundation::IInspectable const& /*sender*/, winrt::Windows::UI::Xaml::Input::CharacterReceivedRoutedEventArgs const& e);
     };
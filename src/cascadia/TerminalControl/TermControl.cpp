@@ -211,13 +211,19 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
     // Method Description:
     // - Search text in text buffer. This is triggered if the user click
     //   search button or press enter.
+    // - The search is kept while the query stays the same, so that going to the next
+    //   match carries on from the matches that were found already, instead of going
+    //   through the whole buffer for every press of enter.
+    // - The search box then shows which of the matches is selected, out of how many,
+    //   or that the text isn't a valid regular expression.
     // Arguments:
     // - text: the text to search
     // - goForward: boolean that represents if the current search direction is forward
     // - caseSensitive: boolean that represents if the current search is case sensitive
+    // - regex: boolean that represents if the text is a regular expression
     // Return Value:
     // - <none>
-    void TermControl::_Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive)
+    void TermControl::_Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive, const bool regex)
     {
         if (text.size() == 0 || _closing)
         {
@@ -232,13 +238,169 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
                                                     Search::Sensitivity::CaseSensitive :
                                                     Search::Sensitivity::CaseInsensitive;
 
-        Search search(*GetUiaData(), text.c_str(), direction, sensitivity);
+        // While a regex search is running, it holds the search. Otherwise it's kept here.
+        // Only the latest search gets to select anything.
+        auto search = std::move(_search);
+        _CancelSearch();
+
         auto lock = _terminal->LockForWriting();
-        if (search.FindNext())
+
+        const std::tuple query{ text, direction, sensitivity, regex };
+        const auto fresh = !search || query != _searchQuery;
+        if (fresh)
+        {
+            try
+            {
+                search = std::make_unique<::Search>(*GetUiaData(), text.c_str(), direction, sensitivity, regex ? Search::Mode::Regex : Search::Mode::Literal);
+            }
+            catch (...)
+            {
+                const auto hr = wil::ResultFromCaughtException();
+                if (hr == E_INVALIDARG && _searchBox)
+                {
+                    _searchBox->SetInvalidQuery();
+                }
+                else
+                {
+                    LOG_HR(hr);
+                }
+                return;
+            }
+            _searchQuery = query;
+        }
+
+        if (regex)
+        {
+            lock.unlock();
+            _SearchRegex(std::move(search), fresh);
+            return;
+        }
+
+        const auto totalMatches = (fresh ? search->FindAll() : search->UpdateMatches()).size();
+        std::optional<size_t> currentMatch;
+        // Having gone around the buffer, FindNext returns false once. It starts over after that.
+        if (search->FindNext() || (totalMatches > 0 && search->FindNext()))
         {
             _terminal->SetBlockSelection(false);
-            search.Select();
+            search->Select();
             _renderer->TriggerSelection();
+            currentMatch = search->GetFoundIndex();
+        }
+        _UpdateSearchStatus(totalMatches, currentMatch);
+        _search = std::move(search);
+    }
+
+    // Method Description:
+    // - Shows the number of matches and the selected one in the search box.
+    // Arguments:
+    // - totalMatches: the number of matches in the buffer
+    // - currentMatch: the index of the selected match among them, if any
+    // Return Value:
+    // - <none>
+    void TermControl::_UpdateSearchStatus(const size_t totalMatches, const std::optional<size_t> currentMatch)
+    {
+        if (_searchBox)
+        {
+            _searchBox->SetStatus(gsl::narrow_cast<int32_t>(totalMatches),
+                                  currentMatch.has_value() ? gsl::narrow_cast<int32_t>(*currentMatch) : -1);
+        }
+    }
+
+    // Method Description:
+    // - Drops the search of the search box and cancels it if it's still running,
+    //   because a new one starts or the matches don't line up with the buffer anymore.
+    // Arguments:
+    // - <none>
+    // Return Value:
+    // - <none>
+    void TermControl::_CancelSearch()
+    {
+        if (_searchCancellation)
+        {
+            _searchCancellation->store(true);
+            _searchCancellation.reset();
+        }
+        _search.reset();
+    }
+
+    // Method Description:
+    // - Searches the text buffer for a regular expression on a background thread,
+    //   then selects the match back on the UI thread.
+    // - A regex has to go through the whole buffer, which can take a moment with a
+    //   long history. The lock is let go between blocks of rows, so that output and
+    //   rendering carry on meanwhile. If the query changes, the search that is still
+    //   running is cancelled, so that only the latest one selects anything.
+    // - The search belongs to this call while it runs. Once it's done, it's handed
+    //   back to be kept for the next one.
+    // Arguments:
+    // - search: the search for the regular expression
+    // - fresh: true if the search hasn't found its matches yet, false if it only
+    //   has to bring them up to date
+    // Return Value:
+    // - <none>
+    winrt::fire_and_forget TermControl::_SearchRegex(std::unique_ptr<::Search> search, const bool fresh)
+    {
+        auto cancellation = std::make_shared<std::atomic<bool>>(false);
+        _searchCancellation = cancellation;
+
+        auto weakThis{ get_weak() };
+        auto dispatcher{ Dispatcher() };
+        co_await winrt::resume_background();
+
+        std::optional<std::pair<COORD, COORD>> found;
+        size_t totalMatches = 0;
+        std::optional<size_t> currentMatch;
+        auto succeeded = false;
+        if (auto control{ weakThis.get() })
+        {
+            try
+            {
+                auto lock = _terminal->LockForWriting();
+                search->SetCancellation(cancellation.get());
+                search->SetYield([&lock]() {
+                    lock.unlock();
+                    std::this_thread::yield();
+                    lock.lock();
+                });
+                // Neither of them outlives this call, the search may.
+                auto detach = wil::scope_exit([&]() noexcept {
+                    search->SetCancellation(nullptr);
+                    search->SetYield(nullptr);
+                });
+
+                totalMatches = (fresh ? search->FindAll() : search->UpdateMatches()).size();
+                if (search->FindNext() || (totalMatches > 0 && search->FindNext()))
+                {
+                    found = search->GetFoundLocation();
+                    currentMatch = search->GetFoundIndex();
+                }
+                succeeded = true;
+            }
+            CATCH_LOG();
+        }
+
+        if (!succeeded || cancellation->load())
+        {
+            co_return;
+        }
+
+        co_await winrt::resume_foreground(dispatcher);
+
+        if (auto control{ weakThis.get() })
+        {
+            if (!_closing && !cancellation->load())
+            {
+                if (found.has_value())
+                {
+                    auto lock = _terminal->LockForWriting();
+                    _terminal->SetBlockSelection(false);
+                    GetUiaData()->SelectNewRegion(found->first, found->second);
+                    _renderer->TriggerSelection();
+                }
+                _UpdateSearchStatus(totalMatches, currentMatch);
+                _search = std::move(search);
+                _searchCancellation.reset();
+            }
         }
     }
 
@@ -253,6 +415,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
     void TermControl::_CloseSearchBoxControl(const winrt::Windows::Foundation::IInspectable& /*sender*/, RoutedEventArgs const& /*args*/)
     {
         _searchBox->Visibility(Visibility::Collapsed);
+        _CancelSearch();
 
         // Set focus back to terminal control
         this->Focus(FocusState::Programmatic);
@@ -648,6 +811,12 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
 
             THROW_IF_FAILED(localPointerToThread->Initialize(_renderer.get()));
 
+            // The DX engine waits for its swap chain before each frame, which
+            // paces them to the vsync of the display. The render thread falls
+            // back to its default frame limit if the swap chain can't do that.
+            localPointerToThread->SetFrameLimit(0);
+            _renderThread = localPointerToThread;
+
             // Set up the DX Engine
             auto dxEngine = std::make_unique<::Microsoft::Console::Render::DxEngine>();
             _renderer->AddRenderEngine(dxEngine.get());
@@ -2250,6 +2419,9 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
 
         _terminal->ClearSelection();
 
+        // The matches of the search box don't line up with the resized buffer.
+        _CancelSearch();
+
         // Tell the dx engine that our window is now the new size.
         THROW_IF_FAILED(_renderEngine->SetWindowSize(size));
 
@@ -2372,34 +2544,17 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         // Mark the current selection as copied
         _selectionNeedsToBeCopied = false;
 
-        // extract text from buffer
-        const auto bufferData = _terminal->RetrieveSelectedTextFromBuffer(singleLine);
-
-        // convert text: vector<string> --> string
-        std::wstring textData;
-        for (const auto& text : bufferData.text)
-        {
-            textData += text;
-        }
-
-        // convert text to HTML format
+        // extract text from buffer, along with its HTML and RTF formats
         // GH#5347 - Don't provide a title for the generated HTML, as many
         // web applications will paste the title first, followed by the HTML
         // content, which is unexpected.
-        const auto htmlData = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::HTML) ?
-                                  TextBuffer::GenHTML(bufferData,
-                                                      _actualFont.GetUnscaledSize().Y,
-                                                      _actualFont.GetFaceName(),
-                                                      _settings.DefaultBackground()) :
-                                  "";
-
-        // convert to RTF format
-        const auto rtfData = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::RTF) ?
-                                 TextBuffer::GenRTF(bufferData,
-                                                    _actualFont.GetUnscaledSize().Y,
-                                                    _actualFont.GetFaceName(),
-                                                    _settings.DefaultBackground()) :
-                                 "";
+        TextBuffer::ClipboardFormats bufferFormats;
+        bufferFormats.html = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::HTML);
+        bufferFormats.rtf = formats == nullptr || WI_IsFlagSet(formats.Value(), CopyFormat::RTF);
+        bufferFormats.fontHeightPoints = _actualFont.GetUnscaledSize().Y;
+        bufferFormats.fontFaceName = _actualFont.GetFaceName();
+        bufferFormats.backgroundColor = _settings.DefaultBackground();
+        const auto bufferData = _terminal->RetrieveSelectedTextFromBuffer(singleLine, bufferFormats);
 
         if (!_settings.CopyOnSelect())
         {
@@ -2408,9 +2563,9 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
 
         // send data up for clipboard
-        auto copyArgs = winrt::make_self<CopyToClipboardEventArgs>(winrt::hstring(textData),
-                                                                   winrt::to_hstring(htmlData),
-                                                                   winrt::to_hstring(rtfData),
+        auto copyArgs = winrt::make_self<CopyToClipboardEventArgs>(winrt::hstring(bufferData.text),
+                                                                   winrt::to_hstring(bufferData.html),
+                                                                   winrt::to_hstring(bufferData.rtf),
                                                                    formats);
         _clipboardCopyHandlers(*this, *copyArgs);
         return true;
@@ -2467,6 +2622,11 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
             // closed. We can just do it whenever.
             _AsyncCloseConnection();
 
+            if (_renderThread)
+            {
+                _TraceFrameStatistics(*std::exchange(_renderThread, nullptr));
+            }
+
             if (auto localRenderEngine{ std::exchange(_renderEngine, nullptr) })
             {
                 if (auto localRenderer{ std::exchange(_renderer, nullptr) })
@@ -2482,6 +2642,29 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         }
     }
 
+    // Method Description:
+    // - Reports how many frames the render thread painted over the lifetime of
+    //   this control, how many paint requests were coalesced into them, and
+    //   how long it took from the first request of a frame to its paint.
+    // Arguments:
+    // - renderThread: the render thread of this control
+    void TermControl::_TraceFrameStatistics(const ::Microsoft::Console::Render::RenderThread& renderThread) noexcept
+    {
+        const auto stats = renderThread.GetFrameStatistics();
+        const auto averageLatency = stats.framesPainted ? stats.totalLatency.count() / gsl::narrow_cast<int64_t>(stats.framesPainted) : 0;
+
+#pragma warning(suppress : 26477 26485 26494 26482 26446) // We don't control TraceLoggingWrite
+        TraceLoggingWrite(g_hTerminalControlProvider,
+                          "RenderFrameStatistics",
+                          TraceLoggingDescription("Event emitted when a control closes, with the counters of the frames it painted"),
+                          TraceLoggingUInt64(stats.framesPainted, "FramesPainted", "The number of frames painted"),
+                          TraceLoggingUInt64(stats.framesSkipped, "FramesSkipped", "The number of paint requests coalesced into a pending frame"),
+                          TraceLoggingInt64(averageLatency, "AverageLatency", "The average time from the first request of a frame to its paint, in microseconds"),
+                          TraceLoggingInt64(stats.maxLatency.count(), "MaxLatency", "The longest time from the first request of a frame to its paint, in microseconds"),
+                          TraceLoggingKeyword(MICROSOFT_KEYWORD_MEASURES),
+                          TelemetryPrivacyDataTag(PDT_ProductAndServicePerformance));
+    }
+
     // Method Description:
     // - Scrolls the viewport of the terminal and updates the scroll bar accordingly
     // Arguments:
@@ -186,6 +186,11 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         bool _initializedTerminal;
 
         winrt::com_ptr<SearchBoxControl> _searchBox;
+        // Raised to cancel the regex search that is still running, when the next one starts.
+        std::shared_ptr<std::atomic<bool>> _searchCancellation;
+        // The search of the search box and the query it's for, kept for going to the next match.
+        std::unique_ptr<::Search> _search;
+        std::tuple<winrt::hstring, Search::Direction, Search::Sensitivity, bool> _searchQuery;
 
         event_token _connectionOutputEventToken;
         TerminalConnection::ITerminalConnection::StateChanged_revoker _connectionStateChangedRevoker;
@@ -193,6 +198,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         std::unique_ptr<::Microsoft::Terminal::Core::Terminal> _terminal;
 
         std::unique_ptr<::Microsoft::Console::Render::Renderer> _renderer;
+        ::Microsoft::Console::Render::RenderThread* _renderThread{ nullptr }; // owned by _renderer
         std::unique_ptr<::Microsoft::Console::Render::DxEngine> _renderEngine;
         std::unique_ptr<::Microsoft::Console::Render::UiaEngine> _uiaEngine;
 
@@ -324,7 +330,10 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         const unsigned int _NumberOfClicks(winrt::Windows::Foundation::Point clickPos, Timestamp clickTime);
         double _GetAutoScrollSpeed(double cursorDistanceFromBorder) const;
 
-        void _Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive);
+        void _Search(const winrt::hstring& text, const bool goForward, const bool caseSensitive, const bool regex);
+        winrt::fire_and_forget _SearchRegex(std::unique_ptr<::Search> search, const bool fresh);
+        void _UpdateSearchStatus(const size_t totalMatches, const std::optional<size_t> currentMatch);
+        void _CancelSearch();
         void _CloseSearchBoxControl(const winrt::Windows::Foundation::IInspectable& sender, Windows::UI::Xaml::RoutedEventArgs const& args);
 
         // TSFInputControl Handlers
@@ -333,6 +342,7 @@ namespace winrt::Microsoft::Terminal::TerminalControl::implementation
         void _FontInfoHandler(const IInspectable& sender, const FontInfoEventArgs& eventArgs);
 
         winrt::fire_and_forget _AsyncCloseConnection();
+        static void _TraceFrameStatistics(const ::Microsoft::Console::Render::RenderThread& renderThread) noexcept;
     };
 }
 
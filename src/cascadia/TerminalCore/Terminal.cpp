@@ -84,8 +84,7 @@ void Terminal::Create(COORD viewportSize, SHORT scrollbackLines, IRenderTarget&
     _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, renderTarget);
     // Add regex pattern recognizers to the buffer
     // For now, we only add the URI regex pattern
-    std::wstring_view linkPattern{ LR"(\b(https?|ftp|file)://[-A-Za-z0-9+&@#/%?=~_|$!:,.;]*[A-Za-z0-9+&@#/%=~_|$])" };
-    _hyperlinkPatternId = _buffer->AddPatternRecognizer(linkPattern);
+    _hyperlinkPatternId = _buffer->AddUrlPatternRecognizer();
 }
 
 // Method Description:
@@ -880,54 +879,43 @@ void Terminal::_WriteBuffer(const std::wstring_view& stringView)
     // We can not waste time displaying a cursor event when we know more text is coming right behind it.
     cursor.StartDeferDrawing();
 
-    for (size_t i = 0; i < stringView.size(); i++)
+    // Build a single iterator over the whole printable run. It takes care of
+    // surrogate pairs and splits wide glyphs into their leading/trailing cells,
+    // so we can hand it to the buffer one row at a time instead of one glyph at a time.
+    OutputCellIterator it{ stringView, _buffer->GetCurrentAttributes() };
+
+    while (it)
     {
-        const auto wch = stringView.at(i);
-        const COORD cursorPosBefore = cursor.GetPosition();
-        COORD proposedCursorPosition = cursorPosBefore;
-
-        // TODO: MSFT 21006766
-        // This is not great but I need it demoable. Fix by making a buffer stream writer.
-        //
-        // If wch is a surrogate character we need to read 2 code units
-        // from the stringView to form a single code point.
-        const auto isSurrogate = wch >= 0xD800 && wch <= 0xDFFF;
-        const auto view = stringView.substr(i, isSurrogate ? 2 : 1);
-        const OutputCellIterator it{ view, _buffer->GetCurrentAttributes() };
-        const auto end = _buffer->Write(it);
+        COORD proposedCursorPosition = cursor.GetPosition();
+
+        // Fill as many cells of the current row as fit. If we write the last
+        // cell of the row here, TextBuffer::WriteLine will mark this line as
+        // wrapped for us. If the next character we process is a newline, the
+        // Terminal::CursorLineFeed will unmark this line as wrapped.
+        const auto end = _buffer->WriteLine(it, proposedCursorPosition, true);
         const auto cellDistance = end.GetCellDistance(it);
-        const auto inputDistance = end.GetInputDistance(it);
+        it = end;
 
-        if (inputDistance > 0)
-        {
-            // If "wch" was a surrogate character, we just consumed 2 code units above.
-            // -> Increment "i" by 1 in that case and thus by 2 in total in this iteration.
-            proposedCursorPosition.X += gsl::narrow<SHORT>(cellDistance);
-            i += inputDistance - 1;
-        }
-        else
+        if (it)
         {
-            // If _WriteBuffer() is called with a consecutive string longer than the viewport/buffer width
-            // the call to _buffer->Write() will refuse to write anything on the current line.
-            // GetInputDistance() thus returns 0, which would in turn cause i to be
-            // decremented by 1 below and force the outer loop to loop forever.
-            // This if() basically behaves as if "\r\n" had been encountered above and retries the write.
-            // With well behaving shells during normal operation this safeguard should normally not be encountered.
-            proposedCursorPosition.X = 0;
-            proposedCursorPosition.Y++;
-
-            // Try the character again.
-            i--;
-
-            // If we write the last cell of the row here, TextBuffer::Write will
-            // mark this line as wrapped for us. If the next character we
-            // process is a newline, the Terminal::CursorLineFeed will unmark
-            // this line as wrapped.
+            // There's still text left over, so the row is full (or the next
+            // glyph is a wide one that didn't fit into the last column).
+            // This also covers the case where the cursor was already sitting
+            // past the last column when we were called: WriteLine refuses to
+            // write anything on the current line then.
+            // Either way behave as if "\r\n" had been encountered and continue
+            // writing on the next line.
 
             // TODO: GH#780 - This should really be a _deferred_ newline. If
             // the next character to come in is a newline or a cursor
             // movement or anything, then we should _not_ wrap this line
             // here.
+            proposedCursorPosition.X = 0;
+            proposedCursorPosition.Y++;
+        }
+        else
+        {
+            proposedCursorPosition.X += gsl::narrow<SHORT>(cellDistance);
         }
 
         _AdjustCursorPosition(proposedCursorPosition);
@@ -165,6 +165,7 @@ public:
     const std::wstring GetHyperlinkUri(uint16_t id) const noexcept override;
     const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
     const std::vector<size_t> GetPatternId(const COORD location) const noexcept override;
+    void GetPatternIdRuns(const SHORT row, std::vector<Microsoft::Console::Render::PatternIdRun>& runs) const noexcept override;
 #pragma endregion
 
 #pragma region IUiaData
@@ -215,7 +216,7 @@ public:
     void SetSelectionEnd(const COORD position, std::optional<SelectionExpansionMode> newExpansionMode = std::nullopt);
     void SetBlockSelection(const bool isEnabled) noexcept;
 
-    const TextBuffer::TextAndColor RetrieveSelectedTextFromBuffer(bool trimTrailingWhitespace) const;
+    TextBuffer::ClipboardData RetrieveSelectedTextFromBuffer(bool trimTrailingWhitespace, const TextBuffer::ClipboardFormats& formats = {}) const;
 #pragma endregion
 
 private:
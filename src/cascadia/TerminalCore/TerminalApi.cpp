@@ -126,22 +126,9 @@ try
         return false;
     }
 
-    // Get a rectangle of the source
-    auto source = Viewport::FromDimensions(copyFromPos, width, 1);
-
-    // Get a rectangle of the target
-    const auto target = Viewport::FromDimensions(copyToPos, source.Dimensions());
-    const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
-
-    auto sourcePos = source.GetWalkOrigin(walkDirection);
-    auto targetPos = target.GetWalkOrigin(walkDirection);
-
-    // Iterate over the source cell data and copy it over to the target
-    do
-    {
-        const auto data = OutputCell(*(_buffer->GetCellDataAt(sourcePos)));
-        _buffer->Write(OutputCellIterator({ &data, 1 }), targetPos);
-    } while (source.WalkInBounds(sourcePos, walkDirection) && target.WalkInBounds(targetPos, walkDirection));
+    // Get a rectangle of the source and move it over in one block
+    const auto source = Viewport::FromDimensions(copyFromPos, width, 1);
+    _buffer->CopyRectangle(source, copyToPos);
 
     return true;
 }
@@ -159,10 +146,6 @@ CATCH_LOG_RETURN_FALSE()
 bool Terminal::InsertCharacter(const size_t count) noexcept
 try
 {
-    // NOTE: the code below is _extremely_ similar to DeleteCharacter
-    // We will want to use this same logic and implement a helper function instead
-    // that does the 'move a region from here to there' operation
-    // TODO: Github issue #2163
     SHORT dist;
     if (!SUCCEEDED(SizeTToShort(count, &dist)))
     {
@@ -178,23 +161,11 @@ try
         return false;
     }
 
-    // Get a rectangle of the source
-    auto source = Viewport::FromDimensions(copyFromPos, width, 1);
-    const auto sourceOrigin = source.Origin();
+    // Get a rectangle of the source and move it over in one block.
+    // Whatever would end up past the right edge of the buffer is dropped.
+    const auto source = Viewport::FromDimensions(copyFromPos, width, 1);
+    _buffer->CopyRectangle(source, copyToPos);
 
-    // Get a rectangle of the target
-    const auto target = Viewport::FromDimensions(copyToPos, source.Dimensions());
-    const auto walkDirection = Viewport::DetermineWalkDirection(source, target);
-
-    auto sourcePos = source.GetWalkOrigin(walkDirection);
-    auto targetPos = target.GetWalkOrigin(walkDirection);
-
-    // Iterate over the source cell data and copy it over to the target
-    do
-    {
-        const auto data = OutputCell(*(_buffer->GetCellDataAt(sourcePos)));
-        _buffer->Write(OutputCellIterator({ &data, 1 }), targetPos);
-    } while (source.WalkInBounds(sourcePos, walkDirection) && target.WalkInBounds(targetPos, walkDirection));
     const auto eraseIter = OutputCellIterator(UNICODE_SPACE, _buffer->GetCurrentAttributes(), dist);
     _buffer->Write(eraseIter, cursorPos);
 
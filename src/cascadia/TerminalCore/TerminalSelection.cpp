@@ -247,18 +247,21 @@ void Terminal::ClearSelection()
 // - get wstring text from highlighted portion of text buffer
 // Arguments:
 // - singleLine: collapse all of the text to one line
+// - formats: the formats to generate besides plain text, if any
 // Return Value:
 // - wstring text from buffer. If extended to multiple lines, each line is separated by \r\n
-const TextBuffer::TextAndColor Terminal::RetrieveSelectedTextFromBuffer(bool singleLine) const
+// - the HTML and RTF of the selection, if they were asked for
+TextBuffer::ClipboardData Terminal::RetrieveSelectedTextFromBuffer(bool singleLine, const TextBuffer::ClipboardFormats& formats) const
 {
     const auto selectionRects = _GetSelectionRects();
 
     const auto GetAttributeColors = std::bind(&Terminal::GetAttributeColors, this, std::placeholders::_1);
 
-    return _buffer->GetText(!singleLine,
-                            !singleLine,
-                            selectionRects,
-                            GetAttributeColors);
+    return _buffer->GetClipboardData(!singleLine,
+                                     !singleLine,
+                                     selectionRects,
+                                     GetAttributeColors,
+                                     formats);
 }
 
 // Method Description:
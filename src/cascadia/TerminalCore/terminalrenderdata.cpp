@@ -159,6 +159,82 @@ const std::vector<size_t> Terminal::GetPatternId(const COORD location) const noe
     return {};
 }
 
+// Method Description:
+// - Gets the regex pattern ids of an entire row of the viewport, as runs of
+//   columns that share the same set of ids. Columns without any pattern are
+//   not covered by a run.
+// - This lets the renderer query the interval tree once per row rather than
+//   once per cell.
+// Arguments:
+// - row: the row of the viewport
+// - runs: receives the runs, sorted by column
+// Return value:
+// - <none>
+void Terminal::GetPatternIdRuns(const SHORT row, std::vector<PatternIdRun>& runs) const noexcept
+try
+{
+    runs.clear();
+
+    const auto width = _buffer->GetSize().Width();
+    const auto intervals = _patternIntervalTree.findOverlapping(COORD{ 1, row }, COORD{ gsl::narrow_cast<SHORT>(width - 1), row });
+    if (intervals.empty())
+    {
+        return;
+    }
+
+    // Clip every interval to this row. The stop of an interval is exclusive.
+    std::vector<std::pair<SHORT, SHORT>> spans;
+    std::vector<SHORT> boundaries;
+    spans.reserve(intervals.size());
+    boundaries.reserve(intervals.size() * 2);
+    for (const auto& interval : intervals)
+    {
+        const SHORT left = interval.start.y() < row ? 0 : interval.start.x<SHORT>();
+        const SHORT right = interval.stop.y() > row ? width : interval.stop.x<SHORT>();
+        spans.emplace_back(left, right);
+        boundaries.emplace_back(left);
+        boundaries.emplace_back(right);
+    }
+
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    // Between two neighboring boundaries the set of covering intervals doesn't change.
+    for (size_t i = 1; i < boundaries.size(); ++i)
+    {
+        const auto left = boundaries.at(i - 1);
+        const auto right = boundaries.at(i);
+
+        std::vector<size_t> ids;
+        for (size_t j = 0; j < spans.size(); ++j)
+        {
+            if (spans.at(j).first <= left && right <= spans.at(j).second)
+            {
+                ids.emplace_back(intervals.at(j).value);
+            }
+        }
+
+        if (ids.empty())
+        {
+            continue;
+        }
+
+        if (!runs.empty() && runs.back().right == left && runs.back().ids == ids)
+        {
+            runs.back().right = right;
+        }
+        else
+        {
+            runs.push_back({ left, right, std::move(ids) });
+        }
+    }
+}
+catch (...)
+{
+    LOG_CAUGHT_EXCEPTION();
+    runs.clear();
+}
+
 std::vector<Microsoft::Console::Types::Viewport> Terminal::GetSelectionRects() noexcept
 try
 {
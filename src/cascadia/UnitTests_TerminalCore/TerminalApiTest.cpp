@@ -7,11 +7,18 @@
 #include "../cascadia/TerminalCore/Terminal.hpp"
 #include "MockTermSettings.h"
 #include "../renderer/inc/DummyRenderTarget.hpp"
+#include "../../renderer/base/Renderer.hpp"
+#include "../../renderer/vt/Xterm256Engine.hpp"
 #include "consoletaeftemplates.hpp"
 
+#include <chrono>
+
 using namespace winrt::Microsoft::Terminal::TerminalControl;
 using namespace Microsoft::Terminal::Core;
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
 
+using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
 
@@ -40,6 +47,13 @@ namespace TerminalCoreUnitTests
         TEST_METHOD(AddHyperlinkCustomIdDifferentUri);
 
         TEST_METHOD(SetTaskbarProgress);
+
+        TEST_METHOD(PatternIdRunsMatchPerCellIds);
+        TEST_METHOD(PatternIdRunsOfOverlappingPatterns);
+
+        BEGIN_TEST_METHOD(UrlViewportFrameTime)
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+        END_TEST_METHOD()
     };
 };
 
@@ -388,3 +402,142 @@ void TerminalCoreUnitTests::TerminalApiTest::SetTaskbarProgress()
     VERIFY_ARE_EQUAL(term.GetTaskbarState(), gsl::narrow<size_t>(1));
     VERIFY_ARE_EQUAL(term.GetTaskbarProgress(), gsl::narrow<size_t>(80));
 }
+
+void TerminalApiTest::PatternIdRunsMatchPerCellIds()
+{
+    Terminal term;
+    DummyRenderTarget emptyRT;
+    term.Create({ 80, 10 }, 0, emptyRT);
+
+    term.Write(L"see https://example.com/a and ftp://x.org/b, or file://c\r\n");
+    term.Write(L"nothing to see here\r\n");
+    term.Write(L"  http://example.com/this/one/is/long/enough/to/wrap/around/onto/the/next/row/of/the/terminal.txt\r\n");
+    term.UpdatePatterns();
+
+    std::vector<PatternIdRun> runs;
+    for (SHORT row = 0; row < 10; ++row)
+    {
+        term.GetPatternIdRuns(row, runs);
+
+        // Expand the runs back into per cell ids and compare against the point queries.
+        size_t runIndex = 0;
+        for (SHORT column = 0; column < 80; ++column)
+        {
+            while (runIndex < runs.size() && runs.at(runIndex).right <= column)
+            {
+                ++runIndex;
+            }
+            std::vector<size_t> expected;
+            if (runIndex < runs.size() && runs.at(runIndex).left <= column)
+            {
+                expected = runs.at(runIndex).ids;
+            }
+            VERIFY_IS_TRUE(expected == term.GetPatternId({ column, row }), NoThrowString().Format(L"(%d, %d)", column, row));
+        }
+    }
+
+    term.GetPatternIdRuns(0, runs);
+    VERIFY_ARE_EQUAL(3u, runs.size());
+    VERIFY_ARE_EQUAL(4, runs.at(0).left);
+    VERIFY_ARE_EQUAL(25, runs.at(0).right);
+
+    term.GetPatternIdRuns(1, runs);
+    VERIFY_ARE_EQUAL(0u, runs.size());
+}
+
+void TerminalApiTest::PatternIdRunsOfOverlappingPatterns()
+{
+    Terminal term;
+    DummyRenderTarget emptyRT;
+    term.Create({ 20, 5 }, 0, emptyRT);
+
+    using PointTree = interval_tree::IntervalTree<til::point, size_t>;
+    PointTree::interval_vector intervals;
+    // Pattern 1 spans from the middle of row 0 to the middle of row 2.
+    intervals.emplace_back(til::point{ 10, 0 }, til::point{ 5, 2 }, 1u);
+    // Pattern 2 lies within row 1, pattern 3 touches pattern 2 but doesn't overlap it.
+    intervals.emplace_back(til::point{ 3, 1 }, til::point{ 8, 1 }, 2u);
+    intervals.emplace_back(til::point{ 8, 1 }, til::point{ 12, 1 }, 3u);
+    term._patternIntervalTree = PointTree{ std::move(intervals) };
+
+    std::vector<PatternIdRun> runs;
+
+    term.GetPatternIdRuns(0, runs);
+    VERIFY_ARE_EQUAL(1u, runs.size());
+    VERIFY_ARE_EQUAL(10, runs.at(0).left);
+    VERIFY_ARE_EQUAL(20, runs.at(0).right);
+
+    term.GetPatternIdRuns(1, runs);
+    VERIFY_ARE_EQUAL(4u, runs.size());
+    VERIFY_ARE_EQUAL(0, runs.at(0).left);
+    VERIFY_ARE_EQUAL(3, runs.at(0).right);
+    VERIFY_ARE_EQUAL(1u, runs.at(0).ids.size());
+    VERIFY_ARE_EQUAL(3, runs.at(1).left);
+    VERIFY_ARE_EQUAL(8, runs.at(1).right);
+    VERIFY_ARE_EQUAL(2u, runs.at(1).ids.size());
+    VERIFY_ARE_EQUAL(8, runs.at(2).left);
+    VERIFY_ARE_EQUAL(12, runs.at(2).right);
+    VERIFY_ARE_EQUAL(2u, runs.at(2).ids.size());
+    VERIFY_ARE_EQUAL(12, runs.at(3).left);
+    VERIFY_ARE_EQUAL(20, runs.at(3).right);
+    VERIFY_IS_TRUE(runs.at(3).ids == std::vector<size_t>{ 1u });
+
+    term.GetPatternIdRuns(2, runs);
+    VERIFY_ARE_EQUAL(1u, runs.size());
+    VERIFY_ARE_EQUAL(0, runs.at(0).left);
+    VERIFY_ARE_EQUAL(5, runs.at(0).right);
+
+    term.GetPatternIdRuns(3, runs);
+    VERIFY_ARE_EQUAL(0u, runs.size());
+}
+
+void TerminalApiTest::UrlViewportFrameTime()
+{
+    constexpr SHORT width = 300;
+    constexpr SHORT height = 100;
+    constexpr int frames = 100;
+
+    Terminal term;
+    DummyRenderTarget emptyRT;
+    term.Create({ width, height }, 0, emptyRT);
+
+    // Fill the whole viewport with URLs.
+    std::wstring line;
+    while (line.size() < width - 40)
+    {
+        line += L"https://example.com/";
+        line += std::to_wstring(line.size());
+        line += L' ';
+    }
+    for (SHORT row = 0; row < height - 1; ++row)
+    {
+        term.Write(line);
+        term.Write(L"\r\n");
+    }
+    term.UpdatePatterns();
+
+    size_t bytesWritten = 0;
+    Renderer renderer{ &term, nullptr, 0, nullptr };
+    Xterm256Engine engine{ wil::unique_hfile{ INVALID_HANDLE_VALUE }, Viewport::FromDimensions({ 0, 0 }, { width, height }) };
+    engine.SetTestCallback([&](const char* const, size_t const cch) {
+        bytesWritten += cch;
+        return true;
+    });
+    renderer.AddRenderEngine(&engine);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto frame = 0; frame < frames; ++frame)
+    {
+        renderer.TriggerRedrawAll();
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    VERIFY_IS_GREATER_THAN(bytesWritten, 0u);
+    Log::Comment(NoThrowString().Format(L"Painted %d frames of %dx%d cells full of URLs in %lld us (%lld us per frame)",
+                                        frames,
+                                        width,
+                                        height,
+                                        static_cast<long long>(elapsed.count()),
+                                        static_cast<long long>(elapsed.count() / frames)));
+}
@@ -10,6 +10,8 @@
 #include "consoletaeftemplates.hpp"
 #include "TestUtils.h"
 
+#include <chrono>
+
 using namespace winrt::Microsoft::Terminal::TerminalControl;
 using namespace Microsoft::Terminal::Core;
 
@@ -38,9 +40,24 @@ class TerminalCoreUnitTests::TerminalBufferTests final
 
     TEST_METHOD(TestWrappingCharByChar);
     TEST_METHOD(TestWrappingALongString);
+    TEST_METHOD(TestWrappingExactlyAtRightMargin);
+    TEST_METHOD(TestWrappingWideGlyphAtRightMargin);
+    TEST_METHOD(TestCursorAfterMultiRowRun);
 
     TEST_METHOD(DontSnapToOutputTest);
 
+    BEGIN_TEST_METHOD(WriteThroughputAscii)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(WriteThroughputCjk)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(WriteThroughputEmoji)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
     TEST_METHOD_SETUP(MethodSetup)
     {
         // STEP 1: Set up the Terminal
@@ -56,6 +73,8 @@ class TerminalCoreUnitTests::TerminalBufferTests final
     }
 
 private:
+    void _MeasureWriteThroughput(const std::wstring_view name, const std::wstring_view line);
+
     DummyRenderTarget emptyRT;
     std::unique_ptr<Terminal> term;
 };
@@ -152,6 +171,90 @@ void TerminalBufferTests::TestWrappingALongString()
     TestUtils::VerifyExpectedString(termTb, TestUtils::Test100CharsString, { 0, 0 });
 }
 
+void TerminalBufferTests::TestWrappingExactlyAtRightMargin()
+{
+    auto& termTb = *term->_buffer;
+    auto& termSm = *term->_stateMachine;
+    auto& cursor = termTb.GetCursor();
+
+    const auto oneRow = TestUtils::Test100CharsString.substr(0, TerminalViewWidth);
+    termSm.ProcessString(oneRow);
+
+    Log::Comment(L"The run fills the row exactly. The cursor stays on it, past the last column.");
+    VERIFY_ARE_EQUAL(TerminalViewWidth, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(0, cursor.GetPosition().Y);
+    VERIFY_IS_TRUE(termTb.GetRowByOffset(0).GetCharRow().WasWrapForced());
+    VERIFY_IS_FALSE(termTb.GetRowByOffset(0).GetCharRow().WasDoubleBytePadded());
+    TestUtils::VerifyExpectedString(termTb, oneRow, { 0, 0 });
+
+    Log::Comment(L"The next run starts at the beginning of the following row.");
+    termSm.ProcessString(L"x");
+    VERIFY_ARE_EQUAL(1, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(1, cursor.GetPosition().Y);
+    TestUtils::VerifyExpectedString(termTb, L"x", { 0, 1 });
+    VERIFY_IS_FALSE(termTb.GetRowByOffset(1).GetCharRow().WasWrapForced());
+}
+
+void TerminalBufferTests::TestWrappingWideGlyphAtRightMargin()
+{
+    auto& termTb = *term->_buffer;
+    auto& termSm = *term->_stateMachine;
+    auto& cursor = termTb.GetCursor();
+
+    // U+306A hiragana na, a double width glyph.
+    const std::wstring_view wide{ L"\x306A" };
+
+    const auto leading = TestUtils::Test100CharsString.substr(0, TerminalViewWidth - 1);
+    termSm.ProcessString(std::wstring{ leading } + std::wstring{ wide });
+
+    Log::Comment(L"The wide glyph doesn't fit into the last column, which is padded out instead.");
+    const auto& row0 = termTb.GetRowByOffset(0);
+    VERIFY_IS_TRUE(row0.GetCharRow().WasDoubleBytePadded());
+    VERIFY_IS_TRUE(row0.GetCharRow().WasWrapForced());
+    TestUtils::VerifyExpectedString(termTb, leading, { 0, 0 });
+    TestUtils::VerifyExpectedString(termTb, L" ", { TerminalViewWidth - 1, 0 });
+
+    Log::Comment(L"The whole glyph moved to the start of the next row.");
+    const auto& row1 = termTb.GetRowByOffset(1);
+    VERIFY_IS_FALSE(row1.GetCharRow().WasDoubleBytePadded());
+    VERIFY_IS_FALSE(row1.GetCharRow().WasWrapForced());
+    VERIFY_IS_TRUE(termTb.GetCellDataAt({ 0, 1 })->DbcsAttr().IsLeading());
+    VERIFY_IS_TRUE(termTb.GetCellDataAt({ 1, 1 })->DbcsAttr().IsTrailing());
+    TestUtils::VerifyExpectedString(termTb, wide, { 0, 1 });
+
+    VERIFY_ARE_EQUAL(2, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(1, cursor.GetPosition().Y);
+}
+
+void TerminalBufferTests::TestCursorAfterMultiRowRun()
+{
+    auto& termTb = *term->_buffer;
+    auto& termSm = *term->_stateMachine;
+    auto& cursor = termTb.GetCursor();
+
+    // Start in the middle of the third row.
+    termSm.ProcessString(L"\x1b[3;6H");
+    VERIFY_ARE_EQUAL(5, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(2, cursor.GetPosition().Y);
+
+    // 75 characters fill the rest of row 2, 80 fill row 3 and the last 45 end up on row 4.
+    std::wstring run;
+    for (auto i = 0; i < 200; i++)
+    {
+        run.push_back(static_cast<wchar_t>(33 + (i % 94)));
+    }
+    termSm.ProcessString(run);
+
+    VERIFY_ARE_EQUAL(45, cursor.GetPosition().X);
+    VERIFY_ARE_EQUAL(4, cursor.GetPosition().Y);
+
+    VERIFY_IS_TRUE(termTb.GetRowByOffset(2).GetCharRow().WasWrapForced());
+    VERIFY_IS_TRUE(termTb.GetRowByOffset(3).GetCharRow().WasWrapForced());
+    VERIFY_IS_FALSE(termTb.GetRowByOffset(4).GetCharRow().WasWrapForced());
+
+    TestUtils::VerifyExpectedString(termTb, run, { 5, 2 });
+}
+
 void TerminalBufferTests::DontSnapToOutputTest()
 {
     auto& termTb = *term->_buffer;
@@ -233,3 +336,72 @@ void TerminalBufferTests::DontSnapToOutputTest()
     VERIFY_ARE_EQUAL(TerminalViewHeight, seventhView.BottomExclusive());
     VERIFY_ARE_EQUAL(TerminalHistoryLength, term->_scrollOffset);
 }
+
+// Routine Description:
+// - Feeds roughly 4MB of the given line (repeated, CRLF terminated) through
+//   the state machine and logs the throughput. The line is longer than the
+//   terminal is wide, so every line also exercises the wrapping path.
+void TerminalBufferTests::_MeasureWriteThroughput(const std::wstring_view name, const std::wstring_view line)
+{
+    auto& termSm = *term->_stateMachine;
+
+    std::wstring chunk;
+    while (chunk.size() < 64 * 1024)
+    {
+        chunk.append(line);
+        chunk.append(L"\r\n");
+    }
+
+    constexpr size_t chunkCount = 32;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < chunkCount; ++i)
+    {
+        termSm.ProcessString(chunk);
+    }
+    const auto delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    const auto bytes = chunkCount * chunk.size() * sizeof(wchar_t);
+    Log::Comment(NoThrowString().Format(L"%s: %zu bytes in %lld us (%.2f MB/s)",
+                                        name.data(),
+                                        bytes,
+                                        delta,
+                                        delta ? (bytes / static_cast<double>(delta)) : 0.0));
+}
+
+void TerminalBufferTests::WriteThroughputAscii()
+{
+    std::wstring line;
+    for (auto i = 0; i < 120; i++)
+    {
+        line.push_back(static_cast<wchar_t>(33 + (i % 94)));
+    }
+
+    _MeasureWriteThroughput(L"ASCII", line);
+}
+
+void TerminalBufferTests::WriteThroughputCjk()
+{
+    // CJK Unified Ideographs are all full width, so each one is written as a
+    // leading/trailing cell pair and regularly forces double byte padding.
+    std::wstring line;
+    for (auto i = 0; i < 61; i++)
+    {
+        line.push_back(static_cast<wchar_t>(0x4E00 + i));
+    }
+
+    _MeasureWriteThroughput(L"CJK", line);
+}
+
+void TerminalBufferTests::WriteThroughputEmoji()
+{
+    // U+1F600 and friends: surrogate pairs that go into the glyph storage of the row.
+    std::wstring line;
+    for (wchar_t i = 0; i < 61; i++)
+    {
+        line.push_back(0xD83D);
+        line.push_back(static_cast<wchar_t>(0xDE00 + i % 0x40));
+    }
+
+    _MeasureWriteThroughput(L"Emoji", line);
+}
@@ -20,6 +20,8 @@ const std::wstring_view ConsoleArguments::HEIGHT_ARG = L"--height";
 const std::wstring_view ConsoleArguments::INHERIT_CURSOR_ARG = L"--inheritcursor";
 const std::wstring_view ConsoleArguments::RESIZE_QUIRK = L"--resizeQuirk";
 const std::wstring_view ConsoleArguments::WIN32_INPUT_MODE = L"--win32input";
+const std::wstring_view ConsoleArguments::DIFF_FRAMES = L"--diffFrames";
+const std::wstring_view ConsoleArguments::PASSTHROUGH_MODE = L"--passthrough";
 const std::wstring_view ConsoleArguments::FEATURE_ARG = L"--feature";
 const std::wstring_view ConsoleArguments::FEATURE_PTY_ARG = L"pty";
 
@@ -493,6 +495,18 @@ void ConsoleArguments::s_ConsumeArg(_Inout_ std::vector<std::wstring>& args, _In
             s_ConsumeArg(args, i);
             hr = S_OK;
         }
+        else if (arg == DIFF_FRAMES)
+        {
+            _diffFrames = true;
+            s_ConsumeArg(args, i);
+            hr = S_OK;
+        }
+        else if (arg == PASSTHROUGH_MODE)
+        {
+            _passthroughMode = true;
+            s_ConsumeArg(args, i);
+            hr = S_OK;
+        }
         else if (arg == CLIENT_COMMANDLINE_ARG)
         {
             // Everything after this is the explicit commandline
@@ -633,6 +647,14 @@ bool ConsoleArguments::IsWin32InputModeEnabled() const
 {
     return _win32InputMode;
 }
+bool ConsoleArguments::IsDiffFramesEnabled() const
+{
+    return _diffFrames;
+}
+bool ConsoleArguments::IsPassthroughModeEnabled() const
+{
+    return _passthroughMode;
+}
 
 // Method Description:
 // - Tell us to use a different size than the one parsed as the size of the
@@ -70,6 +70,8 @@ VtIo::VtIo() :
     _lookingForCursorPosition = pArgs->GetInheritCursor();
     _resizeQuirk = pArgs->IsResizeQuirkEnabled();
     _win32InputMode = pArgs->IsWin32InputModeEnabled();
+    _diffFrames = pArgs->IsDiffFramesEnabled();
+    _passthroughMode = pArgs->IsPassthroughModeEnabled();
 
     // If we were already given VT handles, set up the VT IO engine to use those.
     if (pArgs->InConptyMode())
@@ -174,7 +176,12 @@ VtIo::VtIo() :
             {
                 _pVtRenderEngine->SetTerminalOwner(this);
                 _pVtRenderEngine->SetResizeQuirk(_resizeQuirk);
+                _pVtRenderEngine->SetDiffFrames(_diffFrames);
             }
+
+            // Only xterm-256color terminals can be expected to understand
+            // whatever the client writes. The others get it translated.
+            _passthroughMode = _passthroughMode && _IoMode == VtIoMode::XTERM_256;
         }
     }
     CATCH_RETURN();
@@ -455,6 +462,70 @@ bool VtIo::IsResizeQuirkEnabled() const
     return _resizeQuirk;
 }
 
+// Method Description:
+// - Returns true if passthrough mode is enabled. In this mode, the text of
+//   clients that emit VT themselves is written straight to the terminal, rather
+//   than rendered from the buffer. The buffer is still updated from it, for
+//   clients that read it with the console API.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff we were started with the `--passthrough` flag enabled, and are
+//   connected to an xterm-256color terminal.
+bool VtIo::IsPassthroughModeEnabled() const noexcept
+{
+    return _passthroughMode && _pVtRenderEngine != nullptr;
+}
+
+// Method Description:
+// - Starts passing text through to the terminal. Whatever the buffer changes
+//   that are still waiting to be painted came first, so we paint them now.
+//   Until EndPassthrough, the changes the text makes to the buffer aren't
+//   painted again.
+// - The console lock must be held when calling this routine.
+// Arguments:
+// - text - the text, as the client wrote it
+// Return Value:
+// - S_OK if we wrote the text successfully, otherwise an appropriate HRESULT
+[[nodiscard]] HRESULT VtIo::BeginPassthrough(const std::wstring_view text)
+{
+    auto& g = ServiceLocator::LocateGlobals();
+    if (g.pRender)
+    {
+        RETURN_IF_FAILED(g.pRender->PaintFrame());
+    }
+    _passingThrough = true;
+    return _pVtRenderEngine->BeginPassthrough(text);
+}
+
+// Method Description:
+// - Stops passing text through to the terminal. The buffer now shows what the
+//   terminal does, with the same cursor position and attributes.
+// - The console lock must be held when calling this routine.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void VtIo::EndPassthrough() noexcept
+{
+    const auto& screenInfo = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer();
+    _pVtRenderEngine->EndPassthrough(screenInfo.GetAttributes());
+    _passingThrough = false;
+}
+
+// Method Description:
+// - Returns true while the text of a client is being passed through to the
+//   terminal, between BeginPassthrough and EndPassthrough. The terminal gets
+//   the queries in that text too, and answers them itself.
+// Arguments:
+// - <none>
+// Return Value:
+// - true iff text is being passed through right now.
+bool VtIo::IsPassingThrough() const noexcept
+{
+    return _passingThrough;
+}
+
 // Method Description:
 // - Manually tell the renderer that it should emit a "Erase Scrollback"
 //   sequence to the connected terminal. We need to do this in certain cases
@@ -11,6 +11,10 @@
 
 class ConsoleArguments;
 
+#ifdef UNIT_TESTING
+class ConptyOutputTests;
+#endif
+
 namespace Microsoft::Console::VirtualTerminal
 {
     class VtIo : public Microsoft::Console::ITerminalOwner
@@ -45,6 +49,11 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool IsResizeQuirkEnabled() const;
 
+        bool IsPassthroughModeEnabled() const noexcept;
+        [[nodiscard]] HRESULT BeginPassthrough(const std::wstring_view text);
+        void EndPassthrough() noexcept;
+        bool IsPassingThrough() const noexcept;
+
         [[nodiscard]] HRESULT ManuallyClearScrollback() const noexcept;
 
     private:
@@ -63,6 +72,9 @@ namespace Microsoft::Console::VirtualTerminal
 
         bool _resizeQuirk{ false };
         bool _win32InputMode{ false };
+        bool _diffFrames{ false };
+        bool _passthroughMode{ false };
+        bool _passingThrough{ false };
 
         std::unique_ptr<Microsoft::Console::Render::VtEngine> _pVtRenderEngine;
         std::unique_ptr<Microsoft::Console::VtInputThread> _pVtInputThread;
@@ -74,6 +86,7 @@ namespace Microsoft::Console::VirtualTerminal
 
 #ifdef UNIT_TESTING
         friend class VtIoTests;
+        friend class ::ConptyOutputTests;
 #endif
     };
 }
@@ -939,6 +939,28 @@ constexpr unsigned int LOCAL_BUFFER_SIZE = 100;
                 StateMachine& machine = screenInfo.GetStateMachine();
                 size_t const cch = BufferSize / sizeof(WCHAR);
 
+                // In passthrough mode, the text goes to the terminal as it is.
+                // It's still processed into the buffer for the API readers,
+                // but that's not rendered to the terminal a second time.
+                // Unless DISABLE_NEWLINE_AUTO_RETURN is set, we'd treat a LF
+                // as a CR LF where the terminal doesn't, so that text has to
+                // be rendered from the buffer instead.
+                auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+                const bool passthrough = WI_IsFlagSet(screenInfo.OutputMode, DISABLE_NEWLINE_AUTO_RETURN) &&
+                                         gci.IsInVtIoMode() &&
+                                         gci.GetVtIo()->IsPassthroughModeEnabled() &&
+                                         screenInfo.GetActiveBuffer().IsActiveScreenBuffer();
+                if (passthrough)
+                {
+                    LOG_IF_FAILED(gci.GetVtIo()->BeginPassthrough({ pwchRealUnicode, cch }));
+                }
+                auto endPassthrough = wil::scope_exit([&]() noexcept {
+                    if (passthrough)
+                    {
+                        gci.GetVtIo()->EndPassthrough();
+                    }
+                });
+
                 machine.ProcessString({ pwchRealUnicode, cch });
                 *pcb += BufferSize;
             }
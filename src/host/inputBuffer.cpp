@@ -6,6 +6,7 @@
 #include "dbcs.h"
 #include "stream.h"
 #include "../types/inc/GlyphWidth.hpp"
+#include "../types/inc/convert.hpp"
 
 #include <functional>
 
@@ -16,6 +17,24 @@
 using Microsoft::Console::Interactivity::ServiceLocator;
 using Microsoft::Console::VirtualTerminal::TerminalInput;
 
+// Routine Description:
+// - Appends the key events CharToKeyEvents makes for a character to a vector of records.
+// Arguments:
+// - wch - the character
+// - codepage - the codepage used for characters that aren't on the keyboard
+// - records - the vector to append the records to
+// Return Value:
+// - <none>
+// Note:
+// - will throw on failure
+static void _AppendKeyRecords(const wchar_t wch, const unsigned int codepage, std::vector<INPUT_RECORD>& records)
+{
+    for (const auto& keyEvent : CharToKeyEvents(wch, codepage))
+    {
+        records.push_back(keyEvent->ToInputRecord());
+    }
+}
+
 // Routine Description:
 // - This method creates an input buffer.
 // Arguments:
@@ -151,6 +170,7 @@ void InputBuffer::ReinitializeInputBuffer()
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
     InputMode = INPUT_BUFFER_DEFAULT_INPUT_MODE;
     _storage.clear();
+    _textRuns.clear();
 }
 
 // Routine Description:
@@ -183,9 +203,16 @@ void InputBuffer::TerminateRead(_In_ WaitTerminationReason Flag)
 // - The number of events currently in the input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
+// - Text runs haven't been turned into key events yet, so each of their
+//   characters is counted as the key down and key up most characters become.
 size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 {
-    return _storage.size();
+    size_t readyEvents = _storage.size();
+    for (const auto& run : _textRuns)
+    {
+        readyEvents += (run.text.size() - run.offset) * 2 - 1;
+    }
+    return readyEvents;
 }
 
 // Routine Description:
@@ -199,6 +226,7 @@ size_t InputBuffer::GetNumberOfReadyEvents() const noexcept
 void InputBuffer::Flush()
 {
     _storage.clear();
+    _textRuns.clear();
     ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
 }
 
@@ -210,12 +238,12 @@ void InputBuffer::Flush()
 // - None
 // Note:
 // - The console lock must be held when calling this routine.
+// - Text runs are key events that haven't been expanded yet and are kept.
 void InputBuffer::FlushAllButKeys()
 {
-    auto newEnd = std::remove_if(_storage.begin(), _storage.end(), [](const std::unique_ptr<IInputEvent>& event) {
-        return event->EventType() != InputEventType::KeyEvent;
+    _storage.erase_if([](const INPUT_RECORD& record) noexcept {
+        return record.EventType != KEY_EVENT && record.EventType != TEXT_RUN_EVENT;
     });
-    _storage.erase(newEnd, _storage.end());
 }
 
 // Routine Description:
@@ -241,6 +269,52 @@ void InputBuffer::FlushAllButKeys()
                                          const bool WaitForData,
                                          const bool Unicode,
                                          const bool Stream)
+{
+    try
+    {
+        std::vector<INPUT_RECORD> records;
+        const auto Status = Read(records,
+                                 AmountToRead,
+                                 Peek,
+                                 WaitForData,
+                                 Unicode,
+                                 Stream);
+
+        for (const auto& record : records)
+        {
+            OutEvents.push_back(IInputEvent::Create(record));
+        }
+        return Status;
+    }
+    catch (...)
+    {
+        return NTSTATUS_FROM_HRESULT(wil::ResultFromCaughtException());
+    }
+}
+
+// Routine Description:
+// - This routine reads from the input buffer into an array of records.
+// - It can convert returned data to through the currently set Input CP, it can optionally return a wait condition
+//   if there isn't enough data in the buffer, and it can be set to not remove records as it reads them out.
+// Note:
+// - The console lock must be held when calling this routine.
+// Arguments:
+// - outRecords - vector the read records are appended to
+// - AmountToRead - the amount of events to try to read
+// - Peek - If true, copy events to outRecords but don't remove them from the input buffer.
+// - WaitForData - if true, wait until an event is input (if there aren't enough to fill client buffer). if false, return immediately
+// - Unicode - true if the data in key events should be treated as unicode. false if they should be converted by the current input CP.
+// - Stream - true if read should unpack KeyEvents that have a >1 repeat count. AmountToRead must be 1 if Stream is true.
+// Return Value:
+// - STATUS_SUCCESS if records were read into the client buffer and everything is OK.
+// - CONSOLE_STATUS_WAIT if there weren't enough records to satisfy the request (and waits are allowed)
+// - otherwise a suitable memory/math/string error in NTSTATUS form.
+[[nodiscard]] NTSTATUS InputBuffer::Read(_Out_ std::vector<INPUT_RECORD>& outRecords,
+                                         const size_t AmountToRead,
+                                         const bool Peek,
+                                         const bool WaitForData,
+                                         const bool Unicode,
+                                         const bool Stream)
 {
     try
     {
@@ -254,10 +328,9 @@ void InputBuffer::FlushAllButKeys()
         }
 
         // read from buffer
-        std::deque<std::unique_ptr<IInputEvent>> events;
         size_t eventsRead;
         bool resetWaitEvent;
-        _ReadBuffer(events,
+        _ReadBuffer(outRecords,
                     AmountToRead,
                     eventsRead,
                     Peek,
@@ -265,13 +338,6 @@ void InputBuffer::FlushAllButKeys()
                     Unicode,
                     Stream);
 
-        // copy events to outEvents
-        while (!events.empty())
-        {
-            OutEvents.push_back(std::move(events.front()));
-            events.pop_front();
-        }
-
         if (resetWaitEvent)
         {
             ServiceLocator::LocateGlobals().hInputEvent.ResetEvent();
@@ -309,16 +375,16 @@ void InputBuffer::FlushAllButKeys()
     NTSTATUS Status;
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
-        Status = Read(outEvents,
+        std::vector<INPUT_RECORD> outRecords;
+        Status = Read(outRecords,
                       1,
                       Peek,
                       WaitForData,
                       Unicode,
                       Stream);
-        if (!outEvents.empty())
+        if (!outRecords.empty())
         {
-            outEvent.swap(outEvents.front());
+            outEvent = IInputEvent::Create(outRecords.front());
         }
     }
     catch (...)
@@ -332,7 +398,7 @@ void InputBuffer::FlushAllButKeys()
 // Routine Description:
 // - This routine reads from a buffer. It does the buffer manipulation.
 // Arguments:
-// - outEvents - where read events are placed
+// - outRecords - where read records are appended
 // - readCount - amount of events to read
 // - eventsRead - where to store number of events read
 // - peek - if true , don't remove data from buffer, just copy it.
@@ -343,7 +409,9 @@ void InputBuffer::FlushAllButKeys()
 // - <none>
 // Note:
 // - The console lock must be held when calling this routine.
-void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& outEvents,
+// - Runs of stored events are copied out a block at a time. A peek leaves
+//   the buffer as it is and walks over it with an index instead.
+void InputBuffer::_ReadBuffer(_Out_ std::vector<INPUT_RECORD>& outRecords,
                               const size_t readCount,
                               _Out_ size_t& eventsRead,
                               const bool peek,
@@ -356,95 +424,128 @@ void InputBuffer::_ReadBuffer(_Out_ std::deque<std::unique_ptr<IInputEvent>>& ou
     FAIL_FAST_IF(streamRead && readCount != 1);
 
     resetWaitEvent = false;
+    const auto initialSize = outRecords.size();
 
-    std::deque<std::unique_ptr<IInputEvent>> readEvents;
     // we need another var to keep track of how many we've read
     // because dbcs records count for two when we aren't doing a
     // unicode read but the eventsRead count should return the number
     // of events actually put into outRecords.
     size_t virtualReadCount = 0;
+    const auto countRecord = [&](const INPUT_RECORD& record) {
+        ++virtualReadCount;
+        if (!unicode &&
+            record.EventType == KEY_EVENT &&
+            IsGlyphFullWidth(record.Event.KeyEvent.uChar.UnicodeChar))
+        {
+            ++virtualReadCount;
+        }
+    };
+
+    // the position of the next record to read, and of the text run it may mark.
+    // Both only move when peeking; otherwise records are taken off the front.
+    size_t index = 0;
+    size_t runIndex = 0;
+    std::vector<INPUT_RECORD> keyRecords;
 
-    while (!_storage.empty() && virtualReadCount < readCount)
+    while (index < _storage.size() && virtualReadCount < readCount)
     {
-        bool performNormalRead = true;
         // for stream reads we need to split any key events that have been coalesced
         if (streamRead)
         {
-            if (_storage.front()->EventType() == InputEventType::KeyEvent)
+            auto& record = _storage[index];
+            if (record.EventType == KEY_EVENT && record.Event.KeyEvent.wRepeatCount > 1)
             {
-                KeyEvent* const pKeyEvent = static_cast<KeyEvent* const>(_storage.front().get());
-                if (pKeyEvent->GetRepeatCount() > 1)
+                auto streamRecord = record;
+                streamRecord.Event.KeyEvent.wRepeatCount = 1;
+                outRecords.push_back(streamRecord);
+                countRecord(streamRecord);
+                if (!peek)
                 {
-                    // split the key event
-                    std::unique_ptr<KeyEvent> streamKeyEvent = std::make_unique<KeyEvent>(*pKeyEvent);
-                    streamKeyEvent->SetRepeatCount(1);
-                    readEvents.push_back(std::move(streamKeyEvent));
-                    pKeyEvent->SetRepeatCount(pKeyEvent->GetRepeatCount() - 1);
-                    performNormalRead = false;
+                    --record.Event.KeyEvent.wRepeatCount;
                 }
+                continue;
             }
         }
 
-        if (performNormalRead)
+        // copy everything up to the next text run at once
+        size_t count = 0;
+        while (index + count < _storage.size() &&
+               virtualReadCount < readCount &&
+               _storage[index + count].EventType != TEXT_RUN_EVENT)
         {
-            readEvents.push_back(std::move(_storage.front()));
-            _storage.pop_front();
+            countRecord(_storage[index + count]);
+            ++count;
+        }
+        if (count != 0)
+        {
+            _storage.copy_to(index, count, outRecords);
+            if (peek)
+            {
+                index += count;
+            }
+            else
+            {
+                _storage.pop_front(count);
+            }
+            continue;
         }
 
-        ++virtualReadCount;
-        if (!unicode)
+        // Text runs are handed out one character at a time.
+        if (peek)
         {
-            if (readEvents.back()->EventType() == InputEventType::KeyEvent)
+            const auto& run = til::at(_textRuns, runIndex);
+            for (auto offset = run.offset; offset < run.text.size() && virtualReadCount < readCount; ++offset)
             {
-                const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(readEvents.back().get());
-                if (IsGlyphFullWidth(pKeyEvent->GetCharData()))
+                keyRecords.clear();
+                _AppendKeyRecords(til::at(run.text, offset), run.codepage, keyRecords);
+                for (size_t i = 0; i < keyRecords.size() && virtualReadCount < readCount; ++i)
                 {
-                    ++virtualReadCount;
+                    outRecords.push_back(til::at(keyRecords, i));
+                    countRecord(til::at(keyRecords, i));
                 }
             }
+            ++index;
+            ++runIndex;
+            continue;
         }
-    }
 
-    // the amount of events that were actually read
-    eventsRead = readEvents.size();
+        auto& run = _textRuns.front();
+        keyRecords.clear();
+        _AppendKeyRecords(til::at(run.text, run.offset), run.codepage, keyRecords);
+
+        // A stream read only looks at the key down of a character, so it
+        // doesn't need the key up. Characters typed with Alt+Numpad keep all
+        // of their events, as their character comes with the final key up.
+        if (streamRead &&
+            keyRecords.size() == 2 &&
+            keyRecords.front().Event.KeyEvent.bKeyDown &&
+            !keyRecords.back().Event.KeyEvent.bKeyDown)
+        {
+            keyRecords.pop_back();
+        }
 
-    // copy the events back if we were supposed to peek
-    if (peek)
-    {
-        if (streamRead)
+        if (++run.offset == run.text.size())
         {
-            // we need to check and see if the event was split from a coalesced key event
-            // or if it was unrelated to the current front event in storage
-            if (!readEvents.empty() &&
-                !_storage.empty() &&
-                readEvents.back()->EventType() == InputEventType::KeyEvent &&
-                _storage.front()->EventType() == InputEventType::KeyEvent &&
-                _CanCoalesce(static_cast<const KeyEvent&>(*readEvents.back()),
-                             static_cast<const KeyEvent&>(*_storage.front())))
-            {
-                KeyEvent& keyEvent = static_cast<KeyEvent&>(*_storage.front());
-                keyEvent.SetRepeatCount(keyEvent.GetRepeatCount() + 1);
-            }
-            else
-            {
-                _storage.push_front(IInputEvent::Create(readEvents.back()->ToInputRecord()));
-            }
+            _textRuns.pop_front();
+            _storage.pop_front();
         }
-        else
+
+        // what doesn't fit into this read goes back in front of the rest of the run
+        size_t taken = 0;
+        while (taken < keyRecords.size() && virtualReadCount < readCount)
         {
-            for (auto it = readEvents.crbegin(); it != readEvents.crend(); ++it)
-            {
-                _storage.push_front(IInputEvent::Create((*it)->ToInputRecord()));
-            }
+            outRecords.push_back(til::at(keyRecords, taken));
+            countRecord(til::at(keyRecords, taken));
+            ++taken;
+        }
+        for (auto i = keyRecords.size(); i > taken; --i)
+        {
+            _storage.push_front(til::at(keyRecords, i - 1));
         }
     }
 
-    // move events read to proper deque
-    while (!readEvents.empty())
-    {
-        outEvents.push_back(std::move(readEvents.front()));
-        readEvents.pop_front();
-    }
+    // the amount of events that were actually read
+    eventsRead = outRecords.size() - initialSize;
 
     // signal if we emptied the buffer
     if (_storage.empty())
@@ -468,34 +569,41 @@ size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& in
     {
         _vtInputShouldSuppress = true;
         auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
+        auto inRecords = IInputEvent::ToInputRecords(inEvents);
+        inEvents.clear();
+        _HandleConsoleSuspensionEvents(inRecords);
+        if (inRecords.empty())
         {
             return STATUS_SUCCESS;
         }
-        // read all of the records out of the buffer, then write the
-        // prepend ones, then write the original set. We need to do it
-        // this way to handle any coalescing that might occur.
+        // take all of the records out of the buffer, then write the
+        // prepend ones, then put the original set back after them.
+        // We need to do it this way to handle any coalescing that
+        // might occur between the prepended records.
 
         // get all of the existing records, "emptying" the buffer
-        std::deque<std::unique_ptr<IInputEvent>> existingStorage;
+        InputRecordQueue existingStorage;
         existingStorage.swap(_storage);
+        const bool initiallyEmptyQueue = existingStorage.empty();
+        auto restoreStorage = wil::scope_exit([&]() { _storage.swap(existingStorage); });
 
         // We will need this variable to pass to _WriteBuffer so it can attempt to determine wait status.
-        // However, because we swapped the storage out from under it with an empty deque, it will always
-        // return true after the first one (as it is filling the newly emptied backing deque.)
-        // Then after the second one, because we've inserted some input, it will always say false.
+        // However, because we swapped the storage out from under it with an empty queue, it will always
+        // return true as it is filling the newly emptied one.
         bool unusedWaitStatus = false;
 
         // write the prepend records
         size_t prependEventsWritten;
-        _WriteBuffer(inEvents, prependEventsWritten, unusedWaitStatus);
+        _WriteBuffer(inRecords, prependEventsWritten, unusedWaitStatus);
         FAIL_FAST_IF(!(unusedWaitStatus));
 
-        // write all previously existing records
-        size_t existingEventsWritten;
-        _WriteBuffer(existingStorage, existingEventsWritten, unusedWaitStatus);
-        FAIL_FAST_IF(!(!unusedWaitStatus));
+        // The previously existing records were already written once, with
+        // their coalescing and text run markers, so they go back as they are.
+        for (auto i = _storage.size(); i > 0; --i)
+        {
+            existingStorage.push_front(_storage[i - 1]);
+        }
+        restoreStorage.reset();
 
         // We need to set the wait event if there were 0 events in the
         // input queue when we started.
@@ -504,7 +612,7 @@ size_t InputBuffer::Prepend(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& in
         // and instead need to set the event if the original backing
         // buffer (the one we swapped out at the top) was empty
         // when this whole thing started.
-        if (existingStorage.empty())
+        if (initiallyEmptyQueue)
         {
             ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
         }
@@ -534,9 +642,9 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 {
     try
     {
-        std::deque<std::unique_ptr<IInputEvent>> inEvents;
-        inEvents.push_back(std::move(inEvent));
-        return Write(inEvents);
+        const auto inRecord = inEvent->ToInputRecord();
+        inEvent.reset();
+        return Write(gsl::span<const INPUT_RECORD>{ &inRecord, 1 });
     }
     catch (...)
     {
@@ -554,14 +662,40 @@ size_t InputBuffer::Write(_Inout_ std::unique_ptr<IInputEvent> inEvent)
 // - The number of events that were written to input buffer.
 // Note:
 // - The console lock must be held when calling this routine.
+// - inEvents is emptied.
 size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+{
+    try
+    {
+        const auto inRecords = IInputEvent::ToInputRecords(inEvents);
+        inEvents.clear();
+        return Write(inRecords);
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Writes records to the input buffer. Wakes up any readers that are
+// waiting for additional input events.
+// Arguments:
+// - inRecords - input records to store in the buffer.
+// Return Value:
+// - The number of events that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::Write(const gsl::span<const INPUT_RECORD> inRecords)
 {
     try
     {
         _vtInputShouldSuppress = true;
         auto resetVtInputSuppress = wil::scope_exit([&]() { _vtInputShouldSuppress = false; });
-        _HandleConsoleSuspensionEvents(inEvents);
-        if (inEvents.empty())
+        std::vector<INPUT_RECORD> records{ inRecords.begin(), inRecords.end() };
+        _HandleConsoleSuspensionEvents(records);
+        if (records.empty())
         {
             return 0;
         }
@@ -569,7 +703,7 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
         // Write to buffer.
         size_t EventsWritten;
         bool SetWaitEvent;
-        _WriteBuffer(inEvents, EventsWritten, SetWaitEvent);
+        _WriteBuffer(records, EventsWritten, SetWaitEvent);
 
         if (SetWaitEvent)
         {
@@ -588,9 +722,79 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 }
 
 // Routine Description:
-// - Coalesces input events and transfers them to storage queue.
+// - Writes text to the input buffer, as if it had been typed. Wakes up any
+// readers that are waiting for additional input events.
+// - The text is stored as a single run instead of as key events. The key
+// events CharToKeyEvents would make for a character are only created when a
+// reader gets to that character, so a large paste doesn't cost a pair of
+// events per character up front, and stream readers never see the key ups.
+// Arguments:
+// - text - the text to store in the buffer.
+// - codepage - the codepage used to make key events for characters that
+// aren't on the keyboard.
+// Return Value:
+// - The number of characters that were written to input buffer.
+// Note:
+// - The console lock must be held when calling this routine.
+size_t InputBuffer::WriteString(const std::wstring_view text, const unsigned int codepage)
+{
+    try
+    {
+        if (text.empty())
+        {
+            return 0;
+        }
+
+        // VT input and a suspended console both need to look at each key as
+        // it's written, so the text goes in as key events for them.
+        const CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        if (IsInVirtualTerminalInputMode() || WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED))
+        {
+            std::vector<INPUT_RECORD> keyRecords;
+            for (const auto wch : text)
+            {
+                _AppendKeyRecords(wch, codepage, keyRecords);
+            }
+            Write(keyRecords);
+            return text.size();
+        }
+
+        const bool initiallyEmptyQueue = _storage.empty();
+
+        // Text written right after other text joins its run.
+        if (!_storage.empty() && _storage.back().EventType == TEXT_RUN_EVENT && _textRuns.back().codepage == codepage)
+        {
+            _textRuns.back().text.append(text);
+        }
+        else
+        {
+            _textRuns.push_back({ std::wstring{ text }, 0, codepage });
+            auto removeRun = wil::scope_exit([&]() { _textRuns.pop_back(); });
+            INPUT_RECORD marker{};
+            marker.EventType = TEXT_RUN_EVENT;
+            _storage.push_back(marker);
+            removeRun.release();
+        }
+
+        if (initiallyEmptyQueue)
+        {
+            ServiceLocator::LocateGlobals().hInputEvent.SetEvent();
+        }
+
+        WakeUpReadersWaitingForData();
+        return text.size();
+    }
+    catch (...)
+    {
+        LOG_HR(wil::ResultFromCaughtException());
+        return 0;
+    }
+}
+
+// Routine Description:
+// - Coalesces input records and transfers them to storage queue.
 // Arguments:
-// - inRecords - The events to store.
+// - inRecords - The records to store.
 // - eventsWritten - The number of events written since this function
 // was called.
 // - setWaitEvent - on exit, true if buffer became non-empty.
@@ -599,28 +803,32 @@ size_t InputBuffer::Write(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEv
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw on failure
-void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents,
+void InputBuffer::_WriteBuffer(const gsl::span<const INPUT_RECORD> inRecords,
                                _Out_ size_t& eventsWritten,
                                _Out_ bool& setWaitEvent)
 {
     eventsWritten = 0;
     setWaitEvent = false;
     const bool initiallyEmptyQueue = _storage.empty();
-    const size_t initialInEventsSize = inEvents.size();
     const bool vtInputMode = IsInVirtualTerminalInputMode();
 
-    while (!inEvents.empty())
+    for (const auto& inRecord : inRecords)
     {
-        // Pop the next event.
+        // Text run markers are only ever created by WriteString, along with
+        // their run. One written from the outside would have no run to read.
+        if (inRecord.EventType == TEXT_RUN_EVENT)
+        {
+            continue;
+        }
+
         // If we're in vt mode, try and handle it with the vt input module.
         // If it was handled, do nothing else for it.
-        // If there was one event passed in, try coalescing it with the previous event currently in the buffer.
+        // If there was one record passed in, try coalescing it with the previous record currently in the buffer.
         // If it's not coalesced, append it to the buffer.
-        std::unique_ptr<IInputEvent> inEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (vtInputMode)
+        if (vtInputMode && inRecord.EventType == KEY_EVENT)
         {
-            const bool handled = _termInput.HandleKey(inEvent.get());
+            const KeyEvent keyEvent{ inRecord.Event.KeyEvent };
+            const bool handled = _termInput.HandleKey(&keyEvent);
             if (handled)
             {
                 eventsWritten++;
@@ -632,42 +840,19 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
         // record at a time because this is the original behavior of
         // the input buffer. Changing this behavior may break stuff
         // that was depending on it.
-        if (initialInEventsSize == 1 && !_storage.empty())
+        //
+        // this looks kinda weird but we don't want to coalesce a
+        // mouse event and then try to coalesce a key event right after.
+        if (inRecords.size() == 1 &&
+            !_storage.empty() &&
+            (_CoalesceMouseMovedEvents(inRecord) || _CoalesceRepeatedKeyPressEvents(inRecord)))
         {
-            // coalescing requires a deque of events, so push it back onto the front.
-            inEvents.push_front(std::move(inEvent));
-
-            bool coalesced = false;
-            // this looks kinda weird but we don't want to coalesce a
-            // mouse event and then try to coalesce a key event right after.
-            //
-            // we also pass the whole deque to the coalescing methods
-            // even though they only want one event because it should
-            // be their responsibility to maintain the correct state
-            // of the deque if they process any records in it.
-            if (_CoalesceMouseMovedEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            else if (_CoalesceRepeatedKeyPressEvents(inEvents))
-            {
-                coalesced = true;
-            }
-            if (coalesced)
-            {
-                eventsWritten = 1;
-                return;
-            }
-            else
-            {
-                // We didn't coalesce the event. pull it from the queue again,
-                //  to keep the state consistent with the start of this block.
-                inEvent = std::move(inEvents.front());
-                inEvents.pop_front();
-            }
+            eventsWritten++;
+            continue;
         }
-        // At this point, the event was neither coalesced, nor processed by VT.
-        _storage.push_back(std::move(inEvent));
+
+        // At this point, the record was neither coalesced, nor processed by VT.
+        _storage.push_back(inRecord);
         ++eventsWritten;
     }
     if (initiallyEmptyQueue && !_storage.empty())
@@ -677,67 +862,53 @@ void InputBuffer::_WriteBuffer(_Inout_ std::deque<std::unique_ptr<IInputEvent>>&
 }
 
 // Routine Description:
-// - Checks if the last saved event and the first event of inRecords are
-// both MOUSE_MOVED events. If they are, the last saved event is
-// updated with the new mouse position and the first event of inRecords is
-// dropped.
+// - Checks if the last saved record and inRecord are both MOUSE_MOVED
+// events. If they are, the last saved record is updated in place with the
+// new mouse position.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - inRecord - The incoming record to process.
 // Return Value:
-// true if events were coalesced, false if they were not.
+// true if the records were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceMouseMovedEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+bool InputBuffer::_CoalesceMouseMovedEvents(const INPUT_RECORD& inRecord)
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
     FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::MouseEvent &&
-        pLastStoredEvent->EventType() == InputEventType::MouseEvent)
+    auto& lastRecord = _storage.back();
+    if (inRecord.EventType == MOUSE_EVENT &&
+        lastRecord.EventType == MOUSE_EVENT &&
+        inRecord.Event.MouseEvent.dwEventFlags == MOUSE_MOVED &&
+        lastRecord.Event.MouseEvent.dwEventFlags == MOUSE_MOVED)
     {
-        const MouseEvent* const pInMouseEvent = static_cast<const MouseEvent* const>(pFirstInEvent);
-        const MouseEvent* const pLastMouseEvent = static_cast<const MouseEvent* const>(pLastStoredEvent);
-
-        if (pInMouseEvent->IsMouseMoveEvent() &&
-            pLastMouseEvent->IsMouseMoveEvent())
-        {
-            // update mouse moved position
-            MouseEvent* const pMouseEvent = static_cast<MouseEvent* const>(_storage.back().release());
-            pMouseEvent->SetPosition(pInMouseEvent->GetPosition());
-            std::unique_ptr<IInputEvent> tempPtr(pMouseEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
-            return true;
-        }
+        // update mouse moved position
+        lastRecord.Event.MouseEvent.dwMousePosition = inRecord.Event.MouseEvent.dwMousePosition;
+        return true;
     }
     return false;
 }
 
 // Routine Description:
-// - checks two KeyEvents to see if they're similar enough to be coalesced
+// - checks two key event records to see if they're similar enough to be coalesced
 // Arguments:
-// - a - the first KeyEvent
-// - b - the other KeyEvent
+// - a - the first key event
+// - b - the other key event
 // Return Value:
 // - true if the events could be coalesced, false otherwise
-bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexcept
+bool InputBuffer::_CanCoalesce(const KEY_EVENT_RECORD& a, const KEY_EVENT_RECORD& b) const noexcept
 {
-    if (WI_IsFlagSet(a.GetActiveModifierKeys(), NLS_IME_CONVERSION) &&
-        a.GetCharData() == b.GetCharData() &&
-        a.GetActiveModifierKeys() == b.GetActiveModifierKeys())
+    if (WI_IsFlagSet(a.dwControlKeyState, NLS_IME_CONVERSION) &&
+        a.uChar.UnicodeChar == b.uChar.UnicodeChar &&
+        a.dwControlKeyState == b.dwControlKeyState)
     {
         return true;
     }
     // other key events check
-    else if (a.GetVirtualScanCode() == b.GetVirtualScanCode() &&
-             a.GetCharData() == b.GetCharData() &&
-             a.GetActiveModifierKeys() == b.GetActiveModifierKeys())
+    else if (a.wVirtualScanCode == b.wVirtualScanCode &&
+             a.uChar.UnicodeChar == b.uChar.UnicodeChar &&
+             a.dwControlKeyState == b.dwControlKeyState)
     {
         return true;
     }
@@ -745,44 +916,35 @@ bool InputBuffer::_CanCoalesce(const KeyEvent& a, const KeyEvent& b) const noexc
 }
 
 // Routine Description::
-// - If the last input event saved and the first input event in inRecords
-// are both a keypress down event for the same key, update the repeat
-// count of the saved event and drop the first from inRecords.
+// - If the last record saved and inRecord are both a keypress down event
+// for the same key, the repeat count of the saved record is updated in place.
 // Arguments:
-// - inRecords - The incoming records to process.
+// - inRecord - The incoming record to process.
 // Return Value:
-// true if events were coalesced, false if they were not.
+// true if the records were coalesced, false if they were not.
 // Note:
-// - The size of inRecords must be 1.
 // - Coalescing here means updating a record that already exists in
 // the buffer with updated values from an incoming event, instead of
 // storing the incoming event (which would make the original one
 // redundant/out of date with the most current state).
-bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+// - Text run markers aren't key events, so nothing is coalesced into them.
+bool InputBuffer::_CoalesceRepeatedKeyPressEvents(const INPUT_RECORD& inRecord)
 {
-    FAIL_FAST_IF(!(inEvents.size() == 1));
     FAIL_FAST_IF(_storage.empty());
-    const IInputEvent* const pFirstInEvent = inEvents.front().get();
-    const IInputEvent* const pLastStoredEvent = _storage.back().get();
-    if (pFirstInEvent->EventType() == InputEventType::KeyEvent &&
-        pLastStoredEvent->EventType() == InputEventType::KeyEvent)
-    {
-        const KeyEvent* const pInKeyEvent = static_cast<const KeyEvent* const>(pFirstInEvent);
-        const KeyEvent* const pLastKeyEvent = static_cast<const KeyEvent* const>(pLastStoredEvent);
-
-        if (pInKeyEvent->IsKeyDown() &&
-            pLastKeyEvent->IsKeyDown() &&
-            !IsGlyphFullWidth(pInKeyEvent->GetCharData()) &&
-            _CanCoalesce(*pInKeyEvent, *pLastKeyEvent))
+    auto& lastRecord = _storage.back();
+    if (inRecord.EventType == KEY_EVENT &&
+        lastRecord.EventType == KEY_EVENT)
+    {
+        const auto& inKey = inRecord.Event.KeyEvent;
+        auto& lastKey = lastRecord.Event.KeyEvent;
+
+        if (inKey.bKeyDown &&
+            lastKey.bKeyDown &&
+            !IsGlyphFullWidth(inKey.uChar.UnicodeChar) &&
+            _CanCoalesce(inKey, lastKey))
         {
             // increment repeat count
-            KeyEvent* const pKeyEvent = static_cast<KeyEvent* const>(_storage.back().release());
-            WORD repeatCount = pKeyEvent->GetRepeatCount() + pInKeyEvent->GetRepeatCount();
-            pKeyEvent->SetRepeatCount(repeatCount);
-            std::unique_ptr<IInputEvent> tempPtr(pKeyEvent);
-            tempPtr.swap(_storage.back());
-
-            inEvents.pop_front();
+            lastKey.wRepeatCount += inKey.wRepeatCount;
             return true;
         }
     }
@@ -792,42 +954,38 @@ bool InputBuffer::_CoalesceRepeatedKeyPressEvents(_Inout_ std::deque<std::unique
 // Routine Description:
 // - Handles records that suspend/resume the console.
 // Arguments:
-// - records - records to check for pause/unpause events
+// - inRecords - records to check for pause/unpause events. The ones handled here are removed.
 // Return Value:
 // - None
 // Note:
 // - The console lock must be held when calling this routine.
 // - will throw exception on error
-void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ std::deque<std::unique_ptr<IInputEvent>>& inEvents)
+void InputBuffer::_HandleConsoleSuspensionEvents(_Inout_ std::vector<INPUT_RECORD>& inRecords)
 {
     CONSOLE_INFORMATION& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
 
-    std::deque<std::unique_ptr<IInputEvent>> outEvents;
-    while (!inEvents.empty())
+    size_t kept = 0;
+    for (size_t i = 0; i < inRecords.size(); ++i)
     {
-        std::unique_ptr<IInputEvent> currEvent = std::move(inEvents.front());
-        inEvents.pop_front();
-        if (currEvent->EventType() == InputEventType::KeyEvent)
+        const auto record = til::at(inRecords, i);
+        if (record.EventType == KEY_EVENT && record.Event.KeyEvent.bKeyDown)
         {
-            const KeyEvent* const pKeyEvent = static_cast<const KeyEvent* const>(currEvent.get());
-            if (pKeyEvent->IsKeyDown())
+            if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
+                !IsSystemKey(record.Event.KeyEvent.wVirtualKeyCode))
             {
-                if (WI_IsFlagSet(gci.Flags, CONSOLE_SUSPENDED) &&
-                    !IsSystemKey(pKeyEvent->GetVirtualKeyCode()))
-                {
-                    UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
-                    continue;
-                }
-                else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && pKeyEvent->IsPauseKey())
-                {
-                    WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
-                    continue;
-                }
+                UnblockWriteConsole(CONSOLE_OUTPUT_SUSPENDED);
+                continue;
+            }
+            else if (WI_IsFlagSet(InputMode, ENABLE_LINE_INPUT) && record.Event.KeyEvent.wVirtualKeyCode == VK_PAUSE)
+            {
+                WI_SetFlag(gci.Flags, CONSOLE_SUSPENDED);
+                continue;
             }
         }
-        outEvents.push_back(std::move(currEvent));
+        til::at(inRecords, kept) = record;
+        ++kept;
     }
-    inEvents.swap(outEvents);
+    inRecords.resize(kept);
 }
 
 // Routine Description:
@@ -855,9 +1013,8 @@ void InputBuffer::_HandleTerminalInputCallback(std::deque<std::unique_ptr<IInput
         // add all input events to the storage queue
         while (!inEvents.empty())
         {
-            std::unique_ptr<IInputEvent> inEvent = std::move(inEvents.front());
+            _storage.push_back(inEvents.front()->ToInputRecord());
             inEvents.pop_front();
-            _storage.push_back(std::move(inEvent));
         }
 
         if (!_vtInputShouldSuppress)
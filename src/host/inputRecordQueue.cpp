@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "inputRecordQueue.hpp"
+
+bool InputRecordQueue::empty() const noexcept
+{
+    return _size == 0;
+}
+
+size_t InputRecordQueue::size() const noexcept
+{
+    return _size;
+}
+
+INPUT_RECORD& InputRecordQueue::operator[](const size_t index)
+{
+    FAIL_FAST_IF(index >= _size);
+    return til::at(_records, _Slot(index));
+}
+
+const INPUT_RECORD& InputRecordQueue::operator[](const size_t index) const
+{
+    FAIL_FAST_IF(index >= _size);
+    return til::at(_records, _Slot(index));
+}
+
+INPUT_RECORD& InputRecordQueue::front()
+{
+    return (*this)[0];
+}
+
+const INPUT_RECORD& InputRecordQueue::front() const
+{
+    return (*this)[0];
+}
+
+INPUT_RECORD& InputRecordQueue::back()
+{
+    FAIL_FAST_IF(_size == 0);
+    return (*this)[_size - 1];
+}
+
+const INPUT_RECORD& InputRecordQueue::back() const
+{
+    FAIL_FAST_IF(_size == 0);
+    return (*this)[_size - 1];
+}
+
+// Routine Description:
+// - Adds a record to the end of the queue.
+// Arguments:
+// - record - the record to add
+// Return Value:
+// - <none>
+// Note:
+// - will throw on failure
+void InputRecordQueue::push_back(const INPUT_RECORD& record)
+{
+    if (_size == _records.size())
+    {
+        _Grow();
+    }
+    til::at(_records, _Slot(_size)) = record;
+    ++_size;
+}
+
+// Routine Description:
+// - Adds a record to the front of the queue.
+// Arguments:
+// - record - the record to add
+// Return Value:
+// - <none>
+// Note:
+// - will throw on failure
+void InputRecordQueue::push_front(const INPUT_RECORD& record)
+{
+    if (_size == _records.size())
+    {
+        _Grow();
+    }
+    _head = (_head + _records.size() - 1) & (_records.size() - 1);
+    til::at(_records, _head) = record;
+    ++_size;
+}
+
+// Routine Description:
+// - Removes records from the front of the queue.
+// Arguments:
+// - count - the number of records to remove. Clamped to the size of the queue.
+// Return Value:
+// - <none>
+void InputRecordQueue::pop_front(const size_t count) noexcept
+{
+    const auto popped = std::min(count, _size);
+    _size -= popped;
+    _head = _size == 0 ? 0 : _Slot(popped);
+}
+
+// Routine Description:
+// - Removes all records. The allocation is kept for the records to come.
+void InputRecordQueue::clear() noexcept
+{
+    _head = 0;
+    _size = 0;
+}
+
+void InputRecordQueue::swap(InputRecordQueue& other) noexcept
+{
+    _records.swap(other._records);
+    std::swap(_head, other._head);
+    std::swap(_size, other._size);
+}
+
+// Routine Description:
+// - Appends a range of the queue to a vector of records, leaving the queue as it is.
+// Arguments:
+// - index - the index of the first record to copy
+// - count - the number of records to copy
+// - records - the vector to append the records to
+// Return Value:
+// - <none>
+// Note:
+// - will throw on failure
+void InputRecordQueue::copy_to(const size_t index, const size_t count, std::vector<INPUT_RECORD>& records) const
+{
+    FAIL_FAST_IF(index > _size || count > _size - index);
+    if (count == 0)
+    {
+        return;
+    }
+
+    // The range wraps around the end of the ring at most once.
+    const auto first = _Slot(index);
+    const auto firstCount = std::min(count, _records.size() - first);
+    const auto begin = _records.cbegin();
+    records.insert(records.end(),
+                   begin + gsl::narrow_cast<ptrdiff_t>(first),
+                   begin + gsl::narrow_cast<ptrdiff_t>(first + firstCount));
+    records.insert(records.end(),
+                   begin,
+                   begin + gsl::narrow_cast<ptrdiff_t>(count - firstCount));
+}
+
+// Routine Description:
+// - Finds the slot in _records of a record in the queue.
+// Arguments:
+// - index - the index of the record in the queue
+// Return Value:
+// - The index into _records.
+size_t InputRecordQueue::_Slot(const size_t index) const noexcept
+{
+    return (_head + index) & (_records.size() - 1);
+}
+
+// Routine Description:
+// - Doubles the capacity of the queue, moving the records to the start of the
+// new allocation.
+// Note:
+// - will throw on failure
+void InputRecordQueue::_Grow()
+{
+    const auto capacity = std::max(s_initialCapacity, _records.size() * 2);
+    std::vector<INPUT_RECORD> records;
+    records.reserve(capacity);
+    copy_to(0, _size, records);
+    records.resize(capacity);
+
+    _records.swap(records);
+    _head = 0;
+}
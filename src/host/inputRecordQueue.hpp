@@ -0,0 +1,72 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- inputRecordQueue.hpp
+
+Abstract:
+- A queue of INPUT_RECORDs, used as the storage of the input buffer.
+- The records are stored by value in a ring over a single allocation, which
+  doubles in size when it fills up. Writing and reading an event doesn't
+  allocate, events can be added at either end, and a range of events can be
+  copied out with at most two block copies.
+--*/
+
+#pragma once
+
+class InputRecordQueue final
+{
+public:
+    bool empty() const noexcept;
+    size_t size() const noexcept;
+
+    INPUT_RECORD& operator[](const size_t index);
+    const INPUT_RECORD& operator[](const size_t index) const;
+    INPUT_RECORD& front();
+    const INPUT_RECORD& front() const;
+    INPUT_RECORD& back();
+    const INPUT_RECORD& back() const;
+
+    void push_back(const INPUT_RECORD& record);
+    void push_front(const INPUT_RECORD& record);
+    void pop_front(const size_t count = 1) noexcept;
+    void clear() noexcept;
+    void swap(InputRecordQueue& other) noexcept;
+
+    void copy_to(const size_t index, const size_t count, std::vector<INPUT_RECORD>& records) const;
+
+    // Routine Description:
+    // - Removes all of the records the predicate is true for, keeping the
+    // order of the others.
+    template<typename Predicate>
+    void erase_if(Predicate predicate)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < _size; ++i)
+        {
+            const auto record = (*this)[i];
+            if (!predicate(record))
+            {
+                (*this)[kept] = record;
+                ++kept;
+            }
+        }
+        _size = kept;
+        if (_size == 0)
+        {
+            _head = 0;
+        }
+    }
+
+private:
+    size_t _Slot(const size_t index) const noexcept;
+    void _Grow();
+
+    static constexpr size_t s_initialCapacity = 16;
+
+    // The capacity is always 0 or a power of two, so a slot can be found with a mask.
+    std::vector<INPUT_RECORD> _records;
+    size_t _head = 0;
+    size_t _size = 0;
+};
@@ -195,12 +195,33 @@ bool ConhostInternalGetSet::PrivateWriteConsoleInputW(std::deque<std::unique_ptr
 {
     eventsWritten = 0;
 
+    // The responses to the queries of a client whose text is passed through
+    // come from the terminal, which got the queries too. Ours would be a second answer.
+    const auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+    if (gci.IsInVtIoMode() && gci.GetVtIo()->IsPassingThrough())
+    {
+        return true;
+    }
+
     return SUCCEEDED(DoSrvPrivateWriteConsoleInputW(_io.GetActiveInputBuffer(),
                                                     events,
                                                     eventsWritten,
                                                     true)); // append
 }
 
+// Routine Description:
+// - Writes a string to the end of the input buffer, as if it had been typed.
+// Arguments:
+// - string - the text to write
+// - codepage - the codepage used for characters that aren't on the keyboard
+// Return Value:
+// - true if the whole string was written. false otherwise.
+bool ConhostInternalGetSet::PrivateWriteConsoleInputString(const std::wstring_view string,
+                                                           const unsigned int codepage)
+{
+    return _io.GetActiveInputBuffer()->WriteString(string, codepage) == string.size();
+}
+
 // Routine Description:
 // - Connects the SetConsoleWindowInfo API call directly into our Driver Message servicing call inside Conhost.exe
 // Arguments:
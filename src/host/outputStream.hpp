@@ -67,6 +67,8 @@ public:
 
     bool PrivateWriteConsoleInputW(std::deque<std::unique_ptr<IInputEvent>>& events,
                                    size_t& eventsWritten) override;
+    bool PrivateWriteConsoleInputString(const std::wstring_view string,
+                                        const unsigned int codepage) override;
 
     bool SetConsoleWindowInfo(bool const absolute,
                               const SMALL_RECT& window) override;
@@ -354,6 +354,11 @@ const std::vector<size_t> RenderData::GetPatternId(const COORD /*location*/) con
     return {};
 }
 
+void RenderData::GetPatternIdRuns(const SHORT /*row*/, std::vector<Microsoft::Console::Render::PatternIdRun>& runs) const noexcept
+{
+    runs.clear();
+}
+
 // Routine Description:
 // - Converts a text attribute into the RGB values that should be presented, applying
 //   relevant table translation information and preferences.
@@ -60,6 +60,7 @@ public:
     const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept override;
 
     const std::vector<size_t> GetPatternId(const COORD location) const noexcept override;
+    void GetPatternIdRuns(const SHORT row, std::vector<Microsoft::Console::Render::PatternIdRun>& runs) const noexcept override;
 #pragma endregion
 
 #pragma region IUiaData
@@ -230,13 +230,13 @@ class AttrRowTests
         return HRESULT_FROM_NT(status);
     }
 
-    NoThrowString LogRunElement(_In_ TextAttributeRun& run)
+    NoThrowString LogRunElement(_In_ const TextAttributeRun& run)
     {
         return NoThrowString().Format(L"%wc%d", run.GetAttributes().GetLegacyAttributes(), run.GetLength());
     }
 
     void LogChain(_In_ PCWSTR pwszPrefix,
-                  std::vector<TextAttributeRun>& chain)
+                  const gsl::span<const TextAttributeRun> chain)
     {
         NoThrowString str(pwszPrefix);
 
@@ -732,4 +732,41 @@ class AttrRowTests
         state.CleanupGlobalScreenBuffer();
         state.CleanupGlobalFont();
     }
+
+    TEST_METHOD(TestHyperlinksOnlyWalkedWhenPresent)
+    {
+        HyperlinkRefCounts refs;
+        const TextAttribute plainAttr{ 0x7f };
+        TextAttribute linkAttr{ 0x7f };
+        linkAttr.SetHyperlinkId(1);
+
+        ATTR_ROW row{ 10, plainAttr, &refs };
+        VERIFY_IS_FALSE(row._mayHaveHyperlinks);
+
+        Log::Comment(L"Inserting plain runs into a plain row shouldn't mark it.");
+        const TextAttributeRun plainRun{ 2, TextAttribute{ 0x1f } };
+        VERIFY_SUCCEEDED(row.InsertAttrRuns({ &plainRun, 1 }, 3, 4, 10));
+        VERIFY_IS_FALSE(row._mayHaveHyperlinks);
+        VERIFY_IS_TRUE(refs.empty());
+
+        Log::Comment(L"Inserting a hyperlink marks the row and counts it.");
+        const TextAttributeRun linkRun{ 2, linkAttr };
+        VERIFY_SUCCEEDED(row.InsertAttrRuns({ &linkRun, 1 }, 6, 7, 10));
+        VERIFY_IS_TRUE(row._mayHaveHyperlinks);
+        VERIFY_ARE_EQUAL(1u, refs.at(1));
+
+        Log::Comment(L"Overwriting the hyperlink releases it and clears the mark.");
+        VERIFY_SUCCEEDED(row.InsertAttrRuns({ &plainRun, 1 }, 6, 7, 10));
+        VERIFY_IS_FALSE(row._mayHaveHyperlinks);
+        VERIFY_IS_TRUE(refs.empty());
+
+        Log::Comment(L"Replacing attributes with a hyperlink marks the row too.");
+        row.ReplaceAttrs(plainAttr, linkAttr);
+        VERIFY_IS_TRUE(row._mayHaveHyperlinks);
+        VERIFY_IS_TRUE(row.GetExclusiveHyperlinks() == std::vector<uint16_t>{ 1 });
+
+        row.Reset(plainAttr);
+        VERIFY_IS_FALSE(row._mayHaveHyperlinks);
+        VERIFY_IS_TRUE(refs.empty());
+    }
 };
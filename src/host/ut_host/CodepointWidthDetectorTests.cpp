@@ -8,6 +8,8 @@
 
 #include "../types/inc/CodepointWidthDetector.hpp"
 
+#include <chrono>
+
 using namespace WEX::Logging;
 
 static constexpr std::wstring_view emoji = L"\xD83E\xDD22"; // U+1F922 nauseated face
@@ -25,7 +27,16 @@ static const std::vector<std::tuple<unsigned int, std::wstring, CodepointWidth>>
     { 0x30CA, L"\x30CA", CodepointWidth::Wide }, // U+30CA katakana na
     { 0x72D7, L"\x72D7", CodepointWidth::Wide }, // U+72D7
     { 0x1F47E, L"\xD83D\xDC7E", CodepointWidth::Wide }, // U+1F47E alien monster
-    { 0x1F51C, L"\xD83D\xDD1C", CodepointWidth::Wide } // U+1F51C SOON
+    { 0x1F51C, L"\xD83D\xDD1C", CodepointWidth::Wide }, // U+1F51C SOON
+    { 0x10FF, L"\x10FF", CodepointWidth::Narrow }, // U+10FF georgian letter labial sign, right before a block of wide ones
+    { 0x1100, L"\x1100", CodepointWidth::Wide }, // U+1100 hangul choseong kiyeok, first of its block
+    { 0x115F, L"\x115F", CodepointWidth::Wide }, // U+115F hangul choseong filler, last wide one of its block
+    { 0x1160, L"\x1160", CodepointWidth::Narrow }, // U+1160 hangul jungseong filler
+    { 0x4E00, L"\x4E00", CodepointWidth::Wide }, // U+4E00 in a block that's wide throughout
+    { 0xFFFD, L"\xFFFD", CodepointWidth::Ambiguous }, // U+FFFD replacement character
+    { 0x20000, L"\xD840\xDC00", CodepointWidth::Wide }, // U+20000 first of the supplementary ideographic plane
+    { 0x2FFFE, L"\xD87F\xDFFE", CodepointWidth::Narrow }, // U+2FFFE noncharacter at the end of the plane
+    { 0x10FFFD, L"\xDBFF\xDFFD", CodepointWidth::Ambiguous } // U+10FFFD last private use codepoint
 };
 
 class CodepointWidthDetectorTests
@@ -91,11 +102,55 @@ class CodepointWidthDetectorTests
 
         // Cached item should match what we expect
         const auto it = widthDetector._fallbackCache.begin();
-        VERIFY_ARE_EQUAL(ambiguous, it->first);
+        VERIFY_ARE_EQUAL(0x414u, it->first);
         VERIFY_ARE_EQUAL(FallbackMethod(ambiguous), it->second);
 
+        // Looking it up again should hit the cache.
+        widthDetector.IsWide(ambiguous);
+        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+
+        // A glyph made of several codepoints must not be cached under its first one.
+        widthDetector._checkFallbackViaCache(L"\x415\x301");
+        VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+
         // Cache should empty when font changes.
         widthDetector.NotifyFontChanged();
         VERIFY_ARE_EQUAL(0u, widthDetector._fallbackCache.size());
     }
+
+    BEGIN_TEST_METHOD(BenchmarkWidthLookups)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
 };
+
+void CodepointWidthDetectorTests::BenchmarkWidthLookups()
+{
+    // A mix of what a terminal usually sees: ASCII, box drawing, CJK, ambiguous letters and emoji.
+    static constexpr std::array<std::wstring_view, 8> glyphs{
+        L"a", L"\x2500", L"\x306A", L"\x72D7", L"\xAC00", L"\x414", L"\xD83D\xDC7E", L"\xD840\xDC00"
+    };
+    static constexpr size_t iterations = 1000000;
+
+    CodepointWidthDetector widthDetector;
+    widthDetector.SetFallbackMethod(std::bind(&FallbackMethod, std::placeholders::_1));
+
+    size_t wide = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        if (widthDetector.IsWide(til::at(glyphs, i % glyphs.size())))
+        {
+            ++wide;
+        }
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    Log::Comment(NoThrowString().Format(L"%zu lookups in %lld us, %lld ns per lookup",
+                                        iterations,
+                                        elapsed.count() / 1000,
+                                        elapsed.count() / gsl::narrow_cast<long long>(iterations)));
+
+    // Only the ambiguous glyph goes to the fallback, and only once.
+    VERIFY_ARE_EQUAL(1u, widthDetector._fallbackCache.size());
+    VERIFY_ARE_NOT_EQUAL(0u, wide);
+}
@@ -12,6 +12,7 @@
 #include "../Settings.hpp"
 
 #include "CommonState.hpp"
+#include "_stream.h" // For DoWriteConsole
 
 using namespace WEX::Common;
 using namespace WEX::Logging;
@@ -119,6 +120,9 @@ class ConptyOutputTests
     TEST_METHOD(WriteTwoLinesUsesNewline);
     TEST_METHOD(WriteAFewSimpleLines);
     TEST_METHOD(InvalidateUntilOneBeforeEnd);
+    TEST_METHOD(PassthroughWritesTextAsIs);
+    TEST_METHOD(PassthroughNeedsNewlineWithoutReturn);
+    TEST_METHOD(PassthroughLeavesQueriesToTheTerminal);
 
 private:
     bool _writeCallback(const char* const pch, size_t const cch);
@@ -364,3 +368,141 @@ void ConptyOutputTests::InvalidateUntilOneBeforeEnd()
 
     VERIFY_SUCCEEDED(renderer.PaintFrame());
 }
+
+void ConptyOutputTests::PassthroughWritesTextAsIs()
+{
+    Log::Comment(NoThrowString().Format(
+        L"In passthrough mode, the text of a VT client is written to the "
+        L"terminal as it is, and not rendered again from the buffer."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tb = si.GetTextBuffer();
+    auto& vtIo = *gci.GetVtIo();
+
+    _flushFirstFrame();
+
+    const auto originalMode = si.OutputMode;
+    vtIo._passthroughMode = true;
+    auto restore = wil::scope_exit([&]() {
+        vtIo._passthroughMode = false;
+        si.OutputMode = originalMode;
+    });
+    WI_SetAllFlags(si.OutputMode, ENABLE_PROCESSED_OUTPUT | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN);
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"\x1b[31mHello\x1b[m World";
+    size_t seqCb = 2 * seq.size();
+    expectedOutput.push_back("\x1b[31mHello\x1b[m World");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+
+    {
+        auto iter = tb.GetCellDataAt({ 0, 0 });
+        _verifySpanOfText(L"H", iter, 0, 1);
+        _verifySpanOfText(L"e", iter, 0, 1);
+        _verifySpanOfText(L"l", iter, 0, 2);
+        _verifySpanOfText(L"o", iter, 0, 1);
+    }
+    VERIFY_ARE_EQUAL(COORD({ 11, 0 }), tb.GetCursor().GetPosition());
+
+    Log::Comment(L"The buffer changed, but there's nothing left to paint.");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    Log::Comment(L"Text of a client that doesn't emit VT is still rendered, "
+                 L"from where the passed through text left the cursor.");
+    WI_ClearFlag(si.OutputMode, ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    seq = L"!";
+    seqCb = 2 * seq.size();
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+
+    expectedOutput.push_back("\x1b[1;12H");
+    expectedOutput.push_back("!");
+    expectedOutput.push_back("\x1b[?25h");
+
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+}
+
+void ConptyOutputTests::PassthroughNeedsNewlineWithoutReturn()
+{
+    Log::Comment(NoThrowString().Format(
+        L"Without DISABLE_NEWLINE_AUTO_RETURN, a LF also returns the cursor in the "
+        L"buffer, but not in the terminal. That text is rendered from the buffer."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& tb = si.GetTextBuffer();
+    auto& vtIo = *gci.GetVtIo();
+
+    _flushFirstFrame();
+
+    const auto originalMode = si.OutputMode;
+    vtIo._passthroughMode = true;
+    auto restore = wil::scope_exit([&]() {
+        vtIo._passthroughMode = false;
+        si.OutputMode = originalMode;
+    });
+    WI_SetAllFlags(si.OutputMode, ENABLE_PROCESSED_OUTPUT | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    WI_ClearFlag(si.OutputMode, DISABLE_NEWLINE_AUTO_RETURN);
+
+    // Nothing is expected to be written here. The text isn't passed through.
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"AAA\nBBB";
+    size_t seqCb = 2 * seq.size();
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+
+    {
+        auto iter = tb.GetCellDataAt({ 0, 1 });
+        _verifySpanOfText(L"B", iter, 0, 3);
+    }
+    VERIFY_ARE_EQUAL(COORD({ 3, 1 }), tb.GetCursor().GetPosition());
+
+    expectedOutput.push_back("AAA");
+    expectedOutput.push_back("\r\n");
+    expectedOutput.push_back("BBB");
+
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+}
+
+void ConptyOutputTests::PassthroughLeavesQueriesToTheTerminal()
+{
+    Log::Comment(NoThrowString().Format(
+        L"A query in passed through text reaches the terminal, which answers it. "
+        L"We mustn't answer it a second time."));
+
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& renderer = *g.pRender;
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer();
+    auto& vtIo = *gci.GetVtIo();
+
+    _flushFirstFrame();
+    gci.pInputBuffer->Flush();
+
+    const auto originalMode = si.OutputMode;
+    vtIo._passthroughMode = true;
+    auto restore = wil::scope_exit([&]() {
+        vtIo._passthroughMode = false;
+        si.OutputMode = originalMode;
+    });
+    WI_SetAllFlags(si.OutputMode, ENABLE_PROCESSED_OUTPUT | ENABLE_VIRTUAL_TERMINAL_PROCESSING | DISABLE_NEWLINE_AUTO_RETURN);
+
+    std::unique_ptr<WriteData> waiter;
+    std::wstring seq = L"\x1b[6n\x1b[c";
+    size_t seqCb = 2 * seq.size();
+    expectedOutput.push_back("\x1b[6n\x1b[c");
+    VERIFY_SUCCEEDED(DoWriteConsole(&seq[0], &seqCb, si, false, waiter));
+
+    VERIFY_ARE_EQUAL(0u, gci.pInputBuffer->GetNumberOfReadyEvents());
+    VERIFY_IS_FALSE(vtIo.IsPassingThrough());
+
+    Log::Comment(L"Once the text is done, we answer queries again.");
+    si.GetStateMachine().ProcessString(L"\x1b[c");
+    VERIFY_ARE_NOT_EQUAL(0u, gci.pInputBuffer->GetNumberOfReadyEvents());
+    gci.pInputBuffer->Flush();
+
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+}
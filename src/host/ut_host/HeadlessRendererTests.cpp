@@ -0,0 +1,475 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "WexTestClass.h"
+#include "../../inc/consoletaeftemplates.hpp"
+
+#include "../../renderer/base/renderer.hpp"
+#include "../../renderer/base/HeadlessEngine.hpp"
+#include "../../renderer/inc/DummyRenderTarget.hpp"
+#include "../../types/IUiaData.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+
+// Render data that isn't backed by a console: a text buffer filled with
+// synthetic output, seen through a viewport that the tests can move.
+class SyntheticRenderData final : public IRenderData, IUiaData
+{
+public:
+    SyntheticRenderData(const COORD bufferSize, const COORD viewSize) :
+        _renderTarget{},
+        _buffer{ bufferSize, TextAttribute{}, 12, _renderTarget },
+        _viewport{ Viewport::FromDimensions({ 0, 0 }, viewSize) },
+        _colorTable{},
+        _cursorPosition{ 0, 0 }
+    {
+        for (size_t i = 0; i < _colorTable.size(); ++i)
+        {
+            const auto value = gsl::narrow_cast<BYTE>(i);
+            til::at(_colorTable, i) = RGB(value, 255 - value, value / 2);
+        }
+    }
+
+    TextBuffer& GetMutableTextBuffer() noexcept
+    {
+        return _buffer;
+    }
+
+    void SetViewport(const Viewport viewport) noexcept
+    {
+        _viewport = viewport;
+    }
+
+    void SetCursorPosition(const COORD position) noexcept
+    {
+        _cursorPosition = position;
+    }
+
+    static constexpr COLORREF DefaultForeground = RGB(204, 204, 204);
+    static constexpr COLORREF DefaultBackground = RGB(12, 12, 12);
+
+#pragma region IBaseData
+    Viewport GetViewport() noexcept override
+    {
+        return _viewport;
+    }
+
+    COORD GetTextBufferEndPosition() const noexcept override
+    {
+        return COORD{};
+    }
+
+    const TextBuffer& GetTextBuffer() noexcept override
+    {
+        return _buffer;
+    }
+
+    const FontInfo& GetFontInfo() noexcept override
+    {
+        FAIL_FAST_HR(E_NOTIMPL);
+    }
+
+    std::vector<Viewport> GetSelectionRects() noexcept override
+    {
+        return std::vector<Viewport>{};
+    }
+
+    void LockConsole() noexcept override
+    {
+    }
+
+    void UnlockConsole() noexcept override
+    {
+    }
+#pragma endregion
+
+#pragma region IRenderData
+    const TextAttribute GetDefaultBrushColors() noexcept override
+    {
+        return TextAttribute{};
+    }
+
+    std::pair<COLORREF, COLORREF> GetAttributeColors(const TextAttribute& attr) const noexcept override
+    {
+        return attr.CalculateRgbColors(_colorTable, DefaultForeground, DefaultBackground);
+    }
+
+    COORD GetCursorPosition() const noexcept override
+    {
+        return _cursorPosition;
+    }
+
+    bool IsCursorVisible() const noexcept override
+    {
+        return true;
+    }
+
+    bool IsCursorOn() const noexcept override
+    {
+        return true;
+    }
+
+    ULONG GetCursorHeight() const noexcept override
+    {
+        return 25ul;
+    }
+
+    CursorType GetCursorStyle() const noexcept override
+    {
+        return CursorType::Legacy;
+    }
+
+    ULONG GetCursorPixelWidth() const noexcept override
+    {
+        return 1ul;
+    }
+
+    COLORREF GetCursorColor() const noexcept override
+    {
+        return INVALID_COLOR;
+    }
+
+    bool IsCursorDoubleWidth() const override
+    {
+        return false;
+    }
+
+    bool IsScreenReversed() const noexcept override
+    {
+        return false;
+    }
+
+    const std::vector<RenderOverlay> GetOverlays() const noexcept override
+    {
+        return std::vector<RenderOverlay>{};
+    }
+
+    const bool IsGridLineDrawingAllowed() noexcept override
+    {
+        return true;
+    }
+
+    const std::wstring GetConsoleTitle() const noexcept override
+    {
+        return std::wstring{};
+    }
+
+    const std::wstring GetHyperlinkUri(uint16_t /*id*/) const noexcept override
+    {
+        return {};
+    }
+
+    const std::wstring GetHyperlinkCustomId(uint16_t /*id*/) const noexcept override
+    {
+        return {};
+    }
+
+    const std::vector<size_t> GetPatternId(const COORD /*location*/) const noexcept override
+    {
+        return {};
+    }
+
+    void GetPatternIdRuns(const SHORT /*row*/, std::vector<PatternIdRun>& runs) const noexcept override
+    {
+        runs.clear();
+    }
+#pragma endregion
+
+#pragma region IUiaData
+    const bool IsSelectionActive() const override
+    {
+        return false;
+    }
+
+    const bool IsBlockSelection() const noexcept override
+    {
+        return false;
+    }
+
+    void ClearSelection() override
+    {
+    }
+
+    void SelectNewRegion(const COORD /*coordStart*/, const COORD /*coordEnd*/) override
+    {
+    }
+
+    const COORD GetSelectionAnchor() const noexcept override
+    {
+        return COORD{};
+    }
+
+    const COORD GetSelectionEnd() const noexcept override
+    {
+        return COORD{};
+    }
+
+    void ColorSelection(const COORD /*coordSelectionStart*/, const COORD /*coordSelectionEnd*/, const TextAttribute /*attr*/) override
+    {
+    }
+#pragma endregion
+
+private:
+    DummyRenderTarget _renderTarget;
+    TextBuffer _buffer;
+    Viewport _viewport;
+    std::array<COLORREF, 256> _colorTable;
+    COORD _cursorPosition;
+};
+
+class HeadlessRendererTests
+{
+    TEST_CLASS(HeadlessRendererTests);
+
+    TEST_METHOD(PaintsBufferIntoGrid);
+    TEST_METHOD(PaintsEveryAttributeRunOfARow);
+    TEST_METHOD(BenchmarkFullFrames);
+    TEST_METHOD(BenchmarkScrollingFrames);
+
+    // Every row of the synthetic output is made of runs of this many cells,
+    // each in a different color, and every other one underlined.
+    static constexpr SHORT RunLength = 10;
+
+    static std::wstring s_RowText(const SHORT row, const SHORT width)
+    {
+        std::wstring text;
+        for (SHORT column = 0; column < width; ++column)
+        {
+            text.push_back(gsl::narrow_cast<wchar_t>(L'a' + (row + column) % 26));
+        }
+        return text;
+    }
+
+    static TextAttribute s_RunAttributes(const SHORT run)
+    {
+        TextAttribute attr;
+        attr.SetIndexedForeground256(gsl::narrow_cast<BYTE>(run % 16 + 1));
+        attr.SetUnderlined(run % 2 == 1);
+        return attr;
+    }
+
+    static void s_FillSyntheticOutput(TextBuffer& buffer)
+    {
+        const auto size = buffer.GetSize();
+        for (SHORT row = 0; row < size.Height(); ++row)
+        {
+            const auto text = s_RowText(row, size.Width());
+            for (SHORT column = 0; column < size.Width(); column += RunLength)
+            {
+                const auto length = std::min<size_t>(RunLength, text.size() - column);
+                const std::wstring_view run{ text.data() + column, length };
+                buffer.WriteLine(OutputCellIterator{ run, s_RunAttributes(gsl::narrow_cast<SHORT>(column / RunLength)) }, { column, row });
+            }
+        }
+    }
+
+    static void s_LogFrameTimes(const wchar_t* const name, std::vector<std::chrono::microseconds> frameTimes)
+    {
+        std::sort(frameTimes.begin(), frameTimes.end());
+        std::chrono::microseconds total{};
+        for (const auto frameTime : frameTimes)
+        {
+            total += frameTime;
+        }
+        Log::Comment(NoThrowString().Format(L"%s: %zu frames, mean %lld us, median %lld us, max %lld us",
+                                            name,
+                                            frameTimes.size(),
+                                            total.count() / gsl::narrow_cast<long long>(frameTimes.size()),
+                                            frameTimes.at(frameTimes.size() / 2).count(),
+                                            frameTimes.back().count()));
+    }
+};
+
+void HeadlessRendererTests::PaintsBufferIntoGrid()
+{
+    Log::Comment(L"Paint a frame of text, colors, a wide glyph and gridlines, and check that the engine got all of it.");
+
+    const COORD size{ 20, 4 };
+    SyntheticRenderData data{ size, size };
+    auto& buffer = data.GetMutableTextBuffer();
+
+    TextAttribute red;
+    red.SetIndexedForeground(FOREGROUND_RED);
+    buffer.WriteLine(OutputCellIterator{ L"Hello", red }, { 0, 0 });
+
+    // HIRAGANA LETTER KA takes two columns.
+    buffer.WriteLine(OutputCellIterator{ L"a\x304b" L"b" }, { 0, 1 });
+
+    TextAttribute underlined;
+    underlined.SetUnderlined(true);
+    buffer.WriteLine(OutputCellIterator{ L"line", underlined }, { 2, 2 });
+
+    data.SetCursorPosition({ 3, 3 });
+
+    HeadlessEngine engine{ Viewport::FromDimensions({ 0, 0 }, size) };
+    IRenderEngine* engines[]{ &engine };
+    Renderer renderer{ &data, engines, 1, nullptr };
+
+    renderer.TriggerRedrawAll();
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    VERIFY_ARE_EQUAL(1u, engine.GetStatistics().frames);
+    VERIFY_IS_TRUE(engine.GetDirtyArea().empty());
+
+    VERIFY_ARE_EQUAL(std::wstring{ L"Hello" } + std::wstring(15, L' '), engine.GetRowText(0));
+    VERIFY_ARE_EQUAL(data.GetAttributeColors(red).first, engine.GetCell({ 0, 0 }).foreground);
+    VERIFY_ARE_EQUAL(data.GetAttributeColors(red).first, engine.GetCell({ 4, 0 }).foreground);
+    VERIFY_ARE_EQUAL(SyntheticRenderData::DefaultBackground, engine.GetCell({ 4, 0 }).background);
+    VERIFY_ARE_EQUAL(SyntheticRenderData::DefaultBackground, engine.GetCell({ 5, 0 }).background);
+
+    VERIFY_ARE_EQUAL(std::wstring{ L"a\x304b" L"b" } + std::wstring(16, L' '), engine.GetRowText(1));
+    VERIFY_ARE_EQUAL(std::wstring{ L"\x304b" }, engine.GetCell({ 1, 1 }).text);
+    VERIFY_IS_TRUE(engine.GetCell({ 2, 1 }).text.empty());
+
+    VERIFY_IS_TRUE(engine.GetCell({ 1, 2 }).gridLines == IRenderEngine::GridLines::None);
+    VERIFY_IS_TRUE(engine.GetCell({ 2, 2 }).gridLines == IRenderEngine::GridLines::Underline);
+    VERIFY_IS_TRUE(engine.GetCell({ 5, 2 }).gridLines == IRenderEngine::GridLines::Underline);
+    VERIFY_IS_TRUE(engine.GetCell({ 6, 2 }).gridLines == IRenderEngine::GridLines::None);
+
+    VERIFY_IS_TRUE(engine.GetCursorPosition().has_value());
+    VERIFY_ARE_EQUAL((COORD{ 3, 3 }), engine.GetCursorPosition().value());
+
+    Log::Comment(L"Nothing changed, so there's nothing to paint in the next frame.");
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    VERIFY_ARE_EQUAL(1u, engine.GetStatistics().frames);
+}
+
+void HeadlessRendererTests::PaintsEveryAttributeRunOfARow()
+{
+    Log::Comment(L"Paint rows made of several attribute runs, and check that every cell got the colors and gridlines of its own run.");
+
+    const COORD size{ 40, 3 };
+    SyntheticRenderData data{ size, size };
+    auto& buffer = data.GetMutableTextBuffer();
+    s_FillSyntheticOutput(buffer);
+
+    // Runs of 3, 4 and 5 cells, the middle one with a wide glyph in it.
+    buffer.WriteLine(OutputCellIterator{ L"abc", s_RunAttributes(1) }, { 0, 2 });
+    buffer.WriteLine(OutputCellIterator{ L"d\x304b" L"e", s_RunAttributes(2) }, { 3, 2 });
+    buffer.WriteLine(OutputCellIterator{ L"fghij", s_RunAttributes(3) }, { 7, 2 });
+
+    HeadlessEngine engine{ Viewport::FromDimensions({ 0, 0 }, size) };
+    IRenderEngine* engines[]{ &engine };
+    Renderer renderer{ &data, engines, 1, nullptr };
+
+    renderer.TriggerRedrawAll();
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+
+    const auto verifyCell = [&](const COORD coord, const TextAttribute& attr) {
+        const auto& cell = engine.GetCell(coord);
+        VERIFY_ARE_EQUAL(data.GetAttributeColors(attr).first, cell.foreground);
+        const auto lines = attr.IsUnderlined() ? IRenderEngine::GridLines::Underline : IRenderEngine::GridLines::None;
+        VERIFY_IS_TRUE(cell.gridLines == lines);
+    };
+
+    for (SHORT row = 0; row < 2; ++row)
+    {
+        for (SHORT column = 0; column < size.X; ++column)
+        {
+            verifyCell({ column, row }, s_RunAttributes(column / RunLength));
+        }
+    }
+
+    const SHORT runEnds[]{ 3, 7, 12 };
+    for (SHORT column = 0; column < runEnds[2]; ++column)
+    {
+        const auto run = gsl::narrow_cast<SHORT>(std::upper_bound(std::begin(runEnds), std::end(runEnds), column) - std::begin(runEnds));
+        verifyCell({ column, 2 }, s_RunAttributes(run + 1));
+    }
+    verifyCell({ runEnds[2], 2 }, s_RunAttributes(1));
+}
+
+void HeadlessRendererTests::BenchmarkFullFrames()
+{
+    Log::Comment(L"Repaint a whole screen of colored output, and measure how long each frame takes.");
+
+    const COORD size{ 120, 30 };
+    SyntheticRenderData data{ size, size };
+    s_FillSyntheticOutput(data.GetMutableTextBuffer());
+
+    HeadlessEngine engine{ Viewport::FromDimensions({ 0, 0 }, size) };
+    IRenderEngine* engines[]{ &engine };
+    Renderer renderer{ &data, engines, 1, nullptr };
+
+    // Warm up, so that the buffers the renderer keeps between frames are allocated.
+    renderer.TriggerRedrawAll();
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    engine.ResetStatistics();
+
+    const size_t frames = 200;
+    std::vector<std::chrono::microseconds> frameTimes;
+    frameTimes.reserve(frames);
+
+    for (size_t i = 0; i < frames; ++i)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        renderer.TriggerRedrawAll();
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        frameTimes.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+    s_LogFrameTimes(L"Full frames", std::move(frameTimes));
+
+    Log::Comment(L"Every frame paints every run of every row once: the renderer mustn't split or merge them.");
+    const auto runsPerFrame = gsl::narrow_cast<size_t>(size.Y * (size.X / RunLength));
+    const auto stats = engine.GetStatistics();
+    VERIFY_ARE_EQUAL(frames, stats.frames);
+    VERIFY_ARE_EQUAL(frames * runsPerFrame, stats.lines);
+    VERIFY_ARE_EQUAL(frames * gsl::narrow_cast<size_t>(size.X * size.Y), stats.clusters);
+    VERIFY_ARE_EQUAL(frames * (runsPerFrame + 1), stats.brushes);
+    VERIFY_ARE_EQUAL(frames * runsPerFrame / 2, stats.gridLines);
+
+    for (SHORT row = 0; row < size.Y; ++row)
+    {
+        VERIFY_ARE_EQUAL(s_RowText(row, size.X), engine.GetRowText(row));
+    }
+}
+
+void HeadlessRendererTests::BenchmarkScrollingFrames()
+{
+    Log::Comment(L"Scroll the viewport down through colored output a row at a time, and measure how long each frame takes.");
+
+    const COORD bufferSize{ 120, 300 };
+    const COORD viewSize{ 120, 30 };
+    SyntheticRenderData data{ bufferSize, viewSize };
+    s_FillSyntheticOutput(data.GetMutableTextBuffer());
+
+    HeadlessEngine engine{ Viewport::FromDimensions({ 0, 0 }, viewSize) };
+    IRenderEngine* engines[]{ &engine };
+    Renderer renderer{ &data, engines, 1, nullptr };
+
+    renderer.TriggerRedrawAll();
+    VERIFY_SUCCEEDED(renderer.PaintFrame());
+    engine.ResetStatistics();
+
+    const SHORT frames = bufferSize.Y - viewSize.Y;
+    std::vector<std::chrono::microseconds> frameTimes;
+    frameTimes.reserve(frames);
+
+    for (SHORT top = 1; top <= frames; ++top)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        data.SetViewport(Viewport::FromDimensions({ 0, top }, viewSize));
+        VERIFY_SUCCEEDED(renderer.PaintFrame());
+        frameTimes.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+    s_LogFrameTimes(L"Scrolling frames", std::move(frameTimes));
+
+    Log::Comment(L"Every frame only paints the row that scrolled into view.");
+    const auto runsPerRow = gsl::narrow_cast<size_t>(viewSize.X / RunLength);
+    const auto stats = engine.GetStatistics();
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<size_t>(frames), stats.frames);
+    VERIFY_ARE_EQUAL(gsl::narrow_cast<size_t>(frames) * runsPerRow, stats.lines);
+
+    for (SHORT row = 0; row < viewSize.Y; ++row)
+    {
+        VERIFY_ARE_EQUAL(s_RowText(gsl::narrow_cast<SHORT>(frames + row), viewSize.X), engine.GetRowText(row));
+    }
+}
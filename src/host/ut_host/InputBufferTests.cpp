@@ -8,7 +8,9 @@
 
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../types/inc/IInputEvent.hpp"
+#include "../types/inc/convert.hpp"
 
+using namespace WEX::Common;
 using namespace WEX::Logging;
 using Microsoft::Console::Interactivity::ServiceLocator;
 
@@ -78,7 +80,7 @@ class InputBufferTests
             INPUT_RECORD record;
             record.EventType = MENU_EVENT;
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back()->ToInputRecord());
+            VERIFY_ARE_EQUAL(record, inputBuffer._storage.back());
         }
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT);
     }
@@ -98,7 +100,7 @@ class InputBufferTests
         // verify that the events are the same in storage
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i]->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i], record);
         }
     }
 
@@ -121,10 +123,9 @@ class InputBufferTests
         // check that they coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 1u);
         // check that the mouse position is being updated correctly
-        const IInputEvent* const pOutEvent = inputBuffer._storage.front().get();
-        const MouseEvent* const pMouseEvent = static_cast<const MouseEvent* const>(pOutEvent);
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().X, static_cast<SHORT>(RECORD_INSERT_COUNT));
-        VERIFY_ARE_EQUAL(pMouseEvent->GetPosition().Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
+        const auto& position = inputBuffer._storage.front().Event.MouseEvent.dwMousePosition;
+        VERIFY_ARE_EQUAL(position.X, static_cast<SHORT>(RECORD_INSERT_COUNT));
+        VERIFY_ARE_EQUAL(position.Y, static_cast<SHORT>(RECORD_INSERT_COUNT * 2));
 
         // add a key event and another mouse event to make sure that
         // an event between two mouse events stopped the coalescing.
@@ -162,10 +163,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), mouseRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front(), mouseRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), mouseRecords[i]);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1], mouseRecords[i]);
         }
     }
 
@@ -221,10 +222,10 @@ class InputBufferTests
         // no events should have been coalesced
         VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), RECORD_INSERT_COUNT + 1);
         // check that the events stored match those inserted
-        VERIFY_ARE_EQUAL(inputBuffer._storage.front()->ToInputRecord(), keyRecords[0]);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front(), keyRecords[0]);
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
-            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1]->ToInputRecord(), keyRecords[i]);
+            VERIFY_ARE_EQUAL(inputBuffer._storage[i + 1], keyRecords[i]);
         }
     }
 
@@ -239,7 +240,7 @@ class InputBufferTests
         for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
         {
             VERIFY_IS_GREATER_THAN(inputBuffer.Write(IInputEvent::Create(record)), 0u);
-            VERIFY_ARE_EQUAL(inputBuffer._storage.back()->ToInputRecord(), record);
+            VERIFY_ARE_EQUAL(inputBuffer._storage.back(), record);
         }
 
         // The events shouldn't be coalesced
@@ -382,10 +383,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read one record, make sure ResetWaitEvent isn't set
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        std::vector<INPUT_RECORD> outRecords;
         size_t eventsRead = 0;
         bool resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 1,
                                 eventsRead,
                                 false,
@@ -396,8 +397,8 @@ class InputBufferTests
         VERIFY_IS_FALSE(!!resetWaitEvent);
 
         // read the rest, resetWaitEvent should be set to true
-        outEvents.clear();
-        inputBuffer._ReadBuffer(outEvents,
+        outRecords.clear();
+        inputBuffer._ReadBuffer(outRecords,
                                 RECORD_INSERT_COUNT - 1,
                                 eventsRead,
                                 false,
@@ -431,10 +432,10 @@ class InputBufferTests
         VERIFY_IS_GREATER_THAN(inputBuffer.Write(inEvents), 0u);
 
         // read them out non-unicode style and compare
-        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        std::vector<INPUT_RECORD> outRecords;
         size_t eventsRead = 0;
         bool resetWaitEvent = false;
-        inputBuffer._ReadBuffer(outEvents,
+        inputBuffer._ReadBuffer(outRecords,
                                 recordInsertCount,
                                 eventsRead,
                                 false,
@@ -444,10 +445,10 @@ class InputBufferTests
         // the dbcs record should have counted for two elements in
         // the array, making it so that we get less events read
         VERIFY_ARE_EQUAL(eventsRead, recordInsertCount - 1);
-        VERIFY_ARE_EQUAL(eventsRead, outEvents.size());
+        VERIFY_ARE_EQUAL(eventsRead, outRecords.size());
         for (size_t i = 0; i < eventsRead; ++i)
         {
-            VERIFY_ARE_EQUAL(outEvents[i]->ToInputRecord(), inRecords[i]);
+            VERIFY_ARE_EQUAL(outRecords[i], inRecords[i]);
         }
     }
 
@@ -589,22 +590,17 @@ class InputBufferTests
     {
         InputBuffer inputBuffer;
         INPUT_RECORD record = MakeKeyEvent(true, 1, L'a', 0, L'a', 0);
-        std::unique_ptr<IInputEvent> inputEvent = IInputEvent::Create(record);
         size_t eventsWritten;
         bool waitEvent = false;
         inputBuffer.Flush();
         // write one event to an empty buffer
-        std::deque<std::unique_ptr<IInputEvent>> storage;
-        storage.push_back(std::move(inputEvent));
-        inputBuffer._WriteBuffer(storage, eventsWritten, waitEvent);
+        inputBuffer._WriteBuffer({ &record, 1 }, eventsWritten, waitEvent);
         VERIFY_IS_TRUE(waitEvent);
         // write another, it shouldn't signal this time
         INPUT_RECORD record2 = MakeKeyEvent(true, 1, L'b', 0, L'b', 0);
-        std::unique_ptr<IInputEvent> inputEvent2 = IInputEvent::Create(record2);
         // write another event to a non-empty buffer
         waitEvent = false;
-        storage.push_back(std::move(inputEvent2));
-        inputBuffer._WriteBuffer(storage, eventsWritten, waitEvent);
+        inputBuffer._WriteBuffer({ &record2, 1 }, eventsWritten, waitEvent);
 
         VERIFY_IS_FALSE(waitEvent);
     }
@@ -625,7 +621,7 @@ class InputBufferTests
                                                  true));
         VERIFY_ARE_EQUAL(outEvents.size(), 1u);
         VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount - 1);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount - 1);
         VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
     }
 
@@ -645,7 +641,331 @@ class InputBufferTests
                                                  true));
         VERIFY_ARE_EQUAL(outEvents.size(), 1u);
         VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
-        VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*inputBuffer._storage.front()).GetRepeatCount(), repeatCount);
+        VERIFY_ARE_EQUAL(inputBuffer._storage.front().Event.KeyEvent.wRepeatCount, repeatCount);
         VERIFY_ARE_EQUAL(static_cast<const KeyEvent&>(*outEvents.front()).GetRepeatCount(), 1u);
     }
+
+    TEST_METHOD(WrittenStringIsReadAsKeyEvents)
+    {
+        InputBuffer inputBuffer;
+        const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+        const std::wstring_view text{ L"ab\r" };
+
+        std::deque<std::unique_ptr<IInputEvent>> expectedEvents;
+        for (const auto wch : text)
+        {
+            auto keyEvents = CharToKeyEvents(wch, codepage);
+            std::move(keyEvents.begin(), keyEvents.end(), std::back_inserter(expectedEvents));
+        }
+
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(text, codepage), text.size());
+        Log::Comment(L"The text should be stored as one run, counted as a key down and up per character");
+        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), text.size() * 2);
+
+        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
+                                                 expectedEvents.size(),
+                                                 false,
+                                                 false,
+                                                 true,
+                                                 false));
+        VERIFY_ARE_EQUAL(expectedEvents.size(), outEvents.size());
+        for (size_t i = 0; i < expectedEvents.size(); ++i)
+        {
+            VERIFY_ARE_EQUAL(expectedEvents[i]->ToInputRecord(), outEvents[i]->ToInputRecord());
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+        VERIFY_IS_TRUE(inputBuffer._textRuns.empty());
+    }
+
+    TEST_METHOD(WrittenStringKeepsItsPlaceInTheQueue)
+    {
+        InputBuffer inputBuffer;
+        const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+        INPUT_RECORD menuRecord;
+        menuRecord.EventType = MENU_EVENT;
+
+        VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(menuRecord)), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(L"ab", codepage), 2u);
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(L"c", codepage), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(menuRecord)), 1u);
+
+        Log::Comment(L"Text written back to back should join the same run");
+        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 3u);
+        VERIFY_ARE_EQUAL(inputBuffer._textRuns.size(), 1u);
+
+        Log::Comment(L"Flushing all but keys should keep the text");
+        inputBuffer.FlushAllButKeys();
+        VERIFY_ARE_EQUAL(inputBuffer._storage.size(), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.Write(IInputEvent::Create(menuRecord)), 1u);
+
+        std::deque<std::unique_ptr<IInputEvent>> outEvents;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvents,
+                                                 RECORD_INSERT_COUNT,
+                                                 false,
+                                                 false,
+                                                 true,
+                                                 false));
+        VERIFY_IS_FALSE(outEvents.empty());
+        VERIFY_ARE_EQUAL(outEvents.back()->ToInputRecord(), menuRecord);
+        outEvents.pop_back();
+
+        std::wstring typed;
+        for (const auto& outEvent : outEvents)
+        {
+            VERIFY_ARE_EQUAL(outEvent->EventType(), InputEventType::KeyEvent);
+            const auto& keyEvent = static_cast<const KeyEvent&>(*outEvent);
+            if (keyEvent.IsKeyDown() && keyEvent.GetCharData() != 0)
+            {
+                typed.push_back(keyEvent.GetCharData());
+            }
+        }
+        VERIFY_ARE_EQUAL(String(L"abc"), String(typed.c_str()));
+    }
+
+    TEST_METHOD(StreamReadingWrittenStringSkipsKeyUps)
+    {
+        InputBuffer inputBuffer;
+        const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+        const std::wstring_view text{ L"ab" };
+
+        VERIFY_ARE_EQUAL(inputBuffer.WriteString(text, codepage), text.size());
+        for (const auto wch : text)
+        {
+            std::unique_ptr<IInputEvent> outEvent;
+            VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outEvent, false, false, true, true));
+            VERIFY_IS_NOT_NULL(outEvent.get());
+            const auto& keyEvent = static_cast<const KeyEvent&>(*outEvent);
+            VERIFY_IS_TRUE(keyEvent.IsKeyDown());
+            VERIFY_ARE_EQUAL(wch, keyEvent.GetCharData());
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
+
+    TEST_METHOD(WrittenRecordsCantBeTextRuns)
+    {
+        InputBuffer inputBuffer;
+        INPUT_RECORD markerRecord{};
+        markerRecord.EventType = InputBuffer::TEXT_RUN_EVENT;
+        const auto keyRecord = MakeKeyEvent(TRUE, 1, L'a', 0, L'a', 0);
+
+        Log::Comment(L"A text run marker without a run should be dropped, while the records around it are kept");
+        const std::vector<INPUT_RECORD> records{ markerRecord, keyRecord, markerRecord };
+        VERIFY_ARE_EQUAL(inputBuffer.Write(records), 1u);
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 1u);
+        VERIFY_IS_TRUE(inputBuffer._textRuns.empty());
+
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, RECORD_INSERT_COUNT, false, false, true, false));
+        VERIFY_ARE_EQUAL(outRecords.size(), 1u);
+        VERIFY_ARE_EQUAL(outRecords.front(), keyRecord);
+    }
+
+    TEST_METHOD(StorageKeepsOrderWhenItWrapsAround)
+    {
+        InputBuffer inputBuffer;
+        std::vector<INPUT_RECORD> expected;
+        const auto makeRecord = [this](const size_t i) {
+            return MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'A' + i % 26), 0, static_cast<WCHAR>(L'A' + i % 26), 0);
+        };
+
+        Log::Comment(L"Fill the storage, then read from the front and write more so the records wrap around its end");
+        size_t next = 0;
+        for (; next < RECORD_INSERT_COUNT; ++next)
+        {
+            expected.push_back(makeRecord(next));
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Write(expected), RECORD_INSERT_COUNT);
+
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, RECORD_INSERT_COUNT / 2, false, false, true, false));
+        VERIFY_ARE_EQUAL(outRecords.size(), RECORD_INSERT_COUNT / 2);
+        expected.erase(expected.begin(), expected.begin() + RECORD_INSERT_COUNT / 2);
+
+        std::vector<INPUT_RECORD> moreRecords;
+        for (; next < RECORD_INSERT_COUNT * 2; ++next)
+        {
+            moreRecords.push_back(makeRecord(next));
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Write(moreRecords), moreRecords.size());
+        expected.insert(expected.end(), moreRecords.begin(), moreRecords.end());
+
+        Log::Comment(L"Prepend records too, so the front moves backwards past the start of the storage");
+        std::deque<std::unique_ptr<IInputEvent>> prependEvents;
+        std::vector<INPUT_RECORD> prependRecords;
+        for (size_t i = 0; i < RECORD_INSERT_COUNT; ++i)
+        {
+            prependRecords.push_back(MakeKeyEvent(TRUE, 1, static_cast<WCHAR>(L'a' + i), 0, static_cast<WCHAR>(L'a' + i), 0));
+            prependEvents.push_back(IInputEvent::Create(prependRecords.back()));
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.Prepend(prependEvents), RECORD_INSERT_COUNT);
+        expected.insert(expected.begin(), prependRecords.begin(), prependRecords.end());
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), expected.size());
+
+        Log::Comment(L"A peek and a read should both see every record in order");
+        for (const auto peek : { true, false })
+        {
+            outRecords.clear();
+            VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, expected.size(), peek, false, true, false));
+            VERIFY_ARE_EQUAL(expected.size(), outRecords.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                VERIFY_ARE_EQUAL(expected[i], outRecords[i]);
+            }
+        }
+        VERIFY_ARE_EQUAL(inputBuffer.GetNumberOfReadyEvents(), 0u);
+    }
+
+    BEGIN_TEST_METHOD(PasteThroughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(InputEventThroughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
 };
+
+// Pastes a megabyte of text into the input buffer, once as the key events
+// CharToKeyEvents makes for every character and once with WriteString, and
+// reads it back the way cooked reads do, one character at a time.
+void InputBufferTests::PasteThroughput()
+{
+    static constexpr std::wstring_view line{ L"The quick brown fox jumps over the lazy dog. 0123456789\r" };
+    static constexpr size_t pasteSize = 1024 * 1024;
+    const auto codepage = ServiceLocator::LocateGlobals().getConsoleInformation().OutputCP;
+
+    std::wstring text;
+    while (text.size() < pasteSize)
+    {
+        text.append(line);
+    }
+
+    const auto readAll = [](InputBuffer& inputBuffer) {
+        size_t charsRead = 0;
+        for (;;)
+        {
+            std::unique_ptr<IInputEvent> outEvent;
+            const auto status = inputBuffer.Read(outEvent, false, false, true, true);
+            if (!NT_SUCCESS(status) || !outEvent)
+            {
+                break;
+            }
+            const auto& keyEvent = static_cast<const KeyEvent&>(*outEvent);
+            if (keyEvent.IsKeyDown() && keyEvent.GetCharData() != 0)
+            {
+                ++charsRead;
+            }
+        }
+        return charsRead;
+    };
+
+    const auto measure = [&](const wchar_t* const name, const auto write) {
+        InputBuffer inputBuffer;
+        const auto start = std::chrono::steady_clock::now();
+        write(inputBuffer);
+        const auto written = std::chrono::steady_clock::now();
+        const auto charsRead = readAll(inputBuffer);
+        const auto read = std::chrono::steady_clock::now();
+
+        VERIFY_ARE_EQUAL(text.size(), charsRead);
+        Log::Comment(NoThrowString().Format(L"%s: wrote %zu characters in %lld ms, read them in %lld ms",
+                                            name,
+                                            text.size(),
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(written - start).count(),
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(read - written).count()));
+    };
+
+    measure(L"Key events", [&](InputBuffer& inputBuffer) {
+        std::deque<std::unique_ptr<IInputEvent>> keyEvents;
+        for (const auto wch : text)
+        {
+            auto convertedEvents = CharToKeyEvents(wch, codepage);
+            std::move(convertedEvents.begin(), convertedEvents.end(), std::back_inserter(keyEvents));
+        }
+        inputBuffer.Write(keyEvents);
+    });
+
+    measure(L"Text run", [&](InputBuffer& inputBuffer) {
+        inputBuffer.WriteString(text, codepage);
+    });
+}
+
+// Pushes a million events through the input buffer the ways they arrive:
+// mouse moves and key presses written one at a time, like the window and the
+// VT input thread do, and blocks of records written at once, like
+// WriteConsoleInput does. Each is then peeked all at once and read back in
+// blocks the size of a typical ReadConsoleInput buffer.
+void InputBufferTests::InputEventThroughput()
+{
+    static constexpr size_t eventCount = 1024 * 1024;
+    static constexpr size_t readSize = 4096;
+
+    const auto measure = [](const wchar_t* const name, const size_t expectedEvents, const auto write) {
+        InputBuffer inputBuffer;
+        const auto start = std::chrono::steady_clock::now();
+        write(inputBuffer);
+        const auto written = std::chrono::steady_clock::now();
+
+        std::vector<INPUT_RECORD> outRecords;
+        VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, inputBuffer.GetNumberOfReadyEvents(), true, false, true, false));
+        const auto eventsPeeked = outRecords.size();
+        const auto peeked = std::chrono::steady_clock::now();
+
+        size_t eventsRead = 0;
+        for (;;)
+        {
+            outRecords.clear();
+            VERIFY_SUCCESS_NTSTATUS(inputBuffer.Read(outRecords, readSize, false, false, true, false));
+            if (outRecords.empty())
+            {
+                break;
+            }
+            eventsRead += outRecords.size();
+        }
+        const auto read = std::chrono::steady_clock::now();
+
+        VERIFY_ARE_EQUAL(expectedEvents, eventsPeeked);
+        VERIFY_ARE_EQUAL(expectedEvents, eventsRead);
+        Log::Comment(NoThrowString().Format(L"%s: wrote %zu events in %lld ms, peeked in %lld ms, read in %lld ms",
+                                            name,
+                                            eventsRead,
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(written - start).count(),
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(peeked - written).count(),
+                                            std::chrono::duration_cast<std::chrono::milliseconds>(read - peeked).count()));
+    };
+
+    // Alternating key downs and ups never coalesce, so every one is stored.
+    std::vector<INPUT_RECORD> keyRecords;
+    keyRecords.reserve(eventCount);
+    for (size_t i = 0; i < eventCount; ++i)
+    {
+        const auto wch = static_cast<WCHAR>(L'a' + (i / 2) % 26);
+        keyRecords.push_back(MakeKeyEvent(i % 2 == 0, 1, wch, 0, wch, 0));
+    }
+
+    measure(L"Mouse moves, one at a time", 1, [](InputBuffer& inputBuffer) {
+        INPUT_RECORD mouseRecord{};
+        mouseRecord.EventType = MOUSE_EVENT;
+        mouseRecord.Event.MouseEvent.dwEventFlags = MOUSE_MOVED;
+        for (size_t i = 0; i < eventCount; ++i)
+        {
+            mouseRecord.Event.MouseEvent.dwMousePosition.X = static_cast<SHORT>(i % 80);
+            inputBuffer.Write(gsl::span<const INPUT_RECORD>{ &mouseRecord, 1 });
+        }
+    });
+
+    measure(L"Key presses, one at a time", eventCount, [&](InputBuffer& inputBuffer) {
+        for (const auto& keyRecord : keyRecords)
+        {
+            inputBuffer.Write(gsl::span<const INPUT_RECORD>{ &keyRecord, 1 });
+        }
+    });
+
+    measure(L"Key presses, in blocks", eventCount, [&](InputBuffer& inputBuffer) {
+        for (size_t i = 0; i < keyRecords.size(); i += readSize)
+        {
+            inputBuffer.Write(gsl::span<const INPUT_RECORD>{ keyRecords }.subspan(i, readSize));
+        }
+    });
+}
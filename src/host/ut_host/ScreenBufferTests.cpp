@@ -168,6 +168,7 @@ class ScreenBufferTests
     TEST_METHOD(ScrollOperations);
     TEST_METHOD(InsertChars);
     TEST_METHOD(DeleteChars);
+    TEST_METHOD(ScrollRegionToRightEdgeSetsWrap);
 
     TEST_METHOD(EraseScrollbackTests);
     TEST_METHOD(EraseTests);
@@ -3746,6 +3747,34 @@ void ScreenBufferTests::DeleteChars()
                    L"A whole line of spaces was inserted from the right, erasing the line.");
 }
 
+void ScreenBufferTests::ScrollRegionToRightEdgeSetsWrap()
+{
+    auto& g = ServiceLocator::LocateGlobals();
+    auto& gci = g.getConsoleInformation();
+    auto& si = gci.GetActiveOutputBuffer().GetActiveBuffer();
+
+    const auto bufferWidth = SHORT{ 40 };
+    const auto bufferHeight = si.GetBufferSize().Height();
+    VERIFY_SUCCEEDED(si.ResizeScreenBuffer({ bufferWidth, bufferHeight }, false));
+
+    const auto line = SHORT{ 10 };
+    const auto bufferAttr = TextAttribute{ FOREGROUND_BLUE | BACKGROUND_GREEN };
+    _FillLine(line, L"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abcd", bufferAttr);
+
+    const auto& row = si.GetTextBuffer().GetRowByOffset(line);
+    VERIFY_IS_FALSE(row.GetCharRow().WasWrapForced());
+
+    Log::Comment(L"Move the whole line one column to the right. The first column is clipped "
+                 L"so it isn't filled again, which would unset the wrap flag.");
+    const auto right = gsl::narrow_cast<SHORT>(bufferWidth - 1);
+    const SMALL_RECT source{ 0, line, right, line };
+    const SMALL_RECT clip{ 1, line, right, line };
+    VERIFY_SUCCEEDED(g.api.ScrollConsoleScreenBufferWImpl(si, source, { 1, line }, clip, L' ', bufferAttr.GetLegacyAttributes()));
+
+    VERIFY_IS_TRUE(_ValidateLineContains(line, L"AABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789abc", bufferAttr));
+    VERIFY_IS_TRUE(row.GetCharRow().WasWrapForced(), L"Filling the last column marks the row as wrapped, like writing it cell by cell does.");
+}
+
 void ScreenBufferTests::EraseScrollbackTests()
 {
     auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
@@ -156,4 +156,137 @@ class SearchTests
         Search s(gci.renderData, L"\x304b", Search::Direction::Backward, Search::Sensitivity::CaseInsensitive);
         DoFoundChecks(s, coordStartExpected, -1);
     }
+
+    void DoFindAllChecks(Search& s, const SHORT startX, const SHORT endX)
+    {
+        const auto& matches = s.FindAll();
+        VERIFY_ARE_EQUAL(4u, matches.size());
+
+        for (SHORT y = 0; y < 4; y++)
+        {
+            const COORD startExpected{ startX, y };
+            const COORD endExpected{ endX, y };
+            VERIFY_ARE_EQUAL(startExpected, matches.at(y).first);
+            VERIFY_ARE_EQUAL(endExpected, matches.at(y).second);
+        }
+
+        // FindNext can tell which of them it found.
+        VERIFY_IS_TRUE(s.FindNext());
+        VERIFY_ARE_EQUAL(0u, s.GetFoundIndex().value());
+        VERIFY_IS_TRUE(s.FindNext());
+        VERIFY_ARE_EQUAL(1u, s.GetFoundIndex().value());
+    }
+
+    TEST_METHOD(FindAllCaseInsensitive)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"ab", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive);
+        DoFindAllChecks(s, 0, 1);
+    }
+
+    TEST_METHOD(FindAllCaseSensitiveJapanese)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"\x304b", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        DoFindAllChecks(s, 2, 3);
+    }
+
+    TEST_METHOD(UpdateMatchesFindsNewOutput)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+
+        Search s(gci.renderData, L"AB", Search::Direction::Forward, Search::Sensitivity::CaseSensitive);
+        VERIFY_ARE_EQUAL(4u, s.FindAll().size());
+
+        textBuffer.WriteLine(OutputCellIterator(L"xxABxx"), { 0, 5 });
+
+        const auto& matches = s.UpdateMatches();
+        VERIFY_ARE_EQUAL(5u, matches.size());
+        const COORD startExpected{ 2, 5 };
+        const COORD endExpected{ 3, 5 };
+        VERIFY_ARE_EQUAL(startExpected, matches.back().first);
+        VERIFY_ARE_EQUAL(endExpected, matches.back().second);
+    }
+
+    TEST_METHOD(FindAllRegexCaseInsensitive)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"b.c", Search::Direction::Forward, Search::Sensitivity::CaseInsensitive, Search::Mode::Regex);
+        DoFindAllChecks(s, 1, 4);
+    }
+
+    TEST_METHOD(FindAllRegexAlternationJapanese)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        Search s(gci.renderData, L"\x304d|E", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);
+        const auto& matches = s.FindAll();
+        VERIFY_ARE_EQUAL(8u, matches.size());
+
+        for (SHORT y = 0; y < 4; y++)
+        {
+            VERIFY_ARE_EQUAL((COORD{ 5, y }), matches.at(y * 2).first);
+            VERIFY_ARE_EQUAL((COORD{ 6, y }), matches.at(y * 2).second);
+            VERIFY_ARE_EQUAL((COORD{ 8, y }), matches.at(y * 2 + 1).first);
+            VERIFY_ARE_EQUAL((COORD{ 8, y }), matches.at(y * 2 + 1).second);
+        }
+    }
+
+    TEST_METHOD(FindRegexAcrossWrappedRow)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+        const auto width = textBuffer.GetSize().Width();
+
+        textBuffer.WriteLine(OutputCellIterator(L"xyz"), { width - 3, 5 });
+        textBuffer.GetRowByOffset(5).GetCharRow().SetWrapForced(true);
+        textBuffer.WriteLine(OutputCellIterator(L"123"), { 0, 6 });
+
+        Search s(gci.renderData, L"z\\d+", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);
+        VERIFY_IS_TRUE(s.FindNext());
+
+        const COORD startExpected{ width - 1, 5 };
+        const COORD endExpected{ 2, 6 };
+        VERIFY_ARE_EQUAL(startExpected, s.GetFoundLocation().first);
+        VERIFY_ARE_EQUAL(endExpected, s.GetFoundLocation().second);
+
+        // There's just the one, so going around the buffer ends the search.
+        VERIFY_IS_FALSE(s.FindNext());
+    }
+
+    TEST_METHOD(RegexSearchYieldsBetweenBlocks)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+        auto& textBuffer = gci.GetActiveOutputBuffer().GetTextBuffer();
+
+        // The buffer has more rows than are scanned in one block.
+        VERIFY_IS_TRUE(textBuffer.GetSize().Height() > 256);
+        textBuffer.WriteLine(OutputCellIterator(L"needle"), { 3, 280 });
+
+        Search s(gci.renderData, L"ne+dle", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);
+        size_t yields = 0;
+        s.SetYield([&]() { ++yields; });
+        VERIFY_IS_TRUE(s.FindNext());
+        VERIFY_ARE_EQUAL((COORD{ 3, 280 }), s.GetFoundLocation().first);
+        VERIFY_ARE_EQUAL(1u, yields);
+
+        Log::Comment(L"A search that is cancelled while it's yielded finds nothing.");
+        std::atomic<bool> cancelled{ false };
+        Search cancelledSearch(gci.renderData, L"ne+dle", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);
+        cancelledSearch.SetCancellation(&cancelled);
+        cancelledSearch.SetYield([&]() { cancelled = true; });
+        VERIFY_IS_FALSE(cancelledSearch.FindNext());
+    }
+
+    TEST_METHOD(InvalidRegexThrows)
+    {
+        auto& gci = ServiceLocator::LocateGlobals().getConsoleInformation();
+
+        VERIFY_THROWS(Search(gci.renderData, L"(ab", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);, wil::ResultException);
+        VERIFY_THROWS(Search(gci.renderData, L"(a)\\1", Search::Direction::Forward, Search::Sensitivity::CaseSensitive, Search::Mode::Regex);, wil::ResultException);
+    }
 };
@@ -17,6 +17,8 @@
 #include "../interactivity/inc/ServiceLocator.hpp"
 #include "../renderer/inc/DummyRenderTarget.hpp"
 
+#include <chrono>
+
 using namespace Microsoft::Console::Types;
 using namespace Microsoft::Console::Interactivity;
 using namespace Microsoft::Console::VirtualTerminal;
@@ -140,10 +142,37 @@ class TextBufferTests
 
     TEST_METHOD(ResizeTraditionalRotationPreservesHighUnicode);
     TEST_METHOD(ScrollBufferRotationPreservesHighUnicode);
+    TEST_METHOD(ScrollRowsAcrossCircularBufferEnd);
+
+    BEGIN_TEST_METHOD(ScrollMarginInLargeBuffer)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    TEST_METHOD(CopyRectangleShiftsWithinRow);
+    TEST_METHOD(CopyRectangleOverlappingRows);
+
+    BEGIN_TEST_METHOD(InsertDeleteCharactersInWideRow)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    TEST_METHOD(ReflowPadsWideCharacterAtRowEnd);
+    TEST_METHOD(ReflowToWidthOne);
+
+    BEGIN_TEST_METHOD(ReflowLargeScrollback)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
 
     TEST_METHOD(ResizeTraditionalHighUnicodeRowRemoval);
     TEST_METHOD(ResizeTraditionalHighUnicodeColumnRemoval);
 
+    BEGIN_TEST_METHOD(EmojiThroughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(CombiningMarkThroughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
     TEST_METHOD(TestBurrito);
 
     void WriteLinesToBuffer(const std::vector<std::wstring>& text, TextBuffer& buffer);
@@ -153,9 +182,37 @@ class TextBufferTests
 
     TEST_METHOD(GetTextRects);
     TEST_METHOD(GetText);
+    TEST_METHOD(GetClipboardDataMatchesGetText);
+    TEST_METHOD(GetClipboardDataFormats);
 
     TEST_METHOD(HyperlinkTrim);
     TEST_METHOD(NoHyperlinkTrim);
+    TEST_METHOD(HyperlinkRefCountsFollowRuns);
+
+    BEGIN_TEST_METHOD(ScrollWithHyperlinks)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    TEST_METHOD(CopiedRowOwnsItsCells);
+    TEST_METHOD(ResizeTraditionalKeepsRowsAfterRepack);
+
+    BEGIN_TEST_METHOD(CellIteratorRenderWalk)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    TEST_METHOD(UrlPatternMatchesRegex);
+
+    BEGIN_TEST_METHOD(UrlPatternThroughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(ClipboardExportThroughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+
+    BEGIN_TEST_METHOD(ClipboardExportMemory)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
 };
 
 void TextBufferTests::TestBufferCreate()
@@ -1829,7 +1886,7 @@ void TextBufferTests::ResizeTraditional()
 }
 
 // This tests that when buffer storage rows are rotated around during a resize traditional operation,
-// that the Unicode Storage-held high unicode items like emoji rotate properly with it.
+// that the high unicode items like emoji held by the rows rotate properly with them.
 void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
 {
     // Set up a text buffer for us
@@ -1871,7 +1928,7 @@ void TextBufferTests::ResizeTraditionalRotationPreservesHighUnicode()
 }
 
 // This tests that when buffer storage rows are rotated around during a scroll buffer operation,
-// that the Unicode Storage-held high unicode items like emoji rotate properly with it.
+// that the high unicode items like emoji held by the rows rotate properly with them.
 void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
 {
     // Set up a text buffer for us
@@ -1910,8 +1967,252 @@ void TextBufferTests::ScrollBufferRotationPreservesHighUnicode()
     VERIFY_ARE_EQUAL(String(fire), String(shouldBeFireText.data(), gsl::narrow<int>(shouldBeFireText.size())));
 }
 
+// ScrollRows only touches the rows of the region it scrolls. That region can
+// wrap around the end of the circular buffer's storage.
+void TextBufferTests::ScrollRowsAcrossCircularBufferEnd()
+{
+    const COORD bufferSize{ 10, 8 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    for (auto i = 0; i < 5; ++i)
+    {
+        _buffer->IncrementCircularBuffer();
+    }
+    VERIFY_ARE_EQUAL(5, _buffer->GetFirstRowIndex());
+
+    for (SHORT i = 0; i < bufferSize.Y; ++i)
+    {
+        _buffer->WriteLine(OutputCellIterator(fmt::format(L"r{}", i)), { 0, i });
+    }
+
+    // This is the fire emoji: 🔥. It's kept in the glyph storage of its row, which moves with it.
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->WriteLine(OutputCellIterator(fire), { 3, 6 });
+
+    // Move rows 4 to 6 up by 2. The region [2, 7) lives in storage rows 7, 0, 1, 2 and 3.
+    _buffer->ScrollRows(4, 3, -2);
+
+    const std::wstring_view expected[]{ L"r0", L"r1", L"r4", L"r5", L"r6", L"r2", L"r3", L"r7" };
+    for (SHORT i = 0; i < bufferSize.Y; ++i)
+    {
+        VERIFY_ARE_EQUAL(String(expected[i].data(), 2), String(_buffer->GetRowByOffset(i).GetText().substr(0, 2).c_str()));
+    }
+
+    const auto fireText = *_buffer->GetTextDataAt({ 3, 4 });
+    VERIFY_ARE_EQUAL(String(fire), String(fireText.data(), gsl::narrow<int>(fireText.size())));
+}
+
+// Programs like vim, less or tmux scroll a small region of the screen with DECSTBM
+// margins. That shouldn't cost anything proportional to the scrollback.
+void TextBufferTests::ScrollMarginInLargeBuffer()
+{
+    const COORD bufferSize{ 120, 30000 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    // Don't start at the front of the storage, like a buffer that has been in use for a while.
+    for (auto i = 0; i < 12345; ++i)
+    {
+        _buffer->IncrementCircularBuffer();
+    }
+
+    const SHORT marginTop = bufferSize.Y - 30;
+    const SHORT marginHeight = 20;
+    for (SHORT i = 0; i < marginHeight; ++i)
+    {
+        _buffer->WriteLine(OutputCellIterator(fmt::format(L"line {}", i)), { 0, gsl::narrow<SHORT>(marginTop + i) });
+    }
+
+    const size_t scrolls = 100000;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scrolls; ++i)
+    {
+        _buffer->ScrollRows(marginTop + 1, marginHeight - 1, -1);
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // The region is 20 rows tall, so after 100000 scrolls every row is back where it started.
+    VERIFY_ARE_EQUAL(String(L"line 0"), String(_buffer->GetRowByOffset(marginTop).GetText().substr(0, 6).c_str()));
+    Log::Comment(NoThrowString().Format(L"Scrolled a %d line margin of a %d row buffer %zu times in %lld ms",
+                                        marginHeight,
+                                        bufferSize.Y,
+                                        scrolls,
+                                        elapsed));
+}
+
+// ICH and DCH shift the rest of the row over. The cells keep their attributes
+// and glyphs kept in the glyph storage of the row move along with them.
+void TextBufferTests::CopyRectangleShiftsWithinRow()
+{
+    const COORD bufferSize{ 10, 3 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    const TextAttribute red{ 0x0c };
+    _buffer->WriteLine(OutputCellIterator(L"abc", attr), { 0, 1 });
+    _buffer->WriteLine(OutputCellIterator(L"def", red), { 3, 1 });
+
+    // This is the fire emoji: 🔥.
+    const auto fire = L"\xD83D\xDD25";
+    _buffer->WriteLine(OutputCellIterator(fire), { 6, 1 });
+
+    // Insert 2 cells at column 1. The last 2 columns fall off the row.
+    _buffer->CopyRectangle(Viewport::FromDimensions({ 1, 1 }, 9, 1), { 3, 1 });
+    VERIFY_ARE_EQUAL(String(L"abcbcdef"), String(_buffer->GetRowByOffset(1).GetText().substr(0, 8).c_str()));
+    VERIFY_ARE_EQUAL(red, _buffer->GetCellDataAt({ 6, 1 })->TextAttr());
+    VERIFY_ARE_EQUAL(attr, _buffer->GetCellDataAt({ 4, 1 })->TextAttr());
+    auto fireText = *_buffer->GetTextDataAt({ 8, 1 });
+    VERIFY_ARE_EQUAL(String(fire), String(fireText.data(), gsl::narrow<int>(fireText.size())));
+
+    // Now delete them again.
+    _buffer->CopyRectangle(Viewport::FromDimensions({ 3, 1 }, 7, 1), { 1, 1 });
+    VERIFY_ARE_EQUAL(String(L"abcdef"), String(_buffer->GetRowByOffset(1).GetText().substr(0, 6).c_str()));
+    VERIFY_ARE_EQUAL(red, _buffer->GetCellDataAt({ 3, 1 })->TextAttr());
+    fireText = *_buffer->GetTextDataAt({ 6, 1 });
+    VERIFY_ARE_EQUAL(String(fire), String(fireText.data(), gsl::narrow<int>(fireText.size())));
+
+    // A leading half moved into the last column is padded out, like WriteCells does.
+    _buffer->CopyRectangle(Viewport::FromDimensions({ 6, 1 }, 1, 1), { 9, 1 });
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(1).GetCharRow().WasDoubleBytePadded());
+    const auto paddedText = *_buffer->GetTextDataAt({ 9, 1 });
+    VERIFY_ARE_EQUAL(String(L" "), String(paddedText.data(), gsl::narrow<int>(paddedText.size())));
+}
+
+// Moving a block down and to the right over itself has to start from the bottom.
+void TextBufferTests::CopyRectangleOverlappingRows()
+{
+    const COORD bufferSize{ 6, 5 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    _buffer->WriteLine(OutputCellIterator(L"abc"), { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"def"), { 0, 1 });
+    _buffer->WriteLine(OutputCellIterator(L"ghi"), { 0, 2 });
+
+    _buffer->CopyRectangle(Viewport::FromDimensions({ 0, 0 }, 3, 3), { 1, 1 });
+
+    const std::wstring_view expected[]{ L"abc   ", L"dabc  ", L"gdef  ", L" ghi  ", L"      " };
+    for (SHORT i = 0; i < bufferSize.Y; ++i)
+    {
+        VERIFY_ARE_EQUAL(String(expected[i].data(), 6), String(_buffer->GetRowByOffset(i).GetText().c_str()));
+    }
+}
+
+// Typing in the middle of a long line in a shell inserts or deletes a character
+// at a time. That should cost a copy of the row, not a write per cell.
+void TextBufferTests::InsertDeleteCharactersInWideRow()
+{
+    const COORD bufferSize{ 1000, 10 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    for (SHORT x = 0; x < bufferSize.X; x += 10)
+    {
+        _buffer->WriteLine(OutputCellIterator(L"0123456789", TextAttribute{ gsl::narrow_cast<WORD>(x % 16) }), { x, 0 });
+    }
+    const auto text = _buffer->GetRowByOffset(0).GetText();
+
+    const size_t keystrokes = 10000;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keystrokes; ++i)
+    {
+        _buffer->CopyRectangle(Viewport::FromDimensions({ 1, 0 }, bufferSize.X - 1, 1), { 2, 0 });
+        _buffer->CopyRectangle(Viewport::FromDimensions({ 2, 0 }, bufferSize.X - 2, 1), { 1, 0 });
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Each insert duplicates column 1 and each delete removes that copy again.
+    VERIFY_ARE_EQUAL(String(text.substr(0, bufferSize.X - 1).c_str()), String(_buffer->GetRowByOffset(0).GetText().substr(0, bufferSize.X - 1).c_str()));
+    Log::Comment(NoThrowString().Format(L"Inserted and deleted a character in a %d column row %zu times in %lld ms",
+                                        bufferSize.X,
+                                        keystrokes,
+                                        elapsed));
+}
+
+// Reflow copies rows over a block of cells at a time. It has to wrap them the
+// same way inserting one character at a time does.
+void TextBufferTests::ReflowPadsWideCharacterAtRowEnd()
+{
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute red{ 0x0c };
+    TextBuffer oldBuffer({ 10, 5 }, attr, 12, _renderTarget);
+    TextBuffer newBuffer({ 9, 5 }, attr, 12, _renderTarget);
+
+    // The wide character fills the last 2 columns, then the line wraps.
+    oldBuffer.Write(OutputCellIterator(L"abcdefgh\x3042"), { 0, 0 }, true);
+    oldBuffer.Write(OutputCellIterator(L"xyz", red), { 0, 1 });
+    VERIFY_IS_TRUE(oldBuffer.GetRowByOffset(0).GetCharRow().WasWrapForced());
+    oldBuffer.GetCursor().SetPosition({ 1, 1 });
+
+    VERIFY_SUCCEEDED(TextBuffer::Reflow(oldBuffer, newBuffer, std::nullopt, std::nullopt));
+
+    // The leading half can't go into the last column, so the wide character moves down.
+    const auto& firstRow = newBuffer.GetRowByOffset(0).GetCharRow();
+    VERIFY_IS_TRUE(firstRow.WasWrapForced());
+    VERIFY_IS_TRUE(firstRow.WasDoubleBytePadded());
+    VERIFY_ARE_EQUAL(String(L"abcdefgh "), String(newBuffer.GetRowByOffset(0).GetText().c_str()));
+    VERIFY_ARE_EQUAL(String(L"\x3042xyz"), String(newBuffer.GetRowByOffset(1).GetText().substr(0, 4).c_str()));
+
+    // The rest of the row is colored like the last character, like InsertCharacter does.
+    VERIFY_ARE_EQUAL(red, newBuffer.GetCellDataAt({ 4, 1 })->TextAttr());
+    VERIFY_ARE_EQUAL(red, newBuffer.GetCellDataAt({ 8, 1 })->TextAttr());
+
+    const COORD expectedCursor{ 3, 1 };
+    VERIFY_ARE_EQUAL(expectedCursor, newBuffer.GetCursor().GetPosition());
+}
+
+// A wide character can't fit into a buffer that's a single column wide.
+// Reflowing into one has to finish anyway, one character at a time.
+void TextBufferTests::ReflowToWidthOne()
+{
+    const TextAttribute attr{ 0x7f };
+    TextBuffer oldBuffer({ 10, 5 }, attr, 12, _renderTarget);
+    TextBuffer newBuffer({ 1, 20 }, attr, 12, _renderTarget);
+
+    oldBuffer.Write(OutputCellIterator(L"\x3042ab\x3044c"), { 0, 0 });
+    oldBuffer.GetCursor().SetPosition({ 0, 1 });
+
+    VERIFY_SUCCEEDED(TextBuffer::Reflow(oldBuffer, newBuffer, std::nullopt, std::nullopt));
+
+    // The first wide character pads out the first row before it's split over the next two.
+    VERIFY_IS_TRUE(newBuffer.GetRowByOffset(0).GetCharRow().WasDoubleBytePadded());
+    VERIFY_IS_TRUE(newBuffer.GetRowByOffset(1).GetCharRow().DbcsAttrAt(0).IsLeading());
+    VERIFY_IS_TRUE(newBuffer.GetRowByOffset(2).GetCharRow().DbcsAttrAt(0).IsTrailing());
+    VERIFY_ARE_EQUAL(String(L"a"), String(newBuffer.GetRowByOffset(3).GetText().c_str()));
+    VERIFY_ARE_EQUAL(String(L"b"), String(newBuffer.GetRowByOffset(4).GetText().c_str()));
+}
+
+// Resizing a window with a full scrollback reflows every row of it.
+void TextBufferTests::ReflowLargeScrollback()
+{
+    const TextAttribute attr{ 0x7f };
+    const TextAttribute red{ 0x0c };
+
+    // Buffers are limited to SHORT rows, so 30000 is about as big as it gets.
+    for (const SHORT height : { SHORT{ 10000 }, SHORT{ 30000 } })
+    {
+        TextBuffer oldBuffer({ 120, height }, attr, 12, _renderTarget);
+        SHORT y = 0;
+        for (auto i = 0; y < height - 1; ++i)
+        {
+            // Every third line is long enough to wrap.
+            const auto line = fmt::format(L"{:>6} {}", i, std::wstring(i % 3 == 0 ? 150 : i % 113, L'x'));
+            oldBuffer.Write(OutputCellIterator(line, i % 2 ? attr : red), { 0, y }, true);
+            y += i % 3 == 0 ? 2 : 1;
+        }
+
+        TextBuffer newBuffer({ 100, height }, attr, 12, _renderTarget);
+        const auto start = std::chrono::steady_clock::now();
+        VERIFY_SUCCEEDED(TextBuffer::Reflow(oldBuffer, newBuffer, std::nullopt, std::nullopt));
+        const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+        Log::Comment(NoThrowString().Format(L"Reflowed %d rows from 120 to 100 columns in %lld ms", height, elapsed));
+    }
+}
+
 // This tests that rows removed from the buffer while resizing traditionally will also drop the high unicode
-// characters from the Unicode Storage buffer
+// characters they stored
 void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
 {
     // Set up a text buffer for us
@@ -1935,18 +2236,21 @@ void TextBufferTests::ResizeTraditionalHighUnicodeRowRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
+    VERIFY_ARE_EQUAL(1u, _buffer->_storage[pos.Y].GetCharRow().GetGlyphStorage().size(), L"The row should store one glyph.");
 
     // Perform resize to trim off the row of the buffer that included the emoji
     COORD trimmedBufferSize{ bufferSize.X, bufferSize.Y - 1 };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    for (const auto& row : _buffer->_storage)
+    {
+        VERIFY_ARE_EQUAL(0u, row.GetCharRow().GetGlyphStorage().size(), L"No row should store a glyph now.");
+    }
 }
 
 // This tests that columns removed from the buffer while resizing traditionally will also drop the high unicode
-// characters from the Unicode Storage buffer
+// characters stored for them
 void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
 {
     // Set up a text buffer for us
@@ -1970,14 +2274,89 @@ void TextBufferTests::ResizeTraditionalHighUnicodeColumnRemoval()
     const auto readBackText = *readBack;
     VERIFY_ARE_EQUAL(String(emoji), String(readBackText.data(), gsl::narrow<int>(readBackText.size())));
 
-    VERIFY_ARE_EQUAL(1u, _buffer->GetUnicodeStorage()._map.size(), L"There should be one item in the map.");
+    VERIFY_ARE_EQUAL(1u, _buffer->_storage[pos.Y].GetCharRow().GetGlyphStorage().size(), L"The row should store one glyph.");
 
     // Perform resize to trim off the column of the buffer that included the emoji
     COORD trimmedBufferSize{ bufferSize.X - 1, bufferSize.Y };
 
     VERIFY_NT_SUCCESS(_buffer->ResizeTraditional(trimmedBufferSize));
 
-    VERIFY_IS_TRUE(_buffer->GetUnicodeStorage()._map.empty(), L"The map should now be empty.");
+    VERIFY_ARE_EQUAL(0u, _buffer->_storage[pos.Y].GetCharRow().GetGlyphStorage().size(), L"The row should store no glyph now.");
+}
+
+// Prints lines of glyphs that don't fit into a cell at the bottom of a buffer with scrollback,
+// scrolling after every one of them the way a terminal does, then resizes the buffer.
+// Returns the text of the last line printed.
+static std::wstring _PrintScrollingGlyphLines(TextBuffer& buffer,
+                                              const wchar_t* const name,
+                                              const size_t lineCount,
+                                              const std::function<OutputCellIterator()>& makeLine)
+{
+    const auto bottom = gsl::narrow<SHORT>(buffer.GetSize().Height() - 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lineCount; ++i)
+    {
+        buffer.WriteLine(makeLine(), { 0, bottom });
+        buffer.IncrementCircularBuffer();
+    }
+    const auto printTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    const auto size = buffer.GetSize().Dimensions();
+    start = std::chrono::steady_clock::now();
+    VERIFY_NT_SUCCESS(buffer.ResizeTraditional({ gsl::narrow_cast<SHORT>(size.X - 1), size.Y }));
+    const auto resizeTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    Log::Comment(NoThrowString().Format(L"%s: printed %zu lines of %d columns in %lld ms, resized in %lld ms",
+                                        name,
+                                        lineCount,
+                                        size.X,
+                                        printTime,
+                                        resizeTime));
+
+    return buffer.GetRowByOffset(gsl::narrow_cast<size_t>(bottom) - 1).GetText();
+}
+
+void TextBufferTests::EmojiThroughput()
+{
+    const COORD bufferSize{ 120, 9001 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    // 60 emoji from U+1F600 on, each of them a surrogate pair that takes 2 columns.
+    std::wstring line;
+    for (wchar_t i = 0; i < 60; i++)
+    {
+        line.push_back(0xD83D);
+        line.push_back(static_cast<wchar_t>(0xDE00 + i % 0x40));
+    }
+
+    const auto lastLine = _PrintScrollingGlyphLines(*_buffer, L"Emoji", 100000, [&]() { return OutputCellIterator{ line }; });
+
+    // The resize cut off the right half of the last emoji, so only compare the ones before it.
+    VERIFY_ARE_EQUAL(String(line.substr(0, line.size() - 2).c_str()), String(lastLine.substr(0, line.size() - 2).c_str()));
+}
+
+void TextBufferTests::CombiningMarkThroughput()
+{
+    const COORD bufferSize{ 120, 9001 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    // A latin letter with a combining acute accent (U+0301) in every column.
+    std::vector<OutputCell> cells;
+    std::wstring expected;
+    for (auto i = 0; i < bufferSize.X; i++)
+    {
+        const wchar_t glyph[]{ static_cast<wchar_t>(L'a' + i % 26), 0x0301 };
+        cells.emplace_back(std::wstring_view{ glyph, 2 }, DbcsAttribute{}, attr);
+        expected.append(glyph, 2);
+    }
+
+    const auto lastLine = _PrintScrollingGlyphLines(*_buffer, L"Combining marks", 100000, [&]() { return OutputCellIterator{ cells }; });
+
+    // The resize dropped the last column.
+    VERIFY_ARE_EQUAL(String(expected.substr(0, expected.size() - 2).c_str()), String(lastLine.substr(0, expected.size() - 2).c_str()));
 }
 
 void TextBufferTests::TestBurrito()
@@ -2609,3 +2988,483 @@ void TextBufferTests::NoHyperlinkTrim()
     VERIFY_ARE_EQUAL(_buffer->GetHyperlinkUriFromId(id), url);
     VERIFY_ARE_EQUAL(_buffer->_hyperlinkCustomIdMap[finalCustomId], id);
 }
+
+// The rows of a buffer count the attribute runs referencing each hyperlink,
+// as the runs are created and destroyed.
+void TextBufferTests::HyperlinkRefCountsFollowRuns()
+{
+    const COORD bufferSize{ 80, 4 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+    const auto& refs = _buffer->GetHyperlinkRefCounts();
+
+    const auto id = _buffer->GetHyperlinkId(L"test.url", L"");
+    _buffer->AddHyperlinkToMap(L"test.url", id);
+    TextAttribute linkAttr{ 0x7f };
+    linkAttr.SetHyperlinkId(id);
+
+    Log::Comment(L"Two separate runs in row 0, one run in row 1.");
+    _buffer->WriteLine(OutputCellIterator(L"one", linkAttr), { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"two", linkAttr), { 10, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"three", linkAttr), { 0, 1 });
+    VERIFY_ARE_EQUAL(3u, refs.at(id));
+    VERIFY_ARE_EQUAL(0u, _buffer->GetRowByOffset(0).GetAttrRow().GetExclusiveHyperlinks().size());
+
+    Log::Comment(L"Overwriting a run drops its reference.");
+    _buffer->WriteLine(OutputCellIterator(L"plain", attr), { 0, 1 });
+    VERIFY_ARE_EQUAL(2u, refs.at(id));
+    VERIFY_IS_TRUE(_buffer->GetRowByOffset(0).GetAttrRow().GetExclusiveHyperlinks() == std::vector<uint16_t>{ id });
+
+    Log::Comment(L"A copy of a row doesn't count towards the buffer it was copied from.");
+    {
+        const auto copy = _buffer->GetRowByOffset(0);
+        VERIFY_ARE_EQUAL(2u, refs.at(id));
+    }
+    VERIFY_ARE_EQUAL(2u, refs.at(id));
+
+    Log::Comment(L"Moving rows around, as the traditional resize does, keeps the counts.");
+    VERIFY_SUCCEEDED(_buffer->ResizeTraditional({ 60, 6 }));
+    VERIFY_ARE_EQUAL(2u, _buffer->GetHyperlinkRefCounts().at(id));
+
+    Log::Comment(L"Recycling the row removes the hyperlink, since no other row references it.");
+    _buffer->IncrementCircularBuffer();
+    VERIFY_ARE_EQUAL(0u, _buffer->GetHyperlinkRefCounts().count(id));
+    VERIFY_ARE_EQUAL(_buffer->_hyperlinkMap.end(), _buffer->_hyperlinkMap.find(id));
+}
+
+// Tools like `ls --hyperlink` emit a new hyperlink on every line. Scrolling
+// through such output used to scan the whole buffer for every recycled row.
+void TextBufferTests::ScrollWithHyperlinks()
+{
+    const COORD bufferSize{ 120, 9001 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    const size_t lineCount = 50000;
+    const auto lastRow = gsl::narrow<SHORT>(bufferSize.Y - 1);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lineCount; ++i)
+    {
+        const auto uri = fmt::format(L"file:///home/user/src/file{}.cpp", i);
+        const auto id = _buffer->GetHyperlinkId(uri, L"");
+        _buffer->AddHyperlinkToMap(uri, id);
+
+        TextAttribute linkAttr{ attr };
+        linkAttr.SetHyperlinkId(id);
+        _buffer->WriteLine(OutputCellIterator(L"-rw-r--r-- 1 user user 4096 Nov 26 12:00 ", attr), { 0, lastRow });
+        _buffer->WriteLine(OutputCellIterator(fmt::format(L"file{}.cpp", i), linkAttr), { 41, lastRow });
+        _buffer->IncrementCircularBuffer();
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    // Only the hyperlinks still visible in the buffer are left in the map.
+    VERIFY_ARE_EQUAL(static_cast<size_t>(bufferSize.Y - 1), _buffer->_hyperlinkMap.size());
+    Log::Comment(NoThrowString().Format(L"Scrolled %zu hyperlinked lines through %d rows in %lld ms",
+                                        lineCount,
+                                        bufferSize.Y,
+                                        elapsed));
+}
+
+// The rows of a buffer share one allocation for their cells. A copy of a row
+// must not write through to the buffer it was copied from.
+void TextBufferTests::CopiedRowOwnsItsCells()
+{
+    const COORD bufferSize{ 10, 3 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    _buffer->WriteLine(OutputCellIterator(L"abc"), { 0, 1 });
+
+    auto copy = _buffer->GetRowByOffset(1);
+    copy.GetCharRow().GlyphAt(0) = L"z";
+    VERIFY_ARE_EQUAL(L"zbc       ", copy.GetText());
+    VERIFY_ARE_EQUAL(L"abc       ", _buffer->GetRowByOffset(1).GetText());
+
+    copy.GetCharRow().Reset();
+    VERIFY_ARE_EQUAL(L"          ", copy.GetText());
+    VERIFY_ARE_EQUAL(L"abc       ", _buffer->GetRowByOffset(1).GetText());
+}
+
+void TextBufferTests::ResizeTraditionalKeepsRowsAfterRepack()
+{
+    const COORD bufferSize{ 10, 4 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    _buffer->WriteLine(OutputCellIterator(L"row0"), { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"row1"), { 0, 1 });
+    _buffer->WriteLine(OutputCellIterator(L"row2"), { 0, 2 });
+    _buffer->WriteLine(OutputCellIterator(L"row3"), { 0, 3 });
+
+    // Rotate the rows so that their storage order no longer matches the cell order.
+    _buffer->IncrementCircularBuffer();
+    _buffer->WriteLine(OutputCellIterator(L"row4"), { 0, 3 });
+
+    // Grow in both directions, then shrink back down.
+    VERIFY_SUCCEEDED(_buffer->ResizeTraditional({ 15, 6 }));
+    VERIFY_ARE_EQUAL(L"row1           ", _buffer->GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(L"row4           ", _buffer->GetRowByOffset(3).GetText());
+    VERIFY_ARE_EQUAL(L"               ", _buffer->GetRowByOffset(5).GetText());
+
+    VERIFY_SUCCEEDED(_buffer->ResizeTraditional({ 3, 2 }));
+    VERIFY_ARE_EQUAL(L"row", _buffer->GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(L"row", _buffer->GetRowByOffset(1).GetText());
+
+    _buffer->GetRowByOffset(1).GetCharRow().GlyphAt(2) = L"!";
+    VERIFY_ARE_EQUAL(L"row", _buffer->GetRowByOffset(0).GetText());
+    VERIFY_ARE_EQUAL(L"ro!", _buffer->GetRowByOffset(1).GetText());
+}
+
+// Walks every cell of a large scrollback the same way the renderer reads a
+// row, and reports the memory held by the glyph cells of the buffer.
+// Sums up the bytes in use on the process heap, which new and delete go through,
+// including the overhead of every block.
+static size_t _HeapBytesInUse()
+{
+    const auto heap = GetProcessHeap();
+    THROW_IF_WIN32_BOOL_FALSE(HeapLock(heap));
+    auto unlock = wil::scope_exit([&]() noexcept { HeapUnlock(heap); });
+
+    size_t bytes = 0;
+    PROCESS_HEAP_ENTRY entry{};
+    while (HeapWalk(heap, &entry))
+    {
+        if (WI_IsFlagSet(entry.wFlags, PROCESS_HEAP_ENTRY_BUSY))
+        {
+            bytes += entry.cbData + entry.cbOverhead;
+        }
+    }
+    return bytes;
+}
+
+void TextBufferTests::CellIteratorRenderWalk()
+{
+    const COORD bufferSize{ 120, 10000 };
+    const TextAttribute attr{ 0x7f };
+
+    const auto heapBefore = _HeapBytesInUse();
+    auto start = std::chrono::steady_clock::now();
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+    const auto createTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    const auto heapAfter = _HeapBytesInUse();
+
+    std::wstring line;
+    for (auto i = 0; i < bufferSize.X; i++)
+    {
+        line.push_back(static_cast<wchar_t>(33 + (i % 94)));
+    }
+    for (SHORT y = 0; y < bufferSize.Y; y++)
+    {
+        _buffer->WriteLine(OutputCellIterator(line), { 0, y });
+    }
+
+    start = std::chrono::steady_clock::now();
+    size_t glyphs = 0;
+    for (SHORT y = 0; y < bufferSize.Y; y++)
+    {
+        for (auto it = _buffer->GetCellLineDataAt({ 0, y }); it; ++it)
+        {
+            glyphs += it->Chars().size();
+        }
+    }
+    const auto walkTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    VERIFY_ARE_EQUAL(static_cast<size_t>(bufferSize.X) * bufferSize.Y, glyphs);
+
+    const auto cellBytes = sizeof(CharRow::value_type) * bufferSize.X * bufferSize.Y;
+    Log::Comment(NoThrowString().Format(L"%d rows of %d cells: %zu bytes of glyph cells in 1 allocation, %zu bytes of ROW objects",
+                                        bufferSize.Y,
+                                        bufferSize.X,
+                                        cellBytes,
+                                        sizeof(ROW) * bufferSize.Y));
+    Log::Comment(NoThrowString().Format(L"Measured on the process heap: %zu bytes for the new buffer",
+                                        heapAfter > heapBefore ? heapAfter - heapBefore : 0));
+    Log::Comment(NoThrowString().Format(L"Created in %lld us, walked %zu cells in %lld us", createTime, glyphs, walkTime));
+}
+
+// Returns the intervals of the given pattern as { start, stop } pairs, in order.
+static std::vector<std::pair<til::point, til::point>> _PatternIntervals(const interval_tree::IntervalTree<til::point, size_t>& tree, const size_t patternId)
+{
+    std::vector<std::pair<til::point, til::point>> result;
+    tree.visit_all([&](const auto& interval) {
+        if (interval.value == patternId)
+        {
+            result.emplace_back(interval.start, interval.stop);
+        }
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// TextBuffer::UrlPattern is matched by a scanner of its own. It has to find
+// exactly what the regular expression finds, also after rows changed.
+void TextBufferTests::UrlPatternMatchesRegex()
+{
+    const COORD bufferSize{ 20, 6 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    const auto scannerId = _buffer->AddUrlPatternRecognizer();
+    const auto regexId = _buffer->AddPatternRecognizer(TextBuffer::UrlPattern);
+    VERIFY_IS_TRUE(_buffer->_idsAndPatterns.at(scannerId).isUrlPattern);
+    VERIFY_IS_FALSE(_buffer->_idsAndPatterns.at(regexId).isUrlPattern);
+
+    // Row 0 ends in a URL character, so a match may continue into row 1.
+    _buffer->WriteLine(OutputCellIterator(L"see http://a.b/c, ok"), { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"xhttp://no https://"), { 0, 1 });
+    _buffer->WriteLine(OutputCellIterator(L"https://wrap.example"), { 0, 2 });
+    _buffer->WriteLine(OutputCellIterator(L"/continued. file://x"), { 0, 3 });
+    _buffer->WriteLine(OutputCellIterator(L"\x3042\x3042 ftp://y.z/;"), { 0, 4 });
+    _buffer->WriteLine(OutputCellIterator(L"_http://a http://b)"), { 0, 5 });
+
+    auto tree = _buffer->GetPatterns(0, 5);
+    const auto expected = _PatternIntervals(tree, regexId);
+    VERIFY_ARE_EQUAL(static_cast<size_t>(5), expected.size());
+    VERIFY_IS_TRUE(expected == _PatternIntervals(tree, scannerId));
+
+    // The wrapped URL spans rows 2 and 3 and the one after the wide glyphs starts in cell 5.
+    VERIFY_IS_TRUE(std::find(expected.begin(), expected.end(), std::make_pair(til::point{ 0, 2 }, til::point{ 10, 3 })) != expected.end());
+    VERIFY_IS_TRUE(std::find(expected.begin(), expected.end(), std::make_pair(til::point{ 5, 4 }, til::point{ 15, 4 })) != expected.end());
+
+    // Rows 0 and 1 make up the first line, keyed by the revision of row 0.
+    const auto firstLine = _buffer->_urlMatchCache.find(_buffer->GetRowByOffset(0).GetRevision());
+    VERIFY_IS_TRUE(firstLine != _buffer->_urlMatchCache.end());
+    VERIFY_ARE_EQUAL(2u, firstLine->second.revisions.size());
+
+    // Change one of the rows. Its old matches must not be reused from the cache.
+    const auto revision = _buffer->GetRowByOffset(4).GetRevision();
+    _buffer->WriteLine(OutputCellIterator(L" ftp://changed      "), { 0, 4 });
+    VERIFY_ARE_NOT_EQUAL(revision, _buffer->GetRowByOffset(4).GetRevision());
+    tree = _buffer->GetPatterns(0, 5);
+    const auto changed = _PatternIntervals(tree, regexId);
+    VERIFY_IS_TRUE(changed == _PatternIntervals(tree, scannerId));
+    VERIFY_IS_TRUE(std::find(changed.begin(), changed.end(), std::make_pair(til::point{ 1, 4 }, til::point{ 14, 4 })) != changed.end());
+
+    // Searching fewer rows cuts the line of rows 2 and 3 short, so it can't be reused either.
+    tree = _buffer->GetPatterns(0, 2);
+    VERIFY_IS_TRUE(_PatternIntervals(tree, regexId) == _PatternIntervals(tree, scannerId));
+
+    // Only the lines of the last call are kept around.
+    VERIFY_IS_TRUE(_buffer->_urlMatchCache.size() <= 3u);
+}
+
+// Compares the time it takes to find the URLs in a full viewport of log output
+// through std::wregex and through the scanner, with and without cached lines.
+void TextBufferTests::UrlPatternThroughput()
+{
+    const COORD bufferSize{ 120, 30 };
+    const TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, 12, _renderTarget);
+
+    const auto scannerId = _buffer->AddUrlPatternRecognizer();
+    for (SHORT y = 0; y < bufferSize.Y; y++)
+    {
+        _buffer->WriteLine(OutputCellIterator(fmt::format(L"[{}] fetching https://example.com/packages/{}/index.json from mirror", y, y)), { 0, y });
+    }
+
+    const auto measure = [&](const wchar_t* name, const bool changeRows) {
+        const auto iterations = 100;
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < iterations; i++)
+        {
+            // Getting at the text to change it gives a row a new revision.
+            for (SHORT y = 0; changeRows && y < bufferSize.Y; y++)
+            {
+                _buffer->GetRowByOffset(y).GetCharRow();
+            }
+            _buffer->GetPatterns(0, bufferSize.Y - 1);
+        }
+        const auto delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        Log::Comment(NoThrowString().Format(L"%s: %lld us per viewport", name, delta / iterations));
+    };
+
+    measure(L"scanner, cached", false);
+    measure(L"scanner, every row changed", true);
+    _buffer->_idsAndPatterns.at(scannerId).isUrlPattern = false;
+    measure(L"std::wregex", true);
+}
+
+// Maps the legacy attributes to colors that are easy to tell apart in the HTML and RTF.
+static std::pair<COLORREF, COLORREF> _ClipboardTestColors(const TextAttribute& attr)
+{
+    const auto legacy = attr.GetLegacyAttributes();
+    return { RGB(0x10 * (legacy & 0x0F), 0, 0), RGB(0, 0, 0x10 * ((legacy >> 4) & 0x0F)) };
+}
+
+void TextBufferTests::GetClipboardDataMatchesGetText()
+{
+    COORD bufferSize{ 10, 20 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x7f };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    const std::vector<std::wstring> bufferText = { L"12345",
+                                                   L"  345",
+                                                   L"\x3042\x3044 3  ",
+                                                   L"0123456789",
+                                                   L"ab" };
+    WriteLinesToBuffer(bufferText, *_buffer);
+    _buffer->GetRowByOffset(3).GetCharRow().SetWrapForced(true);
+
+    for (const auto blockSelection : { false, true })
+    {
+        const auto textRects = _buffer->GetTextRects({ 1, 0 }, { 6, 5 }, blockSelection);
+        for (const auto includeCRLF : { false, true })
+        {
+            for (const auto trimTrailingWhitespace : { false, true })
+            {
+                Log::Comment(NoThrowString().Format(L"block: %d, CRLF: %d, trim: %d", blockSelection, includeCRLF, trimTrailingWhitespace));
+
+                std::wstring expected;
+                for (const auto& text : _buffer->GetText(includeCRLF, trimTrailingWhitespace, textRects).text)
+                {
+                    expected += text;
+                }
+
+                const auto data = _buffer->GetClipboardData(includeCRLF, trimTrailingWhitespace, textRects, _ClipboardTestColors, {});
+                VERIFY_ARE_EQUAL(expected, data.text);
+                VERIFY_IS_TRUE(data.html.empty());
+                VERIFY_IS_TRUE(data.rtf.empty());
+            }
+        }
+    }
+}
+
+void TextBufferTests::GetClipboardDataFormats()
+{
+    COORD bufferSize{ 10, 3 };
+    UINT cursorSize = 12;
+    TextAttribute attr{ 0x07 };
+    auto _buffer = std::make_unique<TextBuffer>(bufferSize, attr, cursorSize, _renderTarget);
+
+    // Two runs of different colors in the first row and a third one in the second,
+    // which has the colors of the first run again. The rest is the default attribute.
+    _buffer->WriteLine(OutputCellIterator(L"a<b", TextAttribute{ 0x1A }), { 0, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"{\\}", TextAttribute{ 0x07 }), { 3, 0 });
+    _buffer->WriteLine(OutputCellIterator(L"\x00e9", TextAttribute{ 0x1A }), { 0, 1 });
+
+    TextBuffer::ClipboardFormats formats;
+    formats.html = true;
+    formats.rtf = true;
+    formats.fontHeightPoints = 12;
+    formats.fontFaceName = L"Consolas";
+    formats.backgroundColor = RGB(0, 0, 0);
+
+    const auto textRects = _buffer->GetTextRects({ 0, 0 }, { 9, 1 }, false);
+    const auto data = _buffer->GetClipboardData(true, true, textRects, _ClipboardTestColors, formats);
+
+    VERIFY_ARE_EQUAL(std::wstring{ L"a<b{\\}\r\n\x00e9" }, data.text);
+
+    Log::Comment(L"The HTML has a span per color change and the header points at its parts.");
+    const std::string htmlBody =
+        "<!DOCTYPE><HTML><HEAD></HEAD><BODY><!--StartFragment -->"
+        "<DIV STYLE=\"display:inline-block;white-space:pre;background-color:#000000;font-family:'Consolas',monospace;font-size:12pt;padding:4px;\">"
+        "<SPAN STYLE=\"color:#A00000;background-color:#000010;\">a&lt;b</SPAN>"
+        "<SPAN STYLE=\"color:#700000;background-color:#000000;\">{\\}<BR></SPAN>"
+        "<SPAN STYLE=\"color:#A00000;background-color:#000010;\">\xC3\xA9</SPAN>"
+        "</DIV><!--EndFragment --></BODY></HTML>";
+    const size_t headerSize = 157;
+    const auto htmlHeader = fmt::format("Version:0.9\r\n"
+                                        "StartHTML:{:010}\r\n"
+                                        "EndHTML:{:010}\r\n"
+                                        "StartFragment:{:010}\r\n"
+                                        "EndFragment:{:010}\r\n"
+                                        "StartSelection:{:010}\r\n"
+                                        "EndSelection:{:010}\r\n",
+                                        headerSize,
+                                        headerSize + htmlBody.size(),
+                                        headerSize + 35,
+                                        headerSize + htmlBody.size() - 14,
+                                        headerSize + 35,
+                                        headerSize + htmlBody.size() - 14);
+    VERIFY_ARE_EQUAL(headerSize, htmlHeader.size());
+    VERIFY_IS_TRUE(htmlHeader + htmlBody == data.html);
+
+    Log::Comment(L"The RTF color table holds each color once, after the default background.");
+    const std::string rtf =
+        "{\\rtf1\\ansi\\ansicpg1252\\deff0\\nouicompat"
+        "{\\fonttbl{\\f0\\fmodern\\fcharset0 Consolas;}}"
+        "{\\colortbl ;\\red0\\green0\\blue0;\\red0\\green0\\blue16;\\red160\\green0\\blue0;\\red112\\green0\\blue0;}"
+        "\\viewkind4\\uc4\\pard\\slmult1\\f0\\fs24\\highlight1 "
+        "\\highlight2\\cf3 a<b"
+        "\\highlight1\\cf4 \\{\\\\\\}"
+        "\\line \\highlight2\\cf3 \xC3\xA9}";
+    VERIFY_IS_TRUE(rtf == data.rtf);
+}
+
+// Fills a large buffer with rows of a few differently colored runs for the clipboard benchmarks.
+static std::unique_ptr<TextBuffer> _MakeClipboardBenchmarkBuffer(Microsoft::Console::Render::IRenderTarget& renderTarget)
+{
+    const COORD bufferSize{ 120, 9001 };
+    auto buffer = std::make_unique<TextBuffer>(bufferSize, TextAttribute{ 0x07 }, 12, renderTarget);
+    for (SHORT y = 0; y < bufferSize.Y; y++)
+    {
+        buffer->WriteLine(OutputCellIterator(fmt::format(L"{:>6} ", y), TextAttribute{ 0x08 }), { 0, y });
+        buffer->WriteLine(OutputCellIterator(L"INFO ", TextAttribute{ 0x0A }), { 7, y });
+        buffer->WriteLine(OutputCellIterator(fmt::format(L"fetching <https://example.com/packages/{}/index.json> & {{retrying}}", y), TextAttribute{ 0x07 }), { 12, y });
+    }
+    return buffer;
+}
+
+// Measures the time it takes to copy a large selection as plain text only and
+// with HTML and RTF, which is what the terminals put on the clipboard.
+void TextBufferTests::ClipboardExportThroughput()
+{
+    const auto _buffer = _MakeClipboardBenchmarkBuffer(_renderTarget);
+    const auto bufferSize = _buffer->GetSize().Dimensions();
+    const auto textRects = _buffer->GetTextRects({ 0, 0 }, { bufferSize.X - 1, bufferSize.Y - 1 }, false);
+
+    TextBuffer::ClipboardFormats formats;
+    formats.fontHeightPoints = 12;
+    formats.fontFaceName = L"Cascadia Mono";
+
+    const auto measure = [&](const wchar_t* name, const bool html, const bool rtf) {
+        formats.html = html;
+        formats.rtf = rtf;
+
+        const auto iterations = 10;
+        size_t bytes = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (auto i = 0; i < iterations; i++)
+        {
+            const auto data = _buffer->GetClipboardData(true, true, textRects, _ClipboardTestColors, formats);
+            bytes = data.text.size() * sizeof(wchar_t) + data.html.size() + data.rtf.size();
+        }
+        const auto delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        Log::Comment(NoThrowString().Format(L"%s: %lld us per copy, %zu bytes", name, delta / iterations, bytes));
+    };
+
+    measure(L"text", false, false);
+    measure(L"text + HTML", true, false);
+    measure(L"text + HTML + RTF", true, true);
+}
+
+// Compares the memory the copy holds on to: the rows and per-cell colors GetText
+// collects for formatting, against the single buffer per format GetClipboardData fills.
+void TextBufferTests::ClipboardExportMemory()
+{
+    const auto _buffer = _MakeClipboardBenchmarkBuffer(_renderTarget);
+    const auto bufferSize = _buffer->GetSize().Dimensions();
+    const auto textRects = _buffer->GetTextRects({ 0, 0 }, { bufferSize.X - 1, bufferSize.Y - 1 }, false);
+
+    TextBuffer::ClipboardFormats formats;
+    formats.html = true;
+    formats.rtf = true;
+    formats.fontHeightPoints = 12;
+    formats.fontFaceName = L"Cascadia Mono";
+
+    const auto data = _buffer->GetClipboardData(true, true, textRects, _ClipboardTestColors, formats);
+    const auto outputBytes = data.text.capacity() * sizeof(wchar_t) + data.html.capacity() + data.rtf.capacity();
+
+    const auto rows = _buffer->GetText(true, true, textRects, _ClipboardTestColors);
+    auto rowBytes = rows.text.capacity() * sizeof(std::wstring) + (rows.FgAttr.capacity() + rows.BkAttr.capacity()) * sizeof(std::vector<COLORREF>);
+    for (size_t i = 0; i < rows.text.size(); i++)
+    {
+        rowBytes += rows.text[i].capacity() * sizeof(wchar_t);
+        rowBytes += (rows.FgAttr[i].capacity() + rows.BkAttr[i].capacity()) * sizeof(COLORREF);
+    }
+
+    Log::Comment(NoThrowString().Format(L"single pass: %zu bytes at peak", outputBytes));
+    Log::Comment(NoThrowString().Format(L"rows and colors first: %zu bytes at peak", rowBytes + outputBytes));
+}
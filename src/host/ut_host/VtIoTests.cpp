@@ -37,6 +37,8 @@ class Microsoft::Console::VirtualTerminal::VtIoTests
     TEST_METHOD(DtorTestStackAllocMany);
 
     TEST_METHOD(RendererDtorAndThread);
+    TEST_METHOD(RenderThreadFrameStatistics);
+    TEST_METHOD(RenderThreadPacesFrames);
 
 #ifndef __INSIDE_WINDOWS
     TEST_METHOD(RendererDtorAndThreadAndDx);
@@ -406,6 +408,11 @@ public:
     {
         return {};
     }
+
+    void GetPatternIdRuns(const SHORT /*row*/, std::vector<PatternIdRun>& runs) const noexcept
+    {
+        runs.clear();
+    }
 };
 
 void VtIoTests::RendererDtorAndThread()
@@ -433,6 +440,76 @@ void VtIoTests::RendererDtorAndThread()
     }
 }
 
+// Waits until the render thread painted the given number of frames.
+static void _WaitForFrames(const Microsoft::Console::Render::RenderThread& thread, const uint64_t frames)
+{
+    for (int i = 0; i < 5000 && thread.GetFrameStatistics().framesPainted < frames; ++i)
+    {
+        Sleep(1);
+    }
+    VERIFY_ARE_EQUAL(frames, thread.GetFrameStatistics().framesPainted);
+}
+
+void VtIoTests::RenderThreadFrameStatistics()
+{
+    Log::Comment(NoThrowString().Format(
+        L"Test that paint requests before a frame are coalesced into it"));
+
+    auto data = std::make_unique<MockRenderData>();
+    auto thread = std::make_unique<Microsoft::Console::Render::RenderThread>();
+    auto* pThread = thread.get();
+    auto pRenderer = std::make_unique<Microsoft::Console::Render::Renderer>(data.get(), nullptr, 0, std::move(thread));
+    VERIFY_SUCCEEDED(pThread->Initialize(pRenderer.get()));
+
+    pThread->NotifyPaint();
+    pThread->NotifyPaint();
+    pThread->NotifyPaint();
+    pThread->EnablePainting();
+    _WaitForFrames(*pThread, 1);
+
+    const auto stats = pThread->GetFrameStatistics();
+    VERIFY_ARE_EQUAL(2ull, stats.framesSkipped);
+    VERIFY_IS_TRUE(stats.maxLatency <= stats.totalLatency);
+
+    pRenderer->TriggerTeardown();
+    pRenderer.reset();
+}
+
+void VtIoTests::RenderThreadPacesFrames()
+{
+    Log::Comment(NoThrowString().Format(
+        L"Test that frames keep to the frame limit, but a frame after an idle period is painted right away"));
+
+    auto data = std::make_unique<MockRenderData>();
+    auto thread = std::make_unique<Microsoft::Console::Render::RenderThread>();
+    auto* pThread = thread.get();
+    auto pRenderer = std::make_unique<Microsoft::Console::Render::Renderer>(data.get(), nullptr, 0, std::move(thread));
+    VERIFY_SUCCEEDED(pThread->Initialize(pRenderer.get()));
+
+    const std::chrono::milliseconds frameLimit{ 200 };
+    pThread->SetFrameLimit(gsl::narrow_cast<DWORD>(frameLimit.count()));
+    pThread->EnablePainting();
+
+    pThread->NotifyPaint();
+    _WaitForFrames(*pThread, 1);
+
+    Log::Comment(L"A frame requested right after the last one waits for the rest of the limit.");
+    const auto secondRequest = std::chrono::steady_clock::now();
+    pThread->NotifyPaint();
+    _WaitForFrames(*pThread, 2);
+    VERIFY_IS_TRUE(std::chrono::steady_clock::now() - secondRequest >= frameLimit / 2);
+
+    Log::Comment(L"A frame requested after an idle period doesn't wait.");
+    Sleep(gsl::narrow_cast<DWORD>(frameLimit.count() * 2));
+    const auto latencyBefore = pThread->GetFrameStatistics().totalLatency;
+    pThread->NotifyPaint();
+    _WaitForFrames(*pThread, 3);
+    VERIFY_IS_TRUE(pThread->GetFrameStatistics().totalLatency - latencyBefore < frameLimit / 2);
+
+    pRenderer->TriggerTeardown();
+    pRenderer.reset();
+}
+
 #ifndef __INSIDE_WINDOWS
 void VtIoTests::RendererDtorAndThreadAndDx()
 {
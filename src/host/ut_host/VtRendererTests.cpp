@@ -83,7 +83,11 @@ class Microsoft::Console::Render::VtRendererTest
 
     TEST_METHOD(TestCursorVisibility);
 
+    TEST_METHOD(TestDiffFrames);
+    TEST_METHOD(TestDiffFramesBytesPerFrame);
+
     void Test16Colors(VtEngine* engine);
+    size_t PaintMonitorWorkload(VtEngine& engine, const size_t frames);
 
     std::deque<std::string> qExpectedInput;
     bool WriteCallback(const char* const pch, size_t const cch);
@@ -1585,3 +1589,187 @@ void VtRendererTest::FormattedString()
     qExpectedInput.push_back("\x1b[28;3;500;500;500m");
     VERIFY_SUCCEEDED(engine->_WriteFormattedString(&bigFormat, bigValue, bigValue, bigValue));
 }
+
+void VtRendererTest::TestDiffFrames()
+{
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    std::unique_ptr<Xterm256Engine> engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    auto pfn = std::bind(&VtRendererTest::WriteCallback, this, std::placeholders::_1, std::placeholders::_2);
+    engine->SetTestCallback(pfn);
+    engine->SetDiffFrames(true);
+
+    const auto paintLine = [&](const std::wstring_view line, const COORD coord) {
+        std::vector<Cluster> clusters;
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            clusters.emplace_back(line.substr(i, 1), 1u);
+        }
+        VERIFY_SUCCEEDED(engine->PaintBufferLine({ clusters.data(), clusters.size() }, coord, false, false));
+    };
+
+    qExpectedInput.push_back("\x1b[2J");
+    TestPaint(*engine, [&]() {
+        VERIFY_IS_FALSE(engine->_firstPaint);
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"The first time a line is painted, all of it is written."));
+        qExpectedInput.push_back("\x1b[H");
+        VERIFY_SUCCEEDED(engine->_MoveCursor({ 0, 0 }));
+        qExpectedInput.push_back("Hello World");
+        paintLine(L"Hello World", { 0, 0 });
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"Painting the same line again shouldn't write anything."));
+        paintLine(L"Hello World", { 0, 0 });
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"Only the changed cells are written. The unchanged 'r' between "
+            L"them is cheaper to write again than to skip."));
+        qExpectedInput.push_back("\x1b[1;7H");
+        qExpectedInput.push_back("Earth");
+        paintLine(L"Hello Earth", { 0, 0 });
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"A longer run of unchanged cells is skipped with CUF."));
+        qExpectedInput.push_back("\x1b[H");
+        qExpectedInput.push_back("J");
+        qExpectedInput.push_back("\x1b[9C");
+        qExpectedInput.push_back("i");
+        paintLine(L"Jello Earti", { 0, 0 });
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"A run of the same character is written with REP."));
+        qExpectedInput.push_back("\r\n");
+        qExpectedInput.push_back("\xe2\x94\x80");
+        qExpectedInput.push_back("\x1b[19b");
+        paintLine(std::wstring(20, L'\x2500'), { 0, 1 });
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"Trailing spaces are erased with ECH, like without diffing."));
+        qExpectedInput.push_back("\r\n");
+        qExpectedInput.push_back("ab");
+        qExpectedInput.push_back("\x1b[18X");
+        qExpectedInput.push_back("\x1b[18C");
+        paintLine(L"ab                  ", { 0, 2 });
+    });
+
+    TestPaint(*engine, [&]() {
+        Log::Comment(NoThrowString().Format(
+            L"Blanks the terminal already shows don't need to be erased again."));
+        paintLine(L"ab                  ", { 0, 2 });
+        qExpectedInput.push_back(EMPTY_CALLBACK_SENTINEL);
+        WriteCallback(EMPTY_CALLBACK_SENTINEL, 1);
+    });
+
+    Log::Comment(NoThrowString().Format(
+        L"After text was passed through, nothing is known about the terminal anymore."));
+    qExpectedInput.push_back("\x1b[m");
+    VERIFY_SUCCEEDED(engine->WriteTerminalUtf8("\x1b[m"));
+    TestPaint(*engine, [&]() {
+        qExpectedInput.push_back("\x1b[H");
+        qExpectedInput.push_back("Jello Earti");
+        paintLine(L"Jello Earti", { 0, 0 });
+    });
+}
+
+// Function Description:
+// - Paints frames of a full screen application that updates a few numbers on
+//   every frame, like a process monitor, and counts the bytes that are emitted.
+// Arguments:
+// - engine: the engine to paint with
+// - frames: the number of frames to paint
+// Return Value:
+// - The number of bytes emitted after the first frame.
+size_t VtRendererTest::PaintMonitorWorkload(VtEngine& engine, const size_t frames)
+{
+    size_t bytes = 0;
+    engine.SetTestCallback([&](const char* const /*pch*/, size_t const cch) {
+        bytes += cch;
+        return true;
+    });
+
+    const auto view = SetUpViewport();
+    const auto makeLine = [&](const size_t frame, const short row) {
+        wchar_t text[128]{};
+        if (row == 0)
+        {
+            swprintf_s(text, L"monitor - 12:%02zu:%02zu up 3 days, load average: 0.%02zu", frame / 60, frame % 60, (frame * 7) % 100);
+        }
+        else if (row == 1)
+        {
+            swprintf_s(text, L"  PID USER      PRI   VIRT    RES S  %%CPU  TIME+    COMMAND");
+        }
+        else if (row < view.Height() - 1)
+        {
+            // Every row changes its numbers every few frames.
+            const size_t tick = (frame + row) / 5;
+            swprintf_s(text,
+                       L"%5d user       20 %6d %6zu S %5.1f  0:%02zu.%02zu  process%02d",
+                       1000 + row * 7,
+                       8192 + row * 64,
+                       2048 + (tick * row) % 512,
+                       ((row * 37 + tick * 13) % 1000) / 10.0,
+                       tick / 60 % 60,
+                       tick % 60,
+                       row);
+        }
+        std::wstring line{ text };
+        line.resize(gsl::narrow_cast<size_t>(view.Width()), L' ');
+        return line;
+    };
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        if (frame == 1)
+        {
+            bytes = 0;
+        }
+
+        VERIFY_SUCCEEDED(engine.InvalidateAll());
+        TestPaint(engine, [&]() {
+            for (short row = 0; row < view.Height(); ++row)
+            {
+                const auto line = makeLine(frame, row);
+                std::vector<Cluster> clusters;
+                for (size_t i = 0; i < line.size(); i++)
+                {
+                    clusters.emplace_back(std::wstring_view{ line }.substr(i, 1), 1u);
+                }
+                VERIFY_SUCCEEDED(engine.PaintBufferLine({ clusters.data(), clusters.size() }, { 0, row }, false, false));
+            }
+        });
+    }
+    return bytes;
+}
+
+void VtRendererTest::TestDiffFramesBytesPerFrame()
+{
+    constexpr size_t frames = 100;
+
+    wil::unique_hfile hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto engine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    const auto bytes = PaintMonitorWorkload(*engine, frames);
+
+    hFile = wil::unique_hfile(INVALID_HANDLE_VALUE);
+    auto diffEngine = std::make_unique<Xterm256Engine>(std::move(hFile), SetUpViewport());
+    diffEngine->SetDiffFrames(true);
+    const auto diffBytes = PaintMonitorWorkload(*diffEngine, frames);
+
+    Log::Comment(NoThrowString().Format(L"Bytes per frame, without diffing: %zu", bytes / (frames - 1)));
+    Log::Comment(NoThrowString().Format(L"Bytes per frame, diffing frames: %zu", diffBytes / (frames - 1)));
+    VERIFY_IS_LESS_THAN(diffBytes * 4, bytes);
+}
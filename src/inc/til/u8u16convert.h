@@ -14,6 +14,10 @@ could overcome disadvantages of syscalls. Test results can be read up
 in PR #4093 and the test algorithms are available in src\tools\U8U16Test.
 Based on the results the decision was made to keep using the platform
 functions MultiByteToWideChar and WideCharToMultiByte.
+The UTF-8 to UTF-16 conversion however widens runs of ASCII characters
+itself using SIMD instructions (where available), since that's what the
+vast majority of terminal output consists of. MultiByteToWideChar is only
+called for the text in between.
 
 Author(s):
 - Steffen Illhardt (german-one) 2020
@@ -21,8 +25,115 @@ Author(s):
 
 #pragma once
 
+#if defined(_M_AMD64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define _TIL_U8U16_SSE2 1
+#elif defined(_M_ARM64)
+#include <arm64_neon.h>
+#define _TIL_U8U16_NEON 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define _TIL_U8U16_NEON 1
+#endif
+
 namespace til // Terminal Implementation Library. Also: "Today I Learned"
 {
+    namespace details
+    {
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. We walk the strings in vector sized steps.
+#pragma warning(disable : 26490) // Don't use reinterpret_cast. Required to load and store vectors.
+
+        // Routine Description:
+        // - Widens the ASCII characters at the beginning of a UTF-8 string to UTF-16.
+        //   Stops at the first code unit that isn't ASCII.
+        // Arguments:
+        // - in - pointer to the UTF-8 code units
+        // - length - number of UTF-8 code units in `in`
+        // - out - pointer to a buffer of at least `length` UTF-16 code units
+        // Return Value:
+        // - the number of converted code units (which is the same for UTF-8 and UTF-16)
+        inline size_t u8u16_widen_ascii(const char* const in, const size_t length, wchar_t* const out) noexcept
+        {
+            size_t pos{};
+
+#if _TIL_U8U16_SSE2
+            const auto zero = _mm_setzero_si128();
+            for (; pos + 16u <= length; pos += 16u)
+            {
+                const auto vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+                // movemask collects the highest bit of each byte, which is only set for non-ASCII code units
+                if (_mm_movemask_epi8(vec) != 0)
+                {
+                    break;
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos), _mm_unpacklo_epi8(vec, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + pos + 8u), _mm_unpackhi_epi8(vec, zero));
+            }
+#elif _TIL_U8U16_NEON
+            for (; pos + 16u <= length; pos += 16u)
+            {
+                const auto vec = vld1q_u8(reinterpret_cast<const uint8_t*>(in + pos));
+                if (vmaxvq_u8(vec) >= 0x80u)
+                {
+                    break;
+                }
+                vst1q_u16(reinterpret_cast<uint16_t*>(out + pos), vmovl_u8(vget_low_u8(vec)));
+                vst1q_u16(reinterpret_cast<uint16_t*>(out + pos + 8u), vmovl_high_u8(vec));
+            }
+#endif
+
+            for (; pos < length; ++pos)
+            {
+                const auto ch = static_cast<unsigned char>(in[pos]);
+                if (ch >= 0x80u)
+                {
+                    break;
+                }
+                out[pos] = static_cast<wchar_t>(ch);
+            }
+
+            return pos;
+        }
+
+        // Routine Description:
+        // - Determines the length of the non-ASCII text at the beginning of a UTF-8 string.
+        //   The text ends where a run of at least 16 ASCII characters begins (or at the string end).
+        //   Shorter runs of ASCII characters (like spaces in between words) are included,
+        //   so that MultiByteToWideChar doesn't need to be called for every single word.
+        //   As ASCII characters can't be part of any UTF-8 sequence, the text always
+        //   ends at a code point boundary.
+        // Arguments:
+        // - in - pointer to the UTF-8 code units
+        // - length - number of UTF-8 code units in `in`
+        // Return Value:
+        // - the number of UTF-8 code units in the non-ASCII text
+        inline size_t u8u16_non_ascii_length(const char* const in, const size_t length) noexcept
+        {
+            constexpr size_t minAsciiRun{ 16u };
+            size_t asciiRun{};
+
+            for (size_t pos{}; pos < length; ++pos)
+            {
+                if (static_cast<unsigned char>(in[pos]) < 0x80u)
+                {
+                    if (++asciiRun == minAsciiRun)
+                    {
+                        return pos + 1u - minAsciiRun;
+                    }
+                }
+                else
+                {
+                    asciiRun = 0u;
+                }
+            }
+
+            return length;
+        }
+
+#pragma warning(pop)
+    }
+
     template<class charT>
     class u8u16state final
     {
@@ -262,6 +373,8 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
     // - E_OUTOFMEMORY - the function failed to allocate memory for the resulting string
     // - E_ABORT       - the resulting string length would exceed the upper boundary of an int and thus, the conversion was aborted before the conversion has been completed
     // - E_UNEXPECTED  - an unexpected error occurred
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. The ASCII and non-ASCII runs are converted in place.
     template<class inT, class outT>
     [[nodiscard]] typename std::enable_if<std::is_same<typename inT::value_type, char>::value && std::is_same<typename outT::value_type, wchar_t>::value, HRESULT>::type
     u8u16(const inT in, outT& out) noexcept
@@ -279,10 +392,34 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             // The worst ratio of UTF-8 code units to UTF-16 code units is 1 to 1 if UTF-8 consists of ASCII only.
             RETURN_HR_IF(E_ABORT, !base::MakeCheckedNum(in.length()).AssignIfValid(&lengthRequired));
             out.resize(in.length()); // avoid to call MultiByteToWideChar twice only to get the required size
-            const int lengthOut = MultiByteToWideChar(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, in.data(), lengthRequired, out.data(), lengthRequired);
-            out.resize(gsl::narrow_cast<size_t>(lengthOut));
 
-            return lengthOut == 0 ? E_UNEXPECTED : S_OK;
+            const auto inData = in.data();
+            const auto outData = out.data();
+            size_t inPos{};
+            size_t outPos{};
+
+            while (true)
+            {
+                // ASCII characters are widened in place...
+                const auto asciiLength = details::u8u16_widen_ascii(inData + inPos, in.length() - inPos, outData + outPos);
+                inPos += asciiLength;
+                outPos += asciiLength;
+
+                if (inPos == in.length())
+                {
+                    break;
+                }
+
+                // ...and everything else is left to MultiByteToWideChar.
+                const auto nonAsciiLength = details::u8u16_non_ascii_length(inData + inPos, in.length() - inPos);
+                const int lengthOut = MultiByteToWideChar(gsl::narrow_cast<UINT>(CP_UTF8), 0ul, inData + inPos, gsl::narrow_cast<int>(nonAsciiLength), outData + outPos, gsl::narrow_cast<int>(in.length() - outPos));
+                RETURN_HR_IF(E_UNEXPECTED, lengthOut == 0);
+                inPos += nonAsciiLength;
+                outPos += gsl::narrow_cast<size_t>(lengthOut);
+            }
+
+            out.resize(outPos);
+            return S_OK;
         }
         catch (std::length_error&)
         {
@@ -297,6 +434,7 @@ namespace til // Terminal Implementation Library. Also: "Today I Learned"
             return E_UNEXPECTED;
         }
     }
+#pragma warning(pop)
 
     // Routine Description:
     // - Takes a UTF-8 string, complements and/or caches partials, and performs the conversion to UTF-16.
@@ -220,28 +220,33 @@ void Clipboard::StoreSelectionToClipboard(bool const copyFormatting)
         includeCRLF = trimTrailingWhitespace = true;
     }
 
-    const auto text = buffer.GetText(includeCRLF,
-                                     trimTrailingWhitespace,
-                                     selectionRects,
-                                     GetAttributeColors);
+    TextBuffer::ClipboardFormats formats;
+    if (copyFormatting)
+    {
+        const auto& fontData = gci.GetActiveOutputBuffer().GetCurrentFont();
+        formats.html = true;
+        formats.rtf = true;
+        formats.fontHeightPoints = fontData.GetUnscaledSize().Y * 72 / ServiceLocator::LocateGlobals().dpi;
+        formats.fontFaceName = fontData.GetFaceName();
+        formats.backgroundColor = gci.GetDefaultBackground();
+    }
+
+    const auto data = buffer.GetClipboardData(includeCRLF,
+                                              trimTrailingWhitespace,
+                                              selectionRects,
+                                              GetAttributeColors,
+                                              formats);
 
-    CopyTextToSystemClipboard(text, copyFormatting);
+    CopyTextToSystemClipboard(data);
 }
 
 // Routine Description:
 // - Copies the text given onto the global system clipboard.
 // Arguments:
-// - rows - Rows of text data to copy
-// - fAlsoCopyFormatting - true if the color and formatting should also be copied, false otherwise
-void Clipboard::CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows, bool const fAlsoCopyFormatting)
+// - data - The text to copy, and its HTML and RTF if those should also be copied
+void Clipboard::CopyTextToSystemClipboard(const TextBuffer::ClipboardData& data)
 {
-    std::wstring finalString;
-
-    // Concatenate strings into one giant string to put onto the clipboard.
-    for (const auto& str : rows.text)
-    {
-        finalString += str;
-    }
+    const auto& finalString = data.text;
 
     // allocate the final clipboard data
     const size_t cchNeeded = finalString.size() + 1;
@@ -269,17 +274,14 @@ void Clipboard::CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows,
         THROW_LAST_ERROR_IF(!EmptyClipboard());
         THROW_LAST_ERROR_IF_NULL(SetClipboardData(CF_UNICODETEXT, globalHandle.get()));
 
-        if (fAlsoCopyFormatting)
+        if (!data.html.empty())
         {
-            const auto& fontData = ServiceLocator::LocateGlobals().getConsoleInformation().GetActiveOutputBuffer().GetCurrentFont();
-            int const iFontHeightPoints = fontData.GetUnscaledSize().Y * 72 / ServiceLocator::LocateGlobals().dpi;
-            const COLORREF bgColor = ServiceLocator::LocateGlobals().getConsoleInformation().GetDefaultBackground();
-
-            std::string HTMLToPlaceOnClip = TextBuffer::GenHTML(rows, iFontHeightPoints, fontData.GetFaceName(), bgColor);
-            CopyToSystemClipboard(HTMLToPlaceOnClip, L"HTML Format");
+            CopyToSystemClipboard(data.html, L"HTML Format");
+        }
 
-            std::string RTFToPlaceOnClip = TextBuffer::GenRTF(rows, iFontHeightPoints, fontData.GetFaceName(), bgColor);
-            CopyToSystemClipboard(RTFToPlaceOnClip, L"Rich Text Format");
+        if (!data.rtf.empty())
+        {
+            CopyToSystemClipboard(data.rtf, L"Rich Text Format");
         }
     }
 
@@ -294,7 +296,7 @@ void Clipboard::CopyTextToSystemClipboard(const TextBuffer::TextAndColor& rows,
 // Arguments:
 // - stringToCopy - The string to copy
 // - lpszFormat - the name of the format
-void Clipboard::CopyToSystemClipboard(std::string stringToCopy, LPCWSTR lpszFormat)
+void Clipboard::CopyToSystemClipboard(const std::string& stringToCopy, LPCWSTR lpszFormat)
 {
     const size_t cbData = stringToCopy.size() + 1; // +1 for '\0'
     if (cbData)
@@ -0,0 +1,575 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT license.
+
+#include "precomp.h"
+#include "HeadlessEngine.hpp"
+#pragma hdrstop
+
+using namespace Microsoft::Console::Render;
+using namespace Microsoft::Console::Types;
+
+// Routine Description:
+// - Creates a new headless render engine with a blank grid of cells.
+// Arguments:
+// - initialViewport - The size of the grid, in characters.
+// Return Value:
+// - An instance of a HeadlessEngine.
+HeadlessEngine::HeadlessEngine(const Viewport initialViewport) :
+    RenderEngineBase(),
+    _size{ initialViewport.Dimensions() },
+    _cells(_size.area<size_t>()),
+    _invalidMap{ _size },
+    _foreground{ 0 },
+    _background{ 0 },
+    _cursorPosition{},
+    _statistics{}
+{
+}
+
+// Routine Description:
+// - Gets a cell of the grid, as it was left by the last frame.
+// Arguments:
+// - coord - The position of the cell, relative to the viewport.
+// Return Value:
+// - The cell. Throws if the position is outside the grid.
+const HeadlessEngine::Cell& HeadlessEngine::GetCell(const COORD coord) const
+{
+    const auto index = til::rectangle{ _size }.index_of(til::point{ coord });
+    return til::at(_cells, gsl::narrow_cast<size_t>(index));
+}
+
+// Routine Description:
+// - Gets the text of a row of the grid, as it was left by the last frame.
+// Arguments:
+// - row - The row, relative to the viewport.
+// Return Value:
+// - The text of every cluster in the row, one after the other.
+std::wstring HeadlessEngine::GetRowText(const SHORT row) const
+{
+    std::wstring text;
+    for (SHORT column = 0; column < _size.width<SHORT>(); ++column)
+    {
+        text.append(GetCell({ column, row }).text);
+    }
+    return text;
+}
+
+// Routine Description:
+// - Gets where the cursor was painted in the last frame.
+// Arguments:
+// - <none>
+// Return Value:
+// - The position of the cursor, or nullopt if it wasn't painted or was off.
+std::optional<COORD> HeadlessEngine::GetCursorPosition() const noexcept
+{
+    return _cursorPosition;
+}
+
+// Routine Description:
+// - Gets the number of frames painted, and of the lines, clusters, brushes
+//   and gridlines they were painted with, since the statistics were last reset.
+// Arguments:
+// - <none>
+// Return Value:
+// - The statistics.
+HeadlessEngine::Statistics HeadlessEngine::GetStatistics() const noexcept
+{
+    return _statistics;
+}
+
+// Routine Description:
+// - Resets the statistics to 0.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void HeadlessEngine::ResetStatistics() noexcept
+{
+    _statistics = {};
+}
+
+// Routine Description:
+// - Prepares to paint a frame.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK if there's something to paint, else S_FALSE.
+[[nodiscard]] HRESULT HeadlessEngine::StartPaint() noexcept
+{
+    if (!_invalidMap.any() && !_titleChanged)
+    {
+        return S_FALSE;
+    }
+
+    // The cursor is painted again in every frame it's visible.
+    _cursorPosition.reset();
+    return S_OK;
+}
+
+// Routine Description:
+// - Finishes painting a frame. Everything that was invalid has been painted.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT HeadlessEngine::EndPaint() noexcept
+{
+    _invalidMap.reset_all();
+    ++_statistics.frames;
+    return S_OK;
+}
+
+// Routine Description:
+// - There's nothing to present, the grid is painted directly.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_FALSE since we do nothing.
+[[nodiscard]] HRESULT HeadlessEngine::Present() noexcept
+{
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Notifies us that we're about to be torn down. The grid isn't shown
+//   anywhere, so there's no need to paint it one last time.
+// Arguments:
+// - pForcePaint - Always filled with false.
+// Return Value:
+// - S_FALSE since we do nothing.
+[[nodiscard]] HRESULT HeadlessEngine::PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept
+{
+    *pForcePaint = false;
+    return S_FALSE;
+}
+
+// Routine Description:
+// - The cells are already moved by InvalidateScroll.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_FALSE since we do nothing.
+[[nodiscard]] HRESULT HeadlessEngine::ScrollFrame() noexcept
+{
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Notifies us that the console has changed the character region specified.
+// Arguments:
+// - psrRegion - Character region (SMALL_RECT) that has been changed
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::Invalidate(const SMALL_RECT* const psrRegion) noexcept
+try
+{
+    const til::rectangle rect{ Viewport::FromExclusive(*psrRegion).ToInclusive() };
+    _invalidMap.set(rect & til::rectangle{ _size });
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Notifies us that the console has changed the position of the cursor.
+// Arguments:
+// - pcoordCursor - the new position of the cursor
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::InvalidateCursor(const COORD* const pcoordCursor) noexcept
+{
+    SMALL_RECT sr = Viewport::FromCoord(*pcoordCursor).ToExclusive();
+    return Invalidate(&sr);
+}
+
+// Routine Description:
+// - Notifies us that the system has requested a particular pixel area of the
+//   client rectangle should be redrawn. We don't have pixels, so do nothing.
+// Arguments:
+// - prcDirtyClient - <unused>
+// Return Value:
+// - S_FALSE since we do nothing.
+[[nodiscard]] HRESULT HeadlessEngine::InvalidateSystem(const RECT* const /*prcDirtyClient*/) noexcept
+{
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Notifies us that the console has changed the selection region.
+// Arguments:
+// - rectangles - The rectangles of the selection, line by line
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept
+try
+{
+    for (const auto& rect : rectangles)
+    {
+        _invalidMap.set(til::rectangle{ rect } & til::rectangle{ _size });
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Notifies us that the console is scrolling. Like a real surface, the grid
+//   moves its cells, and only the revealed area needs to be painted again.
+// Arguments:
+// - pcoordDelta - The distance to move the cells.
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::InvalidateScroll(const COORD* const pcoordDelta) noexcept
+try
+{
+    const til::point delta{ *pcoordDelta };
+    if (delta != til::point{ 0, 0 })
+    {
+        _ScrollCells(delta);
+        _invalidMap.translate(delta, true);
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Notifies us to repaint everything.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT HeadlessEngine::InvalidateAll() noexcept
+{
+    _invalidMap.set_all();
+    return S_OK;
+}
+
+// Routine Description:
+// - Notifies us that we're about to circle the buffer. The grid doesn't need
+//   to keep up with the buffer, so there's no need to paint before that.
+// Arguments:
+// - pForcePaint - Always filled with false.
+// Return Value:
+// - S_FALSE since we do nothing.
+[[nodiscard]] HRESULT HeadlessEngine::InvalidateCircling(_Out_ bool* const pForcePaint) noexcept
+{
+    *pForcePaint = false;
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Clears the invalid area of the frame to blank cells in the current
+//   background color, which was just set to the default one.
+// Arguments:
+// - <none>
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::PaintBackground() noexcept
+try
+{
+    for (const auto& rect : _invalidMap.runs())
+    {
+        for (auto row = rect.top(); row < rect.bottom(); ++row)
+        {
+            for (auto column = rect.left(); column < rect.right(); ++column)
+            {
+                auto& cell = _CellAt({ column, row });
+                cell.text.clear();
+                cell.foreground = _foreground;
+                cell.background = _background;
+                cell.gridLines = GridLines::None;
+                cell.selected = false;
+            }
+        }
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Writes a run of clusters into the grid, with the current brushes.
+// Arguments:
+// - clusters - The text and column counts of the clusters to write.
+// - coord - The position of the first cluster, relative to the viewport.
+// - fTrimLeft - True if the first column of the first cluster is outside
+//      the invalid area, and mustn't be written.
+// - lineWrapped - <unused>
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::PaintBufferLine(gsl::span<const Cluster> const clusters,
+                                                      const COORD coord,
+                                                      const bool fTrimLeft,
+                                                      const bool /*lineWrapped*/) noexcept
+try
+{
+    const til::rectangle bounds{ _size };
+    const auto row = ptrdiff_t{ coord.Y };
+    auto x = ptrdiff_t{ coord.X };
+    bool trimLeft = fTrimLeft;
+
+    for (const auto& cluster : clusters)
+    {
+        const auto columns = gsl::narrow_cast<ptrdiff_t>(cluster.GetColumns());
+        for (ptrdiff_t column = 0; column < columns; ++column)
+        {
+            const til::point cellPoint{ x + column, row };
+            if (trimLeft || !bounds.contains(cellPoint))
+            {
+                trimLeft = false;
+                continue;
+            }
+
+            auto& cell = _CellAt(cellPoint);
+            if (column == 0)
+            {
+                cell.text = cluster.GetText();
+            }
+            else
+            {
+                cell.text.clear();
+            }
+            cell.foreground = _foreground;
+            cell.background = _background;
+        }
+
+        x += columns;
+        trimLeft = false;
+    }
+
+    ++_statistics.lines;
+    _statistics.clusters += clusters.size();
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Records the lines drawn around a run of cells.
+// Arguments:
+// - lines - The lines to draw.
+// - color - <unused>
+// - cchLine - The number of cells in the run.
+// - coordTarget - The position of the first cell, relative to the viewport.
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::PaintBufferGridLines(const GridLines lines,
+                                                           const COLORREF /*color*/,
+                                                           const size_t cchLine,
+                                                           const COORD coordTarget) noexcept
+try
+{
+    const til::rectangle bounds{ _size };
+    const til::point target{ coordTarget };
+
+    for (size_t i = 0; i < cchLine; ++i)
+    {
+        const til::point cellPoint{ target.x() + gsl::narrow_cast<ptrdiff_t>(i), target.y() };
+        if (bounds.contains(cellPoint))
+        {
+            _CellAt(cellPoint).gridLines = lines;
+        }
+    }
+
+    ++_statistics.gridLines;
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Marks a region of cells as selected.
+// Arguments:
+// - rect - The selected region, relative to the viewport.
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::PaintSelection(const SMALL_RECT rect) noexcept
+try
+{
+    const auto selection = til::rectangle{ rect } & til::rectangle{ _size };
+    for (auto row = selection.top(); row < selection.bottom(); ++row)
+    {
+        for (auto column = selection.left(); column < selection.right(); ++column)
+        {
+            _CellAt({ column, row }).selected = true;
+        }
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Records where the cursor is painted.
+// Arguments:
+// - options - The position and appearance of the cursor.
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT HeadlessEngine::PaintCursor(const CursorOptions& options) noexcept
+{
+    if (options.isOn)
+    {
+        _cursorPosition = options.coordCursor;
+    }
+    return S_OK;
+}
+
+// Routine Description:
+// - Sets the colors the next cells are painted with.
+// Arguments:
+// - textAttributes - The attributes of the next cells.
+// - pData - The interface to retrieve the colors of the attributes.
+// - isSettingDefaultBrushes - <unused>
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT HeadlessEngine::UpdateDrawingBrushes(const TextAttribute& textAttributes,
+                                                           const gsl::not_null<IRenderData*> pData,
+                                                           const bool /*isSettingDefaultBrushes*/) noexcept
+{
+    std::tie(_foreground, _background) = pData->GetAttributeColors(textAttributes);
+    ++_statistics.brushes;
+    return S_OK;
+}
+
+// Routine Description:
+// - Currently unused by this renderer
+// Arguments:
+// - FontInfoDesired - <unused>
+// - FontInfo - <unused>
+// Return Value:
+// - S_FALSE since we do nothing
+[[nodiscard]] HRESULT HeadlessEngine::UpdateFont(const FontInfoDesired& /*FontInfoDesired*/, _Out_ FontInfo& /*FontInfo*/) noexcept
+{
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Currently unused by this renderer
+// Arguments:
+// - iDpi - <unused>
+// Return Value:
+// - S_FALSE since we do nothing
+[[nodiscard]] HRESULT HeadlessEngine::UpdateDpi(const int /*iDpi*/) noexcept
+{
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Resizes the grid to the size of the viewport. The cells that are revealed
+//   by the resize need to be painted.
+// Arguments:
+// - srNewViewport - The bounds of the new viewport.
+// Return Value:
+// - S_OK if the grid was resized, S_FALSE if its size didn't change, else an
+//   appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT HeadlessEngine::UpdateViewport(const SMALL_RECT srNewViewport) noexcept
+try
+{
+    const til::size newSize{ Viewport::FromInclusive(srNewViewport).Dimensions() };
+    if (newSize == _size)
+    {
+        return S_FALSE;
+    }
+
+    std::vector<Cell> cells(newSize.area<size_t>());
+    const til::rectangle newBounds{ newSize };
+    const auto kept = til::rectangle{ _size } & newBounds;
+    for (auto row = kept.top(); row < kept.bottom(); ++row)
+    {
+        for (auto column = kept.left(); column < kept.right(); ++column)
+        {
+            const til::point point{ column, row };
+            til::at(cells, gsl::narrow_cast<size_t>(newBounds.index_of(point))) = std::move(_CellAt(point));
+        }
+    }
+
+    _cells = std::move(cells);
+    _size = newSize;
+    _invalidMap.resize(newSize, true);
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Currently unused by this renderer
+// Arguments:
+// - FontInfoDesired - <unused>
+// - FontInfo - <unused>
+// - iDpi - <unused>
+// Return Value:
+// - S_FALSE since we do nothing
+[[nodiscard]] HRESULT HeadlessEngine::GetProposedFont(const FontInfoDesired& /*FontInfoDesired*/,
+                                                      _Out_ FontInfo& /*FontInfo*/,
+                                                      const int /*iDpi*/) noexcept
+{
+    return S_FALSE;
+}
+
+// Routine Description:
+// - Gets the area of the grid that needs to be painted.
+// Arguments:
+// - <none>
+// Return Value:
+// - The invalid rectangles, in characters.
+std::vector<til::rectangle> HeadlessEngine::GetDirtyArea()
+{
+    return _invalidMap.runs();
+}
+
+// Routine Description:
+// - Gets the size of a cell. The grid doesn't have pixels, so it's a cell.
+// Arguments:
+// - pFontSize - Filled with a size of 1x1.
+// Return Value:
+// - S_OK
+[[nodiscard]] HRESULT HeadlessEngine::GetFontSize(_Out_ COORD* const pFontSize) noexcept
+{
+    *pFontSize = { 1, 1 };
+    return S_OK;
+}
+
+// Routine Description:
+// - Currently unused by this renderer. Without a font, no glyph is wide.
+// Arguments:
+// - glyph - <unused>
+// - pResult - Always filled with false.
+// Return Value:
+// - S_FALSE since we do nothing
+[[nodiscard]] HRESULT HeadlessEngine::IsGlyphWideByFont(const std::wstring_view /*glyph*/, _Out_ bool* const pResult) noexcept
+{
+    *pResult = false;
+    return S_FALSE;
+}
+
+// Method Description:
+// - Currently unused by this renderer.
+// Arguments:
+// - newTitle: <unused>
+// Return Value:
+// - S_FALSE
+[[nodiscard]] HRESULT HeadlessEngine::_DoUpdateTitle(const std::wstring& /*newTitle*/) noexcept
+{
+    return S_FALSE;
+}
+
+HeadlessEngine::Cell& HeadlessEngine::_CellAt(const til::point point)
+{
+    return til::at(_cells, gsl::narrow_cast<size_t>(til::rectangle{ _size }.index_of(point)));
+}
+
+// Routine Description:
+// - Moves the cells of the grid, like scrolling a surface would. The cells
+//   that are revealed are left as they were, until they're painted again.
+// Arguments:
+// - delta - The distance to move the cells.
+// Return Value:
+// - <none>
+void HeadlessEngine::_ScrollCells(const til::point delta)
+{
+    std::vector<Cell> cells(_cells.size());
+    const til::rectangle bounds{ _size };
+    const auto moved = (bounds + delta) & bounds;
+    for (auto row = moved.top(); row < moved.bottom(); ++row)
+    {
+        for (auto column = moved.left(); column < moved.right(); ++column)
+        {
+            const til::point point{ column, row };
+            til::at(cells, gsl::narrow_cast<size_t>(bounds.index_of(point))) = std::move(_CellAt(point - delta));
+        }
+    }
+    _cells = std::move(cells);
+}
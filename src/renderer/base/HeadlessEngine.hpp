@@ -0,0 +1,115 @@
+/*++
+Copyright (c) Microsoft Corporation
+Licensed under the MIT license.
+
+Module Name:
+- HeadlessEngine.hpp
+
+Abstract:
+- A render engine that paints into a grid of cells in memory instead of onto
+  a window or a pipe. It records the clusters, brushes, gridlines, selection
+  and cursor it receives from the Renderer, so that the Renderer can be tested
+  and measured on its own, without GDI, DirectX or a terminal on the other end.
+--*/
+
+#pragma once
+
+#include "../inc/RenderEngineBase.hpp"
+
+namespace Microsoft::Console::Render
+{
+    class HeadlessEngine final : public RenderEngineBase
+    {
+    public:
+        struct Cell
+        {
+            // The text of the cluster that starts in this cell. Empty for the
+            // cells covered by the rest of a wide cluster.
+            std::wstring text;
+            COLORREF foreground = 0;
+            COLORREF background = 0;
+            GridLines gridLines = GridLines::None;
+            bool selected = false;
+        };
+
+        struct Statistics
+        {
+            size_t frames;
+            size_t lines;
+            size_t clusters;
+            size_t brushes;
+            size_t gridLines;
+        };
+
+        HeadlessEngine(const Microsoft::Console::Types::Viewport initialViewport);
+
+        const Cell& GetCell(const COORD coord) const;
+        std::wstring GetRowText(const SHORT row) const;
+        std::optional<COORD> GetCursorPosition() const noexcept;
+        Statistics GetStatistics() const noexcept;
+        void ResetStatistics() noexcept;
+
+        // IRenderEngine Members
+        [[nodiscard]] HRESULT StartPaint() noexcept override;
+        [[nodiscard]] HRESULT EndPaint() noexcept override;
+        [[nodiscard]] HRESULT Present() noexcept override;
+
+        [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
+
+        [[nodiscard]] HRESULT ScrollFrame() noexcept override;
+
+        [[nodiscard]] HRESULT Invalidate(const SMALL_RECT* const psrRegion) noexcept override;
+        [[nodiscard]] HRESULT InvalidateCursor(const COORD* const pcoordCursor) noexcept override;
+        [[nodiscard]] HRESULT InvalidateSystem(const RECT* const prcDirtyClient) noexcept override;
+        [[nodiscard]] HRESULT InvalidateSelection(const std::vector<SMALL_RECT>& rectangles) noexcept override;
+        [[nodiscard]] HRESULT InvalidateScroll(const COORD* const pcoordDelta) noexcept override;
+        [[nodiscard]] HRESULT InvalidateAll() noexcept override;
+        [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override;
+
+        [[nodiscard]] HRESULT PaintBackground() noexcept override;
+        [[nodiscard]] HRESULT PaintBufferLine(gsl::span<const Cluster> const clusters,
+                                              const COORD coord,
+                                              const bool fTrimLeft,
+                                              const bool lineWrapped) noexcept override;
+        [[nodiscard]] HRESULT PaintBufferGridLines(const GridLines lines,
+                                                   const COLORREF color,
+                                                   const size_t cchLine,
+                                                   const COORD coordTarget) noexcept override;
+        [[nodiscard]] HRESULT PaintSelection(const SMALL_RECT rect) noexcept override;
+
+        [[nodiscard]] HRESULT PaintCursor(const CursorOptions& options) noexcept override;
+
+        [[nodiscard]] HRESULT UpdateDrawingBrushes(const TextAttribute& textAttributes,
+                                                   const gsl::not_null<IRenderData*> pData,
+                                                   const bool isSettingDefaultBrushes) noexcept override;
+        [[nodiscard]] HRESULT UpdateFont(const FontInfoDesired& FontInfoDesired,
+                                         _Out_ FontInfo& FontInfo) noexcept override;
+        [[nodiscard]] HRESULT UpdateDpi(const int iDpi) noexcept override;
+        [[nodiscard]] HRESULT UpdateViewport(const SMALL_RECT srNewViewport) noexcept override;
+
+        [[nodiscard]] HRESULT GetProposedFont(const FontInfoDesired& FontInfoDesired,
+                                              _Out_ FontInfo& FontInfo,
+                                              const int iDpi) noexcept override;
+
+        std::vector<til::rectangle> GetDirtyArea() override;
+        [[nodiscard]] HRESULT GetFontSize(_Out_ COORD* const pFontSize) noexcept override;
+        [[nodiscard]] HRESULT IsGlyphWideByFont(const std::wstring_view glyph, _Out_ bool* const pResult) noexcept override;
+
+    protected:
+        [[nodiscard]] HRESULT _DoUpdateTitle(const std::wstring& newTitle) noexcept override;
+
+    private:
+        Cell& _CellAt(const til::point point);
+        void _ScrollCells(const til::point delta);
+
+        til::size _size;
+        std::vector<Cell> _cells;
+        til::bitmap _invalidMap;
+
+        COLORREF _foreground;
+        COLORREF _background;
+        std::optional<COORD> _cursorPosition;
+
+        Statistics _statistics;
+    };
+}
@@ -43,7 +43,10 @@ HRESULT RenderEngineBase::PrepareRenderInfo(const RenderFrameInfo& /*info*/) noe
 
 // Method Description:
 // - Blocks until the engine is able to render without blocking.
-void RenderEngineBase::WaitUntilCanRender() noexcept
+// Return Value:
+// - true if the engine waited for the display, which paces the frames.
+bool RenderEngineBase::WaitUntilCanRender() noexcept
 {
     // do nothing by default
+    return false;
 }
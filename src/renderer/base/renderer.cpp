@@ -32,6 +32,8 @@ Renderer::Renderer(IRenderData* pData,
     _pThread{ std::move(thread) },
     _destructing{ false },
     _clusterBuffer{},
+    _patternIdRuns{},
+    _attrRuns{},
     _viewport{ pData->GetViewport() }
 {
     for (size_t i = 0; i < cEngines; i++)
@@ -654,18 +656,18 @@ void Renderer::_PaintBufferOutput(_In_ IRenderEngine* const pEngine)
                 // This means that we need 14,27 out of the backing buffer to fill in the 1,1 cell of the screen.
                 const auto screenLine = Viewport::Offset(bufferLine, -view.Origin());
 
-                // Retrieve the cell information iterator limited to just this line we want to redraw.
-                auto it = buffer.GetCellDataAt(bufferLine.Origin(), bufferLine);
+                // Retrieve the row that holds the line we want to redraw.
+                const auto& bufferRow = buffer.GetRowByOffset(bufferLine.Origin().Y);
 
                 // Calculate if two things are true:
                 // 1. this row wrapped
                 // 2. We're painting the last col of the row.
                 // In that case, set lineWrapped=true for the _PaintBufferOutputHelper call.
-                const auto lineWrapped = (buffer.GetRowByOffset(bufferLine.Origin().Y).GetCharRow().WasWrapForced()) &&
+                const auto lineWrapped = (bufferRow.GetCharRow().WasWrapForced()) &&
                                          (bufferLine.RightExclusive() == buffer.GetSize().Width());
 
                 // Ask the helper to paint through this specific line.
-                _PaintBufferOutputHelper(pEngine, it, screenLine.Origin(), lineWrapped);
+                _PaintBufferOutputHelper(pEngine, bufferRow, bufferLine.Left(), bufferLine.RightExclusive(), screenLine.Origin(), lineWrapped);
             }
         }
     }
@@ -677,164 +679,231 @@ static bool _IsAllSpaces(const std::wstring_view v)
     return v.find_first_not_of(L" ") == decltype(v)::npos;
 }
 
+// Routine Description:
+// - Paint helper for one line of the buffer, from the left column up to the right one.
+// - The clusters refer straight to the glyphs stored in the row, and the colors come from the runs
+//   of attributes of the row, so that nothing is copied or compared cell by cell. The vectors this
+//   fills are kept between calls, so once they've grown to fit a row, painting allocates nothing.
+// Arguments:
+// - pEngine - The render engine that we're targeting.
+// - row - The row of the buffer to paint.
+// - left - The first column of the row to paint.
+// - right - The column after the last one to paint.
+// - target - Where on the screen the left column is painted.
+// - lineWrapped - True if the row wrapped and the right column is the last one of the row.
+// Return Value:
+// - <none>
 void Renderer::_PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                        TextBufferCellIterator it,
+                                        const ROW& row,
+                                        const SHORT left,
+                                        const SHORT right,
                                         const COORD target,
                                         const bool lineWrapped)
 {
-    auto globalInvert{ _pData->IsScreenReversed() };
+    // If we have no valid data, there's nothing to draw.
+    if (left < 0 || left >= right)
+    {
+        return;
+    }
+
+    const auto globalInvert{ _pData->IsScreenReversed() };
+    const auto& charRow = row.GetCharRow();
+
+    // Retrieve the attribute runs of the columns all at once.
+    // A color can only change where a run ends.
+    row.GetAttrRow().GetRuns(left, gsl::narrow_cast<size_t>(right) - left, _attrRuns);
+    // The runs start at the left column. The end of a run is the column after its last one.
+    size_t attrRunIndex = 0;
+    SHORT attrRunEnd = left + gsl::narrow_cast<SHORT>(til::at(_attrRuns, 0).GetLength());
 
-    // If we have valid data, let's figure out how to draw it.
-    if (it)
+    // Moves a run index and the column where that run ends along to the run of the given column.
+    const auto seekAttrRun = [&](const SHORT column, size_t& runIndex, SHORT& runEnd) {
+        while (column >= runEnd && runIndex + 1 < _attrRuns.size())
+        {
+            ++runIndex;
+            runEnd += gsl::narrow_cast<SHORT>(til::at(_attrRuns, runIndex).GetLength());
+        }
+    };
+
+    // Retrieve the pattern id runs of this row all at once.
+    // Asking for the ids of every single cell is far too slow.
+    _pData->GetPatternIdRuns(target.Y, _patternIdRuns);
+    size_t patternRunIndex = 0;
+
+    // Retrieve the first color.
+    auto color = til::at(_attrRuns, attrRunIndex).GetAttributes();
+    // Retrieve the first pattern ids. Neighboring runs never share the same ids,
+    // so comparing the run pointers is as good as comparing the ids themselves.
+    // They stay the same until the column they end at.
+    auto patternIds = _PatternIdsAt(target.X, patternRunIndex);
+    auto patternIdsEnd = _PatternIdsEnd(target.X, patternRunIndex);
+
+    // And hold the point where we should start drawing.
+    auto screenPoint = target;
+    size_t cols = 0;
+    auto column = left;
+
+    // This outer loop will continue until we reach the end of the text we are trying to draw.
+    while (column < right)
     {
-        // TODO: MSFT: 20961091 -  This is a perf issue. Instead of rebuilding this and allocing memory to hold the reinterpretation,
-        // we should have an iterator/view adapter for the rendering.
-        // That would probably also eliminate the RenderData needing to give us the entire TextBuffer as well...
-        // Retrieve the iterator for one line of information.
-        size_t cols = 0;
-
-        // Retrieve the first color.
-        auto color = it->TextAttr();
-        // Retrieve the first pattern id
-        auto patternIds = _pData->GetPatternId(target);
-
-        // And hold the point where we should start drawing.
-        auto screenPoint = target;
-
-        // This outer loop will continue until we reach the end of the text we are trying to draw.
-        while (it)
+        // Hold onto the current run color right here for the length of the outer loop.
+        // We'll be changing the persistent one as we run through the inner loops to detect
+        // when a run changes, but we will still need to know this color at the bottom
+        // when we go to draw gridlines for the length of the run.
+        const auto currentRunColor = color;
+
+        // Update the drawing brushes with our color.
+        THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, false));
+
+        // Advance the point by however many columns we've just outputted and reset the accumulator.
+        screenPoint.X += gsl::narrow<SHORT>(cols);
+        cols = 0;
+
+        // Hold onto the start of this run and the target location where we started
+        // in case we need to do some special work to paint the line drawing characters.
+        const auto currentRunColumnStart = column;
+        const auto currentRunTargetStart = screenPoint;
+        const auto currentRunAttrIndex = attrRunIndex;
+        const auto currentRunAttrEnd = attrRunEnd;
+
+        // Whether the attributes of the current attribute run differ from the color,
+        // which only needs to be checked again once we get to the next attribute run.
+        const TextAttribute* comparedAttr = nullptr;
+        bool attrDiffers = false;
+
+        // Ensure that our cluster vector is clear.
+        _clusterBuffer.clear();
+
+        // Reset our flag to know when we're in the special circumstance
+        // of attempting to draw only the right-half of a two-column character
+        // as the first item in our run.
+        bool trimLeft = false;
+
+        // Run contains wide character (>1 columns)
+        bool containsWideCharacter = false;
+
+        // This inner loop will accumulate clusters until the color changes.
+        // When the color changes, it will save the new color off and break.
+        // We also accumulate clusters according to regex patterns
+        do
         {
-            // Hold onto the current run color right here for the length of the outer loop.
-            // We'll be changing the persistent one as we run through the inner loops to detect
-            // when a run changes, but we will still need to know this color at the bottom
-            // when we go to draw gridlines for the length of the run.
-            const auto currentRunColor = color;
-
-            // Hold onto the current pattern id as well
-            const auto currentPatternId = patternIds;
-
-            // Update the drawing brushes with our color.
-            THROW_IF_FAILED(_UpdateDrawingBrushes(pEngine, currentRunColor, false));
-
-            // Advance the point by however many columns we've just outputted and reset the accumulator.
-            screenPoint.X += gsl::narrow<SHORT>(cols);
-            cols = 0;
-
-            // Hold onto the start of this run iterator and the target location where we started
-            // in case we need to do some special work to paint the line drawing characters.
-            const auto currentRunItStart = it;
-            const auto currentRunTargetStart = screenPoint;
-
-            // Ensure that our cluster vector is clear.
-            _clusterBuffer.clear();
-
-            // Reset our flag to know when we're in the special circumstance
-            // of attempting to draw only the right-half of a two-column character
-            // as the first item in our run.
-            bool trimLeft = false;
-
-            // Run contains wide character (>1 columns)
-            bool containsWideCharacter = false;
-
-            // This inner loop will accumulate clusters until the color changes.
-            // When the color changes, it will save the new color off and break.
-            // We also accumulate clusters according to regex patterns
-            do
+            seekAttrRun(column, attrRunIndex, attrRunEnd);
+            const auto& attr = til::at(_attrRuns, attrRunIndex).GetAttributes();
+            if (&attr != comparedAttr)
             {
-                COORD thisPoint{ screenPoint.X + gsl::narrow<SHORT>(cols), screenPoint.Y };
-                const auto thisPointPatterns = _pData->GetPatternId(thisPoint);
-                if (color != it->TextAttr() || patternIds != thisPointPatterns)
+                comparedAttr = &attr;
+                attrDiffers = color != attr;
+            }
+
+            auto thisPointPatterns = patternIds;
+            const auto thisPointX = gsl::narrow<SHORT>(screenPoint.X + cols);
+            if (thisPointX >= patternIdsEnd)
+            {
+                thisPointPatterns = _PatternIdsAt(thisPointX, patternRunIndex);
+                patternIdsEnd = _PatternIdsEnd(thisPointX, patternRunIndex);
+            }
+            const auto patternsChanged = patternIds != thisPointPatterns;
+
+            const std::wstring_view glyph{ charRow.GlyphAt(column) };
+            if (attrDiffers || patternsChanged)
+            {
+                // foreground doesn't matter for runs of spaces (!)
+                // if we trick it . . . we call Paint far fewer times for cmatrix
+                if (!_IsAllSpaces(glyph) || !attr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || patternsChanged)
                 {
-                    auto newAttr{ it->TextAttr() };
-                    // foreground doesn't matter for runs of spaces (!)
-                    // if we trick it . . . we call Paint far fewer times for cmatrix
-                    if (!_IsAllSpaces(it->Chars()) || !newAttr.HasIdenticalVisualRepresentationForBlankSpace(color, globalInvert) || patternIds != thisPointPatterns)
-                    {
-                        color = newAttr;
-                        patternIds = thisPointPatterns;
-                        break; // vend this run
-                    }
+                    color = attr;
+                    patternIds = thisPointPatterns;
+                    break; // vend this run
                 }
+            }
 
-                // Walk through the text data and turn it into rendering clusters.
-                // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
-                size_t columnCount = 0;
+            // Turn the cell into a rendering cluster.
+            // Keep the columnCount as we go to improve performance over digging it out of the vector at the end.
+            const auto dbcsAttr = charRow.DbcsAttrAt(column);
+            const size_t cellColumns = dbcsAttr.IsLeading() ? 2 : 1;
+            size_t columnCount = 0;
 
-                // If we're on the first cluster to be added and it's marked as "trailing"
-                // (a.k.a. the right half of a two column character), then we need some special handling.
-                if (_clusterBuffer.empty() && it->DbcsAttr().IsTrailing())
+            // If we're on the first cluster to be added and it's marked as "trailing"
+            // (a.k.a. the right half of a two column character), then we need some special handling.
+            if (_clusterBuffer.empty() && dbcsAttr.IsTrailing())
+            {
+                // If we have room to move to the left to start drawing...
+                if (screenPoint.X > 0)
                 {
-                    // If we have room to move to the left to start drawing...
-                    if (screenPoint.X > 0)
-                    {
-                        // Move left to the one so the whole character can be struck correctly.
-                        --screenPoint.X;
-                        // And tell the next function to trim off the left half of it.
-                        trimLeft = true;
-                        // And add one to the number of columns we expect it to take as we insert it.
-                        columnCount = it->Columns() + 1;
-                        _clusterBuffer.emplace_back(it->Chars(), columnCount);
-                    }
-                    else
-                    {
-                        // If we didn't have room, move to the right one and just skip this one.
-                        screenPoint.X++;
-                        continue;
-                    }
+                    // Move left to the one so the whole character can be struck correctly.
+                    --screenPoint.X;
+                    // And tell the next function to trim off the left half of it.
+                    trimLeft = true;
+                    // And add one to the number of columns we expect it to take as we insert it.
+                    columnCount = cellColumns + 1;
+                    _clusterBuffer.emplace_back(glyph, columnCount);
                 }
-                // Otherwise if it's not a special case, just insert it as is.
                 else
                 {
-                    columnCount = it->Columns();
-                    _clusterBuffer.emplace_back(it->Chars(), columnCount);
+                    // If we didn't have room, move to the right one and just skip this one.
+                    screenPoint.X++;
+                    continue;
                 }
+            }
+            // Otherwise if it's not a special case, just insert it as is.
+            else
+            {
+                columnCount = cellColumns;
+                _clusterBuffer.emplace_back(glyph, columnCount);
+            }
 
-                if (columnCount > 1)
-                {
-                    containsWideCharacter = true;
-                }
+            if (columnCount > 1)
+            {
+                containsWideCharacter = true;
+            }
 
-                // Advance the cluster and column counts.
-                it += columnCount > 0 ? columnCount : 1; // prevent infinite loop for no visible columns
-                cols += columnCount;
+            // Advance past the cell and the columns it covers on the screen.
+            // A trimmed trailing half covers one more column than it takes in the row.
+            column += gsl::narrow_cast<SHORT>(cellColumns);
+            cols += columnCount;
 
-            } while (it);
+        } while (column < right);
 
-            // Do the painting.
-            THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
+        // Do the painting.
+        THROW_IF_FAILED(pEngine->PaintBufferLine({ _clusterBuffer.data(), _clusterBuffer.size() }, screenPoint, trimLeft, lineWrapped));
 
-            // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
-            // We're only allowed to draw the grid lines under certain circumstances.
-            if (_pData->IsGridLineDrawingAllowed())
+        // If we're allowed to do grid drawing, draw that now too (since it will be coupled with the color data)
+        // We're only allowed to draw the grid lines under certain circumstances.
+        if (_pData->IsGridLineDrawingAllowed())
+        {
+            // See GH: 803
+            // If we found a wide character while we looped above, it's possible we skipped over the right half
+            // attribute that could have contained different line information than the left half.
+            if (containsWideCharacter)
             {
-                // See GH: 803
-                // If we found a wide character while we looped above, it's possible we skipped over the right half
-                // attribute that could have contained different line information than the left half.
-                if (containsWideCharacter)
+                // Start from the original position in this run.
+                auto lineColumn = currentRunColumnStart;
+                auto lineAttrIndex = currentRunAttrIndex;
+                auto lineAttrEnd = currentRunAttrEnd;
+                // Start from the original target in this run.
+                auto lineTarget = currentRunTargetStart;
+
+                // We need to go through the columns again to ensure we get the lines associated with each
+                // exact column. The code above will condense two-column characters into one, but it is possible
+                // (like with the IME) that the line drawing characters will vary from the left to right half
+                // of a wider character.
+                for (auto colsPainted = 0u; colsPainted < cols; ++colsPainted, ++lineTarget.X)
                 {
-                    // Start from the original position in this run.
-                    auto lineIt = currentRunItStart;
-                    // Start from the original target in this run.
-                    auto lineTarget = currentRunTargetStart;
-
-                    // We need to go through the iterators again to ensure we get the lines associated with each
-                    // exact column. The code above will condense two-column characters into one, but it is possible
-                    // (like with the IME) that the line drawing characters will vary from the left to right half
-                    // of a wider character.
-                    // We could theoretically pre-pass for this in the loop above to be more efficient about walking
-                    // the iterator, but I fear it would make the code even more confusing than it already is.
-                    // Do that in the future if some WPR trace points you to this spot as super bad.
-                    for (auto colsPainted = 0u; colsPainted < cols; ++colsPainted, ++lineIt, ++lineTarget.X)
+                    seekAttrRun(lineColumn, lineAttrIndex, lineAttrEnd);
+                    const auto& lines = til::at(_attrRuns, lineAttrIndex).GetAttributes();
+                    _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
+
+                    // Past the right column, the last one's lines carry on.
+                    if (lineColumn + 1 < right)
                     {
-                        auto lines = lineIt->TextAttr();
-                        _PaintBufferOutputGridLineHelper(pEngine, lines, 1, lineTarget);
+                        ++lineColumn;
                     }
                 }
-                else
-                {
-                    // If nothing exciting is going on, draw the lines in bulk.
-                    _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
-                }
+            }
+            else
+            {
+                // If nothing exciting is going on, draw the lines in bulk.
+                _PaintBufferOutputGridLineHelper(pEngine, currentRunColor, cols, screenPoint);
             }
         }
     }
@@ -921,7 +990,8 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
         if (_hoveredInterval->start <= coordTargetTil &&
             coordTargetTil <= _hoveredInterval->stop)
         {
-            if (_pData->GetPatternId(coordTarget).size() > 0)
+            size_t runIndex = 0;
+            if (_PatternIdsAt(coordTarget.X, runIndex))
             {
                 lines |= IRenderEngine::GridLines::Underline;
             }
@@ -938,6 +1008,53 @@ void Renderer::_PaintBufferOutputGridLineHelper(_In_ IRenderEngine* const pEngin
     }
 }
 
+// Method Description:
+// - Finds the pattern ids covering a column of the row whose runs were last
+//   retrieved into _patternIdRuns.
+// - Columns are usually visited left to right, so the search resumes from
+//   the run found last time, which makes walking a whole row linear.
+// Arguments:
+// - column: the column to look up
+// - runIndex: the run to resume the search from. Updated to the first run
+//   that doesn't end before the column.
+// Return Value:
+// - The pattern ids of the column, or nullptr if the column has none.
+const std::vector<size_t>* Renderer::_PatternIdsAt(const SHORT column, size_t& runIndex) const noexcept
+{
+    runIndex = std::min(runIndex, _patternIdRuns.size());
+    while (runIndex > 0 && til::at(_patternIdRuns, runIndex - 1).right > column)
+    {
+        --runIndex;
+    }
+    while (runIndex < _patternIdRuns.size() && til::at(_patternIdRuns, runIndex).right <= column)
+    {
+        ++runIndex;
+    }
+    if (runIndex < _patternIdRuns.size() && til::at(_patternIdRuns, runIndex).left <= column)
+    {
+        return &til::at(_patternIdRuns, runIndex).ids;
+    }
+    return nullptr;
+}
+
+// Method Description:
+// - Finds the column up to which the pattern ids last returned by _PatternIdsAt
+//   stay the same, so that they don't need to be looked up for every column.
+// Arguments:
+// - column: the column the ids were looked up for
+// - runIndex: the run index _PatternIdsAt returned for the column
+// Return Value:
+// - The first column past the column whose pattern ids may differ.
+SHORT Renderer::_PatternIdsEnd(const SHORT column, const size_t runIndex) const noexcept
+{
+    if (runIndex < _patternIdRuns.size())
+    {
+        const auto& run = til::at(_patternIdRuns, runIndex);
+        return run.left <= column ? run.right : run.left;
+    }
+    return SHRT_MAX;
+}
+
 // Routine Description:
 // - Retrieve information about the cursor, and pack it into a CursorOptions
 //   which the render engine can use for painting the cursor.
@@ -1061,9 +1178,9 @@ void Renderer::_PaintOverlay(IRenderEngine& engine,
                     const COORD target{ viewDirty.Left(), iRow };
                     const auto source = target - overlay.origin;
 
-                    auto it = overlay.buffer.GetCellLineDataAt(source);
+                    const auto& sourceRow = overlay.buffer.GetRowByOffset(source.Y);
 
-                    _PaintBufferOutputHelper(&engine, it, target, false);
+                    _PaintBufferOutputHelper(&engine, sourceRow, source.X, overlay.buffer.GetSize().Width(), target, false);
                 }
             }
         }
@@ -1251,10 +1368,14 @@ void Renderer::UpdateLastHoveredInterval(const std::optional<PointTree::interval
 
 // Method Description:
 // - Blocks until the engines are able to render without blocking.
-void Renderer::WaitUntilCanRender()
+// Return Value:
+// - true if any of the engines waited for the display, which paces the frames.
+bool Renderer::WaitUntilCanRender()
 {
+    bool waited = false;
     for (const auto pEngine : _rgpEngines)
     {
-        pEngine->WaitUntilCanRender();
+        waited |= pEngine->WaitUntilCanRender();
     }
+    return waited;
 }
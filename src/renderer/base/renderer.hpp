@@ -73,7 +73,7 @@ namespace Microsoft::Console::Render
 
         void EnablePainting() override;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
-        void WaitUntilCanRender() override;
+        bool WaitUntilCanRender() override;
 
         void AddRenderEngine(_In_ IRenderEngine* const pEngine) override;
 
@@ -103,7 +103,9 @@ namespace Microsoft::Console::Render
         void _PaintBufferOutput(_In_ IRenderEngine* const pEngine);
 
         void _PaintBufferOutputHelper(_In_ IRenderEngine* const pEngine,
-                                      TextBufferCellIterator it,
+                                      const ROW& row,
+                                      const SHORT left,
+                                      const SHORT right,
                                       const COORD target,
                                       const bool lineWrapped);
 
@@ -114,6 +116,9 @@ namespace Microsoft::Console::Render
                                               const size_t cchLine,
                                               const COORD coordTarget);
 
+        const std::vector<size_t>* _PatternIdsAt(const SHORT column, size_t& runIndex) const noexcept;
+        SHORT _PatternIdsEnd(const SHORT column, const size_t runIndex) const noexcept;
+
         void _PaintSelection(_In_ IRenderEngine* const pEngine);
         void _PaintCursor(_In_ IRenderEngine* const pEngine);
 
@@ -128,6 +133,8 @@ namespace Microsoft::Console::Render
 
         static constexpr float _shrinkThreshold = 0.8f;
         std::vector<Cluster> _clusterBuffer;
+        std::vector<PatternIdRun> _patternIdRuns;
+        std::vector<TextAttributeRun> _attrRuns;
 
         std::vector<SMALL_RECT> _GetSelectionRects() const;
         void _ScrollPreviousSelection(const til::point delta);
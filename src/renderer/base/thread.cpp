@@ -201,23 +201,88 @@ DWORD WINAPI RenderThread::_ThreadProc()
 
         ResetEvent(_hPaintCompletedEvent);
 
-        _pRenderer->WaitUntilCanRender();
+        _WaitForFrameLimit();
+
+        _enginePacesFrames = _pRenderer->WaitUntilCanRender();
+
+        _lastFrameStart = std::chrono::steady_clock::now();
+        const auto requestTicks = _requestTicks.exchange(0, std::memory_order_relaxed);
         LOG_IF_FAILED(_pRenderer->PaintFrame());
+        _RecordFrame(requestTicks);
 
         SetEvent(_hPaintCompletedEvent);
+    }
+
+    return S_OK;
+}
+
+// Method Description:
+// - Waits out the rest of the frame limit since the start of the last frame.
+//   After an idle period, like when a keystroke is echoed, this doesn't wait
+//   at all, so that it's painted right away. While output keeps coming, all of
+//   it that arrives in the meantime is coalesced into the next frame.
+// - With a frame limit of 0, the frames follow the display's vsync, which the
+//   engines wait for in WaitUntilCanRender. If none of them did so for the last
+//   frame, like the DX engine before Windows 8.1, the default limit applies.
+// Arguments:
+// - <none>
+// Return Value:
+// - <none>
+void RenderThread::_WaitForFrameLimit() noexcept
+{
+    auto frameLimitMilliseconds = _frameLimitMilliseconds.load(std::memory_order_relaxed);
+    if (frameLimitMilliseconds == 0 && !_enginePacesFrames)
+    {
+        frameLimitMilliseconds = s_FrameLimitMilliseconds;
+    }
+
+    const std::chrono::milliseconds frameLimit{ frameLimitMilliseconds };
+    const auto sinceLastFrame = std::chrono::steady_clock::now() - _lastFrameStart;
+
+    // extra check before we sleep since it's a "long" activity, relatively speaking.
+    if (_fKeepRunning && sinceLastFrame < frameLimit)
+    {
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(frameLimit - sinceLastFrame);
+        Sleep(gsl::narrow_cast<DWORD>(remaining.count()));
+    }
+}
+
+// Method Description:
+// - Counts a painted frame, and the time since it was first requested.
+// Arguments:
+// - requestTicks - when the frame was first requested, in steady_clock ticks.
+//      0 if it was painted without a request.
+// Return Value:
+// - <none>
+void RenderThread::_RecordFrame(const int64_t requestTicks) noexcept
+{
+    _framesPainted.fetch_add(1, std::memory_order_relaxed);
+
+    if (requestTicks != 0)
+    {
+        const std::chrono::steady_clock::duration sinceRequest{ std::chrono::steady_clock::now().time_since_epoch().count() - requestTicks };
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(sinceRequest).count();
+        _totalLatencyMicroseconds.fetch_add(latency, std::memory_order_relaxed);
 
-        // extra check before we sleep since it's a "long" activity, relatively speaking.
-        if (_fKeepRunning)
+        // Only this thread ever writes the maximum.
+        if (latency > _maxLatencyMicroseconds.load(std::memory_order_relaxed))
         {
-            Sleep(s_FrameLimitMilliseconds);
+            _maxLatencyMicroseconds.store(latency, std::memory_order_relaxed);
         }
     }
-
-    return S_OK;
 }
 
 void RenderThread::NotifyPaint()
 {
+    // Remember when the pending frame was first requested. Requests after
+    // that are painted with it.
+    int64_t noRequest = 0;
+    if (_requestTicks.load(std::memory_order_relaxed) != 0 ||
+        !_requestTicks.compare_exchange_strong(noRequest, std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed))
+    {
+        _framesSkipped.fetch_add(1, std::memory_order_relaxed);
+    }
+
     if (_fWaiting.load(std::memory_order_acquire))
     {
         SetEvent(_hEvent);
@@ -228,6 +293,32 @@ void RenderThread::NotifyPaint()
     }
 }
 
+// Method Description:
+// - Sets the shortest time between the starts of two frames.
+// Arguments:
+// - milliseconds - the frame limit. The default is 8 ms. With 0, the frames
+//      follow the vsync of the display, if the render engines wait for it.
+// Return Value:
+// - <none>
+void RenderThread::SetFrameLimit(const DWORD milliseconds) noexcept
+{
+    _frameLimitMilliseconds.store(milliseconds, std::memory_order_relaxed);
+}
+
+// Method Description:
+// - Gets the counters of the frames this thread painted.
+// Arguments:
+// - <none>
+// Return Value:
+// - The number of frames painted and skipped, and the time they took to be painted.
+RenderThread::FrameStatistics RenderThread::GetFrameStatistics() const noexcept
+{
+    return { _framesPainted.load(std::memory_order_relaxed),
+             _framesSkipped.load(std::memory_order_relaxed),
+             std::chrono::microseconds{ _totalLatencyMicroseconds.load(std::memory_order_relaxed) },
+             std::chrono::microseconds{ _maxLatencyMicroseconds.load(std::memory_order_relaxed) } };
+}
+
 void RenderThread::EnablePainting()
 {
     SetEvent(_hPaintEnabledEvent);
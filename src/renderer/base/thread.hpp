@@ -17,6 +17,8 @@ Author(s):
 #include "../inc/IRenderer.hpp"
 #include "../inc/IRenderThread.hpp"
 
+#include <chrono>
+
 namespace Microsoft::Console::Render
 {
     class RenderThread final : public IRenderThread
@@ -33,10 +35,29 @@ namespace Microsoft::Console::Render
         void DisablePainting() override;
         void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) override;
 
+        void SetFrameLimit(const DWORD milliseconds) noexcept;
+
+        struct FrameStatistics
+        {
+            // Frames the thread painted.
+            uint64_t framesPainted;
+            // Paint requests that were coalesced into a frame that was already requested.
+            uint64_t framesSkipped;
+            // The time from the first request of a frame until it was painted.
+            std::chrono::microseconds totalLatency;
+            std::chrono::microseconds maxLatency;
+        };
+
+        FrameStatistics GetFrameStatistics() const noexcept;
+
     private:
         static DWORD WINAPI s_ThreadProc(_In_ LPVOID lpParameter);
         DWORD WINAPI _ThreadProc();
 
+        void _WaitForFrameLimit() noexcept;
+        void _RecordFrame(const int64_t requestTicks) noexcept;
+
+        // The default shortest time between the starts of two frames.
         static DWORD const s_FrameLimitMilliseconds = 8;
 
         HANDLE _hThread;
@@ -50,5 +71,17 @@ namespace Microsoft::Console::Render
         bool _fKeepRunning;
         std::atomic<bool> _fNextFrameRequested;
         std::atomic<bool> _fWaiting;
+
+        std::atomic<DWORD> _frameLimitMilliseconds{ s_FrameLimitMilliseconds };
+        std::chrono::steady_clock::time_point _lastFrameStart{};
+        // Whether a render engine waited for the display's vsync before the last frame.
+        bool _enginePacesFrames{ false };
+
+        // When the pending frame was first requested, in steady_clock ticks. 0 if there's none.
+        std::atomic<int64_t> _requestTicks{ 0 };
+        std::atomic<uint64_t> _framesPainted{ 0 };
+        std::atomic<uint64_t> _framesSkipped{ 0 };
+        std::atomic<int64_t> _totalLatencyMicroseconds{ 0 };
+        std::atomic<int64_t> _maxLatencyMicroseconds{ 0 };
     };
 }
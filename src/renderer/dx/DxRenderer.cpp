@@ -1284,11 +1284,14 @@ CATCH_RETURN()
 // Method Description:
 // - Blocks until the engine is able to render without blocking.
 // - See https://docs.microsoft.com/en-us/windows/uwp/gaming/reduce-latency-with-dxgi-1-3-swap-chains.
-void DxEngine::WaitUntilCanRender() noexcept
+// Return Value:
+// - true if the swap chain has a frame latency waitable object (Windows 8.1+),
+//   which follows the vsync of the display.
+bool DxEngine::WaitUntilCanRender() noexcept
 {
     if (!_swapChainFrameLatencyWaitableObject)
     {
-        return;
+        return false;
     }
 
     const auto ret = WaitForSingleObjectEx(
@@ -1299,6 +1302,7 @@ void DxEngine::WaitUntilCanRender() noexcept
     {
         LOG_WIN32_MSG(ret, "Waiting for swap chain frame latency waitable object returned error or timeout.");
     }
+    return true;
 }
 
 // Routine Description:
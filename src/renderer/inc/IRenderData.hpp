@@ -37,6 +37,14 @@ namespace Microsoft::Console::Render
         const Microsoft::Console::Types::Viewport region;
     };
 
+    struct PatternIdRun final
+    {
+        // The columns [left, right) of the row share this set of pattern ids.
+        SHORT left;
+        SHORT right;
+        std::vector<size_t> ids;
+    };
+
     class IRenderData : public Microsoft::Console::Types::IBaseData
     {
     public:
@@ -70,6 +78,7 @@ namespace Microsoft::Console::Render
         virtual const std::wstring GetHyperlinkCustomId(uint16_t id) const noexcept = 0;
 
         virtual const std::vector<size_t> GetPatternId(const COORD location) const noexcept = 0;
+        virtual void GetPatternIdRuns(const SHORT row, std::vector<PatternIdRun>& runs) const noexcept = 0;
 
     protected:
         IRenderData() = default;
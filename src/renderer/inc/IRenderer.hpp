@@ -58,7 +58,7 @@ namespace Microsoft::Console::Render
 
         virtual void EnablePainting() = 0;
         virtual void WaitForPaintCompletionAndDisable(const DWORD dwTimeoutMs) = 0;
-        virtual void WaitUntilCanRender() = 0;
+        virtual bool WaitUntilCanRender() = 0;
 
         virtual void AddRenderEngine(_In_ IRenderEngine* const pEngine) = 0;
 
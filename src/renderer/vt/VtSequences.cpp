@@ -97,6 +97,18 @@ using namespace Microsoft::Console::Render;
     return _WriteFormattedString(&format, chars);
 }
 
+// Method Description:
+// - Repeats the last printed character a number of times.
+// Arguments:
+// - chars: the number of times to repeat it.
+// Return Value:
+// - S_OK if we succeeded, else an appropriate HRESULT for failing to allocate or write.
+[[nodiscard]] HRESULT VtEngine::_RepeatCharacter(const short chars) noexcept
+{
+    static const std::string format = "\x1b[%db";
+    return _WriteFormattedString(&format, chars);
+}
+
 // Method Description:
 // - Formats and writes a sequence to erase the remainder of the line starting
 //      from the cursor position.
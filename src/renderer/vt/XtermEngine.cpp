@@ -54,6 +54,7 @@ XtermEngine::XtermEngine(_In_ wil::unique_hfile hPipe,
         RETURN_IF_FAILED(_ClearScreen());
         _clearedAllThisFrame = true;
         _firstPaint = false;
+        _ResetShadowFrame();
     }
     else
     {
@@ -396,6 +397,9 @@ try
     _wrappedRow = oldWrappedRow;
     _delayedEolWrap = oldDelayedEolWrap;
 
+    // The rows of the terminal moved along with the scroll.
+    _ScrollShadowFrame(dy);
+
     // Shift our internal tracker of the last text position according to how
     // much we've scrolled. If we manually scroll the buffer right now, by
     // moving the cursor to the bottom row of the viewport and emitting a
@@ -469,7 +473,8 @@ try
 {
     const til::point delta{ *pcoordDelta };
 
-    if (delta != til::point{ 0, 0 })
+    // While passing text through, the terminal scrolls its contents by itself.
+    if (delta != til::point{ 0, 0 } && !_passthrough)
     {
         _trace.TraceInvalidateScroll(delta);
 
@@ -517,6 +522,16 @@ CATCH_RETURN();
 // - S_OK or suitable HRESULT error from either conversion or writing pipe.
 [[nodiscard]] HRESULT XtermEngine::WriteTerminalW(const std::wstring_view wstr) noexcept
 {
+    // While passing text through, this string already went to the terminal
+    // with the rest of it.
+    if (_passthrough)
+    {
+        return S_OK;
+    }
+
+    // We can't tell what this string does to the terminal's contents.
+    _ResetShadowFrame();
+
     RETURN_IF_FAILED(_fUseAsciiOnly ?
                          VtEngine::_WriteTerminalAscii(wstr) :
                          VtEngine::_WriteTerminalUtf8(wstr));
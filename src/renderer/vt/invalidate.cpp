@@ -49,6 +49,12 @@ using namespace Microsoft::Console::Render;
 [[nodiscard]] HRESULT VtEngine::Invalidate(const SMALL_RECT* const psrRegion) noexcept
 try
 {
+    // The text we passed through already changed the terminal the same way.
+    if (_passthrough)
+    {
+        return S_OK;
+    }
+
     const til::rectangle rect{ Viewport::FromExclusive(*psrRegion).ToInclusive() };
     _trace.TraceInvalidate(rect);
     _invalidMap.set(rect);
@@ -64,6 +70,11 @@ CATCH_RETURN();
 // - S_OK
 [[nodiscard]] HRESULT VtEngine::InvalidateCursor(const COORD* const pcoordCursor) noexcept
 {
+    if (_passthrough)
+    {
+        return S_OK;
+    }
+
     // If we just inherited the cursor, we're going to get an InvalidateCursor
     //      for both where the old cursor was, and where the new cursor is
     //      (the inherited location). (See Cursor.cpp:Cursor::SetPosition)
@@ -91,6 +102,11 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT VtEngine::InvalidateAll() noexcept
 try
 {
+    if (_passthrough)
+    {
+        return S_OK;
+    }
+
     _trace.TraceInvalidateAll(_lastViewport.ToOrigin().ToInclusive());
     _invalidMap.set_all();
     return S_OK;
@@ -108,7 +124,8 @@ CATCH_RETURN();
 [[nodiscard]] HRESULT VtEngine::InvalidateCircling(_Out_ bool* const pForcePaint) noexcept
 {
     // If we're in the middle of a resize request, don't try to immediately start a frame.
-    if (_inResizeRequest)
+    // While passing text through, the terminal scrolls its contents by itself.
+    if (_inResizeRequest || _passthrough)
     {
         *pForcePaint = false;
     }
@@ -126,6 +143,26 @@ CATCH_RETURN();
     return S_OK;
 }
 
+// Method Description:
+// - Notifies us that the title of the console changed. If the title was set by
+//      text we passed through, the terminal already has it, and we don't need
+//      to set it again.
+// Arguments:
+// - proposedTitle - the new title of the console
+// Return Value:
+// - S_OK, else an appropriate HRESULT for failing to allocate.
+[[nodiscard]] HRESULT VtEngine::InvalidateTitle(const std::wstring& proposedTitle) noexcept
+try
+{
+    if (_passthrough)
+    {
+        _lastFrameTitle = proposedTitle;
+        return S_OK;
+    }
+    return RenderEngineBase::InvalidateTitle(proposedTitle);
+}
+CATCH_RETURN();
+
 // Method Description:
 // - Notifies us that we're about to be torn down. This gives us a last chance
 //      to force a repaint before the buffer contents are lost. The VT renderer
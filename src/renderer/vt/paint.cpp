@@ -355,6 +355,7 @@ using namespace Microsoft::Console::Types;
         }
 
         RETURN_IF_FAILED(VtEngine::_WriteTerminalAscii(_bufferLine));
+        _ForgetShadowCells(coord, totalWidth);
 
         // Update our internal tracker of the cursor's position
         _lastText.X += totalWidth;
@@ -485,11 +486,25 @@ using namespace Microsoft::Console::Types;
         _trace.TraceClearWrapped();
     }
 
-    // Move the cursor to the start of this run.
-    RETURN_IF_FAILED(_MoveCursor(coord));
+    // When diffing frames, only the cells the terminal doesn't show yet are
+    // written. That's skipped for wrapped lines, since the wrap is only
+    // preserved by writing up to the end of the row, and then on from the
+    // start of the next one.
+    const bool diffThisLine = _diffFrames && !lineWrapped && !_wrappedRow.has_value() && !_delayedEolWrap;
+    if (diffThisLine)
+    {
+        // This moves the cursor and updates _lastText itself.
+        RETURN_IF_FAILED(_PaintUtf8Diff(clusters, coord, columnsActual));
+    }
+    else
+    {
+        // Move the cursor to the start of this run.
+        RETURN_IF_FAILED(_MoveCursor(coord));
 
-    // Write the actual text string
-    RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8({ _bufferLine.data(), cchActual }));
+        // Write the actual text string
+        RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8({ _bufferLine.data(), cchActual }));
+        _RecordShadowCells(clusters, coord, columnsActual);
+    }
 
     // GH#4415, GH#5181
     // If the renderer told us that this was a wrapped line, then mark
@@ -519,7 +534,7 @@ using namespace Microsoft::Console::Types;
     // GH#1245: This needs to be RightExclusive, _not_ inclusive. Otherwise, we
     // won't update our internal cursor position tracker correctly at the last
     // character of the row.
-    if (_lastText.X < _lastViewport.RightExclusive())
+    if (!diffThisLine && _lastText.X < _lastViewport.RightExclusive())
     {
         _lastText.X += static_cast<short>(columnsActual);
     }
@@ -541,7 +556,27 @@ using namespace Microsoft::Console::Types;
     }
     CATCH_RETURN();
 
-    if (useEraseChar)
+    // Erasing below starts at the end of the text. The diff might have skipped
+    // the unchanged cells there, without moving the cursor past them.
+    const COORD endOfText{ static_cast<short>(coord.X + columnsActual), coord.Y };
+    const size_t erasedColumns = endOfText.X + numSpaces > gsl::narrow_cast<size_t>(_lastViewport.RightInclusive()) ?
+                                     gsl::narrow_cast<size_t>(_lastViewport.RightExclusive() - endOfText.X) :
+                                     numSpaces;
+    // If the terminal already shows the blanks we'd erase, leave them be.
+    const bool eraseChanged = !diffThisLine || !_ShadowCellsAreBlank(endOfText, erasedColumns);
+    if (diffThisLine && ((useEraseChar && eraseChanged) || (_newBottomLine && printingBottomLine)) &&
+        (_lastText.X != endOfText.X || _lastText.Y != endOfText.Y))
+    {
+        RETURN_IF_FAILED(_MoveCursor(endOfText));
+    }
+
+    // Whatever we erase or pad, the cells after the text aren't known anymore.
+    if (removeSpaces && eraseChanged && endOfText.X < _lastViewport.RightExclusive())
+    {
+        _ForgetShadowCells(endOfText, _lastViewport.RightExclusive() - endOfText.X);
+    }
+
+    if (useEraseChar && eraseChanged)
     {
         // ECH doesn't actually move the cursor itself. However, we think that
         //   the cursor *should* be at the end of the area we just erased. Stash
@@ -559,6 +594,7 @@ using namespace Microsoft::Console::Types;
         {
             RETURN_IF_FAILED(_EraseLine());
         }
+        _BlankShadowCells(endOfText, erasedColumns);
     }
     else if (_newBottomLine && printingBottomLine)
     {
@@ -589,6 +625,310 @@ using namespace Microsoft::Console::Types;
     return S_OK;
 }
 
+// Routine Description:
+// - Counts the decimal digits of a number, as VT sequence parameters print them.
+static size_t DecimalDigits(size_t value) noexcept
+{
+    size_t digits = 1;
+    while (value >= 10)
+    {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+// Routine Description:
+// - Writes the text of a line like _PaintUtf8BufferLine does, but only the cells
+//      of it that differ from what the connected terminal already shows, according
+//      to the shadow frame.
+//   Unchanged cells between changed ones are skipped with a cursor movement, if that
+//      takes fewer bytes than writing them again. Unchanged cells at the end of the
+//      line aren't written at all.
+// Arguments:
+// - clusters - text and column widths to be written. Their text is in _bufferLine.
+// - coord - character coordinate target to render within viewport
+// - columns - the number of columns to write, from the start of the clusters
+// Return Value:
+// - S_OK or suitable HRESULT error from writing pipe.
+[[nodiscard]] HRESULT VtEngine::_PaintUtf8Diff(gsl::span<const Cluster> const clusters,
+                                               const COORD coord,
+                                               const size_t columns) noexcept
+try
+{
+    // The column and _bufferLine offset at which the cells to write next start.
+    // If the cursor is already at the start of the line, we start right away,
+    // skipping the first cells would cost a movement.
+    std::optional<std::pair<size_t, size_t>> segment;
+    if (_lastText.X == coord.X && _lastText.Y == coord.Y)
+    {
+        segment = { 0, 0 };
+    }
+
+    // The end of the last changed cell, and the bytes the unchanged ones since would take.
+    size_t changedColumn = 0;
+    size_t changedOffset = 0;
+    size_t unchangedBytes = 0;
+
+    const auto writeSegment = [&]() {
+        const auto [startColumn, startOffset] = segment.value();
+        segment.reset();
+        if (changedOffset > startOffset)
+        {
+            RETURN_IF_FAILED(_MoveCursor({ gsl::narrow_cast<short>(coord.X + startColumn), coord.Y }));
+            RETURN_IF_FAILED(_WriteTerminalUtf8Repeated({ _bufferLine.data() + startOffset, changedOffset - startOffset }));
+            if (_lastText.X < _lastViewport.RightExclusive())
+            {
+                _lastText.X += gsl::narrow_cast<short>(changedColumn - startColumn);
+            }
+        }
+        return S_OK;
+    };
+
+    size_t column = 0;
+    size_t offset = 0;
+    for (const auto& cluster : clusters)
+    {
+        if (column >= columns)
+        {
+            break;
+        }
+
+        // Only single cells of a single UTF-16 code unit are kept in the shadow frame.
+        const auto text = cluster.GetText();
+        const auto cell = _ShadowCellAt(coord.X + gsl::narrow_cast<ptrdiff_t>(column), coord.Y);
+        const auto unchanged = cluster.GetColumns() == 1 && text.size() == 1 &&
+                               cell && cell->known && cell->wch == text.front() && cell->attr == _lastTextAttributes;
+        if (unchanged)
+        {
+            unchangedBytes += text.front() < 0x80 ? 1 : (text.front() < 0x800 ? 2 : 3);
+        }
+        else
+        {
+            // CUF is ESC [ %d C
+            if (segment.has_value() && unchangedBytes > 3 + DecimalDigits(column - changedColumn))
+            {
+                RETURN_IF_FAILED(writeSegment());
+            }
+            if (!segment.has_value())
+            {
+                segment = { column, offset };
+            }
+            changedColumn = column + cluster.GetColumns();
+            changedOffset = offset + text.size();
+            unchangedBytes = 0;
+        }
+
+        column += cluster.GetColumns();
+        offset += text.size();
+    }
+
+    if (segment.has_value())
+    {
+        RETURN_IF_FAILED(writeSegment());
+    }
+
+    _RecordShadowCells(clusters, coord, columns);
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Writes a wstring to the tty, encoded as UTF-8 like _WriteTerminalUtf8, but
+//      with runs of the same character shortened into a REP sequence, where that
+//      takes fewer bytes. Lines of box drawing characters are where this helps.
+// Arguments:
+// - wstr - wstring of text to be written
+// Return Value:
+// - S_OK or suitable HRESULT error from either conversion or writing pipe.
+[[nodiscard]] HRESULT VtEngine::_WriteTerminalUtf8Repeated(const std::wstring_view wstr) noexcept
+try
+{
+    size_t written = 0;
+    for (size_t i = 0; i < wstr.size();)
+    {
+        const auto wch = wstr.at(i);
+        auto end = i + 1;
+        while (end < wstr.size() && wstr.at(end) == wch)
+        {
+            ++end;
+        }
+
+        // REP repeats the last character printed. Stick to the ones that are
+        // certainly a cell of their own: ASCII, box drawing and block elements.
+        const auto repeats = end - i - 1;
+        const auto bytes = wch < 0x80 ? 1 : 3;
+        const auto repeatable = (wch >= L' ' && wch < 0x7F) || (wch >= 0x2500 && wch <= 0x259F);
+        // REP is ESC [ %d b
+        if (repeatable && repeats * bytes > 3 + DecimalDigits(repeats))
+        {
+            RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8(wstr.substr(written, i + 1 - written)));
+            RETURN_IF_FAILED(_RepeatCharacter(gsl::narrow<short>(repeats)));
+            written = end;
+        }
+        i = end;
+    }
+
+    if (written < wstr.size())
+    {
+        RETURN_IF_FAILED(VtEngine::_WriteTerminalUtf8(wstr.substr(written)));
+    }
+    return S_OK;
+}
+CATCH_RETURN();
+
+// Routine Description:
+// - Forgets everything in the shadow frame, or sizes it to the viewport.
+//   Used when we can't tell what the terminal shows anymore.
+void VtEngine::_ResetShadowFrame() noexcept
+{
+    try
+    {
+        if (_diffFrames)
+        {
+            _shadowFrame.assign(gsl::narrow_cast<size_t>(_lastViewport.Width()) * _lastViewport.Height(), ShadowCell{});
+            return;
+        }
+    }
+    CATCH_LOG();
+
+    // Without a shadow frame, we just write every cell.
+    _diffFrames = false;
+    _shadowFrame.clear();
+    _shadowFrame.shrink_to_fit();
+}
+
+// Routine Description:
+// - Moves the rows of the shadow frame along with the terminal scrolling.
+//   The rows scrolled into view are blank, but not known to have any particular attributes.
+// Arguments:
+// - delta - the number of rows the contents moved down by. Negative if they moved up.
+void VtEngine::_ScrollShadowFrame(const short delta) noexcept
+{
+    if (_shadowFrame.empty() || delta == 0)
+    {
+        return;
+    }
+
+    const auto width = gsl::narrow_cast<size_t>(_lastViewport.Width());
+    const auto shift = std::min(gsl::narrow_cast<size_t>(std::abs(delta)) * width, _shadowFrame.size());
+    if (delta < 0)
+    {
+        std::move(_shadowFrame.begin() + shift, _shadowFrame.end(), _shadowFrame.begin());
+        std::fill(_shadowFrame.end() - shift, _shadowFrame.end(), ShadowCell{});
+    }
+    else
+    {
+        std::move_backward(_shadowFrame.begin(), _shadowFrame.end() - shift, _shadowFrame.end());
+        std::fill(_shadowFrame.begin(), _shadowFrame.begin() + shift, ShadowCell{});
+    }
+}
+
+// Routine Description:
+// - Records the text that was written at the given position in the shadow frame.
+// Arguments:
+// - clusters - the text and column widths that were written, with the current attributes
+// - coord - the position they were written at
+// - columns - the number of columns that were written
+void VtEngine::_RecordShadowCells(gsl::span<const Cluster> const clusters, const COORD coord, const size_t columns) noexcept
+{
+    if (_shadowFrame.empty())
+    {
+        return;
+    }
+
+    size_t column = 0;
+    for (const auto& cluster : clusters)
+    {
+        if (column >= columns)
+        {
+            break;
+        }
+
+        const auto text = cluster.GetText();
+        if (cluster.GetColumns() == 1 && text.size() == 1)
+        {
+            if (const auto cell = _ShadowCellAt(coord.X + gsl::narrow_cast<ptrdiff_t>(column), coord.Y))
+            {
+                *cell = { text.front(), _lastTextAttributes, true };
+            }
+        }
+        else
+        {
+            _ForgetShadowCells({ gsl::narrow_cast<short>(coord.X + column), coord.Y }, cluster.GetColumns());
+        }
+        column += cluster.GetColumns();
+    }
+}
+
+// Routine Description:
+// - Marks cells of the shadow frame as unknown, so that they will be written again.
+// Arguments:
+// - coord - the first cell
+// - columns - the number of cells, to the right of it
+void VtEngine::_ForgetShadowCells(const COORD coord, const size_t columns) noexcept
+{
+    for (size_t column = 0; column < columns; ++column)
+    {
+        if (const auto cell = _ShadowCellAt(coord.X + gsl::narrow_cast<ptrdiff_t>(column), coord.Y))
+        {
+            cell->known = false;
+        }
+    }
+}
+
+// Routine Description:
+// - Records that cells of the shadow frame were erased, to blanks of the current attributes.
+// Arguments:
+// - coord - the first cell
+// - columns - the number of cells, to the right of it
+void VtEngine::_BlankShadowCells(const COORD coord, const size_t columns) noexcept
+{
+    for (size_t column = 0; column < columns; ++column)
+    {
+        if (const auto cell = _ShadowCellAt(coord.X + gsl::narrow_cast<ptrdiff_t>(column), coord.Y))
+        {
+            *cell = { L' ', _lastTextAttributes, true };
+        }
+    }
+}
+
+// Routine Description:
+// - Checks whether the terminal shows blanks of the current attributes in the given cells.
+// Arguments:
+// - coord - the first cell
+// - columns - the number of cells, to the right of it
+// Return Value:
+// - true if all of the cells are known to be blanks, false otherwise.
+bool VtEngine::_ShadowCellsAreBlank(const COORD coord, const size_t columns) noexcept
+{
+    for (size_t column = 0; column < columns; ++column)
+    {
+        const auto cell = _ShadowCellAt(coord.X + gsl::narrow_cast<ptrdiff_t>(column), coord.Y);
+        if (!cell || !cell->known || cell->wch != L' ' || !(cell->attr == _lastTextAttributes))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Routine Description:
+// - Gets a cell of the shadow frame.
+// Arguments:
+// - x, y - the position of the cell in the viewport
+// Return Value:
+// - The cell, or nullptr if there's no shadow frame or the position is outside of it.
+VtEngine::ShadowCell* VtEngine::_ShadowCellAt(const ptrdiff_t x, const ptrdiff_t y) noexcept
+{
+    const ptrdiff_t width = _lastViewport.Width();
+    if (x < 0 || y < 0 || x >= width || gsl::narrow_cast<size_t>(y * width + x) >= _shadowFrame.size())
+    {
+        return nullptr;
+    }
+    return &til::at(_shadowFrame, gsl::narrow_cast<size_t>(y * width + x));
+}
+
 // Method Description:
 // - Updates the window's title string. Emits the VT sequence to SetWindowTitle.
 //      Because wintelnet does not understand these sequences by default, we
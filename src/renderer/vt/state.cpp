@@ -132,9 +132,49 @@ VtEngine::VtEngine(_In_ wil::unique_hfile pipe,
 // - Wrapper for ITerminalOutputConnection. See _Write.
 [[nodiscard]] HRESULT VtEngine::WriteTerminalUtf8(const std::string_view str) noexcept
 {
+    // We can't tell what this does to the terminal's contents.
+    _ResetShadowFrame();
     return _Write(str);
 }
 
+// Method Description:
+// - Writes text of a client that emits VT itself straight to the terminal.
+//   Until EndPassthrough, the changes that text makes to the buffer aren't
+//   painted, since the terminal makes the same changes by itself.
+// - The caller must paint everything that's pending before, so that the
+//   terminal gets the output in the order it was written.
+// Arguments:
+// - wstr - the text, as the client wrote it
+// Return Value:
+// - S_OK or suitable HRESULT error from either conversion or writing pipe.
+[[nodiscard]] HRESULT VtEngine::BeginPassthrough(const std::wstring_view wstr) noexcept
+{
+    _passthrough = true;
+    RETURN_IF_FAILED(_WriteTerminalUtf8(wstr));
+    return _Flush();
+}
+
+// Method Description:
+// - Ends passing text through. The text moved the cursor and changed the
+//   attributes of the terminal, which we didn't see, so the next cursor
+//   movement is an absolute one and the attributes are those of the buffer,
+//   which the text changed the same way.
+// Arguments:
+// - attributes - the attributes of the buffer, after the text
+// Return Value:
+// - <none>
+void VtEngine::EndPassthrough(const TextAttribute& attributes) noexcept
+{
+    _passthrough = false;
+
+    _lastText = INVALID_COORDS;
+    _lastTextAttributes = attributes;
+    _deferredCursorPos = INVALID_COORDS;
+    _wrappedRow = std::nullopt;
+    _delayedEolWrap = false;
+    _ResetShadowFrame();
+}
+
 // Method Description:
 // - Writes a wstring to the tty, encoded as full utf-8. This is one
 //      implementation of the WriteTerminalW method.
@@ -294,6 +334,9 @@ CATCH_RETURN();
             hr = _ResizeWindow(newView.Width(), newView.Height());
         }
         _resized = true;
+
+        // The terminal may reflow its contents, we don't know what it shows anymore.
+        _ResetShadowFrame();
     }
 
     // See MSFT:19408543
@@ -490,6 +533,21 @@ void VtEngine::SetResizeQuirk(const bool resizeQuirk)
     _resizeQuirk = resizeQuirk;
 }
 
+// Method Description:
+// - Configure the renderer to diff frames. When enabled, we keep a copy of what
+//   the connected terminal shows, and only emit the cells of a painted line
+//   that differ from it. This saves bytes over slow connections, at the cost
+//   of the memory for that copy.
+// Arguments:
+// - diffFrames: true iff we were started with the `--diffFrames` flag enabled.
+// Return Value:
+// - <none>
+void VtEngine::SetDiffFrames(const bool diffFrames)
+{
+    _diffFrames = diffFrames;
+    _ResetShadowFrame();
+}
+
 // Method Description:
 // - Manually emit a "Erase Scrollback" sequence to the connected terminal. We
 //   need to do this in certain cases that we've identified where we believe the
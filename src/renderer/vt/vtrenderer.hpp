@@ -53,6 +53,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT InvalidateAll() noexcept override;
         [[nodiscard]] HRESULT InvalidateCircling(_Out_ bool* const pForcePaint) noexcept override;
         [[nodiscard]] HRESULT PrepareForTeardown(_Out_ bool* const pForcePaint) noexcept override;
+        [[nodiscard]] HRESULT InvalidateTitle(const std::wstring& proposedTitle) noexcept override;
 
         [[nodiscard]] virtual HRESULT StartPaint() noexcept override;
         [[nodiscard]] virtual HRESULT EndPaint() noexcept override;
@@ -98,11 +99,15 @@ namespace Microsoft::Console::Render
 
         [[nodiscard]] virtual HRESULT WriteTerminalW(const std::wstring_view str) noexcept = 0;
 
+        [[nodiscard]] HRESULT BeginPassthrough(const std::wstring_view wstr) noexcept;
+        void EndPassthrough(const TextAttribute& attributes) noexcept;
+
         void SetTerminalOwner(Microsoft::Console::ITerminalOwner* const terminalOwner);
         void BeginResizeRequest();
         void EndResizeRequest();
 
         void SetResizeQuirk(const bool resizeQuirk);
+        void SetDiffFrames(const bool diffFrames);
 
         [[nodiscard]] virtual HRESULT ManuallyClearScrollback() noexcept;
 
@@ -151,6 +156,21 @@ namespace Microsoft::Console::Render
         bool _resizeQuirk{ false };
         std::optional<TextColor> _newBottomLineBG{ std::nullopt };
 
+        // While passing text through, the terminal is changed by the text
+        // itself, so we don't paint what it changes in the buffer.
+        bool _passthrough{ false };
+
+        // What the connected terminal shows, as far as we know, for each cell
+        // of the viewport. Only kept when diffing frames.
+        struct ShadowCell
+        {
+            wchar_t wch{ 0 };
+            TextAttribute attr;
+            bool known{ false };
+        };
+        bool _diffFrames{ false };
+        std::vector<ShadowCell> _shadowFrame;
+
         [[nodiscard]] HRESULT _Write(std::string_view const str) noexcept;
         [[nodiscard]] HRESULT _WriteFormattedString(const std::string* const pFormat, ...) noexcept;
         [[nodiscard]] HRESULT _Flush() noexcept;
@@ -167,6 +187,7 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _DeleteLine(const short sLines) noexcept;
         [[nodiscard]] HRESULT _InsertLine(const short sLines) noexcept;
         [[nodiscard]] HRESULT _CursorForward(const short chars) noexcept;
+        [[nodiscard]] HRESULT _RepeatCharacter(const short chars) noexcept;
         [[nodiscard]] HRESULT _EraseCharacter(const short chars) noexcept;
         [[nodiscard]] HRESULT _CursorPosition(const COORD coord) noexcept;
         [[nodiscard]] HRESULT _CursorHome() noexcept;
@@ -219,6 +240,19 @@ namespace Microsoft::Console::Render
         [[nodiscard]] HRESULT _PaintAsciiBufferLine(gsl::span<const Cluster> const clusters,
                                                     const COORD coord) noexcept;
 
+        [[nodiscard]] HRESULT _PaintUtf8Diff(gsl::span<const Cluster> const clusters,
+                                             const COORD coord,
+                                             const size_t columns) noexcept;
+        [[nodiscard]] HRESULT _WriteTerminalUtf8Repeated(const std::wstring_view str) noexcept;
+
+        void _ResetShadowFrame() noexcept;
+        void _ScrollShadowFrame(const short delta) noexcept;
+        void _RecordShadowCells(gsl::span<const Cluster> const clusters, const COORD coord, const size_t columns) noexcept;
+        void _ForgetShadowCells(const COORD coord, const size_t columns) noexcept;
+        void _BlankShadowCells(const COORD coord, const size_t columns) noexcept;
+        bool _ShadowCellsAreBlank(const COORD coord, const size_t columns) noexcept;
+        ShadowCell* _ShadowCellAt(const ptrdiff_t x, const ptrdiff_t y) noexcept;
+
         [[nodiscard]] HRESULT _WriteTerminalUtf8(const std::wstring_view str) noexcept;
         [[nodiscard]] HRESULT _WriteTerminalAscii(const std::wstring_view str) noexcept;
 
@@ -51,8 +51,9 @@ bool InteractDispatch::WriteCtrlKey(const KeyEvent& event)
 }
 
 // Method Description:
-// - Writes a string of input to the host. The string is converted to keystrokes
-//      that will faithfully represent the input by CharToKeyEvents.
+// - Writes a string of input to the host. The host keeps the string as text, and
+//      only converts it to the keystrokes CharToKeyEvents would make for it
+//      when a client reads them.
 // Arguments:
 // - string : a string to write to the console.
 // Return Value:
@@ -68,18 +69,7 @@ bool InteractDispatch::WriteString(const std::wstring_view string)
     bool success = _pConApi->GetConsoleOutputCP(codepage);
     if (success)
     {
-        std::deque<std::unique_ptr<IInputEvent>> keyEvents;
-
-        for (const auto& wch : string)
-        {
-            std::deque<std::unique_ptr<KeyEvent>> convertedEvents = CharToKeyEvents(wch, codepage);
-
-            std::move(convertedEvents.begin(),
-                      convertedEvents.end(),
-                      std::back_inserter(keyEvents));
-        }
-
-        success = WriteInput(keyEvents);
+        success = _pConApi->PrivateWriteConsoleInputString(string, codepage);
     }
     return success;
 }
@@ -41,6 +41,8 @@ namespace Microsoft::Console::VirtualTerminal
 
         virtual bool PrivateWriteConsoleInputW(std::deque<std::unique_ptr<IInputEvent>>& events,
                                                size_t& eventsWritten) = 0;
+        virtual bool PrivateWriteConsoleInputString(const std::wstring_view string,
+                                                    const unsigned int codepage) = 0;
         virtual bool SetConsoleWindowInfo(const bool absolute,
                                           const SMALL_RECT& window) = 0;
         virtual bool PrivateSetCursorKeysMode(const bool applicationMode) = 0;
@@ -274,6 +274,13 @@ public:
         return _privateWriteConsoleInputWResult;
     }
 
+    bool PrivateWriteConsoleInputString(const std::wstring_view /*string*/,
+                                        const unsigned int /*codepage*/) override
+    {
+        Log::Comment(L"PrivateWriteConsoleInputString MOCK called...");
+        return true;
+    }
+
     bool PrivateWriteConsoleControlInput(_In_ KeyEvent key) override
     {
         Log::Comment(L"PrivateWriteConsoleControlInput MOCK called...");
@@ -113,6 +113,13 @@ InputStateMachineEngine::InputStateMachineEngine(std::unique_ptr<IInteractDispat
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionExecute(const wchar_t wch)
 {
+    // Line breaks and tabs in a bracketed paste are part of the pasted text,
+    // so they're written with it instead of as separate keypresses.
+    if (_inBracketedPaste && (wch == L'\r' || wch == L'\n' || wch == L'\t'))
+    {
+        return _pDispatch->WriteString({ &wch, 1 });
+    }
+
     return _DoControlCharacter(wch, false);
 }
 
@@ -234,6 +241,11 @@ bool InputStateMachineEngine::ActionExecuteFromEscape(const wchar_t wch)
 // - true iff we successfully dispatched the sequence.
 bool InputStateMachineEngine::ActionPrint(const wchar_t wch)
 {
+    if (_inBracketedPaste)
+    {
+        return _pDispatch->WriteString({ &wch, 1 });
+    }
+
     short vkey = 0;
     DWORD modifierState = 0;
     bool success = _GenerateKeyFromChar(wch, vkey, modifierState);
@@ -419,10 +431,23 @@ bool InputStateMachineEngine::ActionCsiDispatch(const VTID id, const VTParameter
         success = success && _WriteSingleKey(vkey, modifierState);
         break;
     case CsiActionCodes::Generic:
+    {
+        // The bracketed paste markers aren't keys. Everything between them is
+        // written as text, see ActionExecute.
+        const auto identifier = static_cast<GenericKeyIdentifiers>(parameters.at(0).value_or(0));
+        if (identifier == GenericKeyIdentifiers::BracketedPasteStart ||
+            identifier == GenericKeyIdentifiers::BracketedPasteEnd)
+        {
+            _inBracketedPaste = identifier == GenericKeyIdentifiers::BracketedPasteStart;
+            success = true;
+            break;
+        }
+
         success = _GetGenericVkey(parameters.at(0), vkey);
         modifierState = _GetGenericKeysModifierState(parameters);
         success = success && _WriteSingleKey(vkey, modifierState);
         break;
+    }
     case CsiActionCodes::CursorBackTab:
         success = _WriteSingleKey(VK_TAB, SHIFT_PRESSED);
         break;
@@ -108,6 +108,8 @@ namespace Microsoft::Console::VirtualTerminal
         F10 = 21,
         F11 = 23,
         F12 = 24,
+        BracketedPasteStart = 200,
+        BracketedPasteEnd = 201,
     };
 
     enum class Ss3ActionCodes : wchar_t
@@ -168,6 +170,7 @@ namespace Microsoft::Console::VirtualTerminal
         std::function<bool()> _pfnFlushToInputQueue;
         bool _lookingForDSR;
         DWORD _mouseButtonState = 0;
+        bool _inBracketedPaste = false;
 
         DWORD _GetCursorKeysModifierState(const VTParameters parameters, const VTID id) noexcept;
         DWORD _GetGenericKeysModifierState(const VTParameters parameters) noexcept;
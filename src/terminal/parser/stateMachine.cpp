@@ -7,6 +7,10 @@
 
 #include "ascii.hpp"
 
+#if defined(_M_IX86) || defined(_M_AMD64)
+#include <intrin.h>
+#endif
+
 using namespace Microsoft::Console::VirtualTerminal;
 
 //Takes ownership of the pEngine.
@@ -374,6 +378,144 @@ static constexpr bool _isActionableFromGround(const wchar_t wch) noexcept
 
 #pragma warning(pop)
 
+#pragma warning(push)
+#pragma warning(disable : 26481) // Don't use pointer arithmetic. We need it to walk the string in vector sized steps.
+#pragma warning(disable : 26490) // Don't use reinterpret_cast. Required to load vectors from the string.
+
+#if defined(_M_IX86) || defined(_M_AMD64)
+// Routine Description:
+// - Determines (once) whether the CPU and OS support AVX2.
+// Arguments:
+// - <none>
+// Return Value:
+// - True if AVX2 instructions can be used. False otherwise.
+static bool _isAvx2Supported() noexcept
+{
+    static const bool supported = []() noexcept {
+        int info[4]{};
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+
+        // OSXSAVE (bit 27) and AVX (bit 28) tell us whether the OS saves the
+        // YMM registers for us. XCR0 bits 1 and 2 must then both be set.
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+        {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    }();
+    return supported;
+}
+
+// Routine Description:
+// - Vectorized scan for _isActionableFromGround, 16 code units per step.
+// - The actionable set is [0x00, 0x1F] (C0) and [0x7F, 0x9F] (DEL and C1).
+//   Unsigned saturating subtraction gives us "wch <= limit" as "(wch -sat limit) == 0",
+//   which covers C0 directly and DEL/C1 after shifting the range down to start at 0.
+// Arguments:
+// - it - Pointer to the first code unit to check
+// - end - Pointer past the last code unit to check
+// Return Value:
+// - Pointer to the first actionable code unit, or to the first code unit of
+//   the (shorter than a vector) remainder that still needs to be checked.
+static const wchar_t* _findActionableFromGroundAvx2(const wchar_t* it, const wchar_t* const end) noexcept
+{
+    const auto c0Limit = _mm256_set1_epi16(0x1F);
+    const auto c1Base = _mm256_set1_epi16(0x7F);
+    const auto c1Limit = _mm256_set1_epi16(0x20);
+    const auto zero = _mm256_setzero_si256();
+
+    for (; end - it >= 16; it += 16)
+    {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        const auto isC0 = _mm256_cmpeq_epi16(_mm256_subs_epu16(chars, c0Limit), zero);
+        const auto isC1 = _mm256_cmpeq_epi16(_mm256_subs_epu16(_mm256_sub_epi16(chars, c1Base), c1Limit), zero);
+        const auto mask = static_cast<unsigned long>(_mm256_movemask_epi8(_mm256_or_si256(isC0, isC1)));
+        if (mask != 0)
+        {
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return it + index / sizeof(wchar_t);
+        }
+    }
+
+    return it;
+}
+
+// Routine Description:
+// - SSE2 version of _findActionableFromGroundAvx2, 8 code units per step.
+//   SSE2 is part of the x64 baseline and required by all our x86 targets.
+// Arguments:
+// - it - Pointer to the first code unit to check
+// - end - Pointer past the last code unit to check
+// Return Value:
+// - Pointer to the first actionable code unit, or to the first code unit of
+//   the (shorter than a vector) remainder that still needs to be checked.
+static const wchar_t* _findActionableFromGroundSse2(const wchar_t* it, const wchar_t* const end) noexcept
+{
+    const auto c0Limit = _mm_set1_epi16(0x1F);
+    const auto c1Base = _mm_set1_epi16(0x7F);
+    const auto c1Limit = _mm_set1_epi16(0x20);
+    const auto zero = _mm_setzero_si128();
+
+    for (; end - it >= 8; it += 8)
+    {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        const auto isC0 = _mm_cmpeq_epi16(_mm_subs_epu16(chars, c0Limit), zero);
+        const auto isC1 = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(chars, c1Base), c1Limit), zero);
+        const auto mask = static_cast<unsigned long>(_mm_movemask_epi8(_mm_or_si128(isC0, isC1)));
+        if (mask != 0)
+        {
+            unsigned long index;
+            _BitScanForward(&index, mask);
+            return it + index / sizeof(wchar_t);
+        }
+    }
+
+    return it;
+}
+#endif
+
+// Routine Description:
+// - Finds the next character that indicates an action that should be taken in the ground state.
+//   Everything in front of it can be handed to the engine as a single printable run.
+// - Ground state text is the overwhelming majority of what we parse, so this uses
+//   SSE2/AVX2 where available and falls back to _isActionableFromGround otherwise.
+// Arguments:
+// - string - Characters to search
+// - offset - Index of the first character to check
+// Return Value:
+// - Index of the first actionable character at or after offset, or string.size() if there is none.
+static size_t _findActionableFromGround(const std::wstring_view string, const size_t offset) noexcept
+{
+    const auto begin = string.data();
+    const auto end = begin + string.size();
+    auto it = begin + offset;
+
+#if defined(_M_IX86) || defined(_M_AMD64)
+    it = _isAvx2Supported() ? _findActionableFromGroundAvx2(it, end) : it;
+    it = _findActionableFromGroundSse2(it, end);
+#endif
+
+    for (; it != end; ++it)
+    {
+        if (_isActionableFromGround(*it))
+        {
+            break;
+        }
+    }
+
+    return it - begin;
+}
+
+#pragma warning(pop)
+
 // Routine Description:
 // - Triggers the Execute action to indicate that the listener should immediately respond to a C0 control character.
 // Arguments:
@@ -1124,330 +1266,557 @@ void StateMachine::_EventEscapeIntermediate(const wchar_t wch)
     }
 }
 
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiEntry state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Store parameter data
-//   6. Collect Control Sequence Private markers
-//   7. Dispatch a control sequence with parameters for action
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiEntry(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiEntry");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiIntermediate();
-    }
-    else if (_isCsiInvalid(wch))
-    {
-        _EnterCsiIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-        _EnterCsiParam();
-    }
-    else if (_isCsiPrivateMarker(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiParam();
-    }
-    else
-    {
-        _ActionCsiDispatch(wch);
-        _EnterGround();
-    }
-}
+// The names reported to the trace for each state, in the order of VTStates.
+static constexpr std::array<std::wstring_view, 21> s_vtStateNames{
+    L"Ground",
+    L"Escape",
+    L"EscapeIntermediate",
+    L"CsiEntry",
+    L"CsiIntermediate",
+    L"CsiIgnore",
+    L"CsiParam",
+    L"OscParam",
+    L"OscString",
+    L"OscTermination",
+    L"Ss3Entry",
+    L"Ss3Param",
+    L"Vt52Param",
+    L"DcsEntry",
+    L"DcsIgnore",
+    L"DcsIntermediate",
+    L"DcsParam",
+    L"DcsPassThrough",
+    L"DcsTermination",
+    L"SosPmApcString",
+    L"SosPmApcTermination",
+};
 
 // Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiIntermediate state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Dispatch a control sequence with parameters for action
+// - Determines the character class of a character below 0x80. Everything else
+//   belongs to VTCharClass::Other (C1 control characters never reach the table,
+//   they're converted to ESC + their 7-bit equivalent beforehand).
+//   CAN and SUB are classed as C0 even though they're handled from anywhere
+//   before any state gets to see them.
 // Arguments:
-// - wch - Character that triggered the event
+// - wch - Character to classify.
 // Return Value:
-// - <none>
-void StateMachine::_EventCsiIntermediate(const wchar_t wch)
+// - The class, as the index into a row of the transition table.
+static constexpr size_t _classifyAscii(const wchar_t wch) noexcept
 {
-    _trace.TraceOnEvent(L"CsiIntermediate");
-    if (_isC0Code(wch))
+    if (wch == AsciiChars::BEL)
     {
-        _ActionExecute(wch);
+        return 1; // VTCharClass::Bel
     }
-    else if (_isIntermediate(wch))
+    if (wch == AsciiChars::ESC)
     {
-        _ActionCollect(wch);
+        return 2; // VTCharClass::Esc
     }
-    else if (_isDelete(wch))
+    if (wch < L' ')
     {
-        _ActionIgnore();
+        return 0; // VTCharClass::C0
     }
-    else if (_isIntermediateInvalid(wch))
+    if (_isIntermediate(wch))
     {
-        _EnterCsiIgnore();
+        return 3; // VTCharClass::Intermediate
     }
-    else
+    if (_isNumericParamValue(wch))
     {
-        _ActionCsiDispatch(wch);
-        _EnterGround();
+        return 4; // VTCharClass::Digit
     }
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiIgnore state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Return to Ground
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiIgnore(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiIgnore");
-    if (_isC0Code(wch))
+    if (wch == L':')
     {
-        _ActionExecute(wch);
+        return 5; // VTCharClass::Colon
     }
-    else if (_isDelete(wch))
+    if (wch == L';')
     {
-        _ActionIgnore();
+        return 6; // VTCharClass::Semicolon
     }
-    else if (_isIntermediate(wch))
+    if (_isCsiPrivateMarker(wch))
     {
-        _ActionIgnore();
-    }
-    else if (_isIntermediateInvalid(wch))
-    {
-        _ActionIgnore();
+        return 7; // VTCharClass::PrivateMarker
     }
-    else
+    if (_isDelete(wch))
     {
-        _EnterGround();
+        return 9; // VTCharClass::Del
     }
+    return 8; // VTCharClass::Final
 }
 
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiParam state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect Intermediate characters
-//   4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   5. Store parameter data
-//   6. Dispatch a control sequence with parameters for action
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventCsiParam(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"CsiParam");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterCsiIntermediate();
-    }
-    else if (_isParameterInvalid(wch))
+static constexpr auto s_vtCharClasses = []() noexcept {
+    std::array<BYTE, 0x80> classes{};
+    for (wchar_t wch = 0; wch < 0x80; wch++)
     {
-        _EnterCsiIgnore();
+        classes[wch] = gsl::narrow_cast<BYTE>(_classifyAscii(wch));
     }
-    else
-    {
-        _ActionCsiDispatch(wch);
-        _EnterGround();
-    }
-}
+    return classes;
+}();
 
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the OscParam state.
-//   Events in this state will:
-//   1. Collect numeric values into an Osc Param
-//   2. Move to the OscString state on a delimiter
-//   3. Ignore everything else.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventOscParam(const wchar_t wch) noexcept
-{
-    _trace.TraceOnEvent(L"OscParam");
-    if (_isOscTerminator(wch))
-    {
-        _EnterGround();
-    }
-    else if (_isNumericParamValue(wch))
-    {
-        _ActionOscParam(wch);
-    }
-    else if (_isOscDelimiter(wch))
-    {
-        _EnterOscString();
-    }
-    else
-    {
-        _ActionIgnore();
-    }
-}
+// One member of each class. The transition table is built by feeding these
+// through the transition rules, so every class must be homogeneous with respect
+// to the predicates used in StateMachine::_GetTransition.
+static constexpr std::array<wchar_t, 11> s_vtClassRepresentatives{
+    AsciiChars::NUL, // C0
+    AsciiChars::BEL, // Bel
+    AsciiChars::ESC, // Esc
+    L' ', // Intermediate
+    L'0', // Digit
+    L':', // Colon
+    L';', // Semicolon
+    L'?', // PrivateMarker
+    L'm', // Final
+    AsciiChars::DEL, // Del
+    L'\xa0', // Other
+};
 
 // Routine Description:
-// - Processes a character event into a Action that occurs while in the OscParam state.
-//   Events in this state will:
-//   1. Trigger the OSC action associated with the param on an OscTerminator
-//   2. If we see a ESC, enter the OscTermination state. We'll wait for one
-//      more character before we dispatch the string.
-//   3. Ignore OscInvalid characters.
-//   4. Collect everything else into the OscString
+// - Determines the action and the next state for a character that arrives in one of the
+//   states within a control sequence (CSI, SS3), or a control string (OSC, DCS, SOS/PM/APC).
+//   This is only evaluated at compile time to build the transition table.
+//   If the returned state matches the given one, the state machine stays where it is
+//   and doesn't re-enter the state.
 // Arguments:
+// - state - The state the character arrives in.
 // - wch - Character that triggered the event
 // Return Value:
-// - <none>
-void StateMachine::_EventOscString(const wchar_t wch)
+// - The action to perform and the state to move to.
+constexpr StateMachine::VTTransition StateMachine::_GetTransition(const VTStates state, const wchar_t wch) noexcept
 {
-    _trace.TraceOnEvent(L"OscString");
-    if (_isOscTerminator(wch))
-    {
-        _ActionOscDispatch(wch);
-        _EnterGround();
-    }
-    else if (_isEscape(wch))
-    {
-        _EnterOscTermination();
-    }
-    else if (_isOscInvalid(wch))
-    {
-        _ActionIgnore();
-    }
-    else
+    switch (state)
     {
-        // add this character to our OSC string
-        _ActionOscPut(wch);
+    case VTStates::CsiEntry:
+        // 1. Execute C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Collect Intermediate characters
+        // 4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+        // 5. Store parameter data
+        // 6. Collect Control Sequence Private markers
+        // 7. Dispatch a control sequence with parameters for action
+        if (_isC0Code(wch))
+        {
+            return { VTActions::Execute, state };
+        }
+        if (_isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isIntermediate(wch))
+        {
+            return { VTActions::Collect, VTStates::CsiIntermediate };
+        }
+        if (_isCsiInvalid(wch))
+        {
+            return { VTActions::None, VTStates::CsiIgnore };
+        }
+        if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
+        {
+            return { VTActions::Param, VTStates::CsiParam };
+        }
+        if (_isCsiPrivateMarker(wch))
+        {
+            return { VTActions::Collect, VTStates::CsiParam };
+        }
+        return { VTActions::CsiDispatch, VTStates::Ground };
+    case VTStates::CsiIntermediate:
+        // 1. Execute C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Collect Intermediate characters
+        // 4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+        // 5. Dispatch a control sequence with parameters for action
+        if (_isC0Code(wch))
+        {
+            return { VTActions::Execute, state };
+        }
+        if (_isIntermediate(wch))
+        {
+            return { VTActions::Collect, state };
+        }
+        if (_isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isIntermediateInvalid(wch))
+        {
+            return { VTActions::None, VTStates::CsiIgnore };
+        }
+        return { VTActions::CsiDispatch, VTStates::Ground };
+    case VTStates::CsiIgnore:
+        // 1. Execute C0 control characters
+        // 2. Ignore Delete characters, intermediates and parameters
+        // 3. Return to Ground on anything else
+        if (_isC0Code(wch))
+        {
+            return { VTActions::Execute, state };
+        }
+        if (_isDelete(wch) || _isIntermediate(wch) || _isIntermediateInvalid(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        return { VTActions::None, VTStates::Ground };
+    case VTStates::CsiParam:
+        // 1. Execute C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Store parameter data
+        // 4. Collect Intermediate characters
+        // 5. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+        // 6. Dispatch a control sequence with parameters for action
+        if (_isC0Code(wch))
+        {
+            return { VTActions::Execute, state };
+        }
+        if (_isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
+        {
+            return { VTActions::Param, state };
+        }
+        if (_isIntermediate(wch))
+        {
+            return { VTActions::Collect, VTStates::CsiIntermediate };
+        }
+        if (_isParameterInvalid(wch))
+        {
+            return { VTActions::None, VTStates::CsiIgnore };
+        }
+        return { VTActions::CsiDispatch, VTStates::Ground };
+    case VTStates::OscParam:
+        // 1. Return to Ground on an OscTerminator
+        // 2. Collect numeric values into an Osc Param
+        // 3. Move to the OscString state on a delimiter
+        // 4. Ignore everything else.
+        if (_isOscTerminator(wch))
+        {
+            return { VTActions::None, VTStates::Ground };
+        }
+        if (_isNumericParamValue(wch))
+        {
+            return { VTActions::OscParam, state };
+        }
+        if (_isOscDelimiter(wch))
+        {
+            return { VTActions::None, VTStates::OscString };
+        }
+        return { VTActions::Ignore, state };
+    case VTStates::OscString:
+        // 1. Trigger the OSC action associated with the param on an OscTerminator
+        // 2. If we see a ESC, enter the OscTermination state. We'll wait for one
+        //    more character before we dispatch the string.
+        // 3. Ignore OscInvalid characters.
+        // 4. Collect everything else into the OscString
+        if (_isOscTerminator(wch))
+        {
+            return { VTActions::OscDispatch, VTStates::Ground };
+        }
+        if (_isEscape(wch))
+        {
+            return { VTActions::None, VTStates::OscTermination };
+        }
+        if (_isOscInvalid(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        return { VTActions::OscPut, state };
+    case VTStates::Ss3Entry:
+        // 1. Execute C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+        // 4. Store parameter data
+        // 5. Dispatch a control sequence with parameters for action
+        // SS3 sequences are structurally the same as CSI sequences, just with a
+        // different initiation. It's safe to reuse CSI's functions for
+        // determining if a character is a parameter, delimiter, or invalid,
+        // and to ignore characters in the CsiIgnore state.
+        if (_isC0Code(wch))
+        {
+            return { VTActions::Execute, state };
+        }
+        if (_isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isCsiInvalid(wch))
+        {
+            return { VTActions::None, VTStates::CsiIgnore };
+        }
+        if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
+        {
+            return { VTActions::Param, VTStates::Ss3Param };
+        }
+        return { VTActions::Ss3Dispatch, VTStates::Ground };
+    case VTStates::Ss3Param:
+        // 1. Execute C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Store parameter data
+        // 4. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
+        // 5. Dispatch a control sequence with parameters for action
+        if (_isC0Code(wch))
+        {
+            return { VTActions::Execute, state };
+        }
+        if (_isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
+        {
+            return { VTActions::Param, state };
+        }
+        if (_isParameterInvalid(wch))
+        {
+            return { VTActions::None, VTStates::CsiIgnore };
+        }
+        return { VTActions::Ss3Dispatch, VTStates::Ground };
+    case VTStates::DcsEntry:
+        // 1. Ignore C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Begin to ignore all remaining characters when an invalid character is detected (DcsIgnore)
+        // 4. Store parameter data
+        // 5. Collect Intermediate characters
+        // 6. Pass through everything else
+        // DCS sequences are structurally almost the same as CSI sequences, just with an
+        // extra data string. It's safe to reuse CSI functions for
+        // determining if a character is a parameter, delimiter, or invalid.
+        if (_isC0Code(wch) || _isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isCsiInvalid(wch))
+        {
+            return { VTActions::None, VTStates::DcsIgnore };
+        }
+        if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
+        {
+            return { VTActions::Param, VTStates::DcsParam };
+        }
+        if (_isIntermediate(wch))
+        {
+            return { VTActions::Collect, VTStates::DcsIntermediate };
+        }
+        return { VTActions::DcsPassThrough, VTStates::DcsPassThrough };
+    case VTStates::DcsIgnore:
+        // The entire DCS string is considered invalid and we will ignore everything.
+        // The termination state is handled outside when an ESC is seen.
+        return { VTActions::Ignore, state };
+    case VTStates::DcsIntermediate:
+        // 1. Ignore C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Collect intermediate data.
+        // 4. Begin to ignore all remaining intermediates when an invalid character is detected (DcsIgnore)
+        // 5. Pass through everything else.
+        if (_isC0Code(wch) || _isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isIntermediate(wch))
+        {
+            return { VTActions::Collect, state };
+        }
+        if (_isIntermediateInvalid(wch))
+        {
+            return { VTActions::None, VTStates::DcsIgnore };
+        }
+        return { VTActions::DcsPassThrough, VTStates::DcsPassThrough };
+    case VTStates::DcsParam:
+        // 1. Ignore C0 control characters
+        // 2. Ignore Delete characters
+        // 3. Collect DCS parameter data
+        // 4. Enter DcsIntermediate if we see an intermediate
+        // 5. Begin to ignore all remaining parameters when an invalid character is detected (DcsIgnore)
+        // 6. Pass through everything else.
+        if (_isC0Code(wch) || _isDelete(wch))
+        {
+            return { VTActions::Ignore, state };
+        }
+        if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
+        {
+            return { VTActions::Param, state };
+        }
+        if (_isIntermediate(wch))
+        {
+            return { VTActions::Collect, VTStates::DcsIntermediate };
+        }
+        if (_isParameterInvalid(wch))
+        {
+            return { VTActions::None, VTStates::DcsIgnore };
+        }
+        return { VTActions::DcsPassThrough, VTStates::DcsPassThrough };
+    case VTStates::DcsPassThrough:
+        // 1. Pass through if character is valid.
+        // 2. If we see a ESC, enter the DcsTermination state.
+        // 3. Ignore everything else.
+        if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
+        {
+            return { VTActions::DcsPassThrough, state };
+        }
+        if (_isEscape(wch))
+        {
+            return { VTActions::None, VTStates::DcsTermination };
+        }
+        return { VTActions::Ignore, state };
+    case VTStates::SosPmApcString:
+        // 1. If we see a ESC, enter the SosPmApcTermination state.
+        // 2. Ignore everything else.
+        if (_isEscape(wch))
+        {
+            return { VTActions::None, VTStates::SosPmApcTermination };
+        }
+        return { VTActions::Ignore, state };
+    default:
+        // The remaining states depend on the engine or the ANSI mode
+        // and are processed by their own event handlers.
+        return { VTActions::Ignore, state };
     }
 }
 
 // Routine Description:
-// - Handle the two-character termination of a OSC sequence.
-//   Events in this state will:
-//   1. Trigger the OSC action associated with the param on an OscTerminator
+// - Builds the [state][character class] transition table from the transition rules.
 // Arguments:
-// - wch - Character that triggered the event
-// Return Value:
 // - <none>
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the Ss3Entry state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   4. Store parameter data
-//   5. Dispatch a control sequence with parameters for action
-//  SS3 sequences are structurally the same as CSI sequences, just with a
-//      different initiation. It's safe to reuse CSI's functions for
-//      determining if a character is a parameter, delimiter, or invalid.
-// Arguments:
-// - wch - Character that triggered the event
 // Return Value:
-// - <none>
-void StateMachine::_EventSs3Entry(const wchar_t wch)
+// - The transition table.
+constexpr StateMachine::VTTransitionTable StateMachine::_BuildTransitionTable() noexcept
 {
-    _trace.TraceOnEvent(L"Ss3Entry");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isCsiInvalid(wch))
-    {
-        // It's safe for us to go into the CSI ignore here, because both SS3 and
-        //      CSI sequences ignore characters the same way.
-        _EnterCsiIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-        _EnterSs3Param();
-    }
-    else
+    static_assert(s_vtStateNames.size() == VTStatesCount);
+    static_assert(s_vtClassRepresentatives.size() == VTCharClassCount);
+    static_assert(s_vtCharClasses[AsciiChars::NUL] == static_cast<BYTE>(VTCharClass::C0));
+    static_assert(s_vtCharClasses[AsciiChars::BEL] == static_cast<BYTE>(VTCharClass::Bel));
+    static_assert(s_vtCharClasses[AsciiChars::ESC] == static_cast<BYTE>(VTCharClass::Esc));
+    static_assert(s_vtCharClasses[L' '] == static_cast<BYTE>(VTCharClass::Intermediate));
+    static_assert(s_vtCharClasses[L'0'] == static_cast<BYTE>(VTCharClass::Digit));
+    static_assert(s_vtCharClasses[L':'] == static_cast<BYTE>(VTCharClass::Colon));
+    static_assert(s_vtCharClasses[L';'] == static_cast<BYTE>(VTCharClass::Semicolon));
+    static_assert(s_vtCharClasses[L'?'] == static_cast<BYTE>(VTCharClass::PrivateMarker));
+    static_assert(s_vtCharClasses[L'm'] == static_cast<BYTE>(VTCharClass::Final));
+    static_assert(s_vtCharClasses[AsciiChars::DEL] == static_cast<BYTE>(VTCharClass::Del));
+
+    VTTransitionTable table{};
+    for (size_t state = 0; state < VTStatesCount; state++)
     {
-        _ActionSs3Dispatch(wch);
-        _EnterGround();
+        for (size_t charClass = 0; charClass < VTCharClassCount; charClass++)
+        {
+            table[state][charClass] = _GetTransition(static_cast<VTStates>(state), s_vtClassRepresentatives[charClass]);
+        }
     }
+    return table;
 }
 
+const StateMachine::VTTransitionTable StateMachine::s_transitions = StateMachine::_BuildTransitionTable();
+
 // Routine Description:
-// - Processes a character event into an Action that occurs while in the CsiParam state.
-//   Events in this state will:
-//   1. Execute C0 control characters
-//   2. Ignore Delete characters
-//   3. Begin to ignore all remaining parameters when an invalid character is detected (CsiIgnore)
-//   4. Store parameter data
-//   5. Dispatch a control sequence with parameters for action
+// - Processes a character event in any of the states within a control sequence (CSI, SS3)
+//   or a control string (OSC, DCS, SOS/PM/APC) by looking up the action and the next
+//   state in the transition table, instead of walking a chain of character predicates.
 // Arguments:
 // - wch - Character that triggered the event
 // Return Value:
 // - <none>
-void StateMachine::_EventSs3Param(const wchar_t wch)
+void StateMachine::_EventFromTable(const wchar_t wch)
 {
-    _trace.TraceOnEvent(L"Ss3Param");
-    if (_isC0Code(wch))
-    {
-        _ActionExecute(wch);
-    }
-    else if (_isDelete(wch))
+    const auto state = _state;
+    const auto stateIndex = static_cast<size_t>(state);
+    const size_t charClass = wch < s_vtCharClasses.size() ? til::at(s_vtCharClasses, wch) : static_cast<size_t>(VTCharClass::Other);
+    const auto transition = til::at(til::at(s_transitions, stateIndex), charClass);
+
+    _trace.TraceOnEvent(til::at(s_vtStateNames, stateIndex));
+
+    switch (transition.action)
     {
+    case VTActions::Ignore:
         _ActionIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
+        break;
+    case VTActions::Execute:
+        _ActionExecute(wch);
+        break;
+    case VTActions::Collect:
+        _ActionCollect(wch);
+        break;
+    case VTActions::Param:
         _ActionParam(wch);
-    }
-    else if (_isParameterInvalid(wch))
-    {
-        _EnterCsiIgnore();
-    }
-    else
-    {
+        break;
+    case VTActions::CsiDispatch:
+        _ActionCsiDispatch(wch);
+        break;
+    case VTActions::OscParam:
+        _ActionOscParam(wch);
+        break;
+    case VTActions::OscPut:
+        _ActionOscPut(wch);
+        break;
+    case VTActions::OscDispatch:
+        _ActionOscDispatch(wch);
+        break;
+    case VTActions::Ss3Dispatch:
         _ActionSs3Dispatch(wch);
-        _EnterGround();
+        break;
+    case VTActions::DcsPassThrough:
+        _ActionDcsPassThrough(wch);
+        break;
+    case VTActions::None:
+    default:
+        break;
+    }
+
+    if (transition.state != state)
+    {
+        _EnterState(transition.state);
+    }
+}
+
+// Routine Description:
+// - Moves the state machine into the given state, performing the entry actions of that state.
+// Arguments:
+// - state - The state to enter.
+// Return Value:
+// - <none>
+void StateMachine::_EnterState(const VTStates state)
+{
+    switch (state)
+    {
+    case VTStates::Ground:
+        return _EnterGround();
+    case VTStates::Escape:
+        return _EnterEscape();
+    case VTStates::EscapeIntermediate:
+        return _EnterEscapeIntermediate();
+    case VTStates::CsiEntry:
+        return _EnterCsiEntry();
+    case VTStates::CsiIntermediate:
+        return _EnterCsiIntermediate();
+    case VTStates::CsiIgnore:
+        return _EnterCsiIgnore();
+    case VTStates::CsiParam:
+        return _EnterCsiParam();
+    case VTStates::OscParam:
+        return _EnterOscParam();
+    case VTStates::OscString:
+        return _EnterOscString();
+    case VTStates::OscTermination:
+        return _EnterOscTermination();
+    case VTStates::Ss3Entry:
+        return _EnterSs3Entry();
+    case VTStates::Ss3Param:
+        return _EnterSs3Param();
+    case VTStates::Vt52Param:
+        return _EnterVt52Param();
+    case VTStates::DcsEntry:
+        return _EnterDcsEntry();
+    case VTStates::DcsIgnore:
+        return _EnterDcsIgnore();
+    case VTStates::DcsIntermediate:
+        return _EnterDcsIntermediate();
+    case VTStates::DcsParam:
+        return _EnterDcsParam();
+    case VTStates::DcsPassThrough:
+        return _EnterDcsPassThrough();
+    case VTStates::DcsTermination:
+        return _EnterDcsTermination();
+    case VTStates::SosPmApcString:
+        return _EnterSosPmApcString();
+    case VTStates::SosPmApcTermination:
+        return _EnterSosPmApcTermination();
+    default:
+        return;
     }
 }
 
@@ -1486,200 +1855,6 @@ void StateMachine::_EventVt52Param(const wchar_t wch)
     }
 }
 
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the DcsEntry state.
-//   Events in this state will:
-//   1. Ignore C0 control characters
-//   2. Ignore Delete characters
-//   3. Begin to ignore all remaining characters when an invalid character is detected (DcsIgnore)
-//   4. Store parameter data
-//   5. Collect Intermediate characters
-//   6. Pass through everything else
-//  DCS sequences are structurally almost the same as CSI sequences, just with an
-//      extra data string. It's safe to reuse CSI functions for
-//      determining if a character is a parameter, delimiter, or invalid.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventDcsEntry(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"DcsEntry");
-    if (_isC0Code(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isCsiInvalid(wch))
-    {
-        _EnterDcsIgnore();
-    }
-    else if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-        _EnterDcsParam();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterDcsIntermediate();
-    }
-    else
-    {
-        _ActionDcsPassThrough(wch);
-        _EnterDcsPassThrough();
-    }
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the DcsIgnore state.
-//   In this state the entire DCS string is considered invalid and we will ignore everything.
-//   The termination state is handled outside when an ESC is seen.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventDcsIgnore() noexcept
-{
-    _trace.TraceOnEvent(L"DcsIgnore");
-    _ActionIgnore();
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the DcsIntermediate state.
-//   Events in this state will:
-//   1. Ignore C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect intermediate data.
-//   4. Begin to ignore all remaining intermediates when an invalid character is detected (DcsIgnore)
-//   5. Enter DcsPassThrough if we see DCS pass through indicator
-//   6. Pass through everything else.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventDcsIntermediate(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"DcsIntermediate");
-    if (_isC0Code(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-    }
-    else if (_isIntermediateInvalid(wch))
-    {
-        _EnterDcsIgnore();
-    }
-    else
-    {
-        _ActionDcsPassThrough(wch);
-        _EnterDcsPassThrough();
-    }
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the DcsParam state.
-//   Events in this state will:
-//   1. Ignore C0 control characters
-//   2. Ignore Delete characters
-//   3. Collect DCS parameter data
-//   4. Enter DcsIntermediate if we see an intermediate
-//   5. Begin to ignore all remaining parameters when an invalid character is detected (DcsIgnore)
-//   6. Pass through everything else.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventDcsParam(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"DcsParam");
-    if (_isC0Code(wch))
-    {
-        _ActionIgnore();
-    }
-    else if (_isDelete(wch))
-    {
-        _ActionIgnore();
-    }
-    if (_isNumericParamValue(wch) || _isParameterDelimiter(wch))
-    {
-        _ActionParam(wch);
-    }
-    else if (_isIntermediate(wch))
-    {
-        _ActionCollect(wch);
-        _EnterDcsIntermediate();
-    }
-    else if (_isParameterInvalid(wch))
-    {
-        _EnterDcsIgnore();
-    }
-    else
-    {
-        _ActionDcsPassThrough(wch);
-        _EnterDcsPassThrough();
-    }
-}
-
-// Routine Description:
-// - Processes a character event into an Action that occurs while in the DcsPassThrough state.
-//   Events in this state will:
-//   1. Pass through if character is valid.
-//   2. If we see a ESC, enter the DcsTermination state.
-//   3. Ignore everything else.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventDcsPassThrough(const wchar_t wch)
-{
-    _trace.TraceOnEvent(L"DcsPassThrough");
-    if (_isC0Code(wch) || _isDcsPassThroughValid(wch))
-    {
-        _ActionDcsPassThrough(wch);
-    }
-    else if (_isEscape(wch))
-    {
-        _EnterDcsTermination();
-    }
-    else
-    {
-        _ActionIgnore();
-    }
-}
-
-// Routine Description:
-// - Handle SOS/PM/APC string.
-//   Events in this state will:
-//   1. If we see a ESC, enter the SosPmApcTermination state.
-//   2. Ignore everything else.
-// Arguments:
-// - wch - Character that triggered the event
-// Return Value:
-// - <none>
-void StateMachine::_EventSosPmApcString(const wchar_t wch) noexcept
-{
-    _trace.TraceOnEvent(L"SosPmApcString");
-    if (_isEscape(wch))
-    {
-        _EnterSosPmApcTermination();
-    }
-    else
-    {
-        _ActionIgnore();
-    }
-}
-
 // Routine Description:
 // - Handle "Variable Length String" termination.
 //   Events in this state will:
@@ -1783,42 +1958,27 @@ void StateMachine::ProcessCharacter(const wchar_t wch)
             return _EventEscape(wch);
         case VTStates::EscapeIntermediate:
             return _EventEscapeIntermediate(wch);
+        case VTStates::Vt52Param:
+            return _EventVt52Param(wch);
+        case VTStates::OscTermination:
+        case VTStates::DcsTermination:
+        case VTStates::SosPmApcTermination:
+            return _EventVariableLengthStringTermination(wch);
         case VTStates::CsiEntry:
-            return _EventCsiEntry(wch);
         case VTStates::CsiIntermediate:
-            return _EventCsiIntermediate(wch);
         case VTStates::CsiIgnore:
-            return _EventCsiIgnore(wch);
         case VTStates::CsiParam:
-            return _EventCsiParam(wch);
         case VTStates::OscParam:
-            return _EventOscParam(wch);
         case VTStates::OscString:
-            return _EventOscString(wch);
-        case VTStates::OscTermination:
-            return _EventVariableLengthStringTermination(wch);
         case VTStates::Ss3Entry:
-            return _EventSs3Entry(wch);
         case VTStates::Ss3Param:
-            return _EventSs3Param(wch);
-        case VTStates::Vt52Param:
-            return _EventVt52Param(wch);
         case VTStates::DcsEntry:
-            return _EventDcsEntry(wch);
         case VTStates::DcsIgnore:
-            return _EventDcsIgnore();
         case VTStates::DcsIntermediate:
-            return _EventDcsIntermediate(wch);
         case VTStates::DcsParam:
-            return _EventDcsParam(wch);
         case VTStates::DcsPassThrough:
-            return _EventDcsPassThrough(wch);
-        case VTStates::DcsTermination:
-            return _EventVariableLengthStringTermination(wch);
         case VTStates::SosPmApcString:
-            return _EventSosPmApcString(wch);
-        case VTStates::SosPmApcTermination:
-            return _EventVariableLengthStringTermination(wch);
+            return _EventFromTable(wch);
         default:
             return;
         }
@@ -1832,7 +1992,7 @@ void StateMachine::ProcessCharacter(const wchar_t wch)
 //      it doesn't understand to the tty.
 //  This does not modify the state of the state machine. Callers should be in
 //      the Action*Dispatch state, and upon completion, the state's handler (eg
-//      _EventCsiParam) should move us into the ground state.
+//      _EventFromTable) should move us into the ground state.
 // Arguments:
 // - <none>
 // Return Value:
@@ -1878,13 +2038,13 @@ void StateMachine::ProcessString(const std::wstring_view string)
 
     while (current < string.size())
     {
-        // The run will be everything from the start INCLUDING the current one
-        // in case we process the current character and it turns into a passthrough
-        // fallback that picks up this _run inside `FlushToTerminal` above.
-        _run = string.substr(start, current - start + 1);
-
         if (_processingIndividually)
         {
+            // The run will be everything from the start INCLUDING the current one
+            // in case we process the current character and it turns into a passthrough
+            // fallback that picks up this _run inside `FlushToTerminal` above.
+            _run = string.substr(start, current - start + 1);
+
             // If we're processing characters individually, send it to the state machine.
             ProcessCharacter(string.at(current));
             ++current;
@@ -1896,26 +2056,20 @@ void StateMachine::ProcessString(const std::wstring_view string)
         }
         else
         {
-            if (_isActionableFromGround(string.at(current))) // If the current char is the start of an escape sequence, or should be executed in ground state...
+            // Skip ahead to the next char that is the start of an escape sequence, or should be executed in ground state...
+            current = _findActionableFromGround(string, current);
+            if (current < string.size())
             {
-                if (!_run.empty())
+                if (current > start)
                 {
-                    // Because the _run above is composed INCLUDING current, we must
-                    // trim it off here since we just determined it's actionable
-                    // and only pass through everything before it.
-                    const auto allLeadingUpTo = _run.substr(0, _run.size() - 1);
-
-                    _engine->ActionPrintString(allLeadingUpTo); // ... print all the chars leading up to it as part of the run...
-                    _trace.DispatchPrintRunTrace(allLeadingUpTo);
+                    // ... print all the chars leading up to it as part of the run...
+                    _run = string.substr(start, current - start);
+                    _engine->ActionPrintString(_run);
+                    _trace.DispatchPrintRunTrace(_run);
                 }
 
                 _processingIndividually = true; // begin processing future characters individually...
                 start = current;
-                continue;
-            }
-            else
-            {
-                ++current; // Otherwise, add this char to the current run to be printed.
             }
         }
     }
@@ -17,6 +17,7 @@ Abstract:
 #include "IStateMachineEngine.hpp"
 #include "telemetry.hpp"
 #include "tracing.hpp"
+#include <array>
 #include <memory>
 
 namespace Microsoft::Console::VirtualTerminal
@@ -97,21 +98,7 @@ namespace Microsoft::Console::VirtualTerminal
         void _EventGround(const wchar_t wch);
         void _EventEscape(const wchar_t wch);
         void _EventEscapeIntermediate(const wchar_t wch);
-        void _EventCsiEntry(const wchar_t wch);
-        void _EventCsiIntermediate(const wchar_t wch);
-        void _EventCsiIgnore(const wchar_t wch);
-        void _EventCsiParam(const wchar_t wch);
-        void _EventOscParam(const wchar_t wch) noexcept;
-        void _EventOscString(const wchar_t wch);
-        void _EventSs3Entry(const wchar_t wch);
-        void _EventSs3Param(const wchar_t wch);
         void _EventVt52Param(const wchar_t wch);
-        void _EventDcsEntry(const wchar_t wch);
-        void _EventDcsIgnore() noexcept;
-        void _EventDcsIntermediate(const wchar_t wch);
-        void _EventDcsParam(const wchar_t wch);
-        void _EventDcsPassThrough(const wchar_t wch);
-        void _EventSosPmApcString(const wchar_t wch) noexcept;
         void _EventVariableLengthStringTermination(const wchar_t wch);
 
         void _AccumulateTo(const wchar_t wch, size_t& value) noexcept;
@@ -142,6 +129,57 @@ namespace Microsoft::Console::VirtualTerminal
             SosPmApcTermination
         };
 
+        static constexpr size_t VTStatesCount = static_cast<size_t>(VTStates::SosPmApcTermination) + 1;
+
+        // The character classes that the states inside control sequences, control strings
+        // and SS3 sequences tell apart. Every character of a class takes the same transition.
+        enum class VTCharClass : BYTE
+        {
+            C0,
+            Bel,
+            Esc,
+            Intermediate,
+            Digit,
+            Colon,
+            Semicolon,
+            PrivateMarker,
+            Final,
+            Del,
+            Other
+        };
+
+        static constexpr size_t VTCharClassCount = static_cast<size_t>(VTCharClass::Other) + 1;
+
+        enum class VTActions : BYTE
+        {
+            None,
+            Ignore,
+            Execute,
+            Collect,
+            Param,
+            CsiDispatch,
+            OscParam,
+            OscPut,
+            OscDispatch,
+            Ss3Dispatch,
+            DcsPassThrough
+        };
+
+        struct VTTransition
+        {
+            VTActions action;
+            VTStates state;
+        };
+
+        using VTTransitionTable = std::array<std::array<VTTransition, VTCharClassCount>, VTStatesCount>;
+
+        static constexpr VTTransition _GetTransition(const VTStates state, const wchar_t wch) noexcept;
+        static constexpr VTTransitionTable _BuildTransitionTable() noexcept;
+        static const VTTransitionTable s_transitions;
+
+        void _EventFromTable(const wchar_t wch);
+        void _EnterState(const VTStates state);
+
         Microsoft::Console::VirtualTerminal::ParserTracing _trace;
 
         std::unique_ptr<IStateMachineEngine> _engine;
@@ -72,6 +72,7 @@ public:
         _expectedToCallWindowManipulation{ false },
         _expectSendCtrlC{ false },
         _expectCursorPosition{ false },
+        _writeStringCount{ 0 },
         _expectedCursor{ -1, -1 },
         _expectedWindowManipulation{ DispatchTypes::WindowManipulationType::Invalid }
     {
@@ -203,6 +204,7 @@ public:
     bool _expectedToCallWindowManipulation;
     bool _expectSendCtrlC;
     bool _expectCursorPosition;
+    size_t _writeStringCount;
     COORD _expectedCursor;
     DispatchTypes::WindowManipulationType _expectedWindowManipulation;
     unsigned short _expectedParams[16];
@@ -276,6 +278,7 @@ class Microsoft::Console::VirtualTerminal::InputEngineTest
     TEST_METHOD(TestSs3Entry);
     TEST_METHOD(TestSs3Immediate);
     TEST_METHOD(TestSs3Param);
+    TEST_METHOD(BracketedPasteTest);
 
     TEST_METHOD(TestWin32InputParsing);
     TEST_METHOD(TestWin32InputOptionals);
@@ -373,6 +376,7 @@ bool TestInteractDispatch::WindowManipulation(const DispatchTypes::WindowManipul
 
 bool TestInteractDispatch::WriteString(const std::wstring_view string)
 {
+    ++_testState->_writeStringCount;
     std::deque<std::unique_ptr<IInputEvent>> keyEvents;
 
     for (const auto& wch : string)
@@ -1398,6 +1402,55 @@ void InputEngineTest::TestSs3Param()
     VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
 }
 
+void InputEngineTest::BracketedPasteTest()
+{
+    auto pfn = std::bind(&TestState::TestInputCallback, &testState, std::placeholders::_1);
+    auto dispatch = std::make_unique<TestInteractDispatch>(pfn, &testState);
+    auto inputEngine = std::make_unique<InputStateMachineEngine>(std::move(dispatch));
+    auto _stateMachine = std::make_unique<StateMachine>(std::move(inputEngine));
+    VERIFY_IS_NOT_NULL(_stateMachine);
+    testState._stateMachine = _stateMachine.get();
+
+    const auto expectKeyDown = [&](const wchar_t wch) {
+        const short keyscan = VkKeyScanW(wch);
+        const short keyscanModifiers = (keyscan >> 8) & 0xff;
+
+        INPUT_RECORD inputRec{};
+        inputRec.EventType = KEY_EVENT;
+        inputRec.Event.KeyEvent.bKeyDown = TRUE;
+        inputRec.Event.KeyEvent.dwControlKeyState = (WI_IsFlagSet(keyscanModifiers, 1) ? SHIFT_PRESSED : 0) |
+                                                    (WI_IsFlagSet(keyscanModifiers, 2) ? LEFT_CTRL_PRESSED : 0) |
+                                                    (WI_IsFlagSet(keyscanModifiers, 4) ? LEFT_ALT_PRESSED : 0);
+        inputRec.Event.KeyEvent.wRepeatCount = 1;
+        inputRec.Event.KeyEvent.wVirtualKeyCode = keyscan & 0xff;
+        inputRec.Event.KeyEvent.uChar.UnicodeChar = wch;
+        testState.vExpectedInput.push_back(inputRec);
+    };
+
+    Log::Comment(L"The paste markers themselves shouldn't be written as input");
+    _stateMachine->ProcessString(L"\x1b[200~");
+    VerifyExpectedInputDrained();
+
+    Log::Comment(L"Text, line breaks and tabs in the paste should all be written as text");
+    for (const auto wch : std::wstring_view{ L"a\tB\r\n" })
+    {
+        expectKeyDown(wch);
+        const auto writeStringCount = testState._writeStringCount;
+        _stateMachine->ProcessString({ &wch, 1 });
+        VERIFY_ARE_EQUAL(writeStringCount + 1, testState._writeStringCount);
+    }
+
+    _stateMachine->ProcessString(L"\x1b[201~");
+    VerifyExpectedInputDrained();
+
+    Log::Comment(L"After the paste, a tab should be a keypress again");
+    expectKeyDown(L'\t');
+    const auto writeStringCount = testState._writeStringCount;
+    _stateMachine->ProcessString(L"\t");
+    VERIFY_ARE_EQUAL(writeStringCount, testState._writeStringCount);
+    VerifyExpectedInputDrained();
+}
+
 void InputEngineTest::TestWin32InputParsing()
 {
     auto pfn = std::bind(&TestState::TestInputCallback, &testState, std::placeholders::_1);
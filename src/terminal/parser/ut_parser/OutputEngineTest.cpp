@@ -776,6 +776,11 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
         mach.ProcessCharacter(L';');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
+        Log::Comment(L"C0 and DEL characters are ignored without leaving DcsParam");
+        mach.ProcessCharacter(AsciiChars::LF);
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
+        mach.ProcessCharacter(AsciiChars::DEL);
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
         mach.ProcessCharacter(L';');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::DcsParam);
         mach.ProcessCharacter(L'8');
@@ -978,6 +983,60 @@ class Microsoft::Console::VirtualTerminal::OutputEngineTest final
         mach.ProcessCharacter(L'\x9c');
         VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
     }
+
+    TEST_METHOD(TestProcessStringThroughput)
+    {
+        BEGIN_TEST_METHOD_PROPERTIES()
+            TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+            TEST_METHOD_PROPERTY(L"Data:uiStream", L"{0, 1, 2}")
+        END_TEST_METHOD_PROPERTIES()
+
+        size_t uiStream;
+        VERIFY_SUCCEEDED_RETURN(TestData::TryGetValue(L"uiStream", uiStream));
+
+        // These approximate recordings of typical output: a plain build log,
+        // `ls --color` (an SGR sequence around every file name) and a
+        // full screen TUI redraw (cursor positioning and SGR in every cell).
+        std::wstring_view name;
+        std::wstring record;
+        switch (uiStream)
+        {
+        case 0:
+            name = L"build log";
+            record = L"  Compiling src/terminal/parser/stateMachine.cpp (release, x64) ... done in 1.27s\r\n";
+            break;
+        case 1:
+            name = L"ls --color";
+            record = L"\x1b[0m\x1b[01;34mbuild\x1b[0m  \x1b[01;32mconfigure\x1b[0m  README.md  \x1b[01;31mdist.tar.gz\x1b[0m\r\n";
+            break;
+        default:
+            name = L"TUI redraw";
+            record = L"\x1b[12;40H\x1b[38;5;208m\x1b[48;2;30;30;30m#\x1b[39;49m\x1b[13;1H\x1b[K\x1b[?25l\x1b]0;top\x07";
+            break;
+        }
+
+        std::wstring stream;
+        while (stream.size() < 4 * 1024 * 1024)
+        {
+            stream.append(record);
+        }
+
+        auto dispatch = std::make_unique<DummyDispatch>();
+        auto engine = std::make_unique<OutputStateMachineEngine>(std::move(dispatch));
+        StateMachine mach(std::move(engine));
+
+        const auto start = std::chrono::steady_clock::now();
+        mach.ProcessString(stream);
+        const auto delta = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        const auto bytes = stream.size() * sizeof(wchar_t);
+        Log::Comment(NoThrowString().Format(L"%s: %zu bytes in %lld us (%.2f MB/s)",
+                                            name.data(),
+                                            bytes,
+                                            delta,
+                                            delta ? (bytes / static_cast<double>(delta)) : 0.0));
+        VERIFY_ARE_EQUAL(mach._state, StateMachine::VTStates::Ground);
+    }
 };
 
 class StatefulDispatch final : public TermDispatch
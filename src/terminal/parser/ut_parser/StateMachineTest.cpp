@@ -128,6 +128,7 @@ class Microsoft::Console::VirtualTerminal::StateMachineTest
     TEST_METHOD(PassThroughUnhandled);
     TEST_METHOD(RunStorageBeforeEscape);
     TEST_METHOD(BulkTextPrint);
+    TEST_METHOD(BulkTextPrintAroundControlCharacters);
     TEST_METHOD(PassThroughUnhandledSplitAcrossWrites);
 };
 
@@ -201,6 +202,39 @@ void StateMachineTest::BulkTextPrint()
     VERIFY_ARE_EQUAL(String(L"12345 Hello World"), String(engine.printed.c_str()));
 }
 
+void StateMachineTest::BulkTextPrintAroundControlCharacters()
+{
+    auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
+    // this dance is required because StateMachine presumes to take ownership of its engine.
+    auto& engine{ *enginePtr.get() };
+    StateMachine machine{ std::move(enginePtr) };
+
+    // The ground state scanner looks at 8 or 16 characters at a time. Move a
+    // control character across several of those blocks and make sure that the
+    // printable text around it (including the characters right next to the
+    // C0 and DEL/C1 ranges) is passed on unaltered and in one piece.
+    const std::wstring_view filler{ L"\x20\x7e\xa0\x100\x3000\xffffab" };
+    const std::wstring_view controls{ L"\a\x7f\x84" };
+
+    for (const auto control : controls)
+    {
+        for (size_t offset = 0; offset <= 40; ++offset)
+        {
+            std::wstring before;
+            std::wstring after;
+            for (size_t i = 0; i < 40; ++i)
+            {
+                (i < offset ? before : after).push_back(filler.at(i % filler.size()));
+            }
+
+            engine.ResetTestState();
+            machine.ProcessString(before + control + after);
+
+            VERIFY_ARE_EQUAL(before + after, engine.printed);
+        }
+    }
+}
+
 void StateMachineTest::PassThroughUnhandledSplitAcrossWrites()
 {
     auto enginePtr{ std::make_unique<TestStateMachineEngine>() };
@@ -4,6 +4,8 @@
 #include "precomp.h"
 #include "WexTestClass.h"
 
+#include <chrono>
+
 using namespace WEX::Common;
 using namespace WEX::Logging;
 using namespace WEX::TestExecution;
@@ -17,8 +19,31 @@ class Utf8Utf16ConvertTests
     TEST_METHOD(TestU8ToU16Partials);
     TEST_METHOD(TestU16ToU8Partials);
     TEST_METHOD(TestU8ToU16OneByOne);
+    TEST_METHOD(TestU8ToU16AsciiRuns);
+    TEST_METHOD(TestU8ToU16NaturalLanguages);
+
+    BEGIN_TEST_METHOD(TestU8ToU16Throughput)
+        TEST_METHOD_PROPERTY(L"IsPerfTest", L"true")
+    END_TEST_METHOD()
+};
+
+// Excerpts of the natural language test files in src\tools\U8U16Test.
+static constexpr std::array<std::wstring_view, 4> naturalLanguageSamples{
+    L"the first time Steve a \"devices and services\" replaced computer",
+    L"la grande qui strat\u00e9gie commerciale Elle conf\u00e8re \u00e0 la \u00ab vente li\u00e9e \u00bb : Windows sur personn",
+    L"\u0441\u043e\u0431\u0441\u0442\u0432\u0435\u043d\u043d\u044b\u0439 C \u043f\u043b\u0430\u043d\u0448\u0435\u0442\u043d\u044b\u0439 \u041f\u043e\u0434\u0440\u0430\u0437\u0434\u0435\u043b\u0435\u043d\u0438\u044f \u0433\u043e\u0434\u0430 \u2014 Surface.",
+    L"\u5fae\u8f6f\u66fe\u8d85\u8d8a\u82f9\u679c\u516c\u53f8\uff0c\u4ee5\u53ca\u968f\u540e\u901a\u8fc7\u6536\u8d2d\u8bfa\u57fa\u4e9a\u8bbe\u5907\u5f62\u6210\u5fae\u8f6f\u79fb\u52a8\u548c\u670d\u52a1\u90e8\u95e8\u3002\u5fae\u8f6f\u516c\u53f8\u65bc2014\u5e74\u63a5\u4efb",
 };
 
+// Converts a UTF-8 string using nothing but MultiByteToWideChar, to compare til::u8u16 with.
+static std::wstring _MultiByteToWideChar(const std::string_view in)
+{
+    std::wstring out(in.length(), L'\0');
+    const auto length = MultiByteToWideChar(CP_UTF8, 0, in.data(), gsl::narrow<int>(in.length()), out.data(), gsl::narrow<int>(out.length()));
+    out.resize(gsl::narrow_cast<size_t>(length));
+    return out;
+}
+
 void Utf8Utf16ConvertTests::TestU8ToU16()
 {
     const std::string u8String{
@@ -191,3 +216,128 @@ void Utf8Utf16ConvertTests::TestU8ToU16OneByOne()
     VERIFY_SUCCEEDED(til::u8u16(u8String1_4, u16Out1, state));
     VERIFY_ARE_EQUAL(u16StringComp1, u16Out1);
 }
+
+void Utf8Utf16ConvertTests::TestU8ToU16AsciiRuns()
+{
+    // ASCII runs are widened by til::u8u16 itself and everything else is converted by MultiByteToWideChar.
+    // Slide complete, truncated and invalid sequences over the boundaries of the vectorized ASCII runs.
+    const std::array<std::string_view, 6> insertions{
+        "\xC3\xB6", // LATIN SMALL LETTER O WITH DIAERESIS
+        "\xE2\x82\xAC", // EURO SIGN
+        "\xF0\x9F\x93\xB7", // U+1F4F7 CAMERA
+        "\xE2\x82", // EURO SIGN (truncated)
+        "\x80", // lone continuation byte
+        "\xFF", // invalid byte
+    };
+
+    for (const auto insertion : insertions)
+    {
+        for (size_t offset = 0; offset <= 40; ++offset)
+        {
+            std::string u8String(offset, 'x');
+            u8String.append(insertion);
+            u8String.append(40 - offset, 'y');
+            u8String.append(insertion);
+
+            std::wstring u16Out{};
+            VERIFY_ARE_EQUAL(S_OK, til::u8u16(u8String, u16Out));
+            VERIFY_ARE_EQUAL(_MultiByteToWideChar(u8String), u16Out);
+        }
+    }
+
+    // The caller's buffer is reused and must not retain anything from a previous, longer conversion.
+    std::wstring u16Out(100, L'z');
+    VERIFY_ARE_EQUAL(S_OK, til::u8u16(std::string_view{ "abc" }, u16Out));
+    VERIFY_ARE_EQUAL(L"abc", u16Out);
+}
+
+void Utf8Utf16ConvertTests::TestU8ToU16NaturalLanguages()
+{
+    for (const auto sample : naturalLanguageSamples)
+    {
+        std::wstring u16String{};
+        for (auto i = 0; i < 10; ++i)
+        {
+            u16String.append(sample);
+            u16String.append(L"\r\n");
+        }
+        const auto u8String = til::u16u8(u16String);
+
+        std::wstring u16Out{};
+        VERIFY_ARE_EQUAL(S_OK, til::u8u16(u8String, u16Out));
+        VERIFY_ARE_EQUAL(u16String, u16Out);
+
+        // Like a pipe, deliver the text in chunks that split code points. The partials must be carried over.
+        for (size_t chunkSize = 1; chunkSize <= 37; ++chunkSize)
+        {
+            til::u8state state{};
+            std::wstring u16Joined{};
+
+            for (size_t pos = 0; pos < u8String.length(); pos += chunkSize)
+            {
+                VERIFY_SUCCEEDED(til::u8u16(std::string_view{ u8String }.substr(pos, chunkSize), u16Out, state));
+                u16Joined.append(u16Out);
+            }
+
+            VERIFY_ARE_EQUAL(u16String, u16Joined);
+        }
+    }
+}
+
+void Utf8Utf16ConvertTests::TestU8ToU16Throughput()
+{
+    // A build log is mostly ASCII, with the occasional non-ASCII character (like a check mark or a box drawing character).
+    std::wstring buildLog{};
+    for (auto i = 0; i < 64; ++i)
+    {
+        buildLog.append(L"  Compiling src/terminal/parser/stateMachine.cpp (Release|x64) ... \u2713 done\r\n");
+    }
+
+    std::vector<std::pair<std::wstring_view, std::wstring_view>> samples{
+        { L"build log", buildLog },
+        { L"en", naturalLanguageSamples.at(0) },
+        { L"fr", naturalLanguageSamples.at(1) },
+        { L"ru", naturalLanguageSamples.at(2) },
+        { L"zh", naturalLanguageSamples.at(3) },
+    };
+
+    // Convert the same amount of text in 4 KiB chunks, just like ConptyConnection reads it from the pipe.
+    constexpr size_t totalSize = 64 * 1024 * 1024;
+    constexpr size_t chunkSize = 4096;
+
+    for (const auto& [name, sample] : samples)
+    {
+        const auto u8Sample = til::u16u8(sample);
+        std::string u8String{};
+        while (u8String.length() < totalSize)
+        {
+            u8String.append(u8Sample);
+        }
+
+        std::wstring u16Out{};
+        std::wstring u16Buffer(chunkSize, L'\0');
+        til::u8state state{};
+
+        const auto measure = [&](auto&& convert) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t pos = 0; pos < u8String.length(); pos += chunkSize)
+            {
+                convert(std::string_view{ u8String }.substr(pos, chunkSize));
+            }
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return u8String.length() / elapsed / (1024.0 * 1024.0);
+        };
+
+        HRESULT hr{ S_OK };
+        const auto mb2wcSpeed = measure([&](const std::string_view chunk) {
+            MultiByteToWideChar(CP_UTF8, 0, chunk.data(), gsl::narrow<int>(chunk.length()), u16Buffer.data(), gsl::narrow<int>(u16Buffer.length()));
+        });
+        const auto u8u16Speed = measure([&](const std::string_view chunk) {
+            const auto result = til::u8u16(chunk, u16Out, state);
+            hr = FAILED(result) ? result : hr;
+        });
+        VERIFY_SUCCEEDED(hr);
+
+        Log::Comment(NoThrowString().Format(L"%.*s: MultiByteToWideChar %.1f MB/s, til::u8u16 %.1f MB/s", gsl::narrow<int>(name.length()), name.data(), mb2wcSpeed, u8u16Speed));
+    }
+}
@@ -18,11 +18,13 @@
 VtConsole::VtConsole(PipeReadCallback const pfnReadCallback,
                      bool const fHeadless,
                      bool const fUseConpty,
-                     COORD const initialSize) :
+                     COORD const initialSize,
+                     bool const fPassthrough) :
     _pfnReadCallback(pfnReadCallback),
     _fHeadless(fHeadless),
     _fUseConPty(fUseConpty),
-    _lastDimensions(initialSize)
+    _lastDimensions(initialSize),
+    _fPassthrough(fPassthrough)
 {
     THROW_HR_IF_NULL(E_INVALIDARG, pfnReadCallback);
 }
@@ -227,6 +229,11 @@ void VtConsole::_createConptyViaCommandline(const std::wstring& command)
         cmdline += L" --headless";
     }
 
+    if (_fPassthrough)
+    {
+        cmdline += L" --passthrough";
+    }
+
     // Create some anon pipes so we can pass handles down and into the console.
     // IMPORTANT NOTE:
     // We're creating the pipe here with un-inheritable handles, then marking
@@ -25,7 +25,7 @@ typedef void (*PipeReadCallback)(BYTE* buffer, DWORD dwRead);
 class VtConsole
 {
 public:
-    VtConsole(PipeReadCallback const pfnReadCallback, bool const fHeadless, bool const fUseConpty, COORD const initialSize);
+    VtConsole(PipeReadCallback const pfnReadCallback, bool const fHeadless, bool const fUseConpty, COORD const initialSize, bool const fPassthrough = false);
     void spawn();
     void spawn(const std::wstring& command);
 
@@ -66,6 +66,7 @@ private:
     bool _active = false;
     bool _fUseConPty = false;
     bool _fHeadless = false;
+    bool _fPassthrough = false;
 
     PipeReadCallback _pfnReadCallback;
 
@@ -48,6 +48,7 @@ int lang = TEST_LANG_NONE;
 
 bool g_headless = false;
 bool g_useConpty = false;
+bool g_passthrough = false;
 bool g_useOutfile = false;
 std::wstring outfile = L"vtpt.out";
 HANDLE hOutFile = INVALID_HANDLE_VALUE;
@@ -115,7 +116,7 @@ HANDLE outPipe()
 
 void newConsole()
 {
-    auto con = new VtConsole(ReadCallback, g_headless, g_useConpty, { lastTerminalWidth, lastTerminalHeight });
+    auto con = new VtConsole(ReadCallback, g_headless, g_useConpty, { lastTerminalWidth, lastTerminalHeight }, g_passthrough);
     con->spawn();
     consoles.push_back(con);
 }
@@ -546,6 +547,10 @@ int __cdecl wmain(int argc, WCHAR* argv[])
             {
                 g_useConpty = true;
             }
+            else if (arg == std::wstring(L"--passthrough"))
+            {
+                g_passthrough = true;
+            }
             else if (arg == std::wstring(L"--debug"))
             {
                 fUseDebug = true;
@@ -3,6 +3,7 @@
 
 #include "precomp.h"
 #include "inc/CodepointWidthDetector.hpp"
+#include "inc/Utf16Parser.hpp"
 
 namespace
 {
@@ -14,11 +15,6 @@ namespace
         CodepointWidth width;
     };
 
-    static bool operator<(const UnicodeRange& range, const unsigned int searchTerm) noexcept
-    {
-        return range.upperBound < searchTerm;
-    }
-
     // Generated by Generate-CodepointWidthsFromUCD.ps1 -Pack:True -Full:False -NoOverrides:False
     // on 10/25/2020 7:32:04 AM (UTC) from Unicode 13.0.0.
     // 321205 (0x4E6B5) codepoints covered.
@@ -321,6 +317,133 @@ namespace
         UnicodeRange{ 0xf0000, 0xffffd, CodepointWidth::Ambiguous },
         UnicodeRange{ 0x100000, 0x10fffd, CodepointWidth::Ambiguous },
     };
+
+    // The table above is expanded into a two-level page table, so that
+    // the width of any codepoint is found with two array lookups instead of a binary search.
+    // The first level holds, for each block of 256 codepoints, the index of the page holding their widths.
+    // A page packs those widths into words, 2 bits per codepoint.
+    // Blocks that have the same width throughout share one of the first three pages.
+    static constexpr unsigned int s_pageBits = 8;
+    static constexpr unsigned int s_pageSize = 1u << s_pageBits;
+    static constexpr unsigned int s_codepointCount = 0x110000;
+    static constexpr unsigned int s_blockCount = s_codepointCount / s_pageSize;
+    static constexpr unsigned int s_widthBits = 2;
+    static constexpr unsigned int s_widthsPerWord = 64 / s_widthBits;
+    static constexpr unsigned int s_wordsPerPage = s_pageSize / s_widthsPerWord;
+    static constexpr unsigned int s_uniformPageCount = 3;
+
+    // Returns a word with every width in it set to the given one.
+    static constexpr uint64_t s_fillWord(const CodepointWidth width) noexcept
+    {
+        return 0x5555555555555555ull * static_cast<uint64_t>(width);
+    }
+
+    // Returns whether a range covers a whole block. Ranges don't overlap, so any other block
+    // a range touches has codepoints of other widths too and needs a page of its own.
+    static constexpr bool s_coversBlock(const UnicodeRange& range, const unsigned int block) noexcept
+    {
+        return range.lowerBound <= block << s_pageBits && (block << s_pageBits) + s_pageSize - 1 <= range.upperBound;
+    }
+
+    // Returns the number of blocks that need a page of their own. Only the first and the last
+    // block of a range can be one of those, and as the ranges are sorted, so are those blocks.
+    static constexpr size_t s_countMixedBlocks() noexcept
+    {
+        size_t count = 0;
+        auto lastBlock = s_blockCount;
+        for (const auto& range : s_wideAndAmbiguousTable)
+        {
+            for (const auto block : { range.lowerBound >> s_pageBits, range.upperBound >> s_pageBits })
+            {
+                if (!s_coversBlock(range, block) && block != lastBlock)
+                {
+                    ++count;
+                    lastBlock = block;
+                }
+            }
+        }
+        return count;
+    }
+
+    static_assert(s_uniformPageCount + s_countMixedBlocks() <= 256, "page indices must fit into a BYTE");
+
+    struct WidthPageTable final
+    {
+        std::array<BYTE, s_blockCount> pages;
+        std::array<uint64_t, (s_uniformPageCount + s_countMixedBlocks()) * s_wordsPerPage> words;
+    };
+
+    static constexpr WidthPageTable s_buildWidthPageTable() noexcept
+    {
+        static_assert(static_cast<BYTE>(CodepointWidth::Narrow) == 0);
+        static_assert(static_cast<BYTE>(CodepointWidth::Wide) == 1);
+        static_assert(static_cast<BYTE>(CodepointWidth::Ambiguous) == 2);
+
+        // Every block starts out pointing at the first page, and every word starts out narrow.
+        // That makes the first page the uniformly narrow one.
+        WidthPageTable table{};
+
+        // The other uniform pages follow in the order of the values of CodepointWidth.
+        for (unsigned int i = 0; i < s_wordsPerPage; ++i)
+        {
+            til::at(table.words, s_wordsPerPage + i) = s_fillWord(CodepointWidth::Wide);
+            til::at(table.words, 2 * s_wordsPerPage + i) = s_fillWord(CodepointWidth::Ambiguous);
+        }
+
+        auto nextPage = s_uniformPageCount;
+        auto lastMixedBlock = s_blockCount;
+        for (const auto& range : s_wideAndAmbiguousTable)
+        {
+            for (auto block = range.lowerBound >> s_pageBits; block <= range.upperBound >> s_pageBits; ++block)
+            {
+                if (s_coversBlock(range, block))
+                {
+                    til::at(table.pages, block) = static_cast<BYTE>(range.width);
+                    continue;
+                }
+
+                // Give the block a page of its own the first time a range touches it,
+                // then fill in the widths of the range, a word at a time.
+                if (block != lastMixedBlock)
+                {
+                    til::at(table.pages, block) = gsl::narrow_cast<BYTE>(nextPage++);
+                    lastMixedBlock = block;
+                }
+
+                const auto pageStart = block << s_pageBits;
+                const auto first = std::max(range.lowerBound, pageStart) - pageStart;
+                const auto last = std::min(range.upperBound, pageStart + s_pageSize - 1) - pageStart;
+                for (auto word = first / s_widthsPerWord; word <= last / s_widthsPerWord; ++word)
+                {
+                    const auto wordStart = word * s_widthsPerWord;
+                    const auto low = std::max(first, wordStart) - wordStart;
+                    const auto count = std::min(last, wordStart + s_widthsPerWord - 1) - wordStart - low + 1;
+                    const auto mask = (count == s_widthsPerWord ? ~0ull : (1ull << (count * s_widthBits)) - 1) << (low * s_widthBits);
+                    til::at(table.words, til::at(table.pages, block) * s_wordsPerPage + word) |= s_fillWord(range.width) & mask;
+                }
+            }
+        }
+
+        return table;
+    }
+
+    // The builder can run at compile time, but the table doesn't need to be a constant expression.
+    // That leaves it to the compiler whether it's worth the evaluation steps or done once at startup.
+    static const auto s_widthPageTable = s_buildWidthPageTable();
+
+    // Returns the width of a codepoint from the page table.
+    static CodepointWidth s_lookupCodepointWidth(const unsigned int codepoint) noexcept
+    {
+        if (codepoint >= s_codepointCount)
+        {
+            return CodepointWidth::Narrow;
+        }
+
+        const auto page = til::at(s_widthPageTable.pages, codepoint >> s_pageBits);
+        const auto offset = codepoint & (s_pageSize - 1);
+        const auto word = til::at(s_widthPageTable.words, page * s_wordsPerPage + offset / s_widthsPerWord);
+        return static_cast<CodepointWidth>((word >> (offset % s_widthsPerWord * s_widthBits)) & 3);
+    }
 }
 
 // Routine Description:
@@ -404,29 +527,19 @@ bool CodepointWidthDetector::IsWide(const std::wstring_view glyph) const
 }
 
 // Routine Description:
-// - returns the width type of codepoint by searching the map generated from the unicode spec
+// - returns the width type of codepoint by looking it up in the page table generated from the unicode spec
 // Arguments:
 // - glyph - the utf16 encoded codepoint to search for
 // Return Value:
 // - the width type of the codepoint
-CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view glyph) const
+CodepointWidth CodepointWidthDetector::_lookupGlyphWidth(const std::wstring_view glyph) const noexcept
 {
     if (glyph.empty())
     {
         return CodepointWidth::Invalid;
     }
 
-    const auto codepoint = _extractCodepoint(glyph);
-    const auto it = std::lower_bound(s_wideAndAmbiguousTable.begin(), s_wideAndAmbiguousTable.end(), codepoint);
-
-    // For characters that are not _in_ the table, lower_bound will return the nearest item that is.
-    // We must check its bounds to make sure that our hit was a true hit.
-    if (it != s_wideAndAmbiguousTable.end() && codepoint >= it->lowerBound && codepoint <= it->upperBound)
-    {
-        return it->width;
-    }
-
-    return CodepointWidth::Narrow;
+    return s_lookupCodepointWidth(_extractCodepoint(glyph));
 }
 
 // Routine Description:
@@ -471,19 +584,29 @@ CodepointWidth CodepointWidthDetector::_lookupGlyphWidthWithCache(const std::wst
 // - Checks the fallback function but caches the results until the font changes
 //   because the lookup function is usually very expensive and will return the same results
 //   for the same inputs.
+// - The cache is keyed by the codepoint the width was looked up for, like the table is,
+//   so that probing it doesn't need to copy the glyph. Only glyphs that consist of a single
+//   codepoint are cached; a longer glyph (e.g. one with a combining mark or a variation
+//   selector) can have a different width than its first codepoint and goes to the fallback directly.
 // Arguments:
 // - glyph - the utf16 encoded codepoint to check width of
 // - true if codepoint is wide or false if it is narrow
 bool CodepointWidthDetector::_checkFallbackViaCache(const std::wstring_view glyph) const
 {
-    const std::wstring findMe{ glyph };
+    const auto isSingleCodepoint = glyph.size() == 1 ||
+                                   (glyph.size() == 2 && Utf16Parser::IsLeadingSurrogate(glyph.at(0)) && Utf16Parser::IsTrailingSurrogate(glyph.at(1)));
+    if (!isSingleCodepoint)
+    {
+        return _pfnFallbackMethod(glyph);
+    }
+
+    const auto codepoint = _extractCodepoint(glyph);
 
-    // TODO: Cache needs to be emptied when font changes.
-    const auto it = _fallbackCache.find(findMe);
+    const auto it = _fallbackCache.find(codepoint);
     if (it == _fallbackCache.end())
     {
         auto result = _pfnFallbackMethod(glyph);
-        _fallbackCache.insert_or_assign(findMe, result);
+        _fallbackCache.insert_or_assign(codepoint, result);
         return result;
     }
     else